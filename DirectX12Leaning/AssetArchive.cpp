@@ -0,0 +1,268 @@
+//STL
+#include <fstream>
+
+//Utility
+#include "TextureCache.h"
+
+//this
+#include "AssetArchive.h"
+
+namespace
+{
+	const uint32_t maxMipCount = 16;
+
+	//Name length, offset, size, hash, width, height, format, mip count
+	const uint64_t minIndexEntrySize = 4 + 8 * 3 + 4 * 4;
+
+	//Bounds checked little endian reads
+	class Reader
+	{
+	public:
+		Reader(const uint8_t *data, const size_t size) : p(data), end(data + size), failed(false) {}
+
+		uint32_t U32()
+		{
+			uint32_t value = 0;
+			if (Take(4)) {
+				value = (uint32_t)p[-4] | ((uint32_t)p[-3] << 8) | ((uint32_t)p[-2] << 16) | ((uint32_t)p[-1] << 24);
+			}
+			return value;
+		}
+
+		uint64_t U64()
+		{
+			const uint64_t low = U32();
+			return low | ((uint64_t)U32() << 32);
+		}
+
+		std::string String(const uint32_t length)
+		{
+			if (!Take(length)) {
+				return std::string();
+			}
+			return std::string((const char *)p - length, length);
+		}
+
+		bool Failed() const { return failed; }
+
+	private:
+		bool Take(const size_t count)
+		{
+			if (failed || (size_t)(end - p) < count) {
+				failed = true;
+				return false;
+			}
+			p += count;
+			return true;
+		}
+
+		const uint8_t *p;
+		const uint8_t *end;
+		bool failed;
+	};
+
+	void WriteU32(std::vector<uint8_t> &out, const uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i) {
+			out.push_back((uint8_t)(value >> (i * 8)));
+		}
+	}
+
+	void WriteU64(std::vector<uint8_t> &out, const uint64_t value)
+	{
+		WriteU32(out, (uint32_t)value);
+		WriteU32(out, (uint32_t)(value >> 32));
+	}
+
+	uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+bool AssetArchive::Open(const std::string &path)
+{
+	Close();
+	if (!file.Open(path)) {
+		return false;
+	}
+
+	Reader header(file.GetData(), file.GetSize());
+	const uint32_t magic = header.U32();
+	const uint32_t version = header.U32();
+	const uint32_t count = header.U32();
+	header.U32();
+	const uint64_t indexOffset = header.U64();
+	const uint64_t indexSize = header.U64();
+	if (header.Failed() || magic != assetArchiveMagic || version != assetArchiveVersion ||
+		indexOffset > file.GetSize() || indexSize > file.GetSize() - indexOffset || count > indexSize / minIndexEntrySize) {
+		Close();
+		return false;
+	}
+
+	//Only the index is read here, payload pages stay untouched
+	Reader index(file.GetData() + indexOffset, (size_t)indexSize);
+	entries.resize(count);
+	for (auto &entry : entries) {
+		entry.name = index.String(index.U32());
+		entry.offset = index.U64();
+		entry.size = index.U64();
+		entry.contentHash = index.U64();
+		entry.width = index.U32();
+		entry.height = index.U32();
+		entry.format = index.U32();
+
+		const uint32_t mipCount = index.U32();
+		if (index.Failed() || mipCount == 0 || mipCount > maxMipCount || ImageElementSize(entry.format) == 0 ||
+			entry.offset > file.GetSize() || entry.size > file.GetSize() - entry.offset) {
+			Close();
+			return false;
+		}
+
+		entry.mips.resize(mipCount);
+		for (auto &mip : entry.mips) {
+			mip.width = index.U32();
+			mip.height = index.U32();
+			mip.rowPitch = index.U32();
+			mip.rowCount = index.U32();
+			mip.offset = (size_t)index.U64();
+
+			//Rows must cover the level and stay inside the payload
+			const uint64_t mipSize = (uint64_t)mip.rowPitch * mip.rowCount;
+			if (index.Failed() || mip.rowPitch < ImageRowPitch(entry.format, mip.width) || mip.rowCount != ImageRowCount(entry.format, mip.height) ||
+				mip.offset > entry.size || mipSize > entry.size - mip.offset) {
+				Close();
+				return false;
+			}
+		}
+
+		if (!names.emplace(entry.name, &entry - entries.data()).second) {
+			Close();
+			return false;
+		}
+	}
+	return true;
+}
+
+void AssetArchive::Close()
+{
+	file.Close();
+	entries.clear();
+	names.clear();
+}
+
+bool AssetArchive::IsOpen() const
+{
+	return file.IsOpen();
+}
+
+int AssetArchive::Find(const std::string &name) const
+{
+	auto found = names.find(CanonicalTexturePath(name));
+	return found != names.end() ? (int)found->second : -1;
+}
+
+size_t AssetArchive::GetCount() const
+{
+	return entries.size();
+}
+
+const std::string &AssetArchive::GetName(const size_t index) const
+{
+	return entries[index].name;
+}
+
+uint64_t AssetArchive::GetContentHash(const size_t index) const
+{
+	return entries[index].contentHash;
+}
+
+uint64_t AssetArchive::GetPayloadSize(const size_t index) const
+{
+	return entries[index].size;
+}
+
+ImageView AssetArchive::GetImage(const size_t index) const
+{
+	const Entry &entry = entries[index];
+	return { entry.width, entry.height, entry.format, entry.mips.data(), (uint32_t)entry.mips.size(), file.GetData() + entry.offset };
+}
+
+const MappedFile &AssetArchive::GetFile() const
+{
+	return file;
+}
+
+bool AssetArchiveWriter::AddTexture(const std::string &name, const DecodedImage &image)
+{
+	const std::string canonicalName = CanonicalTexturePath(name);
+	for (auto &texture : textures) {
+		if (texture.name == canonicalName) {
+			return false;
+		}
+	}
+
+	textures.push_back({ canonicalName, HashImage(image), image });
+	return true;
+}
+
+bool AssetArchiveWriter::Save(const std::string &path) const
+{
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+
+	//Payloads first, each on its own page
+	const std::vector<char> padding(assetArchiveAlignment, 0);
+	std::vector<uint64_t> offsets;
+	uint64_t position = assetArchiveAlignment;
+	file.write(padding.data(), assetArchiveAlignment);
+	for (auto &texture : textures) {
+		offsets.push_back(position);
+		file.write((const char *)texture.image.pixels.data(), texture.image.pixels.size());
+		position += texture.image.pixels.size();
+
+		const uint64_t aligned = AlignUp(position, assetArchiveAlignment);
+		file.write(padding.data(), aligned - position);
+		position = aligned;
+	}
+
+	std::vector<uint8_t> index;
+	for (size_t i = 0; i < textures.size(); ++i) {
+		const Texture &texture = textures[i];
+		WriteU32(index, (uint32_t)texture.name.size());
+		index.insert(index.end(), texture.name.begin(), texture.name.end());
+		WriteU64(index, offsets[i]);
+		WriteU64(index, texture.image.pixels.size());
+		WriteU64(index, texture.contentHash);
+		WriteU32(index, texture.image.width);
+		WriteU32(index, texture.image.height);
+		WriteU32(index, texture.image.format);
+		WriteU32(index, (uint32_t)texture.image.mips.size());
+		for (auto &mip : texture.image.mips) {
+			WriteU32(index, mip.width);
+			WriteU32(index, mip.height);
+			WriteU32(index, mip.rowPitch);
+			WriteU32(index, mip.rowCount);
+			WriteU64(index, mip.offset);
+		}
+	}
+	file.write((const char *)index.data(), index.size());
+
+	std::vector<uint8_t> header;
+	WriteU32(header, assetArchiveMagic);
+	WriteU32(header, assetArchiveVersion);
+	WriteU32(header, (uint32_t)textures.size());
+	WriteU32(header, 0);
+	WriteU64(header, position);
+	WriteU64(header, index.size());
+	file.seekp(0);
+	file.write((const char *)header.data(), header.size());
+	return (bool)file;
+}
+
+size_t AssetArchiveWriter::GetCount() const
+{
+	return textures.size();
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ImageCodec.h"
+#include "MappedFile.h"
+
+//'DXLA'
+const uint32_t assetArchiveMagic = 0x414c5844;
+const uint32_t assetArchiveVersion = 1;
+
+//Payloads start on a page so each texture pages in on its own
+const uint32_t assetArchiveAlignment = 4096;
+
+/// <summary>
+/// Texture pack: decoded mips stored ready to upload, index of name -> offset / size / layout
+/// </summary>
+/// <remarks>
+/// Layout: header, payloads (page aligned), index at indexOffset.
+/// Names are CanonicalTexturePath of the path given when packing.
+/// </remarks>
+class AssetArchive
+{
+public:
+	/// <summary>
+	/// Map the archive and read its index (payloads are not touched)
+	/// </summary>
+	/// <returns>false when the file is missing or malformed</returns>
+	bool Open(const std::string &path);
+	void Close();
+	bool IsOpen() const;
+
+	//Entry index, -1 when not packed
+	int Find(const std::string &name) const;
+
+	size_t GetCount() const;
+	const std::string &GetName(const size_t index) const;
+	uint64_t GetContentHash(const size_t index) const;	//HashImage at pack time
+	uint64_t GetPayloadSize(const size_t index) const;
+
+	/// <summary>
+	/// Texels of an entry, pointing into the mapping (valid until Close)
+	/// </summary>
+	ImageView GetImage(const size_t index) const;
+
+	const MappedFile &GetFile() const;
+
+private:
+	struct Entry
+	{
+		std::string name;
+		uint64_t offset;
+		uint64_t size;
+		uint64_t contentHash;
+		uint32_t width;
+		uint32_t height;
+		uint32_t format;
+		std::vector<ImageMip> mips;
+	};
+
+	MappedFile file;
+	std::vector<Entry> entries;
+	std::unordered_map<std::string, size_t> names;
+};
+
+/// <summary>
+/// Builds an AssetArchive file
+/// </summary>
+class AssetArchiveWriter
+{
+public:
+	/// <param name="name">Stored as CanonicalTexturePath(name)</param>
+	/// <returns>false when the name is already packed</returns>
+	bool AddTexture(const std::string &name, const DecodedImage &image);
+
+	bool Save(const std::string &path) const;
+	size_t GetCount() const;
+
+private:
+	struct Texture
+	{
+		std::string name;
+		uint64_t contentHash;
+		DecodedImage image;
+	};
+
+	std::vector<Texture> textures;
+};
@@ -0,0 +1,159 @@
+//Texture archive tool
+//usage: AssetPack pack archive file...          pack .tga / .hdr / .dds (mips generated when missing)
+//       AssetPack list archive
+//       AssetPack bench archive file... [-n N]   loose decode vs mapped archive, same files
+
+//STL
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//Utility
+#include "AssetArchive.h"
+#include "CacheKey.h"
+#include "ImageCodec.h"
+#include "TextureLayout.h"
+
+namespace
+{
+	int Pack(const std::string &archivePath, const std::vector<std::string> &files)
+	{
+		AssetArchiveWriter writer;
+		for (auto &path : files) {
+			DecodedImage image;
+			if (!DecodeImageFile(path, image)) {
+				printf("failed  %s: cannot decode\n", path.c_str());
+				return 1;
+			}
+			GenerateImageMips(image);
+
+			if (!writer.AddTexture(path, image)) {
+				printf("failed  %s: packed twice\n", path.c_str());
+				return 1;
+			}
+			printf("packed  %s (%ux%u, %zu mips)\n", path.c_str(), image.width, image.height, image.mips.size());
+		}
+
+		if (!writer.Save(archivePath)) {
+			printf("cannot write %s\n", archivePath.c_str());
+			return 1;
+		}
+		return 0;
+	}
+
+	int List(const std::string &archivePath)
+	{
+		AssetArchive archive;
+		if (!archive.Open(archivePath)) {
+			printf("cannot open %s\n", archivePath.c_str());
+			return 1;
+		}
+
+		for (size_t i = 0; i < archive.GetCount(); ++i) {
+			const ImageView image = archive.GetImage(i);
+			printf("%-40s %5ux%-5u format %3u  mips %2u  %10llu bytes  hash %016llx\n",
+				archive.GetName(i).c_str(), image.width, image.height, image.format, image.mipCount,
+				(unsigned long long)archive.GetPayloadSize(i), (unsigned long long)archive.GetContentHash(i));
+		}
+		return 0;
+	}
+
+	//Same work as the streamer: layout + copy into an upload buffer
+	uint64_t Upload(const ImageView &image, std::vector<uint8_t> &staging)
+	{
+		std::vector<UploadSubresource> layout;
+		staging.resize((size_t)ComputeUploadLayout(image, layout));
+		WriteUploadData(image, layout, staging.data());
+		return HashBytes(staging.data(), staging.size() < 64 ? staging.size() : 64);
+	}
+
+	int Bench(const std::string &archivePath, const std::vector<std::string> &files, const int iterations)
+	{
+		std::vector<uint8_t> staging;
+		uint64_t check = 0;
+		uint64_t bytes = 0;
+
+		//Loose: open + read + decode (+ mips) per file
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i) {
+			for (auto &path : files) {
+				DecodedImage image;
+				if (!DecodeImageFile(path, image)) {
+					printf("cannot decode %s\n", path.c_str());
+					return 1;
+				}
+				GenerateImageMips(image);
+				check += Upload(ViewImage(image), staging);
+				bytes += staging.size();
+			}
+		}
+		const double looseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		//Archive: one open, views into the mapping
+		start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; ++i) {
+			AssetArchive archive;
+			if (!archive.Open(archivePath)) {
+				printf("cannot open %s\n", archivePath.c_str());
+				return 1;
+			}
+			for (auto &path : files) {
+				const int index = archive.Find(path);
+				if (index < 0) {
+					printf("%s is not in %s\n", path.c_str(), archivePath.c_str());
+					return 1;
+				}
+				check -= Upload(archive.GetImage(index), staging);
+			}
+		}
+		const double archiveSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		const double megabytes = bytes / (1024.0 * 1024.0);
+		printf("files      : %zu x %d iterations, %.1f MB uploaded per pass\n", files.size(), iterations, megabytes / iterations);
+		printf("loose      : %8.3f ms per pass  %8.1f MB/s\n", looseSeconds * 1000.0 / iterations, megabytes / looseSeconds);
+		printf("archive    : %8.3f ms per pass  %8.1f MB/s\n", archiveSeconds * 1000.0 / iterations, megabytes / archiveSeconds);
+		printf("speedup    : %.1fx\n", archiveSeconds > 0 ? looseSeconds / archiveSeconds : 0.0);
+
+		//Both paths must produce the same upload bytes
+		if (check != 0) {
+			printf("mismatch between loose and archive data\n");
+			return 1;
+		}
+		return 0;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3) {
+		printf("usage: AssetPack pack archive file...\n");
+		printf("       AssetPack list archive\n");
+		printf("       AssetPack bench archive file... [-n iterations]\n");
+		return 1;
+	}
+
+	const std::string command = argv[1];
+	const std::string archivePath = argv[2];
+
+	int iterations = 10;
+	std::vector<std::string> files;
+	for (int i = 3; i < argc; ++i) {
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+			iterations = std::max(1, atoi(argv[++i]));
+		}
+		else {
+			files.push_back(argv[i]);
+		}
+	}
+
+	if (command == "pack")	{ return Pack(archivePath, files); }
+	if (command == "list")	{ return List(archivePath); }
+	if (command == "bench")	{ return Bench(archivePath, files, iterations); }
+
+	printf("unknown command %s\n", command.c_str());
+	return 1;
+}
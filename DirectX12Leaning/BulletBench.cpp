@@ -0,0 +1,89 @@
+//BulletPool fire / expire cost and heap use
+//usage: BulletBench [capacity] [rounds]   (default 100000 200)
+
+//STL
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//Utility
+#include "BulletPool.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	//Counted by the replaced operator new below
+	uint64_t allocationCount = 0;
+
+	double Milliseconds(const Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+}
+
+void *operator new(size_t size)
+{
+	++allocationCount;
+	if (void *p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+int main(int argc, char *argv[])
+{
+	const uint32_t capacity = argc > 1 ? (uint32_t)std::strtoul(argv[1], nullptr, 10) : 100000;
+	const uint32_t rounds = argc > 2 ? (uint32_t)std::strtoul(argv[2], nullptr, 10) : 200;
+	const Position3D muzzle = { 0, 0, 0 };
+
+	BulletPool pool(capacity, 60.0f, 3);
+
+	//Fill the pool with volleys, expire everything, again: every slot is reused each round
+	const uint64_t allocationsBefore = allocationCount;
+	double fireTime = 0, expireTime = 0;
+	for (uint32_t r = 0; r < rounds; ++r) {
+		auto start = Clock::now();
+		while (pool.GetCount() + 5 <= capacity) {
+			pool.FireVolley(muzzle, 5, 30.0f);
+		}
+		fireTime += Milliseconds(start);
+
+		//Front first: the worst case for swap remove bookkeeping
+		start = Clock::now();
+		while (pool.GetCount() > 0) {
+			pool.ExpireAt(0);
+		}
+		expireTime += Milliseconds(start);
+	}
+	const uint64_t allocations = allocationCount - allocationsBefore;
+	const double fired = (double)(capacity / 5 * 5) * rounds;
+
+	//Exhaustion: extra shots are dropped, nothing grows
+	pool.Clear();
+	const uint64_t droppedBefore = pool.GetDroppedCount();
+	uint32_t accepted = 0;
+	for (uint32_t i = 0; i < capacity + 100; ++i) {
+		accepted += pool.Fire(muzzle, 0) != invalidEntityHandle ? 1 : 0;
+	}
+	const uint64_t dropped = pool.GetDroppedCount() - droppedBefore;
+
+	printf("capacity        : %u\n", capacity);
+	printf("fire            : %.2f ns / bullet\n", fireTime * 1e6 / fired);
+	printf("expire          : %.2f ns / bullet\n", expireTime * 1e6 / fired);
+	printf("heap allocations: %llu in %u fill / drain rounds\n", (unsigned long long)allocations, rounds);
+	printf("full pool       : %u accepted, %llu dropped of %u shots\n", accepted, (unsigned long long)dropped, capacity + 100);
+
+	return allocations == 0 && accepted == capacity && dropped == 100 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+//STL
+#include <cmath>
+
+//this
+#include "BulletPool.h"
+
+namespace
+{
+	const float degreesToRadians = 3.14159265f / 180.0f;
+
+	//Playfield, bullets past it expire (the player moves in x -50 - 50, y -25 - 25)
+	const float fieldMinX = -80.0f;
+	const float fieldMaxX = 60.0f;
+	const float fieldMinY = -40.0f;
+	const float fieldMaxY = 40.0f;
+}
+
+BulletPool::BulletPool() : BulletPool(0, 0, 0) {}
+
+BulletPool::BulletPool(const uint32_t capacity, const float speed, const float radius) :
+	bullets(capacity),
+	speed(speed),
+	radius(radius),
+	volleysLeft(0),
+	volleyTimer(0),
+	dropped(0)
+{
+}
+
+void BulletPool::Update(const SimInput &input, const Position3D &playerPos, const float deltaTime)
+{
+	//A new press restarts the burst
+	if (input.GetKeyDown(SimButton_Fire)) {
+		volleysLeft = pattern.volleys;
+		volleyTimer = 0;
+	}
+
+	if (volleysLeft > 0) {
+		volleyTimer -= deltaTime;
+		if (volleyTimer <= 0) {
+			FireVolley(playerPos, pattern.shots, pattern.spread);
+			volleyTimer += pattern.volleyInterval;
+			--volleysLeft;
+		}
+	}
+
+	bullets.Integrate(deltaTime);
+	bullets.DespawnOutside(fieldMinX, fieldMinY, fieldMaxX, fieldMaxY);
+}
+
+EntityHandle BulletPool::Fire(const Position3D &position, const float angle)
+{
+	const float radians = angle * degreesToRadians;
+	const EntityHandle handle = bullets.Spawn(position.x, position.y, speed * std::cos(radians), speed * std::sin(radians));
+	if (handle == invalidEntityHandle) {
+		++dropped;
+	}
+	return handle;
+}
+
+uint32_t BulletPool::FireVolley(const Position3D &position, const uint32_t shots, const float spread)
+{
+	uint32_t fired = 0;
+	for (uint32_t i = 0; i < shots; ++i) {
+		const float angle = shots > 1 ? spread * ((float)i / (shots - 1) - 0.5f) : 0.0f;
+		if (Fire(position, angle) != invalidEntityHandle) {
+			++fired;
+		}
+	}
+	return fired;
+}
+
+void BulletPool::ExpireAt(const uint32_t index)
+{
+	bullets.DespawnAt(index);
+}
+
+void BulletPool::Clear()
+{
+	bullets.Clear();
+	volleysLeft = 0;
+}
+
+void BulletPool::SetPattern(const BulletPattern &pattern)
+{
+	this->pattern = pattern;
+}
+
+const BulletPattern &BulletPool::GetPattern() const
+{
+	return pattern;
+}
+
+uint32_t BulletPool::GetCount() const
+{
+	return bullets.GetCount();
+}
+
+uint32_t BulletPool::GetCapacity() const
+{
+	return bullets.GetCapacity();
+}
+
+uint64_t BulletPool::GetDroppedCount() const
+{
+	return dropped;
+}
+
+float BulletPool::GetRadius() const
+{
+	return radius;
+}
+
+const EntityStore &BulletPool::GetBullets() const
+{
+	return bullets;
+}
+
+void BulletPool::WriteState(StateHash &hash) const
+{
+	bullets.WriteState(hash);
+	hash.WriteValue(volleysLeft);
+	hash.WriteValue(volleyTimer);
+}
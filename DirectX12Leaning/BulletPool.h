@@ -0,0 +1,73 @@
+#pragma once
+#include "SimulationTypes.h"
+#include "EntityStore.h"
+
+//What one press of fire shoots
+struct BulletPattern
+{
+	uint32_t shots = 1;				//Bullets per volley
+	float spread = 0;				//Degrees between the first and the last bullet of a volley
+	uint32_t volleys = 1;			//Burst length
+	float volleyInterval = 0.1f;	//Seconds between volleys of a burst
+};
+
+/// <summary>
+/// Fixed capacity pool of live bullets (EntityStore underneath)
+/// </summary>
+/// <remarks>
+/// Fire / expire reuse free slots and never allocate.
+/// Shots fired while the pool is full are dropped and counted.
+/// </remarks>
+class BulletPool
+{
+public:
+	BulletPool();
+	BulletPool(const uint32_t capacity, const float speed, const float radius);
+
+	/// <summary>
+	/// Start pattern on fire, advance bursts, move and expire bullets
+	/// </summary>
+	/// <param name="playerPos">Muzzle, volleys of a burst follow the player</param>
+	void Update(const SimInput &input, const Position3D &playerPos, const float deltaTime);
+
+	/// <summary>
+	/// One bullet heading angle degrees from +x
+	/// </summary>
+	/// <returns>invalidEntityHandle when the pool is full</returns>
+	EntityHandle Fire(const Position3D &position, const float angle);
+
+	/// <summary>
+	/// shots bullets fanned over spread degrees, centered on +x
+	/// </summary>
+	/// <returns>Bullets fired (less than shots when the pool ran out)</returns>
+	uint32_t FireVolley(const Position3D &position, const uint32_t shots, const float spread);
+
+	//Remove the bullet at dense index (swap remove, indices above it change)
+	void ExpireAt(const uint32_t index);
+	void Clear();
+
+	void SetPattern(const BulletPattern &pattern);
+	const BulletPattern &GetPattern() const;
+
+	uint32_t GetCount() const;
+	uint32_t GetCapacity() const;
+	uint64_t GetDroppedCount() const;	//Shots lost to a full pool
+	float GetRadius() const;
+	const EntityStore &GetBullets() const;
+
+	void WriteState(StateHash &hash) const;
+
+private:
+	EntityStore bullets;
+	BulletPattern pattern;
+
+	//units per second
+	float speed;
+	float radius;
+
+	//Burst in progress
+	uint32_t volleysLeft;
+	float volleyTimer;
+
+	uint64_t dropped;
+};
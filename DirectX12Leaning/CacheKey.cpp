@@ -0,0 +1,65 @@
+//STL
+#include <cstring>
+
+//this
+#include "CacheKey.h"
+
+uint64_t HashBytes(const void *data, const size_t size, uint64_t hash)
+{
+	const uint8_t *p = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; ++i) {
+		hash ^= p[i];
+		hash *= fnvPrime;
+	}
+	return hash;
+}
+
+CacheKey::CacheKey()
+{
+	Clear();
+}
+
+void CacheKey::Write(const void *data, const size_t size)
+{
+	if (size == 0) {
+		return;
+	}
+
+	const uint8_t *p = static_cast<const uint8_t *>(data);
+	bytes.insert(bytes.end(), p, p + size);
+	hash = HashBytes(data, size, hash);
+}
+
+void CacheKey::WriteString(const char *text)
+{
+	//Length first so "ab"+"c" and "a"+"bc" differ
+	const uint32_t length = text != nullptr ? static_cast<uint32_t>(strlen(text)) : 0;
+	WriteValue(length);
+	Write(text, length);
+}
+
+void CacheKey::Clear()
+{
+	hash = fnvOffsetBasis;
+	bytes.clear();
+}
+
+uint64_t CacheKey::GetHash() const
+{
+	return hash;
+}
+
+size_t CacheKey::GetSize() const
+{
+	return bytes.size();
+}
+
+bool CacheKey::operator==(const CacheKey &other) const
+{
+	return hash == other.hash && bytes == other.bytes;
+}
+
+bool CacheKey::operator!=(const CacheKey &other) const
+{
+	return !(*this == other);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//FNV-1a 64bit
+const uint64_t fnvOffsetBasis = 14695981039346656037ull;
+const uint64_t fnvPrime = 1099511628211ull;
+
+uint64_t HashBytes(const void *data, const size_t size, const uint64_t hash = fnvOffsetBasis);
+
+/// <summary>
+/// Byte stream describing an object by content (hash + full bytes for exact compare)
+/// </summary>
+class CacheKey
+{
+public:
+	CacheKey();
+
+	void Write(const void *data, const size_t size);
+
+	//Null terminated, nullptr writes as empty
+	void WriteString(const char *text);
+
+	//Plain value without padding (enums, ints, floats)
+	template<class T>
+	void WriteValue(const T &value)
+	{
+		Write(&value, sizeof(T));
+	}
+
+	void Clear();
+
+	uint64_t GetHash() const;
+	size_t GetSize() const;
+
+	bool operator==(const CacheKey &other) const;
+	bool operator!=(const CacheKey &other) const;
+
+private:
+	uint64_t hash;
+	std::vector<uint8_t> bytes;
+};
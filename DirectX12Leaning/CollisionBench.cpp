@@ -0,0 +1,126 @@
+//SpatialHash broadphase against brute force, same random circles for both
+//usage: CollisionBench [count ...]   (default 1000 10000 100000)
+
+//STL
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//Utility
+#include "SimulationTypes.h"
+#include "SpatialHash.h"
+
+namespace
+{
+	struct Circle
+	{
+		float x;
+		float y;
+		float radius;
+	};
+
+	//Radius 1 - 3 (bullet / enemy sized), density kept the same for every count
+	std::vector<Circle> RandomCircles(const uint32_t count, const uint32_t seed)
+	{
+		const float side = std::sqrt((float)count) * 10.0f;
+
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(0, side);
+		std::uniform_real_distribution<float> radius(1.0f, 3.0f);
+
+		std::vector<Circle> circles(count);
+		for (auto &circle : circles) {
+			circle = { position(random), position(random), radius(random) };
+		}
+		return circles;
+	}
+
+	void BruteForce(const std::vector<Circle> &circles, std::vector<CollisionPair> &pairs)
+	{
+		pairs.clear();
+		for (uint32_t i = 0; i < (uint32_t)circles.size(); ++i) {
+			const Circle &a = circles[i];
+			for (uint32_t j = i + 1; j < (uint32_t)circles.size(); ++j) {
+				const Circle &b = circles[j];
+				if (CirclesOverlap(a.x, a.y, a.radius, b.x, b.y, b.radius)) {
+					pairs.push_back({ i, j });
+				}
+			}
+		}
+	}
+
+	//Clear + Insert + Build + QueryPairs, what a tick pays
+	void Broadphase(SpatialHash &hash, const std::vector<Circle> &circles, std::vector<CollisionPair> &pairs)
+	{
+		hash.Clear();
+		for (auto &circle : circles) {
+			hash.Insert(circle.x, circle.y, circle.radius);
+		}
+		hash.Build();
+		hash.QueryPairs(pairs);
+	}
+
+	bool SamePairs(std::vector<CollisionPair> a, std::vector<CollisionPair> b)
+	{
+		auto less = [](const CollisionPair &l, const CollisionPair &r) { return l.a != r.a ? l.a < r.a : l.b < r.b; };
+		std::sort(a.begin(), a.end(), less);
+		std::sort(b.begin(), b.end(), less);
+		return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const CollisionPair &l, const CollisionPair &r) {
+			return l.a == r.a && l.b == r.b;
+		});
+	}
+
+	//Average milliseconds per run, repeated until about 0.2 s has passed
+	template <typename Function>
+	double Measure(Function function)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		int runs = 0;
+		const auto start = Clock::now();
+		double elapsed = 0;
+		do {
+			function();
+			++runs;
+			elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		} while (elapsed < 200.0);
+		return elapsed / runs;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	std::vector<uint32_t> counts;
+	for (int i = 1; i < argc; ++i) {
+		counts.push_back((uint32_t)std::strtoul(argv[i], nullptr, 10));
+	}
+	if (counts.empty()) {
+		counts = { 1000, 10000, 100000 };
+	}
+
+	printf("%10s %10s %14s %14s %10s %16s\n", "bodies", "pairs", "brute (ms)", "hash (ms)", "speedup", "hash bodies/s");
+
+	int mismatches = 0;
+	for (auto count : counts) {
+		const std::vector<Circle> circles = RandomCircles(count, count);
+
+		SpatialHash hash(8.0f);
+		std::vector<CollisionPair> brutePairs, hashPairs;
+		const double bruteTime = Measure([&] { BruteForce(circles, brutePairs); });
+		const double hashTime = Measure([&] { Broadphase(hash, circles, hashPairs); });
+
+		const bool same = SamePairs(brutePairs, hashPairs);
+		if (!same) {
+			++mismatches;
+		}
+
+		printf("%10u %10zu %14.3f %14.3f %9.1fx %16.0f%s\n",
+			count, hashPairs.size(), bruteTime, hashTime, bruteTime / hashTime, count / (hashTime / 1000.0),
+			same ? "" : "  MISMATCH");
+	}
+	return mismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,177 @@
+//STL
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+//Utility
+#include "CacheKey.h"
+#include "ImageCodec.h"
+
+//this
+#include "CookManifest.h"
+
+namespace
+{
+	bool IsAbsolutePath(const std::string &path)
+	{
+		return (!path.empty() && (path[0] == '/' || path[0] == '\\')) || (path.size() > 1 && path[1] == ':');
+	}
+
+	std::string JoinPath(const std::string &baseDir, const std::string &path)
+	{
+		if (baseDir.empty() || IsAbsolutePath(path)) {
+			return path;
+		}
+
+		const char last = baseDir.back();
+		return (last == '/' || last == '\\') ? baseDir + path : baseDir + "/" + path;
+	}
+}
+
+bool ParseCookKind(const std::string &name, CookKind &kind)
+{
+	if (name == "color")	{ kind = CookKind::Color; return true; }
+	if (name == "mask")		{ kind = CookKind::Mask; return true; }
+	if (name == "normal")	{ kind = CookKind::Normal; return true; }
+	return false;
+}
+
+const char *GetCookKindName(const CookKind kind)
+{
+	switch (kind)
+	{
+		case CookKind::Mask:	return "mask";
+		case CookKind::Normal:	return "normal";
+		default:				return "color";
+	}
+}
+
+uint32_t GetCookFormat(const CookKind kind)
+{
+	switch (kind)
+	{
+		case CookKind::Mask:	return ImageFormat_BC4;
+		case CookKind::Normal:	return ImageFormat_BC5;
+		default:				return ImageFormat_BC7;
+	}
+}
+
+bool ParseCookManifest(const std::string &text, const std::string &baseDir, std::vector<CookEntry> &entries, std::string &error)
+{
+	std::istringstream stream(text);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(stream, line)) {
+		++lineNumber;
+
+		const size_t comment = line.find('#');
+		if (comment != std::string::npos) {
+			line.erase(comment);
+		}
+
+		std::istringstream fields(line);
+		std::string input, output, kindName, extra;
+		if (!(fields >> input)) {
+			continue;
+		}
+
+		CookEntry entry;
+		if (!(fields >> output >> kindName) || (fields >> extra)) {
+			error = "line " + std::to_string(lineNumber) + ": expected \"input output kind\"";
+			return false;
+		}
+		if (!ParseCookKind(kindName, entry.kind)) {
+			error = "line " + std::to_string(lineNumber) + ": unknown kind \"" + kindName + "\" (color / mask / normal)";
+			return false;
+		}
+
+		entry.input = JoinPath(baseDir, input);
+		entry.output = JoinPath(baseDir, output);
+		entries.push_back(entry);
+	}
+	return true;
+}
+
+uint64_t CookHash(const std::vector<uint8_t> &input, const CookKind kind)
+{
+	const uint32_t version = cookerVersion;
+	const uint32_t kindValue = (uint32_t)kind;
+
+	uint64_t hash = HashBytes(&version, sizeof(version));
+	hash = HashBytes(&kindValue, sizeof(kindValue), hash);
+	return HashBytes(input.data(), input.size(), hash);
+}
+
+std::string CookedTexturePath(const std::string &path)
+{
+	//Only a dot in the file name counts
+	const size_t dot = path.find_last_of('.');
+	const size_t slash = path.find_last_of("/\\");
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+		return path + ".dds";
+	}
+	return path.substr(0, dot) + ".dds";
+}
+
+bool CookDatabase::Load(const std::string &path)
+{
+	hashes.clear();
+
+	std::ifstream file(path);
+	if (!file) {
+		return true;
+	}
+
+	//"hash output" per line, output may contain spaces
+	std::string line;
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		uint64_t hash = 0;
+		if (!(fields >> std::hex >> hash)) {
+			continue;
+		}
+
+		std::string output;
+		std::getline(fields >> std::ws, output);
+		if (output.empty()) {
+			return false;
+		}
+		hashes[output] = hash;
+	}
+	return true;
+}
+
+bool CookDatabase::Save(const std::string &path) const
+{
+	std::ofstream file(path, std::ios::trunc);
+	if (!file) {
+		return false;
+	}
+
+	for (auto &entry : hashes) {
+		file << std::hex << std::setw(16) << std::setfill('0') << entry.second << ' ' << entry.first << '\n';
+	}
+	return (bool)file;
+}
+
+bool CookDatabase::IsUpToDate(const std::string &output, const uint64_t hash) const
+{
+	auto found = hashes.find(output);
+	return found != hashes.end() && found->second == hash;
+}
+
+bool CookDatabase::NeedsCook(const std::string &output, const uint64_t hash) const
+{
+	//Deleted outputs are cooked again even with a matching hash
+	return !IsUpToDate(output, hash) || !std::ifstream(output, std::ios::binary);
+}
+
+void CookDatabase::Set(const std::string &output, const uint64_t hash)
+{
+	hashes[output] = hash;
+}
+
+size_t CookDatabase::GetSize() const
+{
+	return hashes.size();
+}
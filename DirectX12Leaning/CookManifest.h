@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+//Bump when the cooker output changes, every entry is cooked again
+const uint32_t cookerVersion = 1;
+
+enum class CookKind {
+	Color,		//BC7
+	Mask,		//BC4, red channel
+	Normal		//BC5, red / green channels
+};
+
+struct CookEntry
+{
+	std::string input;		//Relative to the manifest
+	std::string output;
+	CookKind kind;
+};
+
+bool ParseCookKind(const std::string &name, CookKind &kind);
+const char *GetCookKindName(const CookKind kind);
+
+//ImageFormat (DXGI_FORMAT value) the kind is compressed to
+uint32_t GetCookFormat(const CookKind kind);
+
+/// <summary>
+/// Parse "input output kind" lines, '#' starts a comment
+/// </summary>
+/// <param name="baseDir">Prefixed to relative paths ("" = as written)</param>
+/// <param name="error">Line and reason of the first bad line</param>
+bool ParseCookManifest(const std::string &text, const std::string &baseDir, std::vector<CookEntry> &entries, std::string &error);
+
+//Input bytes + kind + cookerVersion
+uint64_t CookHash(const std::vector<uint8_t> &input, const CookKind kind);
+
+//path with its extension replaced by ".dds" (where the manifest writes the cooked texture)
+std::string CookedTexturePath(const std::string &path);
+
+/// <summary>
+/// Hash of the input each output was last cooked from
+/// </summary>
+class CookDatabase
+{
+public:
+	//A missing file is an empty database
+	bool Load(const std::string &path);
+	bool Save(const std::string &path) const;
+
+	bool IsUpToDate(const std::string &output, const uint64_t hash) const;
+
+	//Output missing, never cooked, or cooked from other input bytes / kind / cooker version
+	bool NeedsCook(const std::string &output, const uint64_t hash) const;
+	void Set(const std::string &output, const uint64_t hash);
+	size_t GetSize() const;
+
+private:
+	std::map<std::string, uint64_t> hashes;
+};
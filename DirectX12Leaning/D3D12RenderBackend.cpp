@@ -0,0 +1,186 @@
+//API
+#include <d3d12.h>
+
+//STL
+#include <assert.h>
+
+//this
+#include "D3D12RenderBackend.h"
+
+//The stream stores D3D12 values in plain integers
+static_assert(sizeof(GpuAddress) == sizeof(D3D12_GPU_VIRTUAL_ADDRESS), "GpuAddress must hold D3D12_GPU_VIRTUAL_ADDRESS");
+static_assert(sizeof(CpuDescriptor) >= sizeof(SIZE_T), "CpuDescriptor must hold D3D12_CPU_DESCRIPTOR_HANDLE");
+
+void D3D12RenderBackend::Execute(const RenderCommandList &list, ID3D12GraphicsCommandList *cmdList)
+{
+	Execute((const RenderCommandHeader *)list.GetData(), (const RenderCommandHeader *)(list.GetData() + list.GetSize()), cmdList);
+}
+
+void D3D12RenderBackend::Execute(const RenderCommandHeader *begin, const RenderCommandHeader *end, ID3D12GraphicsCommandList *cmdList)
+{
+	for (const RenderCommandHeader *header = begin; header != end; header = RenderCommandList::Next(header)) {
+		switch (header->type) {
+			case RenderCommandType::SetPipelineState: {
+				auto &command = *(const CmdSetPipelineState *)header;
+				cmdList->SetPipelineState((ID3D12PipelineState *)command.pipeline);
+				break;
+			}
+			case RenderCommandType::SetGraphicsRootSignature: {
+				auto &command = *(const CmdSetGraphicsRootSignature *)header;
+				cmdList->SetGraphicsRootSignature((ID3D12RootSignature *)command.rootSignature);
+				break;
+			}
+			case RenderCommandType::SetDescriptorHeaps: {
+				auto &command = *(const CmdSetDescriptorHeaps *)header;
+				ID3D12DescriptorHeap *heaps[CmdSetDescriptorHeaps::maxHeaps];
+				for (uint32_t i = 0; i < command.count; ++i) {
+					heaps[i] = (ID3D12DescriptorHeap *)command.heaps[i];
+				}
+				cmdList->SetDescriptorHeaps(command.count, heaps);
+				break;
+			}
+			case RenderCommandType::SetGraphicsRootConstantBufferView: {
+				auto &command = *(const CmdSetRootView *)header;
+				cmdList->SetGraphicsRootConstantBufferView(command.slot, command.address);
+				break;
+			}
+			case RenderCommandType::SetGraphicsRootShaderResourceView: {
+				auto &command = *(const CmdSetRootView *)header;
+				cmdList->SetGraphicsRootShaderResourceView(command.slot, command.address);
+				break;
+			}
+			case RenderCommandType::SetGraphicsRootDescriptorTable: {
+				auto &command = *(const CmdSetGraphicsRootDescriptorTable *)header;
+				D3D12_GPU_DESCRIPTOR_HANDLE table;
+				table.ptr = command.table;
+				cmdList->SetGraphicsRootDescriptorTable(command.slot, table);
+				break;
+			}
+			case RenderCommandType::IASetPrimitiveTopology: {
+				auto &command = *(const CmdIASetPrimitiveTopology *)header;
+				cmdList->IASetPrimitiveTopology((D3D12_PRIMITIVE_TOPOLOGY)command.topology);
+				break;
+			}
+			case RenderCommandType::IASetVertexBuffer: {
+				auto &command = *(const CmdIASetVertexBuffer *)header;
+				D3D12_VERTEX_BUFFER_VIEW view;
+				view.BufferLocation = command.view.address;
+				view.SizeInBytes = command.view.size;
+				view.StrideInBytes = command.view.stride;
+				cmdList->IASetVertexBuffers(command.slot, 1, &view);
+				break;
+			}
+			case RenderCommandType::IASetIndexBuffer: {
+				auto &command = *(const CmdIASetIndexBuffer *)header;
+				D3D12_INDEX_BUFFER_VIEW view;
+				view.BufferLocation = command.view.address;
+				view.SizeInBytes = command.view.size;
+				view.Format = (DXGI_FORMAT)command.view.format;
+				cmdList->IASetIndexBuffer(&view);
+				break;
+			}
+			case RenderCommandType::RSSetViewport: {
+				auto &command = *(const CmdRSSetViewport *)header;
+				D3D12_VIEWPORT viewport;
+				viewport.TopLeftX = command.x;
+				viewport.TopLeftY = command.y;
+				viewport.Width = command.width;
+				viewport.Height = command.height;
+				viewport.MinDepth = command.minDepth;
+				viewport.MaxDepth = command.maxDepth;
+				cmdList->RSSetViewports(1, &viewport);
+				break;
+			}
+			case RenderCommandType::RSSetScissorRect: {
+				auto &command = *(const CmdRSSetScissorRect *)header;
+				D3D12_RECT rect;
+				rect.left = command.left;
+				rect.top = command.top;
+				rect.right = command.right;
+				rect.bottom = command.bottom;
+				cmdList->RSSetScissorRects(1, &rect);
+				break;
+			}
+			case RenderCommandType::OMSetRenderTargets: {
+				auto &command = *(const CmdOMSetRenderTargets *)header;
+				D3D12_CPU_DESCRIPTOR_HANDLE renderTarget, depthStencil;
+				renderTarget.ptr = (SIZE_T)command.renderTarget;
+				depthStencil.ptr = (SIZE_T)command.depthStencil;
+				cmdList->OMSetRenderTargets(
+					command.renderTarget != 0 ? 1 : 0,
+					command.renderTarget != 0 ? &renderTarget : nullptr,
+					false,
+					command.depthStencil != 0 ? &depthStencil : nullptr
+				);
+				break;
+			}
+			case RenderCommandType::ClearRenderTargetView: {
+				auto &command = *(const CmdClearRenderTargetView *)header;
+				D3D12_CPU_DESCRIPTOR_HANDLE view;
+				view.ptr = (SIZE_T)command.view;
+				cmdList->ClearRenderTargetView(view, command.color, 0, nullptr);
+				break;
+			}
+			case RenderCommandType::ClearDepthStencilView: {
+				auto &command = *(const CmdClearDepthStencilView *)header;
+				D3D12_CPU_DESCRIPTOR_HANDLE view;
+				view.ptr = (SIZE_T)command.view;
+				cmdList->ClearDepthStencilView(view, (D3D12_CLEAR_FLAGS)command.flags, command.depth, command.stencil, 0, nullptr);
+				break;
+			}
+			case RenderCommandType::ResourceBarrier: {
+				auto &command = *(const CmdResourceBarrier *)header;
+				D3D12_RESOURCE_BARRIER barrier{};
+				barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+				barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+				barrier.Transition.pResource = (ID3D12Resource *)command.resource;
+				barrier.Transition.StateBefore = (D3D12_RESOURCE_STATES)command.before;
+				barrier.Transition.StateAfter = (D3D12_RESOURCE_STATES)command.after;
+				barrier.Transition.Subresource = command.subresource;
+				cmdList->ResourceBarrier(1, &barrier);
+				break;
+			}
+			case RenderCommandType::CopyBufferRegion: {
+				auto &command = *(const CmdCopyBufferRegion *)header;
+				cmdList->CopyBufferRegion((ID3D12Resource *)command.destination, command.destinationOffset, (ID3D12Resource *)command.source, command.sourceOffset, command.size);
+				break;
+			}
+			case RenderCommandType::DrawIndexedInstanced: {
+				auto &command = *(const CmdDrawIndexedInstanced *)header;
+				cmdList->DrawIndexedInstanced(command.indexCount, command.instanceCount, command.startIndex, command.baseVertex, command.startInstance);
+				break;
+			}
+			case RenderCommandType::DrawInstanced: {
+				auto &command = *(const CmdDrawInstanced *)header;
+				cmdList->DrawInstanced(command.vertexCount, command.instanceCount, command.startVertex, command.startInstance);
+				break;
+			}
+			case RenderCommandType::EndQuery: {
+				auto &command = *(const CmdEndQuery *)header;
+				cmdList->EndQuery((ID3D12QueryHeap *)command.heap, (D3D12_QUERY_TYPE)command.queryType, command.index);
+				break;
+			}
+			case RenderCommandType::ResolveQueryData: {
+				auto &command = *(const CmdResolveQueryData *)header;
+				cmdList->ResolveQueryData((ID3D12QueryHeap *)command.heap, (D3D12_QUERY_TYPE)command.queryType, command.start, command.count, (ID3D12Resource *)command.destination, command.destinationOffset);
+				break;
+			}
+
+			//Statistics only
+			case RenderCommandType::Upload: {
+				break;
+			}
+
+			//RenderCommandListPool::BuildSubmission splits the stream here, never replayed
+			case RenderCommandType::ParallelLists: {
+				assert(false);
+				break;
+			}
+
+			default: {
+				assert(false);
+				break;
+			}
+		}
+	}
+}
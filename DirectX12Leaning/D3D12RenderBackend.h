@@ -0,0 +1,15 @@
+#pragma once
+#include "RenderCommandList.h"
+
+/// <summary>
+/// Replays a RenderCommandList into a D3D12 command list
+/// </summary>
+class D3D12RenderBackend
+{
+public:
+	//cmdList must be open, commands are appended in stream order
+	void Execute(const RenderCommandList &list, ID3D12GraphicsCommandList *cmdList);
+
+	//Commands [begin, end) (RenderSubmission range), no state: one call per thread at a time is fine
+	void Execute(const RenderCommandHeader *begin, const RenderCommandHeader *end, ID3D12GraphicsCommandList *cmdList);
+};
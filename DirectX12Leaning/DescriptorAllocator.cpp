@@ -0,0 +1,114 @@
+//STL
+#include <algorithm>
+#include <functional>
+#include <assert.h>
+
+//this
+#include "DescriptorAllocator.h"
+
+DescriptorAllocator::DescriptorAllocator(const uint32_t persistentCapacity, const uint32_t transientCapacity) :
+	persistentCapacity(persistentCapacity),
+	transientCapacity(transientCapacity),
+	allocated(persistentCapacity, 0),
+	allocatedCount(0),
+	transient(std::max(transientCapacity, 1u))
+{
+	freeList.reserve(persistentCapacity);
+	for (uint32_t i = persistentCapacity; i > 0; --i) {
+		freeList.push_back(i - 1);
+	}
+}
+
+uint32_t DescriptorAllocator::Allocate()
+{
+	if (freeList.empty()) {
+		return invalidIndex;
+	}
+
+	const uint32_t index = freeList.back();
+	freeList.pop_back();
+
+	allocated[index] = 1;
+	++allocatedCount;
+	return index;
+}
+
+void DescriptorAllocator::Free(const uint32_t index)
+{
+	if (index == invalidIndex) {
+		return;
+	}
+
+	//Double free / transient slot
+	assert(index < persistentCapacity && allocated[index] != 0);
+
+	allocated[index] = 0;
+	--allocatedCount;
+	freedThisFrame.push_back(index);
+}
+
+uint32_t DescriptorAllocator::AllocateTransient(const uint32_t count)
+{
+	if (transientCapacity == 0 || count == 0) {
+		return invalidIndex;
+	}
+
+	const uint64_t offset = transient.Allocate(count, 1);
+	if (offset == LinearRingAllocator::invalidOffset) {
+		return invalidIndex;
+	}
+	return persistentCapacity + (uint32_t)offset;
+}
+
+void DescriptorAllocator::EndFrame(const uint64_t fenceValue)
+{
+	transient.EndFrame(fenceValue);
+
+	if (!freedThisFrame.empty()) {
+		pendingFrees.push_back({ fenceValue, std::vector<uint32_t>() });
+		pendingFrees.back().indices.swap(freedThisFrame);
+	}
+}
+
+void DescriptorAllocator::Retire(const uint64_t completedFenceValue)
+{
+	transient.Retire(completedFenceValue);
+
+	bool returned = false;
+	while (!pendingFrees.empty() && pendingFrees.front().fenceValue <= completedFenceValue) {
+		const std::vector<uint32_t> &indices = pendingFrees.front().indices;
+		freeList.insert(freeList.end(), indices.begin(), indices.end());
+		pendingFrees.pop_front();
+		returned = true;
+	}
+
+	//Keep handing out the lowest slot first
+	if (returned) {
+		std::sort(freeList.begin(), freeList.end(), std::greater<uint32_t>());
+	}
+}
+
+uint32_t DescriptorAllocator::GetCapacity() const
+{
+	return persistentCapacity + transientCapacity;
+}
+
+uint32_t DescriptorAllocator::GetPersistentCapacity() const
+{
+	return persistentCapacity;
+}
+
+uint32_t DescriptorAllocator::GetTransientCapacity() const
+{
+	return transientCapacity;
+}
+
+uint32_t DescriptorAllocator::GetAllocatedCount() const
+{
+	return allocatedCount;
+}
+
+bool DescriptorAllocator::IsAllocated(const uint32_t index) const
+{
+	return index < persistentCapacity && allocated[index] != 0;
+}
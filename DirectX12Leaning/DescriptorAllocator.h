@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include "LinearRingAllocator.h"
+
+/// <summary>
+/// Descriptor slots of one heap: [0, persistent) from a free list, [persistent, persistent + transient) as a per frame ring
+/// </summary>
+class DescriptorAllocator
+{
+public:
+	static const uint32_t invalidIndex = UINT32_MAX;
+
+	DescriptorAllocator(const uint32_t persistentCapacity, const uint32_t transientCapacity);
+
+	/// <summary>
+	/// Slot kept until Free (textures)
+	/// </summary>
+	/// <returns>Lowest free slot, invalidIndex when full</returns>
+	uint32_t Allocate();
+
+	/// <summary>
+	/// Slot is reused once the frame it was freed in has retired
+	/// </summary>
+	void Free(const uint32_t index);
+
+	/// <summary>
+	/// count contiguous slots valid for the current frame only
+	/// </summary>
+	/// <returns>First slot, invalidIndex when the ring is full</returns>
+	uint32_t AllocateTransient(const uint32_t count);
+
+	//Same contract as LinearRingAllocator
+	void EndFrame(const uint64_t fenceValue);
+	void Retire(const uint64_t completedFenceValue);
+
+	uint32_t GetCapacity() const;
+	uint32_t GetPersistentCapacity() const;
+	uint32_t GetTransientCapacity() const;
+	uint32_t GetAllocatedCount() const;
+	bool IsAllocated(const uint32_t index) const;
+
+private:
+	struct PendingFree
+	{
+		uint64_t fenceValue;
+		std::vector<uint32_t> indices;
+	};
+
+	uint32_t persistentCapacity;
+	uint32_t transientCapacity;
+
+	//Popped from the back, kept so the lowest slot comes first
+	std::vector<uint32_t> freeList;
+	std::vector<uint8_t> allocated;
+	uint32_t allocatedCount;
+
+	//Freed during the current frame / waiting for the GPU
+	std::vector<uint32_t> freedThisFrame;
+	std::deque<PendingFree> pendingFrees;
+
+	LinearRingAllocator transient;
+};
@@ -0,0 +1,93 @@
+//API
+#include <d3d12.h>
+#include <d3dx12.h>
+
+//STL
+#include <assert.h>
+
+//this
+#include "DescriptorHeap.h"
+
+DescriptorHeap::DescriptorHeap(const uint32_t persistentCapacity, const uint32_t transientCapacity) :
+	allocator(persistentCapacity, transientCapacity),
+	heap(nullptr),
+	cpuBase{},
+	gpuBase{},
+	descriptorSize(0)
+{
+}
+
+DescriptorHeap::~DescriptorHeap()
+{
+	if (heap != nullptr) {
+		heap->Release();
+	}
+}
+
+void DescriptorHeap::Initialize(ID3D12Device *dev)
+{
+	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc{};
+	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+	descHeapDesc.NumDescriptors = allocator.GetCapacity();
+
+	result = dev->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&heap));
+	assert(result == S_OK);
+
+	cpuBase = heap->GetCPUDescriptorHandleForHeapStart();
+	gpuBase = heap->GetGPUDescriptorHandleForHeapStart();
+	descriptorSize = dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+}
+
+uint32_t DescriptorHeap::Allocate()
+{
+	const uint32_t index = allocator.Allocate();
+
+	//Raise descriptorHeapSize in DirectX12.h
+	assert(index != DescriptorAllocator::invalidIndex);
+	return index;
+}
+
+void DescriptorHeap::Free(const uint32_t index)
+{
+	allocator.Free(index);
+}
+
+uint32_t DescriptorHeap::AllocateTransient(const uint32_t count)
+{
+	const uint32_t index = allocator.AllocateTransient(count);
+
+	//Ring too small for the frames in flight
+	assert(index != DescriptorAllocator::invalidIndex);
+	return index;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE DescriptorHeap::GetCpuHandle(const uint32_t index) const
+{
+	return CD3DX12_CPU_DESCRIPTOR_HANDLE(cpuBase, index, descriptorSize);
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE DescriptorHeap::GetGpuHandle(const uint32_t index) const
+{
+	return CD3DX12_GPU_DESCRIPTOR_HANDLE(gpuBase, index, descriptorSize);
+}
+
+ID3D12DescriptorHeap *DescriptorHeap::GetHeap() const
+{
+	return heap;
+}
+
+void DescriptorHeap::EndFrame(const uint64_t fenceValue)
+{
+	allocator.EndFrame(fenceValue);
+}
+
+void DescriptorHeap::Retire(const uint64_t completedFenceValue)
+{
+	allocator.Retire(completedFenceValue);
+}
+
+uint32_t DescriptorHeap::GetAllocatedCount() const
+{
+	return allocator.GetAllocatedCount();
+}
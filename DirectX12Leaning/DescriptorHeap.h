@@ -0,0 +1,43 @@
+#pragma once
+#include "DescriptorAllocator.h"
+
+/// <summary>
+/// The one shader visible CBV / SRV / UAV heap, bound once per frame by DirectX12
+/// </summary>
+class DescriptorHeap
+{
+public:
+	DescriptorHeap(const uint32_t persistentCapacity, const uint32_t transientCapacity);
+	~DescriptorHeap();
+	void Initialize(ID3D12Device *dev);
+
+	/// <summary>
+	/// Slot for a long lived view (texture SRV), asserts when the heap is full
+	/// </summary>
+	uint32_t Allocate();
+	void Free(const uint32_t index);
+
+	/// <summary>
+	/// count contiguous slots for the current frame (tables built per draw)
+	/// </summary>
+	uint32_t AllocateTransient(const uint32_t count);
+
+	D3D12_CPU_DESCRIPTOR_HANDLE GetCpuHandle(const uint32_t index) const;
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(const uint32_t index) const;
+	ID3D12DescriptorHeap *GetHeap() const;
+
+	//Called by DirectX12::ScreenFlip
+	void EndFrame(const uint64_t fenceValue);
+	void Retire(const uint64_t completedFenceValue);
+
+	uint32_t GetAllocatedCount() const;
+
+private:
+	HRESULT result;
+	DescriptorAllocator allocator;
+
+	ID3D12DescriptorHeap *heap;
+	D3D12_CPU_DESCRIPTOR_HANDLE cpuBase;
+	D3D12_GPU_DESCRIPTOR_HANDLE gpuBase;
+	UINT descriptorSize;
+};
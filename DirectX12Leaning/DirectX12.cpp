@@ -14,6 +14,7 @@
 //STL
 #include <vector>
 #include <string>
+#include <algorithm>
 #include <assert.h>
 
 //Utility
@@ -23,7 +24,65 @@
 //this me
 #include "DirectX12.h"
 
-DirectX12::DirectX12(HWND hwnd, const int window_width, const int window_height, SelectVSYNC vsync) : hwnd(hwnd), window_width(window_width), window_height(window_height), VSYNCMode((int)vsync)
+#pragma region FrameFence
+D3D12FrameFence::D3D12FrameFence()
+{
+	queue = nullptr;
+	fence = nullptr;
+	event = nullptr;
+}
+
+D3D12FrameFence::~D3D12FrameFence()
+{
+	if (event != nullptr) {
+		CloseHandle(event);
+	}
+}
+
+HRESULT D3D12FrameFence::Initialize(ID3D12Device *dev, ID3D12CommandQueue *queue)
+{
+	this->queue = queue;
+
+	HRESULT result = dev->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+	assert(result == S_OK);
+
+	event = CreateEvent(nullptr, false, false, nullptr);
+	assert(event != nullptr);
+
+	return result;
+}
+
+void D3D12FrameFence::Signal(const uint64_t value)
+{
+	queue->Signal(fence.Get(), value);
+}
+
+uint64_t D3D12FrameFence::GetCompletedValue()
+{
+	return fence->GetCompletedValue();
+}
+
+void D3D12FrameFence::WaitForValue(const uint64_t value)
+{
+	if (fence->GetCompletedValue() < value) {
+		fence->SetEventOnCompletion(value, event);
+		WaitForSingleObject(event, INFINITE);
+	}
+}
+#pragma endregion
+
+DirectX12::DirectX12(HWND hwnd, const int window_width, const int window_height, SelectVSYNC vsync, const int frameLatency) :
+	hwnd(hwnd),
+	window_width(window_width),
+	window_height(window_height),
+	VSYNCMode((int)vsync),
+	framePacer(&frameFence, std::min(std::max(frameLatency, 1), maxFrameLatency)),
+	uploadRing(uploadRingSize),
+	descriptorHeap(descriptorHeapSize, transientDescriptorSize),
+	textureStreamer(textureCacheBudget),
+	gpuProfiler(framePacer.GetFrameCount() + 1),
+	renderTargets(renderTargetViewCount, depthStencilViewCount),
+	depthStencil(nullptr)
 {
 	//GPU
 	result = S_FALSE;
@@ -34,7 +93,8 @@ DirectX12::DirectX12(HWND hwnd, const int window_width, const int window_height,
 	featurelevel = {};
 
 	//Commands
-	cmdAllocator = nullptr;
+	cmdAllocators = std::vector<ComPtr<ID3D12CommandAllocator>>(framePacer.GetFrameCount());
+	parallelCmdLists = std::vector<std::vector<ParallelCmdList>>(framePacer.GetFrameCount());
 	cmdList = nullptr;
 	cmdQueue = nullptr;
 	cmdQueueDesc = {};
@@ -46,22 +106,27 @@ DirectX12::DirectX12(HWND hwnd, const int window_width, const int window_height,
 	//Heap
 	heapDesc = {};
 
-	//Fence
-	fence = nullptr;
-	fenceVal = 0;
+	//Target view (at least double buffered)
+	backBuffers = std::vector<ComPtr<ID3D12Resource>>(std::max(framePacer.GetFrameCount(), 2));
 
 	//Draw
 	barrierDesc = {};
+	renderTargetView = {};
+	frameRegion = GpuProfiler::invalidRegion;
+	skippedStateCalls = 0;
 }
 
 DirectX12::~DirectX12()
 {
+	//GPU may still use the frames in flight
+	if (cmdQueue != nullptr) {
+		WaitIdle();
+	}
+
 	delete tmpAdapter;
-	delete cmdAllocator;
 	delete cmdQueue;
 	delete swapchain;
 	delete rtvHeaps;
-	delete fence;
 }
 
 void DirectX12::Initialize_components()
@@ -70,11 +135,19 @@ void DirectX12::Initialize_components()
 	D3D12ListUpGPU();
 	D3D12SelectGPU();
 	D3D12FeatureLv();
+	pipelineCache.Initialize(dev.Get());
+	shaderCache.Initialize();
+	uploadRing.Initialize(dev.Get(), &frameFence);
+	descriptorHeap.Initialize(dev.Get());
+	textureStreamer.Initialize(dev.Get(), &descriptorHeap);
+	renderTargets.Initialize(dev.Get());
 
 	//Create allocater
 	D3D12CreateCommandAllocator();
 	D3D12CreateCommandList();
 	D3D12CreateCommandQueueDescription();
+	gpuProfiler.Initialize(dev.Get(), cmdQueue);
+	SetFrameDescriptorHeaps();
 
 	//Swap chain
 	D3D12SetSwapchainDescription();
@@ -84,6 +157,7 @@ void DirectX12::Initialize_components()
 
 	//Target veiw
 	D3D12SetTargetView();
+	D3D12CreateDepthStencil();
 
 	//Fence
 	D3D12CreateFence();
@@ -100,13 +174,109 @@ ID3D12Device *DirectX12::GetDevice()
 	return dev.Get();
 }
 
-ID3D12GraphicsCommandList *DirectX12::GetCommandList()
+RenderCommandList *DirectX12::GetCommandList()
+{
+	return &commands;
+}
+
+uint32_t DirectX12::GetSkippedStateCalls() const
+{
+	return skippedStateCalls;
+}
+
+uint32_t DirectX12::BeginParallelCommandLists(const uint32_t count)
+{
+	const uint32_t first = parallelCommands.Begin(commands, count);
+	for (uint32_t i = first; i < first + count; ++i) {
+		SetFrameState(parallelCommands.Get(i));
+	}
+
+	//The main list continues in a new D3D12 command list
+	SetFrameState(&commands);
+	return first;
+}
+
+RenderCommandList *DirectX12::GetParallelCommandList(const uint32_t index)
+{
+	return parallelCommands.Get(index);
+}
+
+JobSystem *DirectX12::GetJobSystem()
+{
+	return &jobs;
+}
+
+int DirectX12::GetFrameIndex() const
+{
+	return framePacer.GetFrameIndex();
+}
+
+int DirectX12::GetFrameCount() const
+{
+	return framePacer.GetFrameCount();
+}
+
+FramePacer *DirectX12::GetFramePacer()
+{
+	return &framePacer;
+}
+
+PipelineCache *DirectX12::GetPipelineCache()
 {
-	return cmdList.Get();
+	return &pipelineCache;
+}
+
+ShaderCache *DirectX12::GetShaderCache()
+{
+	return &shaderCache;
+}
+
+UploadRing *DirectX12::GetUploadRing()
+{
+	return &uploadRing;
+}
+
+DescriptorHeap *DirectX12::GetDescriptorHeap()
+{
+	return &descriptorHeap;
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE DirectX12::GetDepthStencilView() const
+{
+	return depthStencil->view;
+}
+
+DXGI_FORMAT DirectX12::GetDepthFormat() const
+{
+	return DXGI_FORMAT_D32_FLOAT;
+}
+
+GpuRenderTargetPool *DirectX12::GetRenderTargetPool()
+{
+	return &renderTargets;
+}
+
+TextureStreamer *DirectX12::GetTextureStreamer()
+{
+	return &textureStreamer;
+}
+
+GpuProfiler *DirectX12::GetGpuProfiler()
+{
+	return &gpuProfiler;
+}
+
+void DirectX12::WaitIdle()
+{
+	framePacer.WaitIdle();
+	gpuProfiler.Retire(framePacer.GetCompletedValue());
 }
 
 void DirectX12::ClearDrawScreen(const DirectX::XMFLOAT4 color)
 {
+	PROFILE_SCOPE("ClearDrawScreen");
+	frameRegion = gpuProfiler.Begin(&commands, "Frame");
+
 	//Get buck buffer number
 	UINT bbIndex = swapchain->GetCurrentBackBufferIndex();
 
@@ -114,7 +284,7 @@ void DirectX12::ClearDrawScreen(const DirectX::XMFLOAT4 color)
 	barrierDesc.Transition.pResource = backBuffers[bbIndex].Get();
 	barrierDesc.Transition.StateBefore = D3D12_RESOURCE_STATE_PRESENT;		//view
 	barrierDesc.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;	//draw
-	cmdList->ResourceBarrier(1, &barrierDesc);
+	commands.ResourceBarrier(1, &barrierDesc);
 
 	//Get Render target view discriper heap handle
 	auto rtvH = CD3DX12_CPU_DESCRIPTOR_HANDLE(
@@ -123,11 +293,14 @@ void DirectX12::ClearDrawScreen(const DirectX::XMFLOAT4 color)
 		dev->GetDescriptorHandleIncrementSize(heapDesc.Type)
 	);
 
-	cmdList->OMSetRenderTargets(1, &rtvH, false, nullptr);
+	renderTargetView = rtvH;
+	const D3D12_CPU_DESCRIPTOR_HANDLE dsvH = depthStencil->view;
+	commands.OMSetRenderTargets(1, &rtvH, false, &dsvH);
 
 	//Display clear
 	float clearColor[] = { color.x, color.y, color.z, color.w };
-	cmdList->ClearRenderTargetView(rtvH, clearColor, 0, nullptr);
+	commands.ClearRenderTargetView(rtvH, clearColor, 0, nullptr);
+	commands.ClearDepthStencilView(dsvH, D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
 
 	SetScissorrect();
 	SetViewport();
@@ -135,37 +308,101 @@ void DirectX12::ClearDrawScreen(const DirectX::XMFLOAT4 color)
 
 void DirectX12::ScreenFlip()
 {
+	PROFILE_SCOPE("ScreenFlip");
+
 	RestoreResourceBarrierSetting();
 
-	//Close command
-	cmdList->Close();
+	//Timestamps of the frame go to the readback buffer with the frame
+	gpuProfiler.End(&commands, frameRegion);
+	frameRegion = GpuProfiler::invalidRegion;
+	gpuProfiler.Resolve(&commands);
+
+	//Recorded frame -> D3D12, one command list per submitted range (replayed in parallel)
+	{
+		PROFILE_SCOPE("ReplayCommands");
+		parallelCommands.BuildSubmission(commands, submission);
+		PrepareParallelCmdLists((uint32_t)submission.size() - 1);
+
+		const int frameIndex = framePacer.GetFrameIndex();
+		jobs.ParallelFor((uint32_t)submission.size(), 1, [this, frameIndex](const uint32_t i) {
+			ID3D12GraphicsCommandList *list = i == 0 ? cmdList.Get() : parallelCmdLists[frameIndex][i - 1].list.Get();
+			renderBackend.Execute(submission[i].begin, submission[i].end, list);
+
+			//Close command
+			list->Close();
+		});
+
+		submitLists.clear();
+		submitLists.push_back(cmdList.Get());
+		for (uint32_t i = 1; i < (uint32_t)submission.size(); ++i) {
+			submitLists.push_back(parallelCmdLists[frameIndex][i - 1].list.Get());
+		}
 
-	//Run commandlist
-	ID3D12CommandList *cmdLists[] = { cmdList.Get() };
-	cmdQueue->ExecuteCommandLists(1, cmdLists);
+		skippedStateCalls = commands.GetSkippedCount() + parallelCommands.GetSkippedCount();
+		Profiler::Get().RecordCounter("SkippedStateCalls", skippedStateCalls);
+		commands.Reset();
+		parallelCommands.Reset();
+	}
 
-	//awaiting run commandlist
-	cmdQueue->Signal(fence, ++fenceVal);
-	if (fence->GetCompletedValue() != fenceVal) {
-		HANDLE event = CreateEvent(nullptr, false, false, nullptr);
-		fence->SetEventOnCompletion(fenceVal, event);
+	//Run commandlists in submission order
+	cmdQueue->ExecuteCommandLists((UINT)submitLists.size(), submitLists.data());
+	{
+		PROFILE_SCOPE("Present");
+		swapchain->Present(VSYNCMode, 0);
+	}
 
-		if (event != 0) {
-			WaitForSingleObject(event, INFINITE);
-			CloseHandle(event);
-		}
+	//Only wait when the next frame slot is still in flight
+	const uint64_t fenceValue = framePacer.EndFrame();
+	uploadRing.EndFrame(fenceValue);
+	descriptorHeap.EndFrame(fenceValue);
+	renderTargets.EndFrame(fenceValue);
+	textureStreamer.EndFrame(fenceValue);
+	gpuProfiler.EndFrame(fenceValue);
+
+	int frameIndex;
+	{
+		PROFILE_SCOPE("WaitFrame");
+		frameIndex = framePacer.BeginFrame();
 	}
+	uploadRing.Retire(framePacer.GetCompletedValue());
+	descriptorHeap.Retire(framePacer.GetCompletedValue());
+	renderTargets.Retire(framePacer.GetCompletedValue());
+	textureStreamer.Retire(framePacer.GetCompletedValue());
+	gpuProfiler.Retire(framePacer.GetCompletedValue());
+
+	//Textures decoded since the last frame go to the copy queue
+	textureStreamer.Update();
+
+	cmdAllocators[frameIndex]->Reset();
+	cmdList->Reset(cmdAllocators[frameIndex].Get(), nullptr);
+	SetFrameDescriptorHeaps();
+}
+
+void DirectX12::SetFrameDescriptorHeaps()
+{
+	//Draw classes only set tables into this heap
+	ID3D12DescriptorHeap *ppHeaps[] = { descriptorHeap.GetHeap() };
+	commands.SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+}
 
-	cmdAllocator->Reset();
-	cmdList->Reset(cmdAllocator, nullptr);
-	swapchain->Present(VSYNCMode, 0);
+void DirectX12::SetFrameState(RenderCommandList *list)
+{
+	//What ClearDrawScreen bound, for a list that starts in the middle of the frame
+	ID3D12DescriptorHeap *ppHeaps[] = { descriptorHeap.GetHeap() };
+	list->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
+
+	const D3D12_CPU_DESCRIPTOR_HANDLE dsvH = depthStencil->view;
+	list->OMSetRenderTargets(1, &renderTargetView, false, &dsvH);
+	list->RSSetViewports(1, &viewport);
+	list->RSSetScissorRects(1, &scissorrect);
+	list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
 void DirectX12::RestoreResourceBarrierSetting()
 {
 	barrierDesc.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
 	barrierDesc.Transition.StateAfter = D3D12_RESOURCE_STATE_PRESENT;
-	cmdList->ResourceBarrier(1, &barrierDesc);
+	commands.ResourceBarrier(1, &barrierDesc);
 }
 
 void DirectX12::SetScissorrect()
@@ -177,7 +414,7 @@ void DirectX12::SetScissorrect()
 	viewport.MinDepth = .0f;
 	viewport.MaxDepth = 1.f;
 
-	cmdList->RSSetViewports(1, &viewport);
+	commands.RSSetViewports(1, &viewport);
 }
 
 void DirectX12::SetViewport()
@@ -187,8 +424,8 @@ void DirectX12::SetViewport()
 	scissorrect.top = 0L;
 	scissorrect.bottom = scissorrect.top + window_height;
 
-	cmdList->RSSetScissorRects(1, &scissorrect);
-	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	commands.RSSetScissorRects(1, &scissorrect);
+	commands.IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 #pragma endregion
 
@@ -244,11 +481,13 @@ HRESULT DirectX12::D3D12FeatureLv()
 #pragma region Commands
 HRESULT DirectX12::D3D12CreateCommandAllocator()
 {
-	result = dev->CreateCommandAllocator(
-		D3D12_COMMAND_LIST_TYPE_DIRECT,
-		IID_PPV_ARGS(&cmdAllocator)
-	);
-	assert(result == S_OK);
+	for (auto &allocator : cmdAllocators) {
+		result = dev->CreateCommandAllocator(
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			IID_PPV_ARGS(&allocator)
+		);
+		assert(result == S_OK);
+	}
 	return result;
 }
 
@@ -257,7 +496,7 @@ HRESULT DirectX12::D3D12CreateCommandList()
 	result = dev->CreateCommandList(
 		0,
 		D3D12_COMMAND_LIST_TYPE_DIRECT,
-		cmdAllocator,
+		cmdAllocators[framePacer.GetFrameIndex()].Get(),
 		nullptr,
 		IID_PPV_ARGS(&cmdList)
 	);
@@ -265,6 +504,26 @@ HRESULT DirectX12::D3D12CreateCommandList()
 	return result;
 }
 
+void DirectX12::PrepareParallelCmdLists(const uint32_t count)
+{
+	//This frame slot's previous lists finished on the GPU (FramePacer::BeginFrame waited)
+	std::vector<ParallelCmdList> &lists = parallelCmdLists[framePacer.GetFrameIndex()];
+	while (lists.size() < count) {
+		ParallelCmdList added;
+		result = dev->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&added.allocator));
+		assert(result == S_OK);
+		result = dev->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, added.allocator.Get(), nullptr, IID_PPV_ARGS(&added.list));
+		assert(result == S_OK);
+		added.list->Close();
+		lists.push_back(added);
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		lists[i].allocator->Reset();
+		lists[i].list->Reset(lists[i].allocator.Get(), nullptr);
+	}
+}
+
 HRESULT DirectX12::D3D12CreateCommandQueueDescription()
 {
 	result = dev->CreateCommandQueue(&cmdQueueDesc, IID_PPV_ARGS(&cmdQueue));
@@ -281,7 +540,7 @@ void DirectX12::D3D12SetSwapchainDescription()
 	swapchainDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
 	swapchainDesc.SampleDesc.Count = 1;
 	swapchainDesc.BufferUsage = DXGI_USAGE_BACK_BUFFER;
-	swapchainDesc.BufferCount = 2;
+	swapchainDesc.BufferCount = (UINT)backBuffers.size();
 	swapchainDesc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
 	swapchainDesc.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
 
@@ -305,7 +564,7 @@ void DirectX12::D3D12SetDescripterHeap()
 	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
 
 	//Front and Back screen layer
-	heapDesc.NumDescriptors = 2;
+	heapDesc.NumDescriptors = (UINT)backBuffers.size();
 	dev->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&rtvHeaps));
 }
 #pragma endregion
@@ -314,7 +573,7 @@ void DirectX12::D3D12SetDescripterHeap()
 void DirectX12::D3D12SetTargetView()
 {
 	//target view
-	for (auto i = 0; i < 2; ++i) {
+	for (auto i = 0; i < backBuffers.size(); ++i) {
 		result = swapchain->GetBuffer(i, IID_PPV_ARGS(&backBuffers[i]));
 		assert(result == S_OK);
 
@@ -333,11 +592,19 @@ void DirectX12::D3D12SetTargetView()
 }
 #pragma endregion
 
+#pragma region Depth
+void DirectX12::D3D12CreateDepthStencil()
+{
+	//One depth buffer for the whole screen, kept for the lifetime of the device
+	depthStencil = renderTargets.Acquire(window_width, window_height, GetDepthFormat());
+}
+#pragma endregion
+
 #pragma region Fence
 void DirectX12::D3D12CreateFence()
 {
 	//Generate Fence
-	result = dev->CreateFence(fenceVal, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+	result = frameFence.Initialize(dev.Get(), cmdQueue);
 	assert(result == S_OK);
 }
 #pragma endregion
\ No newline at end of file
@@ -1,11 +1,58 @@
 #pragma once
 #include <wrl.h>
+#include "FramePacer.h"
+#include "PipelineCache.h"
+#include "ShaderCache.h"
+#include "UploadRing.h"
+#include "DescriptorHeap.h"
+#include "GpuRenderTargetPool.h"
+#include "TextureStreamer.h"
+#include "GpuProfiler.h"
+#include "RenderCommandList.h"
+#include "RenderCommandListPool.h"
+#include "D3D12RenderBackend.h"
+#include "JobSystem.h"
 
 enum class SelectVSYNC {
 	DisableVSYNC,
 	EnableVSYNC
 };
 
+//Frames the CPU may record ahead of the GPU
+const int maxFrameLatency = 3;
+
+//Per frame constant / instance data for every frame in flight
+const uint64_t uploadRingSize = 8 * 1024 * 1024;
+
+//Shader visible descriptors (textures / per frame tables)
+const uint32_t descriptorHeapSize = 1024;
+const uint32_t transientDescriptorSize = 1024;
+
+//Pooled render / depth targets (back buffers keep their own RTV heap)
+const uint32_t renderTargetViewCount = 16;
+const uint32_t depthStencilViewCount = 8;
+
+//Unreferenced textures kept resident for reuse
+const uint64_t textureCacheBudget = 256 * 1024 * 1024;
+
+//FramePacer fence on a D3D12 command queue
+class D3D12FrameFence : public FrameFence
+{
+public:
+	D3D12FrameFence();
+	~D3D12FrameFence();
+	HRESULT Initialize(ID3D12Device *dev, ID3D12CommandQueue *queue);
+
+	void Signal(const uint64_t value) override;
+	uint64_t GetCompletedValue() override;
+	void WaitForValue(const uint64_t value) override;
+
+private:
+	ID3D12CommandQueue *queue;
+	Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+	HANDLE event;
+};
+
 class DirectX12
 {
 private:
@@ -13,7 +60,7 @@ private:
 
 public: //Public function
 	//Initialize
-	DirectX12(HWND hwnd, const int window_width, const int window_height, SelectVSYNC vsync = SelectVSYNC::EnableVSYNC);
+	DirectX12(HWND hwnd, const int window_width, const int window_height, SelectVSYNC vsync = SelectVSYNC::EnableVSYNC, const int frameLatency = 2);
 	~DirectX12();
 
 	void Initialize_components();
@@ -22,7 +69,56 @@ public: //Public function
 	DirectX::XMFLOAT4 GetColor(const float R, const float G, const float B, const float A);
 
 	ID3D12Device *GetDevice();
-	ID3D12GraphicsCommandList *GetCommandList();
+
+	//Frame commands, replayed into the D3D12 command list by ScreenFlip
+	RenderCommandList *GetCommandList();
+
+	//Redundant state sets the command list dropped in the last flipped frame
+	uint32_t GetSkippedStateCalls() const;
+
+	/// <summary>
+	/// count command lists submitted here, after what GetCommandList recorded so far (draw region only)
+	/// </summary>
+	/// <remarks>
+	/// Record each list on one thread (GetJobSystem) and finish before the next call / ScreenFlip. Every list starts
+	/// with the frame's heaps, render target, viewport, scissor and topology bound; commands recorded
+	/// into GetCommandList afterwards run after these lists.
+	/// </remarks>
+	/// <returns>Index of the first list (GetParallelCommandList)</returns>
+	uint32_t BeginParallelCommandLists(const uint32_t count);
+	RenderCommandList *GetParallelCommandList(const uint32_t index);
+
+	//Worker threads for frame work (parallel recording, command replay)
+	JobSystem *GetJobSystem();
+
+	//Frame pacing
+	int GetFrameIndex() const;
+	int GetFrameCount() const;
+	FramePacer *GetFramePacer();
+	void WaitIdle();
+
+	//Shared root signatures / pipeline states
+	PipelineCache *GetPipelineCache();
+	ShaderCache *GetShaderCache();
+
+	//Frame scoped upload memory (root CBV / SRV data)
+	UploadRing *GetUploadRing();
+
+	//Every CBV / SRV / UAV lives here, the heap is set once per frame
+	DescriptorHeap *GetDescriptorHeap();
+
+	//Screen sized depth buffer shared by every 3D draw, bound in ClearDrawScreen
+	D3D12_CPU_DESCRIPTOR_HANDLE GetDepthStencilView() const;
+	DXGI_FORMAT GetDepthFormat() const;
+
+	//Offscreen targets shared by size / format
+	GpuRenderTargetPool *GetRenderTargetPool();
+
+	//Background texture decode / copy queue upload
+	TextureStreamer *GetTextureStreamer();
+
+	//Timestamp regions on the frame command list (GPU_PROFILE_SCOPE)
+	GpuProfiler *GetGpuProfiler();
 
 	//Draw function
 	void ClearDrawScreen(const DirectX::XMFLOAT4 color);
@@ -31,6 +127,8 @@ public: //Public function
 private:
 	ComPtr<ID3D12Device> dev;
 	ComPtr<ID3D12GraphicsCommandList> cmdList;
+	RenderCommandList commands;
+	D3D12RenderBackend renderBackend;
 	//ID3D12DescriptorHeap *dsvHeap;
 
 private:
@@ -50,13 +148,21 @@ private:
 	//Heap
 	void D3D12SetDescripterHeap();
 
+	//Depth
+	void D3D12CreateDepthStencil();
+
 	//Target veiw
 	void D3D12SetTargetView();
 
 	//Fence
 	void D3D12CreateFence();
 
+	//Parallel command lists
+	void PrepareParallelCmdLists(const uint32_t count);
+
 	//Draw
+	void SetFrameDescriptorHeaps();
+	void SetFrameState(RenderCommandList *list);
 	void RestoreResourceBarrierSetting();
 	void SetScissorrect();
 	void SetViewport();
@@ -80,11 +186,23 @@ private:
 		D3D_FEATURE_LEVEL_11_0
 	};
 
-	//Commands
-	ID3D12CommandAllocator *cmdAllocator;
+	//Commands (one allocator per frame in flight)
+	std::vector<ComPtr<ID3D12CommandAllocator>> cmdAllocators;
 	ID3D12CommandQueue *cmdQueue;
 	D3D12_COMMAND_QUEUE_DESC cmdQueueDesc;
 
+	//Submitted ranges after the first one, each with its own allocator (per frame in flight)
+	struct ParallelCmdList
+	{
+		ComPtr<ID3D12CommandAllocator> allocator;
+		ComPtr<ID3D12GraphicsCommandList> list;
+	};
+	std::vector<std::vector<ParallelCmdList>> parallelCmdLists;
+	RenderCommandListPool parallelCommands;
+	std::vector<RenderSubmission> submission;
+	std::vector<ID3D12CommandList *> submitLists;
+	JobSystem jobs;
+
 	//Swapchain
 	DXGI_SWAP_CHAIN_DESC1 swapchainDesc;
 	IDXGISwapChain4 *swapchain;
@@ -94,15 +212,34 @@ private:
 	D3D12_DESCRIPTOR_HEAP_DESC heapDesc;
 
 	//Target view
-	std::vector<ComPtr<ID3D12Resource>> backBuffers = std::vector<ComPtr<ID3D12Resource>>(2);
+	std::vector<ComPtr<ID3D12Resource>> backBuffers;
 
 	//Fence
-	ID3D12Fence *fence;
-	UINT64 fenceVal;
+	D3D12FrameFence frameFence;
+	FramePacer framePacer;
+
+	//Pipeline
+	PipelineCache pipelineCache;
+	ShaderCache shaderCache;
+	UploadRing uploadRing;
+	DescriptorHeap descriptorHeap;
+	TextureStreamer textureStreamer;
+	GpuProfiler gpuProfiler;
+
+	//Render targets
+	GpuRenderTargetPool renderTargets;
+	GpuRenderTarget *depthStencil;
 
 	//Draw
 	D3D12_RESOURCE_BARRIER barrierDesc;
+	D3D12_CPU_DESCRIPTOR_HANDLE renderTargetView;	//Back buffer of the frame (SetFrameState)
 	D3D12_VIEWPORT viewport;
 	D3D12_RECT scissorrect;
+
+	//GPU time of the whole frame, ClearDrawScreen to ScreenFlip
+	uint32_t frameRegion;
+
+	//RenderCommandList::GetSkippedCount of the last frame
+	uint32_t skippedStateCalls;
 };
 
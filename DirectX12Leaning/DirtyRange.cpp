@@ -0,0 +1,58 @@
+//STL
+#include <algorithm>
+
+//this
+#include "DirtyRange.h"
+
+DirtyRange::DirtyRange() :
+	begin(0),
+	end(0),
+	uploadCount(0)
+{
+}
+
+void DirtyRange::Mark(const uint64_t offset, const uint64_t size)
+{
+	if (size == 0) {
+		return;
+	}
+
+	if (!IsDirty()) {
+		begin = offset;
+		end = offset + size;
+		return;
+	}
+
+	//Merge, anything in between is uploaded too
+	begin = std::min(begin, offset);
+	end = std::max(end, offset + size);
+}
+
+void DirtyRange::Clear()
+{
+	if (IsDirty()) {
+		++uploadCount;
+	}
+	begin = 0;
+	end = 0;
+}
+
+bool DirtyRange::IsDirty() const
+{
+	return end > begin;
+}
+
+uint64_t DirtyRange::GetOffset() const
+{
+	return begin;
+}
+
+uint64_t DirtyRange::GetSize() const
+{
+	return end - begin;
+}
+
+uint64_t DirtyRange::GetUploadCount() const
+{
+	return uploadCount;
+}
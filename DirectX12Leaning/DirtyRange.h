@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// Byte span of a CPU copy that changed since the last upload (single merged range)
+/// </summary>
+class DirtyRange
+{
+public:
+	DirtyRange();
+
+	void Mark(const uint64_t offset, const uint64_t size);
+	void Clear();
+
+	bool IsDirty() const;
+	uint64_t GetOffset() const;
+	uint64_t GetSize() const;
+
+	//Times Clear was called on a dirty range (uploads done)
+	uint64_t GetUploadCount() const;
+
+private:
+	uint64_t begin;
+	uint64_t end;
+	uint64_t uploadCount;
+};
@@ -1,5 +1,6 @@
 //API
 #include <d3d12.h>
+#include <d3dx12.h>
 #include <DirectXMath.h>
 
 //shader(HLSL)
@@ -9,37 +10,35 @@
 //STL
 #include <iostream>
 #include <vector>
+#include <assert.h>
 
 //Utility
 #include "tempUtility.h"
+#include "DirectX12.h"
 
 //this
 #include "Draw2D.h"
 
-Draw2D::Draw2D(const unsigned int shapeSize, const float radius, const int fillMode, ID3D12Device *dev, ID3D12GraphicsCommandList *cmdList, const int window_width, const int window_height) :
+Draw2D::Draw2D(const unsigned int shapeSize, const float radius, const int fillMode, DirectX12 *dx12, const int window_width, const int window_height) :
 	shapeSize(shapeSize),
 	radius(radius),
-	dev(dev),
-	cmdList(cmdList),
+	dx12(dx12),
 	window_width(window_width),
 	window_height(window_height)
 {
+	dev = dx12->GetDevice();
+	cmdList = dx12->GetCommandList();
+
 	SetVertices();
-	SetHeapProperty();
-	SetResourceDescription();
 	CreateVertexBuffer();
-	GetVertexMapVirtualMemory();
+	UploadVertices();
 	SetVertexBufferView();
 	SetIndices();
 	SetIndexBuffer();
-	GetIndexMapVirtualMemory();
+	UploadIndices();
 	SetIndexBufferView();
 	SetShader();
-	SetConstantBufferHeapProperty();
-	SetConstantBufferResourceDescription();
-	SetDescripterHeap();
-	CreateConstantBuffer();
-	
+
 	//Top layout
 	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
 		{
@@ -62,6 +61,11 @@ Draw2D::Draw2D(const unsigned int shapeSize, const float radius, const int fillM
 	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
 	gpipeline.NumRenderTargets = 1;
 	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	//Depth buffer is bound but 2D neither tests nor writes it
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthEnable = false;
+	gpipeline.DSVFormat = dx12->GetDepthFormat();
 	gpipeline.SampleDesc.Count = 1;
 
 	SetRootParameter();
@@ -71,32 +75,31 @@ Draw2D::Draw2D(const unsigned int shapeSize, const float radius, const int fillM
 
 void Draw2D::execute(const DirectX::XMFLOAT4 color)
 {
-	//Get VirtualMemory
-	DirectX::XMFLOAT3 *vertMap = nullptr;
-	result = verBuff->Map(0, nullptr, (void **)&vertMap);
-	assert(result == S_OK);
-
-	//Update point
-	std::copy(vertices.begin(), vertices.end(), vertMap);
-	verBuff->Unmap(0, nullptr);
-
-	//Initialize const buffer
-	ConstBufferData *constMap = nullptr;
-	result = constBuff->Map(0, nullptr, (void **)&constMap);
-	constMap->color = color;
-	constBuff->Unmap(0, nullptr);
-	assert(result == S_OK);
+	PROFILE_SCOPE("Draw2D::execute");
+	GPU_PROFILE_SCOPE(dx12->GetGpuProfiler(), cmdList, "Draw2D::execute");
+
+	//Copy only when the mesh was changed, upload ring full: skip the draw
+	UploadVertices();
+	if (vertexDirty.IsDirty()) {
+		return;
+	}
+
+	ConstBufferData constData;
+	constData.color = color;
+
+	//Constant buffer (frame ring), no room: skip the draw
+	const D3D12_GPU_VIRTUAL_ADDRESS constants = dx12->GetUploadRing()->Push(constData);
+	if (constants == 0) {
+		return;
+	}
 
 	//pipeline
 	cmdList->SetPipelineState(pipelinestate);
 	cmdList->SetGraphicsRootSignature(rootsignature);
 
-	//Set Descriptor heap
-	ID3D12DescriptorHeap *ppHeaps[] = { basicDescHeap };
-	cmdList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
-
-	//Set constant buffer view
-	cmdList->SetGraphicsRootDescriptorTable(0, basicDescHeap->GetGPUDescriptorHandleForHeapStart());
+	//Set constant buffer
+	cmdList->SetGraphicsRootConstantBufferView(0, constants);
+	cmdList->Upload(sizeof(constData));
 
 	cmdList->IASetVertexBuffers(0, 1, &vbView);
 	cmdList->IASetIndexBuffer(&ibView);
@@ -117,50 +120,18 @@ void Draw2D::SetVertices()
 	sizeVB = static_cast<UINT>(sizeof(DirectX::XMFLOAT3) * vertices.size());
 }
 
-void Draw2D::SetHeapProperty()
-{
-	//Set vertex buffer
-	heapprop = {};
-	heapprop.Type = D3D12_HEAP_TYPE_UPLOAD;	//Transfer to GPU
-	heapprop.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-	heapprop.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-}
-
-void Draw2D::SetResourceDescription()
-{
-	//Resource setting
-	resdesc = {};
-	resdesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	resdesc.Width = sizeVB;
-	resdesc.Height = 1;
-	resdesc.DepthOrArraySize = 1;
-	resdesc.MipLevels = 1;
-	resdesc.Format = DXGI_FORMAT_UNKNOWN;
-	resdesc.SampleDesc.Count = 1;
-	resdesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-	resdesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-}
-
 void Draw2D::CreateVertexBuffer()
 {
-	//Create top buffer
-	verBuff = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&heapprop,
-		D3D12_HEAP_FLAG_NONE,
-		&resdesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&verBuff)
-	);
-	assert(result == S_OK);
+	//Create top buffer (GPU local, written by copy)
+	vertexBuffer.Create(dx12, sizeVB, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+	vertexDirty.Mark(0, sizeVB);
 }
 
 void Draw2D::SetVertexBufferView()
 {
 	//Create vertex buffer view
 	vbView = {};
-	vbView.BufferLocation = verBuff->GetGPUVirtualAddress();
+	vbView.BufferLocation = vertexBuffer.GetGPUVirtualAddress();
 	vbView.SizeInBytes = sizeof(DirectX::XMFLOAT3) * vertices.size();
 	vbView.StrideInBytes = sizeof(DirectX::XMFLOAT3);
 }
@@ -181,132 +152,43 @@ void Draw2D::SetIndices()
 void Draw2D::SetIndexBuffer()
 {
 	//Add index buffer
-	indexBuff = nullptr;
-	resdesc.Width = sizeof(unsigned short) * indices.size();
-	result = this->dev->CreateCommittedResource(
-		&heapprop,
-		D3D12_HEAP_FLAG_NONE,
-		&resdesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&indexBuff)
-	);
-	assert(result == S_OK);
+	indexBuffer.Create(dx12, sizeof(unsigned short) * indices.size(), D3D12_RESOURCE_STATE_INDEX_BUFFER);
 }
 
-void Draw2D::GetIndexMapVirtualMemory()
+void Draw2D::UploadIndices()
 {
-	//Get virtual memory
-	indexMap = nullptr;
-	result = indexBuff->Map(0, nullptr, (void **)&indexMap);
-	assert(result == S_OK);
-	for (int i = 0; i < indices.size(); ++i) {
-		indexMap[i] = indices[i];
-	}
-	indexBuff->Unmap(0, nullptr);
+	//Indices never change after SetIndices
+	const bool uploaded = indexBuffer.Upload(indices.data(), 0, sizeof(unsigned short) * indices.size());
+	assert(uploaded);
 }
 
-void Draw2D::GetVertexMapVirtualMemory()
+void Draw2D::UploadVertices()
 {
-	//Get VirtualMemory
-	vertMap = nullptr;
-	result = verBuff->Map(0, nullptr, (void **)&vertMap);
-	assert(result == S_OK);
-
-	std::copy(vertices.begin(), vertices.end(), vertMap);
-	for (auto i = 0; i < vertices.size(); ++i) {
-		vertMap[i] = vertices[i];
+	if (!vertexDirty.IsDirty()) {
+		return;
+	}
+
+	//Kept dirty when the upload ring is full, retried next draw
+	const uint8_t *source = reinterpret_cast<const uint8_t *>(vertices.data());
+	if (vertexBuffer.Upload(source + vertexDirty.GetOffset(), vertexDirty.GetOffset(), vertexDirty.GetSize())) {
+		vertexDirty.Clear();
 	}
-	verBuff->Unmap(0, nullptr);
 }
 
 void Draw2D::SetIndexBufferView()
 {
 	//Create index buffer view
 	ibView = {};
-	ibView.BufferLocation = indexBuff->GetGPUVirtualAddress();
+	ibView.BufferLocation = indexBuffer.GetGPUVirtualAddress();
 	ibView.Format = DXGI_FORMAT_R16_UINT;
 	ibView.SizeInBytes = sizeof(unsigned short) * indices.size();
 }
 
 void Draw2D::SetShader()
 {
-	//shader
-	vsBlob = nullptr;
-	psBlob = nullptr;
-	errorBlob = nullptr;
-
-	result = D3DCompileFromFile(
-		L"Shaders/BasicVS.hlsl",
-		nullptr,
-		D3D_COMPILE_STANDARD_FILE_INCLUDE,
-		"main", "vs_5_0",
-		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-		0,
-		&vsBlob, &errorBlob
-	);
-	assert(result == S_OK);
-
-	result = D3DCompileFromFile(
-		L"Shaders/BasicPS.hlsl",
-		nullptr,
-		D3D_COMPILE_STANDARD_FILE_INCLUDE,
-		"main", "ps_5_0",
-		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-		0,
-		&psBlob, &errorBlob
-	);
-	assert(result == S_OK);
-}
-
-void Draw2D::SetConstantBufferHeapProperty()
-{
-	//Heap
-	cbheapprop.Type = D3D12_HEAP_TYPE_UPLOAD;
-}
-
-void Draw2D::SetConstantBufferResourceDescription()
-{
-	//Resources
-	cbresdesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	cbresdesc.Width = (sizeof(ConstBufferData) + 0xff) & ~0xff;
-	cbresdesc.Height = 1;
-	cbresdesc.DepthOrArraySize = 1;
-	cbresdesc.MipLevels = 1;
-	cbresdesc.SampleDesc.Count = 1;
-	cbresdesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-	//Create
-	constBuff = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&cbheapprop,
-		D3D12_HEAP_FLAG_NONE,
-		&cbresdesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&constBuff)
-	);
-	assert(result == S_OK);
-}
-
-void Draw2D::SetDescripterHeap()
-{
-	//Descripter heap
-	basicDescHeap = nullptr;
-	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	descHeapDesc.NumDescriptors = 1;
-
-	result = this->dev->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&basicDescHeap));
-	assert(result == S_OK);
-}
-
-void Draw2D::CreateConstantBuffer()
-{
-	//Create const buffer
-	cbvDesc.BufferLocation = constBuff->GetGPUVirtualAddress();
-	cbvDesc.SizeInBytes = (UINT)constBuff->GetDesc().Width;
-	this->dev->CreateConstantBufferView(&cbvDesc, basicDescHeap->GetCPUDescriptorHandleForHeapStart());
+	//Compiled once, shared through the cache
+	vsBlob = dx12->GetShaderCache()->Get(L"Shaders/BasicVS.hlsl", "main", "vs_5_0");
+	psBlob = dx12->GetShaderCache()->Get(L"Shaders/BasicPS.hlsl", "main", "ps_5_0");
 }
 
 void Draw2D::SetGraphicsPipeLine(const int fillMode)
@@ -346,16 +228,11 @@ void Draw2D::SetRenderTargetBlendDescription()
 
 void Draw2D::SetRootParameter()
 {
-	//root parameter
-	descTblrange.NumDescriptors = 1;
-	descTblrange.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-	descTblrange.BaseShaderRegister = 0;
-	descTblrange.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-	//setting root parameter
-	rootparam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-	rootparam.DescriptorTable.pDescriptorRanges = &descTblrange;
-	rootparam.DescriptorTable.NumDescriptorRanges = 1;
+	//setting root parameter (root CBV b0)
+	rootparam = {};
+	rootparam.ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootparam.Descriptor.ShaderRegister = 0;
+	rootparam.Descriptor.RegisterSpace = 0;
 	rootparam.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 }
 
@@ -367,14 +244,8 @@ void Draw2D::SetRootSignature()
 	rootSignatureDesc.pParameters = &rootparam;
 	rootSignatureDesc.NumParameters = 1;
 
-	rootSigBlob = nullptr;
-	result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
-	assert(result == S_OK);
-
-	result = this->dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(&rootsignature));
-	assert(result == S_OK);
-
-	rootSigBlob->Release();
+	//Shared with every object using the same layout
+	rootsignature = dx12->GetPipelineCache()->GetRootSignature(rootSignatureDesc);
 }
 
 void Draw2D::SetSignature()
@@ -382,7 +253,5 @@ void Draw2D::SetSignature()
 	//set signature
 	gpipeline.pRootSignature = rootsignature;
 
-	pipelinestate = nullptr;
-	result = this->dev->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelinestate));
-	assert(result == S_OK);
+	pipelinestate = dx12->GetPipelineCache()->GetPipelineState(gpipeline);
 }
@@ -1,4 +1,8 @@
 #pragma once
+#include "GpuBuffer.h"
+#include "DirtyRange.h"
+
+class DirectX12;
 
 class Draw2D
 {
@@ -7,26 +11,20 @@ private:
 	int window_height;
 
 public:
-	Draw2D(const unsigned int shapeSize, const float radius, const int fillMode, ID3D12Device *dev, ID3D12GraphicsCommandList *cmdList, const int window_width, const int window_height);
+	Draw2D(const unsigned int shapeSize, const float radius, const int fillMode, DirectX12 *dx12, const int window_width, const int window_height);
 	void execute(const DirectX::XMFLOAT4 color);
 	void SetPos(const DirectX::XMFLOAT3 pos);
 
 private:
 	void SetVertices();
-	void SetHeapProperty();
-	void SetResourceDescription();
 	void CreateVertexBuffer();
-	void GetVertexMapVirtualMemory();
+	void UploadVertices();
 	void SetVertexBufferView();
 	void SetIndices();
 	void SetIndexBuffer();
-	void GetIndexMapVirtualMemory();
+	void UploadIndices();
 	void SetIndexBufferView();
 	void SetShader();
-	void SetConstantBufferHeapProperty();
-	void SetConstantBufferResourceDescription();
-	void SetDescripterHeap();
-	void CreateConstantBuffer();
 	void SetGraphicsPipeLine(const int fillMode);
 	void SetRenderTargetBlendDescription();
 	void SetRootParameter();
@@ -43,35 +41,27 @@ private:
 	UINT sizeVB;
 	HRESULT result;
 
+	DirectX12 *dx12;
 	ID3D12Device *dev;
-	ID3D12GraphicsCommandList *cmdList;
+	RenderCommandList *cmdList;
 
 private:
-	D3D12_HEAP_PROPERTIES heapprop;
-	D3D12_RESOURCE_DESC resdesc;
-	ID3D12Resource *verBuff;
-	DirectX::XMFLOAT3 *vertMap;
+	//Mesh lives in DEFAULT heap, vertices are re-uploaded only while dirty
+	GpuBuffer vertexBuffer;
+	DirtyRange vertexDirty;
 	D3D12_VERTEX_BUFFER_VIEW vbView;
-	ID3D12Resource *indexBuff;
-	unsigned short *indexMap;
+	GpuBuffer indexBuffer;
 	D3D12_INDEX_BUFFER_VIEW ibView;
 
 	ID3DBlob *vsBlob;
 	ID3DBlob *psBlob;
 	ID3DBlob *errorBlob;
 
-	D3D12_HEAP_PROPERTIES cbheapprop;
-	D3D12_RESOURCE_DESC cbresdesc;
-	ID3D12Resource *constBuff;
-	ID3D12DescriptorHeap *basicDescHeap;
-	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc;
-	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
 
-	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline;
-	D3D12_DESCRIPTOR_RANGE descTblrange;
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
 	D3D12_ROOT_PARAMETER rootparam;
 	ID3D12RootSignature *rootsignature;
-	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{};
 	ID3DBlob *rootSigBlob;
 	ID3D12PipelineState *pipelinestate;
 };
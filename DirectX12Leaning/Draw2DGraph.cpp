@@ -1,5 +1,6 @@
 //API
 #include <d3d12.h>
+#include <d3dx12.h>
 #include <DirectXMath.h>
 
 //shader(HLSL)
@@ -12,17 +13,25 @@
 
 //Utility
 #include "tempUtility.h"
+#include "DirectX12.h"
 
 //this
 #include "Draw2DGraph.h"
 
-Draw2DGraph::Draw2DGraph() {}
-Draw2DGraph::Draw2DGraph(const wchar_t *fileName, const int fillMode, ID3D12Device *dev, ID3D12GraphicsCommandList *cmdList, const int window_width, const int window_height) :
-	dev(dev),
-	cmdList(cmdList),
+Draw2DGraph::Draw2DGraph()
+{
+	dx12 = nullptr;
+	texture = invalidTextureHandle;
+}
+
+Draw2DGraph::Draw2DGraph(const wchar_t *fileName, const int fillMode, DirectX12 *dx12, const int window_width, const int window_height) :
+	dx12(dx12),
 	window_width(window_width),
 	window_height(window_height)
 {
+	dev = dx12->GetDevice();
+	cmdList = dx12->GetCommandList();
+
 	matrix = DirectX::XMMatrixIdentity();
 	matProjection = DirectX::XMMatrixOrthographicOffCenterLH(0.0f, (float)window_width, (float)window_height, 0.0f, 0.0f, 1.0f);
 
@@ -37,10 +46,6 @@ Draw2DGraph::Draw2DGraph(const wchar_t *fileName, const int fillMode, ID3D12Devi
 	GetIndexMapVirtualMemory();
 	SetIndexBufferView();
 	SetShader();
-	SetConstantBufferHeapProperty();
-	SetConstantBufferResourceDescription();
-	SetDescripterHeap();
-	CreateConstantBuffer();
 	CreateTextureData(fileName);
 
 	//Top layout
@@ -58,6 +63,11 @@ Draw2DGraph::Draw2DGraph(const wchar_t *fileName, const int fillMode, ID3D12Devi
 	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
 	gpipeline.NumRenderTargets = 1;
 	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	//Depth buffer is bound but 2D neither tests nor writes it
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthEnable = false;
+	gpipeline.DSVFormat = dx12->GetDepthFormat();
 	gpipeline.SampleDesc.Count = 1;
 
 	SetRootParameter();
@@ -65,6 +75,14 @@ Draw2DGraph::Draw2DGraph(const wchar_t *fileName, const int fillMode, ID3D12Devi
 	SetSignature();
 }
 
+Draw2DGraph::~Draw2DGraph()
+{
+	//Texture stays cached until the budget needs the memory
+	if (dx12 != nullptr) {
+		dx12->GetTextureStreamer()->Release(texture);
+	}
+}
+
 void Draw2DGraph::Update(float x, float y, float rotate)
 {
 	matrix = DirectX::XMMatrixIdentity();
@@ -96,28 +114,18 @@ void Draw2DGraph::execute(const DirectX::XMFLOAT4 color, const float adjustXPos,
 	std::copy(vertices.begin(), vertices.end(), vertMap);
 	verBuff->Unmap(0, nullptr);
 
-	//Initialize const buffer
-	ConstBufferData3D *constMap = nullptr;
-	result = constBuff->Map(0, nullptr, (void **)&constMap);
-	constMap->color = color;
-	constMap->mat = matrix;
-	constBuff->Unmap(0, nullptr);
-	assert(result == S_OK);
+	ConstBufferData3D constData;
+	constData.color = color;
+	constData.mat = matrix;
 
 	//pipeline
 	cmdList->SetPipelineState(pipelinestate);
 	cmdList->SetGraphicsRootSignature(rootsignature);
 
-	//Set Descriptor heap
-	ID3D12DescriptorHeap *ppHeaps[] = { basicDescHeap };
-	cmdList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
-
-	//Set constant buffer view
-	//Set constant buffer view
-	D3D12_GPU_DESCRIPTOR_HANDLE gpuDescHandle = basicDescHeap->GetGPUDescriptorHandleForHeapStart();
-	cmdList->SetGraphicsRootDescriptorTable(0, gpuDescHandle);
-	gpuDescHandle.ptr += this->dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	cmdList->SetGraphicsRootDescriptorTable(1, gpuDescHandle);
+	//Constant buffer (frame ring), texture
+	cmdList->SetGraphicsRootConstantBufferView(0, dx12->GetUploadRing()->Push(constData));
+	cmdList->Upload(sizeof(constData) + sizeof(vertices[0]) * vertices.size());
+	cmdList->SetGraphicsRootDescriptorTable(1, dx12->GetTextureStreamer()->GetGpuHandle(texture));
 
 	cmdList->IASetVertexBuffers(0, 1, &vbView);
 	cmdList->IASetIndexBuffer(&ibView);
@@ -243,135 +251,15 @@ void Draw2DGraph::SetIndexBufferView()
 
 void Draw2DGraph::SetShader()
 {
-	//shader
-	vsBlob = nullptr;
-	psBlob = nullptr;
-	errorBlob = nullptr;
-
-	result = D3DCompileFromFile(
-		L"Shaders/Graph2DVS.hlsl",
-		nullptr,
-		D3D_COMPILE_STANDARD_FILE_INCLUDE,
-		"main", "vs_5_0",
-		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-		0,
-		&vsBlob, &errorBlob
-	);
-	assert(result == S_OK);
-
-	result = D3DCompileFromFile(
-		L"Shaders/Graph2DPS.hlsl",
-		nullptr,
-		D3D_COMPILE_STANDARD_FILE_INCLUDE,
-		"main", "ps_5_0",
-		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-		0,
-		&psBlob, &errorBlob
-	);
-	assert(result == S_OK);
-}
-
-void Draw2DGraph::SetConstantBufferHeapProperty()
-{
-	//Heap
-	cbheapprop.Type = D3D12_HEAP_TYPE_UPLOAD;
-}
-
-void Draw2DGraph::SetConstantBufferResourceDescription()
-{
-	//Resources
-	cbresdesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	cbresdesc.Width = (sizeof(ConstBufferData3D) + 0xff) & ~0xff;
-	cbresdesc.Height = 1;
-	cbresdesc.DepthOrArraySize = 1;
-	cbresdesc.MipLevels = 1;
-	cbresdesc.SampleDesc.Count = 1;
-	cbresdesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-	//Create
-	constBuff = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&cbheapprop,
-		D3D12_HEAP_FLAG_NONE,
-		&cbresdesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&constBuff)
-	);
-	assert(result == S_OK);
-}
-
-void Draw2DGraph::SetDescripterHeap()
-{
-	//Descripter heap
-	basicDescHeap = nullptr;
-	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	descHeapDesc.NumDescriptors = 1;
-
-	result = this->dev->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&basicDescHeap));
-	assert(result == S_OK);
-
-	basicHeapHandle = basicDescHeap->GetCPUDescriptorHandleForHeapStart();
-}
-
-void Draw2DGraph::CreateConstantBuffer()
-{
-	//Create const buffer
-	cbvDesc.BufferLocation = constBuff->GetGPUVirtualAddress();
-	cbvDesc.SizeInBytes = (UINT)constBuff->GetDesc().Width;
-	this->dev->CreateConstantBufferView(&cbvDesc, basicHeapHandle);
+	//Compiled once, shared through the cache
+	vsBlob = dx12->GetShaderCache()->Get(L"Shaders/Graph2DVS.hlsl", "main", "vs_5_0");
+	psBlob = dx12->GetShaderCache()->Get(L"Shaders/Graph2DPS.hlsl", "main", "ps_5_0");
 }
 
 void Draw2DGraph::CreateTextureData(const wchar_t *fileName)
 {
-	result = LoadFromWICFile(
-		fileName,
-		DirectX::WIC_FLAGS_NONE,
-		&metadata, scratchImg
-	);
-	assert(result == S_OK);
-
-	const DirectX::Image *img = scratchImg.GetImage(0, 0, 0);
-
-	texHeapProp.Type = D3D12_HEAP_TYPE_CUSTOM;
-	texHeapProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
-	texHeapProp.MemoryPoolPreference = D3D12_MEMORY_POOL_L0;
-
-	texresDesc.Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(metadata.dimension);
-	texresDesc.Format = metadata.format;
-	texresDesc.Width = metadata.width;
-	texresDesc.Height = (UINT)metadata.height;
-	texresDesc.DepthOrArraySize = (UINT16)metadata.arraySize;
-	texresDesc.MipLevels = (UINT16)metadata.mipLevels;
-	texresDesc.SampleDesc.Count = 1;
-
-	texbuff = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&texHeapProp,
-		D3D12_HEAP_FLAG_NONE,
-		&texresDesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&texbuff)
-	);
-
-	result = texbuff->WriteToSubresource(
-		0,
-		nullptr,
-		img->pixels,
-		(UINT)img->rowPitch,
-		(UINT)img->slicePitch
-	);
-
-	basicHeapHandle.ptr += this->dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	srvDesc.Format = metadata.format;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = 1;
-
-	this->dev->CreateShaderResourceView(texbuff, &srvDesc, basicHeapHandle);
+	//Decoded in the background, drawn with a placeholder until uploaded
+	texture = dx12->GetTextureStreamer()->Load(fileName);
 }
 
 void Draw2DGraph::SetGraphicsPipeLine(const int fillMode)
@@ -424,12 +312,6 @@ void Draw2DGraph::SetRootParameter()
 	//rootparam.ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
 	//root parameter
-	D3D12_DESCRIPTOR_RANGE descRangeCBV{};
-	descRangeCBV.NumDescriptors = 1;
-	descRangeCBV.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-	descRangeCBV.BaseShaderRegister = 0;
-	descRangeCBV.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
 	D3D12_DESCRIPTOR_RANGE descRangeSRV{};
 	descRangeSRV.NumDescriptors = 1;
 	descRangeSRV.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_SRV;
@@ -438,9 +320,9 @@ void Draw2DGraph::SetRootParameter()
 
 	//setting root parameter
 	D3D12_ROOT_PARAMETER rootparam[2] = {};
-	rootparam[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-	rootparam[0].DescriptorTable.pDescriptorRanges = &descRangeCBV;
-	rootparam[0].DescriptorTable.NumDescriptorRanges = 1;
+	rootparam[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+	rootparam[0].Descriptor.ShaderRegister = 0;
+	rootparam[0].Descriptor.RegisterSpace = 0;
 	rootparam[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
 
 	rootparam[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
@@ -467,14 +349,8 @@ void Draw2DGraph::SetRootParameter()
 	rootSignatureDesc.pStaticSamplers = &sampleDesc;
 	rootSignatureDesc.NumStaticSamplers = 1;
 
-	rootSigBlob = nullptr;
-	result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
-	assert(result == S_OK);
-
-	result = this->dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(&rootsignature));
-	assert(result == S_OK);
-
-	rootSigBlob->Release();
+	//Shared with every object using the same layout
+	rootsignature = dx12->GetPipelineCache()->GetRootSignature(rootSignatureDesc);
 }
 
 void Draw2DGraph::SetRootSignature()
@@ -500,7 +376,5 @@ void Draw2DGraph::SetSignature()
 	//set signature
 	gpipeline.pRootSignature = rootsignature;
 
-	pipelinestate = nullptr;
-	result = this->dev->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelinestate));
-	assert(result == S_OK);
+	pipelinestate = dx12->GetPipelineCache()->GetPipelineState(gpipeline);
 }
\ No newline at end of file
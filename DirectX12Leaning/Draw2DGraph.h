@@ -1,5 +1,9 @@
 #pragma once
 #include <DirectXTex.h>
+#include "TextureLoader.h"
+
+class DirectX12;
+
 class Draw2DGraph
 {
 private:
@@ -8,7 +12,8 @@ private:
 
 public:
 	Draw2DGraph();
-	Draw2DGraph(const wchar_t *fileName, const int fillMode, ID3D12Device *dev, ID3D12GraphicsCommandList *cmdList, const int window_width, const int window_height);
+	Draw2DGraph(const wchar_t *fileName, const int fillMode, DirectX12 *dx12, const int window_width, const int window_height);
+	~Draw2DGraph();
 	void Update(float x, float y, float rotate);
 	void execute(const DirectX::XMFLOAT4 color);
 	void execute(const DirectX::XMFLOAT4 color, const float adjustXPos = 0, const float adjustYPos = 0);
@@ -25,10 +30,6 @@ private:
 	void GetIndexMapVirtualMemory();
 	void SetIndexBufferView();
 	void SetShader();
-	void SetConstantBufferHeapProperty();
-	void SetConstantBufferResourceDescription();
-	void SetDescripterHeap();
-	void CreateConstantBuffer();
 	void CreateTextureData(const wchar_t *fileName);
 	void SetGraphicsPipeLine(const int fillMode);
 	void SetRenderTargetBlendDescription();
@@ -43,8 +44,9 @@ private:
 	UINT sizeVB;
 	HRESULT result;
 
+	DirectX12 *dx12;
 	ID3D12Device *dev;
-	ID3D12GraphicsCommandList *cmdList;
+	RenderCommandList *cmdList;
 
 private:
 	DirectX::XMMATRIX matProjection;
@@ -63,26 +65,13 @@ private:
 	ID3DBlob *psBlob;
 	ID3DBlob *errorBlob;
 
-	DirectX::TexMetadata metadata;
-	DirectX::ScratchImage scratchImg;
-	D3D12_HEAP_PROPERTIES texHeapProp;
-	D3D12_RESOURCE_DESC texresDesc;
-	ID3D12Resource *texbuff;
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
-
-	D3D12_HEAP_PROPERTIES cbheapprop;
-	D3D12_RESOURCE_DESC cbresdesc;
-	ID3D12Resource *constBuff;
-	ID3D12DescriptorHeap *basicDescHeap;
-	D3D12_CPU_DESCRIPTOR_HANDLE basicHeapHandle;
-	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc;
-	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
+	//Streamed, placeholder until uploaded
+	TextureHandle texture;
 
-	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline;
-	D3D12_DESCRIPTOR_RANGE descRangeCBV;
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
 	D3D12_ROOT_PARAMETER rootparam;
 	ID3D12RootSignature *rootsignature;
-	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{};
 	ID3DBlob *rootSigBlob;
 	ID3D12PipelineState *pipelinestate;
 };
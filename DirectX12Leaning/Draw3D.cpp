@@ -9,35 +9,39 @@
 //STL
 #include <iostream>
 #include <vector>
+#include <algorithm>
 
 //Utility
 #include "tempUtility.h"
+#include "DirectX12.h"
 #include "DrawUtility.h"
 #include "Draw3D.h"
 
-Draw3D::Draw3D() {}
-Draw3D::Draw3D(const wchar_t *fileName, DrawShapeData shapeData, const float radius, const int fillMode, ID3D12Device *dev, ID3D12GraphicsCommandList *cmdList, const int window_width, const int window_height) :
+Draw3D::Draw3D()
+{
+	dx12 = nullptr;
+	texture = invalidTextureHandle;
+}
+
+Draw3D::Draw3D(const wchar_t *fileName, DrawShapeData shapeData, const float radius, const int fillMode, DirectX12 *dx12, const int window_width, const int window_height, const uint32_t instanceCapacity) :
 	radius(radius),
-	dev(dev),
-	cmdList(cmdList),
-	dsvHeap(dsvHeap),
+	dx12(dx12),
 	window_width(window_width),
-	window_height(window_height)
+	window_height(window_height),
+	instanceCapacity(instanceCapacity)
 {
+	dev = dx12->GetDevice();
+	cmdList = dx12->GetCommandList();
+
 	SetShape(shapeData);
 	SetHeapProperty();
 	SetResourceDescription();
 	CreateVertexBuffer();
-	GetVertexMapVirtualMemory();
 	SetVertexBufferView();
 	SetIndexBuffer();
-	GetIndexMapVirtualMemory();
+	UploadIndices();
 	SetIndexBufferView();
 	SetShader();
-	SetConstantBufferHeapProperty();
-	SetConstantBufferResourceDescription();
-	SetDescripterHeap();
-	CreateConstantBuffer();
 	CreateTextureData(fileName);
 
 	//Top layout
@@ -49,9 +53,9 @@ Draw3D::Draw3D(const wchar_t *fileName, DrawShapeData shapeData, const float rad
 
 	CreateWorldMatrix();
 	CreateViewMatrix();
-	MappingConstBuffer();
-	SetDepthCulling();
+	CreateProjectionMatrix();
 	SetNormalVector();
+	UploadVertices();
 
 	SetGraphicsPipeLine(fillMode);
 
@@ -69,47 +73,55 @@ Draw3D::Draw3D(const wchar_t *fileName, DrawShapeData shapeData, const float rad
 	SetSignature();
 }
 
+Draw3D::~Draw3D()
+{
+	//Texture stays cached until the budget needs the memory
+	if (dx12 != nullptr) {
+		dx12->GetTextureStreamer()->Release(texture);
+	}
+}
+
 void Draw3D::execute(const DirectX::XMFLOAT4 color, const DirectX::XMMATRIX Translation)
 {
-	//Get VirtualMemory
-	vertMap = nullptr;
-	result = verBuff->Map(0, nullptr, (void **)&vertMap);
-	assert(result == S_OK);
+	//Copy only when the mesh was changed, upload ring full: skip the draw
+	UploadVertices();
+	if (vertexDirty.IsDirty()) {
+		return;
+	}
 
-	//Update point
-	std::copy(vertices.begin(), vertices.end(), vertMap);
-	verBuff->Unmap(0, nullptr);
+	execute(color, Translation, cmdList);
+}
 
-	matTrans = Translation;
+void Draw3D::execute(const DirectX::XMFLOAT4 color, const DirectX::XMMATRIX Translation, RenderCommandList *list) const
+{
+	//Mesh changes are copied by the frame list overload, not from a recording thread
+	assert(!vertexDirty.IsDirty());
 
-	matWorld = DirectX::XMMatrixIdentity();
-	matWorld *= matScale;
-	matWorld *= matRot;
-	matWorld *= matTrans;
+	PROFILE_SCOPE("Draw3D::execute");
+	GPU_PROFILE_SCOPE(dx12->GetGpuProfiler(), list, "Draw3D::execute");
 
-	matView = DirectX::XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMLoadFloat3(&up));
+	//Locals only: several threads may draw this mesh at once
+	const DirectX::XMMATRIX world = matScale * matRot * Translation;
+	const DirectX::XMMATRIX view = DirectX::XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMLoadFloat3(&up));
 
-	constMap = nullptr;
-	result = constBuff->Map(0, nullptr, (void **)&constMap);
-	assert(result == S_OK);
+	ConstBufferData3D constData;
+	constData.color = color;
+	constData.mat = world * view * matProjection;
 
-	constMap->color = color;
-	constMap->mat = matWorld * matView * matProjection;
-	constBuff->Unmap(0, nullptr);
+	//Constant buffer (frame ring), no room: skip the draw
+	const D3D12_GPU_VIRTUAL_ADDRESS constants = dx12->GetUploadRing()->Push(constData);
+	if (constants == 0) {
+		return;
+	}
 
 	//pipeline
-	cmdList->SetPipelineState(pipelinestate);
-	cmdList->SetGraphicsRootSignature(rootsignature);
+	list->SetPipelineState(pipelinestate);
+	list->SetGraphicsRootSignature(rootsignature);
 
-	//Set Descriptor heap
-	ID3D12DescriptorHeap *ppHeaps[] = { basicDescHeap };
-	cmdList->SetDescriptorHeaps(_countof(ppHeaps), ppHeaps);
-
-	//Set constant buffer view
-	D3D12_GPU_DESCRIPTOR_HANDLE gpuDescHandle = basicDescHeap->GetGPUDescriptorHandleForHeapStart();
-	cmdList->SetGraphicsRootDescriptorTable(0, gpuDescHandle);
-	gpuDescHandle.ptr += this->dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-	cmdList->SetGraphicsRootDescriptorTable(1, gpuDescHandle);
+	//Constant buffer, texture
+	list->SetGraphicsRootConstantBufferView(0, constants);
+	list->SetGraphicsRootDescriptorTable(1, dx12->GetTextureStreamer()->GetGpuHandle(texture));
+	list->Upload(sizeof(constData));
 
 	//Set constant buffer view
 	/*cmdList->SetGraphicsRootDescriptorTable(0, basicDescHeap->GetGPUDescriptorHandleForHeapStart());*/
@@ -118,12 +130,64 @@ void Draw3D::execute(const DirectX::XMFLOAT4 color, const DirectX::XMMATRIX Tran
 	cmdList->IASetIndexBuffer(&ibView);
 	cmdList->DrawIndexedInstanced((int)indices.size(), 1, 0, 0, 0);*/
 
-	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	cmdList->IASetVertexBuffers(0, 1, &vbView);
+	list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	list->IASetVertexBuffers(0, 1, &vbView);
 
 	//Index buffer set command
+	list->IASetIndexBuffer(&ibView);
+	list->DrawIndexedInstanced((int)indices.size(), 1, 0, 0, 0);
+}
+
+void Draw3D::executeInstanced(const InstancePacker &instances)
+{
+	assert(instanceCapacity > 0);
+
+	const uint32_t count = std::min(instances.GetCount(), instanceCapacity);
+	if (count == 0) {
+		return;
+	}
+
+	PROFILE_SCOPE("Draw3D::executeInstanced");
+	GPU_PROFILE_SCOPE(dx12->GetGpuProfiler(), cmdList, "Draw3D::executeInstanced");
+
+	UploadVertices();
+	if (vertexDirty.IsDirty()) {
+		return;
+	}
+
+	//Instance data for this frame, no room: skip the draw
+	const UploadAllocation instanceData = dx12->GetUploadRing()->Allocate(sizeof(InstanceData) * count);
+	if (instanceData.cpu == nullptr) {
+		return;
+	}
+	memcpy(instanceData.cpu, instances.GetData(), sizeof(InstanceData) * count);
+
+	//World is per instance, the constant buffer only holds the camera
+	matView = DirectX::XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMLoadFloat3(&up));
+
+	ConstBufferData3D constData;
+	constData.color = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);
+	constData.mat = matView * matProjection;
+
+	const D3D12_GPU_VIRTUAL_ADDRESS constants = dx12->GetUploadRing()->Push(constData);
+	if (constants == 0) {
+		return;
+	}
+
+	//pipeline
+	cmdList->SetPipelineState(pipelinestate);
+	cmdList->SetGraphicsRootSignature(rootsignature);
+
+	//Constant buffer, texture, instances
+	cmdList->SetGraphicsRootConstantBufferView(0, constants);
+	cmdList->SetGraphicsRootDescriptorTable(1, dx12->GetTextureStreamer()->GetGpuHandle(texture));
+	cmdList->SetGraphicsRootShaderResourceView(2, instanceData.gpu);
+	cmdList->Upload(sizeof(constData) + sizeof(InstanceData) * count);
+
+	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	cmdList->IASetVertexBuffers(0, 1, &vbView);
 	cmdList->IASetIndexBuffer(&ibView);
-	cmdList->DrawIndexedInstanced((int)indices.size(), 1, 0, 0, 0);
+	cmdList->DrawIndexedInstanced((int)indices.size(), count, 0, 0, 0);
 }
 
 void Draw3D::SetRotation(DirectX::XMMATRIX Rotation)
@@ -209,35 +273,16 @@ void Draw3D::SetResourceDescription()
 
 void Draw3D::CreateVertexBuffer()
 {
-	////Create top buffer
-	//verBuff = nullptr;
-	//result = this->dev->CreateCommittedResource(
-	//	&heapprop,
-	//	D3D12_HEAP_FLAG_NONE,
-	//	&resdesc,
-	//	D3D12_RESOURCE_STATE_GENERIC_READ,
-	//	nullptr,
-	//	IID_PPV_ARGS(&verBuff)
-	//);
-	//assert(result == S_OK);
-
-	verBuff = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(sizeVB),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&verBuff)
-	);
-	assert(result == S_OK);
+	//Create top buffer (GPU local, written by copy)
+	vertexBuffer.Create(dx12, sizeVB, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER);
+	vertexDirty.Mark(0, sizeVB);
 }
 
 void Draw3D::SetVertexBufferView()
 {
 	//Create vertex buffer view
 	vbView = {};
-	vbView.BufferLocation = verBuff->GetGPUVirtualAddress();
+	vbView.BufferLocation = vertexBuffer.GetGPUVirtualAddress();
 	vbView.SizeInBytes = sizeof(Vertex3D) * vertices.size();
 	vbView.StrideInBytes = sizeof(Vertex3D);
 }
@@ -245,209 +290,49 @@ void Draw3D::SetVertexBufferView()
 void Draw3D::SetIndexBuffer()
 {
 	//Add index buffer
-	indexBuff = nullptr;
-	resdesc.Width = sizeof(unsigned short) * indices.size();
-	result = this->dev->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(indices.size()),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&indexBuff)
-	);
-	assert(result == S_OK);
+	indexBuffer.Create(dx12, sizeof(unsigned short) * indices.size(), D3D12_RESOURCE_STATE_INDEX_BUFFER);
 }
 
-void Draw3D::GetIndexMapVirtualMemory()
+void Draw3D::UploadIndices()
 {
-	//Get virtual memory
-	indexMap = nullptr;
-	result = indexBuff->Map(0, nullptr, (void **)&indexMap);
-	assert(result == S_OK);
-	for (int i = 0; i < indices.size(); ++i) {
-		indexMap[i] = indices[i];
-	}
-	indexBuff->Unmap(0, nullptr);
+	//Indices never change after SetShape
+	const bool uploaded = indexBuffer.Upload(indices.data(), 0, sizeof(unsigned short) * indices.size());
+	assert(uploaded);
 }
 
-void Draw3D::GetVertexMapVirtualMemory()
+void Draw3D::UploadVertices()
 {
-	//Get VirtualMemory
-	vertMap = nullptr;
-	result = verBuff->Map(0, nullptr, (void **)&vertMap);
-	assert(result == S_OK);
+	if (!vertexDirty.IsDirty()) {
+		return;
+	}
 
-	std::copy(vertices.begin(), vertices.end(), vertMap);
-	verBuff->Unmap(0, nullptr);
+	//Kept dirty when the upload ring is full, retried next draw
+	const uint8_t *source = reinterpret_cast<const uint8_t *>(vertices.data());
+	if (vertexBuffer.Upload(source + vertexDirty.GetOffset(), vertexDirty.GetOffset(), vertexDirty.GetSize())) {
+		vertexDirty.Clear();
+	}
 }
 
 void Draw3D::SetIndexBufferView()
 {
 	//Create index buffer view
 	ibView = {};
-	ibView.BufferLocation = indexBuff->GetGPUVirtualAddress();
+	ibView.BufferLocation = indexBuffer.GetGPUVirtualAddress();
 	ibView.Format = DXGI_FORMAT_R16_UINT;
 	ibView.SizeInBytes = sizeof(unsigned short) * indices.size();
 }
 
 void Draw3D::SetShader()
 {
-	//shader
-	vsBlob = nullptr;
-	psBlob = nullptr;
-	errorBlob = nullptr;
-
-	result = D3DCompileFromFile(
-		L"Shaders/BasicVS3D.hlsl",
-		nullptr,
-		D3D_COMPILE_STANDARD_FILE_INCLUDE,
-		"main", "vs_5_0",
-		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-		0,
-		&vsBlob, &errorBlob
-	);
-	assert(result == S_OK);
-
-	result = D3DCompileFromFile(
-		L"Shaders/BasicPS3D.hlsl",
-		nullptr,
-		D3D_COMPILE_STANDARD_FILE_INCLUDE,
-		"main", "ps_5_0",
-		D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-		0,
-		&psBlob, &errorBlob
-	);
-	assert(result == S_OK);
-}
-
-void Draw3D::SetConstantBufferHeapProperty()
-{
-	//Heap
-	cbheapprop.Type = D3D12_HEAP_TYPE_UPLOAD;
-}
-
-void Draw3D::SetConstantBufferResourceDescription()
-{
-	////Resources
-	//cbresdesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-	//cbresdesc.Width = (sizeof(ConstBufferData) + 0xff) & ~0xff;
-	//cbresdesc.Height = 1;
-	//cbresdesc.DepthOrArraySize = 1;
-	//cbresdesc.MipLevels = 1;
-	//cbresdesc.SampleDesc.Count = 1;
-	//cbresdesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-	////Create
-	//constBuff = nullptr;
-	//result = this->dev->CreateCommittedResource(
-	//	&cbheapprop,
-	//	D3D12_HEAP_FLAG_NONE,
-	//	&cbresdesc,
-	//	D3D12_RESOURCE_STATE_GENERIC_READ,
-	//	nullptr,
-	//	IID_PPV_ARGS(&constBuff)
-	//);
-
-	UINT64 buffSize = (sizeof(ConstBufferData) + 0xff) & ~0xff;
-	result = this->dev->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(buffSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&constBuff)
-	);
-	assert(result == S_OK);
-}
-
-void Draw3D::SetDescripterHeap()
-{
-	//Descripter heap
-	descHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	descHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	descHeapDesc.NumDescriptors = 2;
-
-	result = this->dev->CreateDescriptorHeap(&descHeapDesc, IID_PPV_ARGS(&basicDescHeap));
-	assert(result == S_OK);
-
-	basicHeapHandle = basicDescHeap->GetCPUDescriptorHandleForHeapStart();
-}
-
-void Draw3D::CreateConstantBuffer()
-{
-	//Create const buffer
-	cbvDesc.BufferLocation = constBuff->GetGPUVirtualAddress();
-	cbvDesc.SizeInBytes = (UINT)constBuff->GetDesc().Width;
-	this->dev->CreateConstantBufferView(&cbvDesc, basicHeapHandle);
+	//Compiled once, shared through the cache
+	vsBlob = dx12->GetShaderCache()->Get(instanceCapacity > 0 ? L"Shaders/BasicVS3DInstanced.hlsl" : L"Shaders/BasicVS3D.hlsl", "main", "vs_5_0");
+	psBlob = dx12->GetShaderCache()->Get(L"Shaders/BasicPS3D.hlsl", "main", "ps_5_0");
 }
 
 void Draw3D::CreateTextureData(const wchar_t *fileName)
 {
-	if (fileName == nullptr) {
-		result = LoadFromWICFile(
-			L"Resources/Default.png",
-			DirectX::WIC_FLAGS_NONE,
-			&metadata, scratchImg
-		);
-		assert(result == S_OK);
-	}
-	else {
-		result = LoadFromWICFile(
-			fileName,
-			DirectX::WIC_FLAGS_NONE,
-			&metadata, scratchImg
-		);
-		assert(result == S_OK);
-	}
-
-	const DirectX::Image *img = scratchImg.GetImage(0, 0, 0);
-
-	/*texHeapProp.Type = D3D12_HEAP_TYPE_CUSTOM;
-	texHeapProp.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_WRITE_BACK;
-	texHeapProp.MemoryPoolPreference = D3D12_MEMORY_POOL_L0;*/
-
-	/*texresDesc.Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(metadata.dimension);
-	texresDesc.Format = metadata.format;
-	texresDesc.Width = metadata.width;
-	texresDesc.Height = (UINT)metadata.height;
-	texresDesc.DepthOrArraySize = (UINT16)metadata.arraySize;
-	texresDesc.MipLevels = (UINT16)metadata.mipLevels;
-	texresDesc.SampleDesc.Count = 1;*/
-
-	texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
-		metadata.format,
-		(UINT64)metadata.width,
-		(UINT)metadata.height,
-		(UINT16)metadata.arraySize,
-		(UINT16)metadata.mipLevels
-	);
-
-	texbuff = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, D3D12_MEMORY_POOL_L0),
-		D3D12_HEAP_FLAG_NONE,
-		&texresDesc,
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&texbuff)
-	);
-
-	result = texbuff->WriteToSubresource(
-		0,
-		nullptr,
-		img->pixels,
-		(UINT)img->rowPitch,
-		(UINT)img->slicePitch
-	);
-
-	basicHeapHandle.ptr += this->dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-
-	srvDesc.Format = metadata.format;
-	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-	srvDesc.Texture2D.MipLevels = 1;
-
-	this->dev->CreateShaderResourceView(texbuff, &srvDesc, basicHeapHandle);
+	//Decoded in the background, drawn with a placeholder until uploaded
+	texture = dx12->GetTextureStreamer()->Load(fileName != nullptr ? fileName : L"Resources/Default.png");
 }
 
 void Draw3D::CreateWorldMatrix()
@@ -477,84 +362,13 @@ void Draw3D::CreateViewMatrix()
 	matView = DirectX::XMMatrixLookAtLH(XMLoadFloat3(&eye), XMLoadFloat3(&target), XMLoadFloat3(&up));
 }
 
-void Draw3D::MappingConstBuffer()
+void Draw3D::CreateProjectionMatrix()
 {
-	constMap = nullptr;
-	result = constBuff->Map(0, nullptr, (void **)&constMap);
-
 	matProjection = DirectX::XMMatrixPerspectiveFovLH(
 		DirectX::XMConvertToRadians(60.0f),
 		(float)window_width / window_height,
 		0.1f, 1000.0f
 	);
-
-	constMap->mat = matWorld * matView * matProjection;
-
-	constBuff->Unmap(0, nullptr);
-	assert(result == S_OK);
-}
-
-void Draw3D::SetDepthCulling()
-{
-	depthResDesc = CD3DX12_RESOURCE_DESC::Tex2D(
-		DXGI_FORMAT_D32_FLOAT,
-		window_width,
-		window_height,
-		1, 0,
-		1, 0,
-		D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL
-	);
-
-	/*depthResDesc = {};
-	depthResDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-	depthResDesc.Width = window_width;
-	depthResDesc.Height = window_height;
-	depthResDesc.DepthOrArraySize = 1;
-	depthResDesc.Format = DXGI_FORMAT_D32_FLOAT;
-	depthResDesc.SampleDesc.Count = 1;
-	depthResDesc.Flags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;*/
-
-	/*depthHeapProp = {};
-	depthHeapProp.Type = D3D12_HEAP_TYPE_DEFAULT;
-
-	depthClearValue = {};
-	depthClearValue.DepthStencil.Depth = 1.0f;
-	depthClearValue.Format = DXGI_FORMAT_D32_FLOAT;*/
-
-	/*depthBuffer = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&depthHeapProp,
-		D3D12_HEAP_FLAG_NONE,
-		&depthResDesc,
-		D3D12_RESOURCE_STATE_DEPTH_WRITE,
-		&depthClearValue,
-		IID_PPV_ARGS(&depthBuffer)
-	);*/
-	depthBuffer = nullptr;
-	result = this->dev->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_NONE,
-		&depthResDesc,
-		D3D12_RESOURCE_STATE_DEPTH_WRITE,
-		&CD3DX12_CLEAR_VALUE(DXGI_FORMAT_D32_FLOAT, 1.0f, 0),
-		IID_PPV_ARGS(&depthBuffer)
-	);
-
-	dsvHeapDesc = {};
-	dsvHeapDesc.NumDescriptors = 1;
-	dsvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;	//DepthStencilView
-
-	dsvHeap = nullptr;
-	result = this->dev->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&dsvHeap));
-
-	dsvDesc = {};
-	dsvDesc.Format = DXGI_FORMAT_D32_FLOAT;
-	dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
-	this->dev->CreateDepthStencilView(
-		depthBuffer,
-		&dsvDesc,
-		dsvHeap->GetCPUDescriptorHandleForHeapStart()
-	);
 }
 
 void Draw3D::SetNormalVector()
@@ -579,6 +393,7 @@ void Draw3D::SetNormalVector()
 		XMStoreFloat3(&vertices[index[1]].normal, normal);
 		XMStoreFloat3(&vertices[index[2]].normal, normal);
 	}
+	vertexDirty.Mark(0, sizeVB);
 }
 
 void Draw3D::SetGraphicsPipeLine(const int fillMode)
@@ -658,14 +473,17 @@ void Draw3D::SetRootParameter()
 	//rootparam[1].DescriptorTable.pDescriptorRanges = &descRangeSRV;
 	//rootparam[1].DescriptorTable.NumDescriptorRanges = 1;
 	//rootparam[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;
-	CD3DX12_DESCRIPTOR_RANGE descRangeCBV, descRangeSRV;
-	descRangeCBV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
 	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
 
-	CD3DX12_ROOT_PARAMETER rootparam[2];
-	rootparam[0].InitAsDescriptorTable(1, &descRangeCBV);
+	//Constant buffer lives in the frame upload ring
+	CD3DX12_ROOT_PARAMETER rootparam[3];
+	rootparam[0].InitAsConstantBufferView(0);
 	rootparam[1].InitAsDescriptorTable(1, &descRangeSRV);
 
+	//Instance buffer (t1), instanced mode only
+	rootparam[2].InitAsShaderResourceView(1, 0, D3D12_SHADER_VISIBILITY_VERTEX);
+
 	/*D3D12_STATIC_SAMPLER_DESC sampleDesc{};
 	sampleDesc.AddressU = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
 	sampleDesc.AddressV = D3D12_TEXTURE_ADDRESS_MODE_WRAP;
@@ -682,18 +500,12 @@ void Draw3D::SetRootParameter()
 	rootsignature = nullptr;
 	rootSignatureDesc.Flags = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT;
 	rootSignatureDesc.pParameters = rootparam;
-	rootSignatureDesc.NumParameters = _countof(rootparam);
+	rootSignatureDesc.NumParameters = instanceCapacity > 0 ? _countof(rootparam) : _countof(rootparam) - 1;
 	rootSignatureDesc.pStaticSamplers = &sampleDesc;
 	rootSignatureDesc.NumStaticSamplers = 1;
 
-	rootSigBlob = nullptr;
-	result = D3D12SerializeRootSignature(&rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
-	assert(result == S_OK);
-
-	result = this->dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(&rootsignature));
-	assert(result == S_OK);
-
-	rootSigBlob->Release();
+	//Shared with every object using the same layout
+	rootsignature = dx12->GetPipelineCache()->GetRootSignature(rootSignatureDesc);
 }
 
 void Draw3D::SetRootSignature()
@@ -724,9 +536,7 @@ void Draw3D::SetSignature()
 	gpipeline.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ALL;
 	gpipeline.DepthStencilState.DepthFunc = D3D12_COMPARISON_FUNC_LESS;*/
 	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
-	gpipeline.DSVFormat = DXGI_FORMAT_D32_FLOAT;
+	gpipeline.DSVFormat = dx12->GetDepthFormat();	//Shared depth buffer (DirectX12)
 
-	pipelinestate = nullptr;
-	result = this->dev->CreateGraphicsPipelineState(&gpipeline, IID_PPV_ARGS(&pipelinestate));
-	assert(result == S_OK);
+	pipelinestate = dx12->GetPipelineCache()->GetPipelineState(gpipeline);
 }
\ No newline at end of file
@@ -1,6 +1,12 @@
 #pragma once
 #include <DirectXTex.h>
 #include <d3dx12.h>
+#include "InstancePacker.h"
+#include "GpuBuffer.h"
+#include "DirtyRange.h"
+#include "TextureLoader.h"
+
+class DirectX12;
 
 enum class DrawShapeData {
 	TriangularPyramid,
@@ -15,8 +21,20 @@ private:
 
 public:
 	Draw3D();
-	Draw3D(const wchar_t *fileName, DrawShapeData shapeData, const float radius, const int fillMode, ID3D12Device *dev, ID3D12GraphicsCommandList *cmdList, const int window_width, const int window_height);
+	Draw3D(const wchar_t *fileName, DrawShapeData shapeData, const float radius, const int fillMode, DirectX12 *dx12, const int window_width, const int window_height, const uint32_t instanceCapacity = 0);
+	~Draw3D();
 	void execute(const DirectX::XMFLOAT4 color, const DirectX::XMMATRIX Translation);
+
+	/// <summary>
+	/// Record the draw into list (DirectX12::GetParallelCommandList); safe on several threads for one mesh
+	/// </summary>
+	void execute(const DirectX::XMFLOAT4 color, const DirectX::XMMATRIX Translation, RenderCommandList *list) const;
+
+	/// <summary>
+	/// Draw every packed instance with one DrawIndexedInstanced (instanceCapacity > 0 only)
+	/// </summary>
+	/// <param name="instances">World matrices are used as is (SetRotation is not applied)</param>
+	void executeInstanced(const InstancePacker &instances);
 	void SetRotation(DirectX::XMMATRIX Rotation);
 
 private:
@@ -24,22 +42,17 @@ private:
 	void SetHeapProperty();
 	void SetResourceDescription();
 	void CreateVertexBuffer();
-	void GetVertexMapVirtualMemory();
+	void UploadVertices();
 	void SetVertexBufferView();
 	void SetIndexBuffer();
-	void GetIndexMapVirtualMemory();
+	void UploadIndices();
 	void SetIndexBufferView();
 	void SetShader();
-	void SetConstantBufferHeapProperty();
-	void SetConstantBufferResourceDescription();
-	void SetDescripterHeap();
-	void CreateConstantBuffer();
 	void CreateTextureData(const wchar_t *fileName);
 
 	void CreateWorldMatrix();
 	void CreateViewMatrix();
-	void MappingConstBuffer();
-	void SetDepthCulling();
+	void CreateProjectionMatrix();
 	void SetNormalVector();
 
 	void SetGraphicsPipeLine(const int fillMode);
@@ -57,37 +70,30 @@ private:
 	UINT sizeVB;
 	HRESULT result;
 
+	DirectX12 *dx12;
 	ID3D12Device *dev;
-	ID3D12GraphicsCommandList *cmdList;
+	RenderCommandList *cmdList;
+
+	//Instanced mode (instance data comes from the upload ring)
+	uint32_t instanceCapacity;
 
 private:
 	D3D12_HEAP_PROPERTIES heapprop;
 	D3D12_RESOURCE_DESC resdesc;
-	ID3D12Resource *verBuff;
-	Vertex3D *vertMap;
+
+	//Mesh lives in DEFAULT heap, vertices are re-uploaded only while dirty
+	GpuBuffer vertexBuffer;
+	DirtyRange vertexDirty;
 	D3D12_VERTEX_BUFFER_VIEW vbView;
-	ID3D12Resource *indexBuff;
-	unsigned short *indexMap;
+	GpuBuffer indexBuffer;
 	D3D12_INDEX_BUFFER_VIEW ibView;
 
 	ID3DBlob *vsBlob;
 	ID3DBlob *psBlob;
 	ID3DBlob *errorBlob;
 
-	D3D12_HEAP_PROPERTIES cbheapprop;
-	D3D12_RESOURCE_DESC cbresdesc;
-	ID3D12Resource *constBuff;
-	ID3D12DescriptorHeap *basicDescHeap;
-	D3D12_CPU_DESCRIPTOR_HANDLE basicHeapHandle;
-	D3D12_DESCRIPTOR_HEAP_DESC descHeapDesc;
-	D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-
-	DirectX::TexMetadata metadata;
-	DirectX::ScratchImage scratchImg;
-	D3D12_HEAP_PROPERTIES texHeapProp;
-	CD3DX12_RESOURCE_DESC texresDesc;
-	ID3D12Resource *texbuff;
-	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc;
+	//Streamed, placeholder until uploaded
+	TextureHandle texture;
 
 	DirectX::XMMATRIX matWorld;
 	DirectX::XMMATRIX matScale;
@@ -100,20 +106,11 @@ private:
 	DirectX::XMFLOAT3 up;
 	float angle;
 
-	ConstBufferData3D *constMap;
-	CD3DX12_RESOURCE_DESC depthResDesc;
-	D3D12_HEAP_PROPERTIES depthHeapProp{};
-	D3D12_CLEAR_VALUE depthClearValue{};
-	ID3D12Resource *depthBuffer;
-	D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc{};
-	ID3D12DescriptorHeap *dsvHeap;
-	D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc = {};
-
-	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline;
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
 	D3D12_DESCRIPTOR_RANGE descTblrange;
 	D3D12_ROOT_PARAMETER rootparam;
 	ID3D12RootSignature *rootsignature;
-	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{};
 	ID3DBlob *rootSigBlob;
 	ID3D12PipelineState *pipelinestate;
 };
\ No newline at end of file
@@ -0,0 +1,88 @@
+//EntityStore update cost for projectile sized workloads
+//usage: EntityBench [count] [ticks]   (default 100000 1000)
+
+//STL
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+//Utility
+#include "EntityStore.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	//Projectiles fly right from the player area and leave the screen
+	const float fieldMinX = -60.0f;
+	const float fieldMaxX = 60.0f;
+	const float fieldMinY = -30.0f;
+	const float fieldMaxY = 30.0f;
+
+	void SpawnProjectile(EntityStore &store, std::mt19937 &random)
+	{
+		std::uniform_real_distribution<float> position(-50.0f, 0.0f);
+		std::uniform_real_distribution<float> height(-25.0f, 25.0f);
+		std::uniform_real_distribution<float> spread(-10.0f, 10.0f);
+		store.Spawn(position(random), height(random), 60.0f, spread(random));
+	}
+
+	double Milliseconds(const Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const uint32_t count = argc > 1 ? (uint32_t)std::strtoul(argv[1], nullptr, 10) : 100000;
+	const uint32_t ticks = argc > 2 ? (uint32_t)std::strtoul(argv[2], nullptr, 10) : 1000;
+	const float deltaTime = 1.0f / 120.0f;
+
+	std::mt19937 random(1);
+	EntityStore store(count);
+
+	auto start = Clock::now();
+	for (uint32_t i = 0; i < count; ++i) {
+		SpawnProjectile(store, random);
+	}
+	const double spawnTime = Milliseconds(start);
+
+	//Integrate only: the vectorized part
+	start = Clock::now();
+	for (uint32_t t = 0; t < ticks; ++t) {
+		store.Integrate(deltaTime);
+	}
+	const double integrateTime = Milliseconds(start) / ticks;
+
+	//Full tick: move, drop what left the field, refill to count
+	store.Clear();
+	for (uint32_t i = 0; i < count; ++i) {
+		SpawnProjectile(store, random);
+	}
+
+	uint64_t despawned = 0;
+	double churnTime = 0;
+	for (uint32_t t = 0; t < ticks; ++t) {
+		start = Clock::now();
+		store.Integrate(deltaTime);
+		despawned += store.DespawnOutside(fieldMinX, fieldMinY, fieldMaxX, fieldMaxY);
+		churnTime += Milliseconds(start);
+
+		//Refill outside the timed part, it measures the RNG more than the store
+		while (store.GetCount() < count) {
+			SpawnProjectile(store, random);
+		}
+	}
+	churnTime /= ticks;
+
+	printf("entities        : %u\n", count);
+	printf("spawn           : %.3f ms (%.1f ns each)\n", spawnTime, spawnTime * 1e6 / count);
+	printf("integrate       : %.3f ms / tick\n", integrateTime);
+	printf("integrate+cull  : %.3f ms / tick (%.1f despawned / tick)\n", churnTime, (double)despawned / ticks);
+	printf("budget (1 ms)   : %s\n", churnTime < 1.0 ? "ok" : "over");
+
+	return churnTime < 1.0 ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+//STL
+#include <cassert>
+
+//this
+#include "EntityStore.h"
+
+namespace
+{
+	const uint32_t slotMask = maxEntityCapacity;
+	const uint32_t generationMask = UINT32_MAX >> entitySlotBits;
+
+	EntityHandle MakeHandle(const uint32_t slot, const uint32_t generation)
+	{
+		return (generation << entitySlotBits) | slot;
+	}
+}
+
+EntityStore::EntityStore(const uint32_t capacity)
+	: count(0),
+	x(capacity),
+	y(capacity),
+	velocityX(capacity),
+	velocityY(capacity),
+	timer(capacity),
+	flags(capacity),
+	slotOf(capacity),
+	indexOf(capacity),
+	generation(capacity, 0)
+{
+	assert(capacity <= maxEntityCapacity);
+
+	//Low slots first
+	freeSlots.reserve(capacity);
+	for (uint32_t slot = capacity; slot > 0; --slot) {
+		freeSlots.push_back(slot - 1);
+	}
+}
+
+EntityHandle EntityStore::Spawn(const float x, const float y, const float velocityX, const float velocityY, const uint32_t flags)
+{
+	if (freeSlots.empty()) {
+		return invalidEntityHandle;
+	}
+
+	const uint32_t slot = freeSlots.back();
+	freeSlots.pop_back();
+
+	const uint32_t index = count++;
+	this->x[index] = x;
+	this->y[index] = y;
+	this->velocityX[index] = velocityX;
+	this->velocityY[index] = velocityY;
+	this->timer[index] = 0;
+	this->flags[index] = flags;
+	slotOf[index] = slot;
+	indexOf[slot] = index;
+	return MakeHandle(slot, generation[slot]);
+}
+
+bool EntityStore::Despawn(const EntityHandle handle)
+{
+	const uint32_t index = Find(handle);
+	if (index == UINT32_MAX) {
+		return false;
+	}
+
+	DespawnAt(index);
+	return true;
+}
+
+void EntityStore::DespawnAt(const uint32_t index)
+{
+	assert(index < count);
+
+	const uint32_t slot = slotOf[index];
+	const uint32_t last = --count;
+
+	//Swap remove: the last entity fills the hole
+	if (index != last) {
+		x[index] = x[last];
+		y[index] = y[last];
+		velocityX[index] = velocityX[last];
+		velocityY[index] = velocityY[last];
+		timer[index] = timer[last];
+		flags[index] = flags[last];
+		slotOf[index] = slotOf[last];
+		indexOf[slotOf[index]] = index;
+	}
+
+	//Skip the generation that would turn the last slot into invalidEntityHandle
+	generation[slot] = (generation[slot] + 1) & generationMask;
+	if (MakeHandle(slot, generation[slot]) == invalidEntityHandle) {
+		generation[slot] = 0;
+	}
+	freeSlots.push_back(slot);
+}
+
+void EntityStore::Clear()
+{
+	while (count > 0) {
+		DespawnAt(count - 1);
+	}
+}
+
+uint32_t EntityStore::DespawnOutside(const float minX, const float minY, const float maxX, const float maxY)
+{
+	//Backwards, so the entity swapped into a hole has already been tested
+	uint32_t despawned = 0;
+	for (uint32_t i = count; i > 0; --i) {
+		const uint32_t index = i - 1;
+		if (x[index] < minX || x[index] > maxX || y[index] < minY || y[index] > maxY) {
+			DespawnAt(index);
+			++despawned;
+		}
+	}
+	return despawned;
+}
+
+void EntityStore::Integrate(const float deltaTime)
+{
+	//One stream per loop so each vectorizes on its own
+	float *__restrict px = x.data();
+	float *__restrict py = y.data();
+	const float *__restrict vx = velocityX.data();
+	const float *__restrict vy = velocityY.data();
+	const uint32_t n = count;
+
+	for (uint32_t i = 0; i < n; ++i) {
+		px[i] += vx[i] * deltaTime;
+	}
+	for (uint32_t i = 0; i < n; ++i) {
+		py[i] += vy[i] * deltaTime;
+	}
+}
+
+bool EntityStore::IsAlive(const EntityHandle handle) const
+{
+	return Find(handle) != UINT32_MAX;
+}
+
+uint32_t EntityStore::Find(const EntityHandle handle) const
+{
+	const uint32_t slot = handle & slotMask;
+	if (handle == invalidEntityHandle || slot >= generation.size() || generation[slot] != (handle >> entitySlotBits)) {
+		return UINT32_MAX;
+	}
+
+	//A free slot still matches handles made up with its current generation
+	const uint32_t index = indexOf[slot];
+	return index < count && slotOf[index] == slot ? index : UINT32_MAX;
+}
+
+EntityHandle EntityStore::GetHandle(const uint32_t index) const
+{
+	assert(index < count);
+	const uint32_t slot = slotOf[index];
+	return MakeHandle(slot, generation[slot]);
+}
+
+void EntityStore::WriteState(StateHash &hash) const
+{
+	hash.WriteValue(count);
+	hash.Write(x.data(), sizeof(float) * count);
+	hash.Write(y.data(), sizeof(float) * count);
+	hash.Write(velocityX.data(), sizeof(float) * count);
+	hash.Write(velocityY.data(), sizeof(float) * count);
+	hash.Write(timer.data(), sizeof(float) * count);
+	hash.Write(flags.data(), sizeof(uint32_t) * count);
+	for (uint32_t i = 0; i < count; ++i) {
+		hash.WriteValue(GetHandle(i));
+	}
+}
+
+uint32_t EntityStore::GetCount() const
+{
+	return count;
+}
+
+uint32_t EntityStore::GetCapacity() const
+{
+	return (uint32_t)x.size();
+}
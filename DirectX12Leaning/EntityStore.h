@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "StateHash.h"
+
+//Slot in the low 20 bits, generation in the high 12
+typedef uint32_t EntityHandle;
+const EntityHandle invalidEntityHandle = UINT32_MAX;
+
+const uint32_t entitySlotBits = 20;
+const uint32_t maxEntityCapacity = (1u << entitySlotBits) - 1;
+
+/// <summary>
+/// Pooled entities stored as dense arrays (structure of arrays)
+/// </summary>
+/// <remarks>
+/// Live entities are [0, GetCount()) of every array; Despawn moves the last one into the hole,
+/// so dense indices change and only handles stay valid. A handle of a despawned entity is
+/// rejected until its slot has been reused 4096 times (12 bit generation).
+/// Everything is allocated by the constructor, Spawn / Despawn never allocate.
+/// </remarks>
+class EntityStore
+{
+public:
+	/// <param name="capacity">Live entity limit (up to maxEntityCapacity)</param>
+	EntityStore(const uint32_t capacity = 0);
+
+	/// <returns>invalidEntityHandle when the store is full</returns>
+	EntityHandle Spawn(const float x, const float y, const float velocityX = 0, const float velocityY = 0, const uint32_t flags = 0);
+
+	/// <returns>false when the handle is stale</returns>
+	bool Despawn(const EntityHandle handle);
+	void DespawnAt(const uint32_t index);
+	void Clear();
+
+	/// <summary>
+	/// Despawn everything outside [minX, maxX] x [minY, maxY]
+	/// </summary>
+	/// <returns>Despawned count</returns>
+	uint32_t DespawnOutside(const float minX, const float minY, const float maxX, const float maxY);
+
+	/// <summary>
+	/// position += velocity * deltaTime for every live entity
+	/// </summary>
+	void Integrate(const float deltaTime);
+
+	bool IsAlive(const EntityHandle handle) const;
+
+	//Dense index, UINT32_MAX when the handle is stale
+	uint32_t Find(const EntityHandle handle) const;
+	EntityHandle GetHandle(const uint32_t index) const;
+
+	uint32_t GetCount() const;
+	uint32_t GetCapacity() const;
+
+	//Live entities and their handles (for replay divergence checks)
+	void WriteState(StateHash &hash) const;
+
+	//Dense arrays, index with [0, GetCount())
+	float *GetX()							{ return x.data(); }
+	float *GetY()							{ return y.data(); }
+	float *GetVelocityX()					{ return velocityX.data(); }
+	float *GetVelocityY()					{ return velocityY.data(); }
+	float *GetTimer()						{ return timer.data(); }
+	uint32_t *GetFlags()					{ return flags.data(); }
+	const float *GetX() const				{ return x.data(); }
+	const float *GetY() const				{ return y.data(); }
+	const float *GetVelocityX() const		{ return velocityX.data(); }
+	const float *GetVelocityY() const		{ return velocityY.data(); }
+	const float *GetTimer() const			{ return timer.data(); }
+	const uint32_t *GetFlags() const		{ return flags.data(); }
+
+private:
+	uint32_t count;
+
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> timer;		//Free for the owner (age, respawn wait ...)
+	std::vector<uint32_t> flags;	//Owner defined bits
+	std::vector<uint32_t> slotOf;	//Dense index -> slot
+
+	std::vector<uint32_t> indexOf;	//Slot -> dense index
+	std::vector<uint32_t> generation;
+	std::vector<uint32_t> freeSlots;
+};
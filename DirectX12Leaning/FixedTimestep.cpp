@@ -0,0 +1,70 @@
+//STL
+#include <cmath>
+
+//this
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(const double tickRate, const int maxTicksPerFrame) :
+	maxTicksPerFrame(maxTicksPerFrame)
+{
+	tickLength = std::llround(1e9 / tickRate);
+	Reset();
+}
+
+int FixedTimestep::Advance(const double elapsedSeconds)
+{
+	//Clock went backwards or was paused
+	if (elapsedSeconds > 0.0) {
+		accumulator += std::llround(elapsedSeconds * 1e9);
+	}
+
+	int ticks = static_cast<int>(accumulator / tickLength);
+	accumulator -= ticks * tickLength;
+
+	//Long hitch: run at most maxTicksPerFrame and drop the rest
+	if (ticks > maxTicksPerFrame) {
+		droppedTicks += ticks - maxTicksPerFrame;
+		ticks = maxTicksPerFrame;
+	}
+
+	tickCount += ticks;
+	return ticks;
+}
+
+float FixedTimestep::GetAlpha() const
+{
+	return static_cast<float>(static_cast<double>(accumulator) / tickLength);
+}
+
+int64_t FixedTimestep::GetTickEndTime(const int64_t now, const int index, const int count) const
+{
+	//The leftover accumulator is time after the last tick
+	return now - accumulator - (count - 1 - index) * tickLength;
+}
+
+float FixedTimestep::GetDeltaTime() const
+{
+	return static_cast<float>(tickLength / 1e9);
+}
+
+double FixedTimestep::GetTickRate() const
+{
+	return 1e9 / tickLength;
+}
+
+uint64_t FixedTimestep::GetTickCount() const
+{
+	return tickCount;
+}
+
+uint64_t FixedTimestep::GetDroppedTicks() const
+{
+	return droppedTicks;
+}
+
+void FixedTimestep::Reset()
+{
+	accumulator = 0;
+	tickCount = 0;
+	droppedTicks = 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+
+class FixedTimestep
+{
+public:
+	/// <summary>
+	/// Accumulator based fixed step scheduler
+	/// </summary>
+	/// <param name="tickRate">Simulation ticks per second</param>
+	/// <param name="maxTicksPerFrame">Tick limit per Advance (excess time is dropped)</param>
+	FixedTimestep(const double tickRate = 120.0, const int maxTicksPerFrame = 8);
+
+	/// <summary>
+	/// Add elapsed frame time and get the number of ticks to run
+	/// </summary>
+	/// <param name="elapsedSeconds">Real time since the last call</param>
+	/// <returns>Ticks to simulate this frame</returns>
+	int Advance(const double elapsedSeconds);
+
+	/// <summary>
+	/// Interpolation factor between the previous and the current tick (0 - 1)
+	/// </summary>
+	float GetAlpha() const;
+
+	/// <summary>
+	/// Where tick index of the last Advance ends on the caller's clock (input events up to it belong to the tick)
+	/// </summary>
+	/// <param name="now">Time Advance was called for (nanoseconds)</param>
+	/// <param name="index">0 - count - 1</param>
+	/// <param name="count">Ticks returned by Advance</param>
+	int64_t GetTickEndTime(const int64_t now, const int index, const int count) const;
+
+	float GetDeltaTime() const;
+	double GetTickRate() const;
+	uint64_t GetTickCount() const;
+	uint64_t GetDroppedTicks() const;
+	void Reset();
+
+private:
+	//nanoseconds
+	int64_t tickLength;
+	int64_t accumulator;
+
+	int maxTicksPerFrame;
+	uint64_t tickCount;
+	uint64_t droppedTicks;
+};
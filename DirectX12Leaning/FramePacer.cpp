@@ -0,0 +1,115 @@
+//STL
+#include <algorithm>
+#include <assert.h>
+
+//this
+#include "FramePacer.h"
+
+NullFrameFence::NullFrameFence(const uint64_t gpuFrameDelay) :
+	gpuFrameDelay(gpuFrameDelay)
+{
+	signaledValue = 0;
+	completedValue = 0;
+	waitCount = 0;
+}
+
+void NullFrameFence::Signal(const uint64_t value)
+{
+	signaledValue = value;
+	if (value > gpuFrameDelay) {
+		completedValue = std::max(completedValue, value - gpuFrameDelay);
+	}
+}
+
+uint64_t NullFrameFence::GetCompletedValue()
+{
+	return completedValue;
+}
+
+void NullFrameFence::WaitForValue(const uint64_t value)
+{
+	//Waiting for a value never signaled would hang a real queue
+	assert(value <= signaledValue);
+
+	completedValue = std::max(completedValue, value);
+	waitCount++;
+}
+
+uint64_t NullFrameFence::GetSignaledValue() const
+{
+	return signaledValue;
+}
+
+uint64_t NullFrameFence::GetWaitCount() const
+{
+	return waitCount;
+}
+
+FramePacer::FramePacer(FrameFence *fence, const int frameCount) :
+	fence(fence),
+	frameFenceValues(std::max(frameCount, 1), 0)
+{
+	frameIndex = 0;
+	fenceValue = 0;
+	completedValue = 0;
+	waitCount = 0;
+}
+
+uint64_t FramePacer::EndFrame()
+{
+	fence->Signal(++fenceValue);
+	frameFenceValues[frameIndex] = fenceValue;
+
+	return fenceValue;
+}
+
+int FramePacer::BeginFrame()
+{
+	frameIndex = (frameIndex + 1) % (int)frameFenceValues.size();
+
+	//Slot is still used by the GPU
+	const uint64_t value = frameFenceValues[frameIndex];
+	completedValue = fence->GetCompletedValue();
+	if (completedValue < value) {
+		fence->WaitForValue(value);
+		completedValue = fence->GetCompletedValue();
+		waitCount++;
+	}
+	assert(completedValue >= value);
+
+	return frameIndex;
+}
+
+void FramePacer::WaitIdle()
+{
+	completedValue = fence->GetCompletedValue();
+	if (completedValue < fenceValue) {
+		fence->WaitForValue(fenceValue);
+		completedValue = fence->GetCompletedValue();
+	}
+}
+
+int FramePacer::GetFrameIndex() const
+{
+	return frameIndex;
+}
+
+int FramePacer::GetFrameCount() const
+{
+	return (int)frameFenceValues.size();
+}
+
+uint64_t FramePacer::GetSubmittedValue() const
+{
+	return fenceValue;
+}
+
+uint64_t FramePacer::GetCompletedValue() const
+{
+	return completedValue;
+}
+
+uint64_t FramePacer::GetWaitCount() const
+{
+	return waitCount;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//Queue / fence the pacer runs against (D3D12 or a stand-in)
+class FrameFence
+{
+public:
+	virtual ~FrameFence() {}
+
+	//Queue side: signal value after all submitted work
+	virtual void Signal(const uint64_t value) = 0;
+
+	//Last value the GPU has reached
+	virtual uint64_t GetCompletedValue() = 0;
+
+	//Block the CPU until value is reached
+	virtual void WaitForValue(const uint64_t value) = 0;
+};
+
+/// <summary>
+/// Fence without a GPU: the GPU side runs gpuFrameDelay signals behind the CPU
+/// </summary>
+/// <remarks>
+/// Signal(n) completes value n - gpuFrameDelay (0 = the GPU keeps up), WaitForValue
+/// completes up to the value at once. Used to test pacing off Windows.
+/// </remarks>
+class NullFrameFence : public FrameFence
+{
+public:
+	explicit NullFrameFence(const uint64_t gpuFrameDelay);
+
+	void Signal(const uint64_t value) override;
+	uint64_t GetCompletedValue() override;
+	void WaitForValue(const uint64_t value) override;
+
+	uint64_t GetSignaledValue() const;
+	uint64_t GetWaitCount() const;
+
+private:
+	uint64_t gpuFrameDelay;
+	uint64_t signaledValue;
+	uint64_t completedValue;
+	uint64_t waitCount;
+};
+
+class FramePacer
+{
+public:
+	/// <summary>
+	/// Keep at most frameCount frames in flight on fence
+	/// </summary>
+	/// <param name="fence">Queue fence</param>
+	/// <param name="frameCount">Frame latency depth (frames in flight)</param>
+	FramePacer(FrameFence *fence, const int frameCount);
+
+	/// <summary>
+	/// Submit end of the current frame (signal fence)
+	/// </summary>
+	/// <returns>Fence value of the submitted frame</returns>
+	uint64_t EndFrame();
+
+	/// <summary>
+	/// Move to the next frame slot, waiting until its previous use retired
+	/// </summary>
+	/// <returns>Frame slot index (per-frame allocator / resources)</returns>
+	int BeginFrame();
+
+	//Block until every submitted frame is complete
+	void WaitIdle();
+
+	int GetFrameIndex() const;
+	int GetFrameCount() const;
+	uint64_t GetSubmittedValue() const;
+	uint64_t GetCompletedValue() const;
+	uint64_t GetWaitCount() const;
+
+private:
+	FrameFence *fence;
+
+	int frameIndex;
+	uint64_t fenceValue;
+	uint64_t completedValue;
+	uint64_t waitCount;
+	std::vector<uint64_t> frameFenceValues;
+};
@@ -1,75 +1,153 @@
 #include "includes.h"
 #include "GamePlay.h"
 
-GamePlay::GamePlay(Win32 *win32,DirectX12 *dx12, Input *input, const int window_width, const int window_height) : 
+GamePlay::GamePlay(Win32 *win32,DirectX12 *dx12, InputBackend *input, const int window_width, const int window_height, const SessionOptions &session) : 
 	win32(win32),
 	dx12(dx12),
 	input(input),
 	window_height(window_height),
-	window_width(window_width)
+	window_width(window_width),
+	replaying(false),
+	profilePath(session.profilePath),
+	bulletInstances(bulletCapacity),
+	enemyInstances(enemyCount)
 {
 	dev = dx12->GetDevice();
 	cmdList = dx12->GetCommandList();
 
-	SceneNum = 0;
-
-	player = PlayerOP(0, 0, 0, 5, input);
-	drawPlayer = new Draw3D(L"Resources/AI.png", DrawShapeData::TriangularPyramid, 5, D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
-	drawPlayer->SetRotation(DirectX::XMMatrixRotationZ(DirectX::XMConvertToRadians(-90.0f)));
-
-	bullet = Bullet(1.0f, 3, input);
-	DrawBullet = new Draw3D(L"Resources/senju.png", DrawShapeData::TriangularPyramid, 2, D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
-	DrawBullet->SetRotation(DirectX::XMMatrixRotationZ(DirectX::XMConvertToRadians(-90.0f)));
+	//Capture from the first frame, loading included
+	if (!profilePath.empty()) {
+		Profiler::Get().SetThreadName("Main");
+		Profiler::Get().Start();
+	}
 
-	enemyObject = std::vector<Draw3D *>(2);
-	for (auto i = 0; i < enemyObject.size(); i++) {
-		enemyObject[i] = new Draw3D(L"Resources/seven.png", DrawShapeData::Box, 2, D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
+	//A replay brings its own seed and tick rate
+	uint64_t seed = session.seed;
+	if (!session.replayPath.empty()) {
+		replayFile.open(session.replayPath, std::ios::binary);
+		replaying = replayFile && replay.Open(&replayFile);
+		if (replaying) {
+			seed = replay.GetSeed();
+			timestep = FixedTimestep(replay.GetTickRate());
+		}
+		else {
+			OutputDebugStringA("Replay: cannot read the recording, playing live\n");
+		}
 	}
+	simulation.Reset(seed);
+	prevState = simulation.GetSnapshot();
 
-	Background = std::vector<Draw2DGraph*>(2);
-	for (auto i = 0; i < Background.size(); i++) {
-		Background[i] = new Draw2DGraph(L"Resources/data.png", D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
+	if (!session.recordPath.empty()) {
+		recordFile.open(session.recordPath, std::ios::binary | std::ios::trunc);
+		if (!recordFile || !recorder.Begin(&recordFile, seed, timestep.GetTickRate())) {
+			OutputDebugStringA("Record: cannot write the recording\n");
+		}
 	}
 
-	titleFlag = false;
-	alpha = 255;
-	Timer = 0;
-	TitleBG = new Draw2DGraph(L"Resources/TitleBG.png", D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
-	TitleMessage = new Draw2DGraph(L"Resources/PressMessage.png", D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
-	BackHome = new Draw2DGraph(L"Resources/BackHome.png", D3D12_FILL_MODE_SOLID, dev, cmdList, window_width, window_height);
+	//Packed textures when the archive exists, loose files otherwise
+	dx12->GetTextureStreamer()->MountArchive(L"Resources/textures.pak");
+
+	drawPlayer = new Draw3D(L"Resources/AI.png", DrawShapeData::TriangularPyramid, 5, D3D12_FILL_MODE_SOLID, dx12, window_width, window_height);
+	drawPlayer->SetRotation(DirectX::XMMatrixRotationZ(DirectX::XMConvertToRadians(-90.0f)));
+
+	DrawBullet = new Draw3D(L"Resources/senju.png", DrawShapeData::TriangularPyramid, 2, D3D12_FILL_MODE_SOLID, dx12, window_width, window_height, bulletCapacity);
+
+	drawEnemy = new Draw3D(L"Resources/seven.png", DrawShapeData::Box, 2, D3D12_FILL_MODE_SOLID, dx12, window_width, window_height, enemyCount);
+
+	sprites = new SpriteRenderer(dx12, window_width, window_height);
+	Background = sprites->LoadTexture(L"Resources/data.png");
+	TitleBG = sprites->LoadTexture(L"Resources/TitleBG.png");
+	TitleMessage = sprites->LoadTexture(L"Resources/PressMessage.png");
+	BackHome = sprites->LoadTexture(L"Resources/BackHome.png");
 }
 
 GamePlay::~GamePlay()
 {
+	dx12->WaitIdle();
+	recorder.End();
+
+	//WaitIdle read back the GPU regions still in flight
+	if (!profilePath.empty()) {
+		Profiler::Get().Stop();
+		Profiler::Get().Collect();
+
+		std::ofstream trace(profilePath, std::ios::trunc);
+		if (!trace || !Profiler::Get().WriteChromeTrace(trace)) {
+			OutputDebugStringA("Profile: cannot write the trace\n");
+		}
+	}
+
 	delete drawPlayer;
 	delete DrawBullet;
-	delete TitleBG, TitleMessage, BackHome;
+	delete drawEnemy;
+	delete sprites;
+}
 
-	for (auto v : enemyObject) {
-		delete v;
+namespace
+{
+	float Lerp(const float a, const float b, const float t)
+	{
+		return a + (b - a) * t;
 	}
 
-	for (auto v : Background) {
-		delete v;
+	Position3D Lerp(const Position3D &a, const Position3D &b, const float t)
+	{
+		return { Lerp(a.x, b.x, t), Lerp(a.y, b.y, t), Lerp(a.z, b.z, t) };
+	}
+
+	//Index of the bullet in snapshot, -1 when it was not live
+	int FindBullet(const SimulationSnapshot &snapshot, const EntityHandle id)
+	{
+		for (uint32_t i = 0; i < snapshot.bulletCount; ++i) {
+			if (snapshot.bulletId[i] == id) {
+				return (int)i;
+			}
+		}
+		return -1;
 	}
 }
 
 void GamePlay::Update()
 {
+	auto prevTime = std::chrono::steady_clock::now();
+
 	while (true)
 	{
+		PROFILE_SCOPE("Frame");
+
+		//Frame time
+		auto nowTime = std::chrono::steady_clock::now();
+		const double elapsed = std::chrono::duration<double>(nowTime - prevTime).count();
+		prevTime = nowTime;
+
+		const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(nowTime.time_since_epoch()).count();
+		input->Poll(keys, now);
+		if (keys.GetLatestKey(keycode::Escape)) { break; }
+
+		//Simulation, each tick takes the key events that happened during it
+		const int ticks = timestep.Advance(elapsed);
+		for (auto i = 0; i < ticks; ++i) {
+			PROFILE_SCOPE("Tick");
+			prevState = simulation.GetSnapshot();
+
+			keys.AdvanceTo(timestep.GetTickEndTime(now, i, ticks));
+			const SimInput tickInput = NextInput();
+			simulation.Tick(tickInput, timestep.GetDeltaTime());
+			AfterTick(tickInput);
+		}
+
 		//Clear
 		dx12->ClearDrawScreen(dx12->GetColor(30, 30, 30, 255));
-		input->Update();
 
-		switch (SceneNum)
+		const SimulationSnapshot &state = simulation.GetSnapshot();
+		switch (state.scene)
 		{
-			case 0: {
-				Title();
+			case SceneType::Title: {
+				TitleDraw(state, timestep.GetAlpha());
 				break;
 			}
-			case 1: {
-				GameScene();
+			case SceneType::Game: {
+				GameSceneDraw(state, timestep.GetAlpha());
 				break;
 			}
 
@@ -77,131 +155,134 @@ void GamePlay::Update()
 		}
 
 		dx12->ScreenFlip();
+
+		//Last frame's events into the capture (GPU regions arrive frames later)
+		Profiler::Get().Collect();
 		if (!win32->ProcessMessage()) { break; }
-		if (input->GetKeyDown(keycode::Escape)) { break; }
 	}
 }
 
-void GamePlay::Title()
+SimInput GamePlay::NextInput()
 {
-#pragma region UpdatePorocess
-	Timer++;
-	if (Timer > 60) {
-		Timer = 0;
-	}
-	if (input->GetKeyDown(keycode::Space)) {
-		titleFlag = true;
-	}
+	if (replaying) {
+		SimInput recorded;
+		if (replay.Next(recorded)) {
+			return recorded;
+		}
 
-	if (titleFlag == true) {
-		alpha -= 3.0f;
+		replaying = false;
+		OutputDebugStringA(("Replay: finished after " + std::to_string(replay.GetTickCount()) + " ticks\n").c_str());
 	}
+	return ReadSimInput(keys);
+}
 
-	if (alpha <= 0.1f) {
-		SceneNum = 1;
-		titleFlag = false;
+void GamePlay::AfterTick(const SimInput &tickInput)
+{
+	//Hash only when something reads it
+	if (!replaying && !recorder.IsRecording()) {
+		return;
 	}
-#pragma endregion
 
-#pragma region DrawProcess
-	//TitleBG->Update(window_width / 2, window_height / 2, 20);
-	TitleBG->execute(dx12->GetColor(255, 255, 255, alpha), 0.0f);
-
-	if (Timer <= 30) {
-		TitleMessage->execute(dx12->GetColor(255, 255, 255, alpha), 0.0f);
+	const uint64_t hash = simulation.GetStateHash();
+	if (replaying && !replay.Check(hash) && replay.GetDivergedTick() == replay.GetTickCount()) {
+		OutputDebugStringA(("Replay: diverged at tick " + std::to_string(replay.GetDivergedTick()) + "\n").c_str());
+	}
+	if (recorder.IsRecording()) {
+		recorder.Record(tickInput, hash);
 	}
-#pragma endregion
 }
 
-void GamePlay::GameScene()
+Sprite GamePlay::ScreenSprite(const uint32_t texture, const DirectX::XMFLOAT4 color, const float adjustXPos, const uint32_t layer) const
 {
-#pragma region UpdateProcess
-	//Background position adjust
-	for (int i = 0; i < 2; i++) {
-		if (xAdjust[i] <= -1.99f) {
-			xAdjust[i] = 2.0f;
-		}
-		xAdjust[i] -= .01f;
-	}
-
-	//Enemy
-	for (int i = 0; i < 2; ++i) {
-		if (bullet.GetActiveFlag() && bullet.GetCollision(enemyPos[i], 2)) {
-			enemyFlag[i] = false;
-			bullet.SetActiveFlag(false);
-		}
-
-		if (enemyFlag[i] == false) {
-			enemyWaitTime[i] += 1;
-
-			if (enemyWaitTime[i] > 60) {
-				enemyPos[i].x = rand() % 51;
-				enemyPos[i].y = rand() % 50 - 25;
-				enemyWaitTime[i] = 0;
-				enemyFlag[i] = true;
-			}
-		}
+	//Full screen quad, adjustXPos in screen units (2 = one screen width)
+	Sprite sprite;
+	sprite.texture = texture;
+	sprite.layer = layer;
+	sprite.x = adjustXPos * window_width / 2;
+	sprite.y = 0;
+	sprite.width = (float)window_width;
+	sprite.height = (float)window_height;
+	sprite.color[0] = color.x;
+	sprite.color[1] = color.y;
+	sprite.color[2] = color.z;
+	sprite.color[3] = color.w;
+	return sprite;
+}
 
-		if (enemyFlag[i] == true && enemyPos[i].y <= -25) { enemyTurnFlag[i] = true; }
-		if (enemyFlag[i] == true && enemyPos[i].y >= 25) { enemyTurnFlag[i] = false; }
+void GamePlay::TitleDraw(const SimulationSnapshot &state, const float interpolation)
+{
+	PROFILE_SCOPE("TitleDraw");
 
-		if (enemyTurnFlag[i]) { enemyPos[i].y += enemySpeed[i]; }
-		else { enemyPos[i].y -= enemySpeed[i]; }
+	sprites->Begin();
+	sprites->Draw(ScreenSprite(TitleBG, dx12->GetColor(255, 255, 255, state.alpha), 0.0f, 0));
 
-		enemyObject[i]->SetRotation(DirectX::XMMatrixRotationY(DirectX::XMConvertToRadians(-10.0f)));
+	if (state.timer <= 0.5f) {
+		sprites->Draw(ScreenSprite(TitleMessage, dx12->GetColor(255, 255, 255, state.alpha), 0.0f, 1));
 	}
+	sprites->Flush();
+}
 
-	player.Update();
-	bullet.Update(player.Get3DPoint());
-#pragma endregion
+void GamePlay::GameSceneDraw(const SimulationSnapshot &state, const float interpolation)
+{
+	PROFILE_SCOPE("GameSceneDraw");
 
-#pragma region DrawProcess
+	//Scene just changed: nothing to blend from
+	const SimulationSnapshot &prev = (prevState.scene == state.scene) ? prevState : state;
 
 	//Background image
-	for (auto i = 0; i < Background.size(); i++) {
-		Background[i]->execute(dx12->GetColor(255, 255, 255, alpha), xAdjust[i]);
+	sprites->Begin();
+	for (auto i = 0; i < 2; i++) {
+		//Do not interpolate across the wrap around
+		float x = state.backgroundX[i];
+		if (prev.backgroundX[i] >= state.backgroundX[i]) {
+			x = Lerp(prev.backgroundX[i], state.backgroundX[i], interpolation);
+		}
+		sprites->Draw(ScreenSprite(Background, dx12->GetColor(255, 255, 255, state.alpha), x, 0));
 	}
+	sprites->Flush();
 
 	//player
-	drawPlayer->execute(dx12->GetColor(255, 255, 255, alpha), player.GetPlayerPositionMatrix());
+	const Position3D playerPos = Lerp(prev.player, state.player, interpolation);
+	drawPlayer->execute(dx12->GetColor(255, 255, 255, state.alpha), DirectX::XMMatrixTranslation(playerPos.x, playerPos.y, playerPos.z));
 
 	//enemy
-	for (auto i = 0; i < enemyObject.size(); i++) {
-		if (enemyFlag[i]) {
-			enemyObject[i]->execute(dx12->GetColor(255, 255, 255, alpha), DirectX::XMMatrixTranslation(enemyPos[i].x, enemyPos[i].y, enemyPos[i].z));
+	const float enemyAngle = Lerp(prev.enemyAngle, state.enemyAngle, interpolation);
+	DirectX::XMFLOAT4X4 enemyRot;
+	DirectX::XMStoreFloat4x4(&enemyRot, DirectX::XMMatrixRotationY(DirectX::XMConvertToRadians(enemyAngle)));
+
+	const DirectX::XMFLOAT4 enemyColor = dx12->GetColor(255, 255, 255, state.alpha);
+	enemyInstances.Begin(&enemyRot._11);
+	for (auto i = 0; i < enemyCount; i++) {
+		if (state.enemyActive[i]) {
+			//Respawned: no previous position to blend from
+			Position3D pos = state.enemy[i];
+			if (prev.enemyActive[i]) {
+				pos = Lerp(prev.enemy[i], pos, interpolation);
+			}
+			enemyInstances.Add(pos, &enemyColor.x);
 		}
 	}
+	drawEnemy->executeInstanced(enemyInstances);
 
 	//projectile
-	if (bullet.GetActiveFlag()) {
-		DrawBullet->execute(dx12->GetColor(138, 119, 183, alpha), bullet.GetBulletPositionMatrix());
-	}
-
-	BackHome->execute(dx12->GetColor(255, 255, 255, alpha), 0);
-#pragma endregion
-
-#pragma region SceneSetting
-	if (input->GetKeyDown(keycode::H)) {
-		titleFlag = true;
-	}
-
-	if (titleFlag == true) {
-		alpha -= 3.0f;
-
-		if (alpha <= 0.1f) {
-			SceneNum = 0;
-			titleFlag = false;
-			alpha = 255;
+	DirectX::XMFLOAT4X4 bulletRot;
+	DirectX::XMStoreFloat4x4(&bulletRot, DirectX::XMMatrixRotationZ(DirectX::XMConvertToRadians(-90.0f)));
+
+	const DirectX::XMFLOAT4 bulletColor = dx12->GetColor(138, 119, 183, state.alpha);
+	bulletInstances.Begin(&bulletRot._11);
+	for (uint32_t i = 0; i < state.bulletCount; i++) {
+		//Just fired: no previous position to blend from
+		Position3D pos = state.bullet[i];
+		const int prevIndex = FindBullet(prev, state.bulletId[i]);
+		if (prevIndex >= 0) {
+			pos = Lerp(prev.bullet[prevIndex], pos, interpolation);
 		}
+		bulletInstances.Add(pos, &bulletColor.x);
 	}
-	else {
-		if (alpha <= 255) {
-			alpha += 3.0f;
-		}
-		if (alpha > 255) {
-			alpha = 255;
-		}
-	}
-#pragma endregion
+	DrawBullet->executeInstanced(bulletInstances);
 
-}
\ No newline at end of file
+	//HUD
+	sprites->Begin();
+	sprites->Draw(ScreenSprite(BackHome, dx12->GetColor(255, 255, 255, state.alpha), 0.0f, 0));
+	sprites->Flush();
+}
@@ -1,51 +1,73 @@
 #pragma once
+
+//Command line: -seed N, -record file, -replay file, -profile file
+struct SessionOptions
+{
+	uint64_t seed = 0;
+	std::wstring recordPath;	//Empty = no recording
+	std::wstring replayPath;	//Inputs come from the file until it ends, then from the keyboard
+	std::wstring profilePath;	//Chrome trace of the whole session, written on exit
+};
+
 class GamePlay
 {
 public:
-	GamePlay(Win32 *win32, DirectX12 *dx12, Input *input, const int window_width, const int window_height);
+	GamePlay(Win32 *win32, DirectX12 *dx12, InputBackend *input, const int window_width, const int window_height, const SessionOptions &session);
 	~GamePlay();
 	void Update();
 
 private:
-	void Title();
-	void GameScene();
+	/// <summary>
+	/// Input of this tick: the replay while it lasts, the keyboard after
+	/// </summary>
+	SimInput NextInput();
+
+	//Record the tick and compare it with the replay
+	void AfterTick(const SimInput &tickInput);
+	void TitleDraw(const SimulationSnapshot &state, const float interpolation);
+	void GameSceneDraw(const SimulationSnapshot &state, const float interpolation);
+	Sprite ScreenSprite(const uint32_t texture, const DirectX::XMFLOAT4 color, const float adjustXPos, const uint32_t layer) const;
 
 private:
 	Win32 *win32;
 	DirectX12 *dx12;
 	ID3D12Device *dev;
-	ID3D12GraphicsCommandList *cmdList;
-	Input *input;
+	RenderCommandList *cmdList;
+	InputBackend *input;
+	InputQueue keys;
 	const int window_width;
 	const int window_height;
 
+	//Simulation runs at a fixed rate, rendering interpolates between ticks
+	FixedTimestep timestep;
+	GameSimulation simulation;
+	SimulationSnapshot prevState;
+
+	//Session recording / replay (SimulationSoak --replay runs the same file headless)
+	std::ofstream recordFile;
+	InputRecorder recorder;
+	std::ifstream replayFile;
+	InputReplay replay;
+	bool replaying;
+
+	//CPU / GPU capture (Profiler)
+	std::wstring profilePath;
+
 private:
-	PlayerOP player;
 	Draw3D *drawPlayer;
 
-	Bullet bullet;
+	//Every live bullet in one instanced call
 	Draw3D *DrawBullet;
+	InstancePacker bulletInstances;
 
-	std::vector<Draw3D *> enemyObject;
-	std::vector<Draw2DGraph*> Background;
-
-	Position3D enemyPos[2] = {
-		{20, rand() % 50 - 25.0f, 0},
-		{20, rand() % 50 - 25.0f, 0}
-	};
-
-	bool enemyFlag[2]		= { true,  true };
-	bool enemyTurnFlag[2]	= { false, false };
-	int enemyWaitTime[2]	= { 0,		0 };
-	float enemySpeed[2]		= { 0.5f,	1.0f };
-	float xAdjust[2]		= { 0, 2 };
-
-	Draw2DGraph *TitleBG;
-	Draw2DGraph *TitleMessage;
-	Draw2DGraph *BackHome;
-	bool titleFlag;
-	float alpha;
-	int SceneNum;
-	int Timer;
-};
+	//All enemies share one mesh, drawn with one instanced call
+	Draw3D *drawEnemy;
+	InstancePacker enemyInstances;
 
+	//2D (title / background / HUD)
+	SpriteRenderer *sprites;
+	uint32_t Background;
+	uint32_t TitleBG;
+	uint32_t TitleMessage;
+	uint32_t BackHome;
+};
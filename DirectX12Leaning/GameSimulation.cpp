@@ -0,0 +1,242 @@
+//STL
+#include <algorithm>
+#include <cmath>
+
+//this
+#include "GameSimulation.h"
+
+namespace
+{
+	const float enemySpeed[enemyCount] = { 30.0f, 60.0f };
+}
+
+GameSimulation::GameSimulation(const uint64_t seed) :
+	random(seed),
+	bullets(bulletCapacity, 60.0f, 3),
+	enemies(enemyCount)
+{
+	player = PlayerOP(0, 0, 0, 5);
+
+	//Three way spread per press
+	BulletPattern pattern;
+	pattern.shots = 3;
+	pattern.spread = 20.0f;
+	bullets.SetPattern(pattern);
+
+	//No allocation while playing
+	collision.Reserve(bulletCapacity + enemyCount);
+	collisionPairs.reserve(bulletCapacity * enemyCount);
+	expiredBullets.reserve(bulletCapacity);
+
+	for (auto i = 0; i < enemyCount; ++i) {
+		enemies.Spawn(20, random.Range(50) - 25.0f, 0, -enemySpeed[i], EnemyFlag_Active);
+	}
+
+	titleFlag = false;
+	WriteSnapshot();
+}
+
+void GameSimulation::Reset(const uint64_t seed)
+{
+	*this = GameSimulation(seed);
+}
+
+void GameSimulation::Tick(const SimInput &input, const float deltaTime)
+{
+	switch (state.scene)
+	{
+		case SceneType::Title: {
+			TitleUpdate(input, deltaTime);
+			break;
+		}
+		case SceneType::Game: {
+			GameSceneUpdate(input, deltaTime);
+			break;
+		}
+
+		default: break;
+	}
+
+	state.tick++;
+	WriteSnapshot();
+}
+
+const SimulationSnapshot &GameSimulation::GetSnapshot() const
+{
+	return state;
+}
+
+uint64_t GameSimulation::GetStateHash() const
+{
+	StateHash hash;
+	hash.WriteValue(state.scene);
+	hash.WriteValue(state.tick);
+	hash.WriteValue(state.alpha);
+	hash.WriteValue(state.timer);
+	hash.WriteValue(state.backgroundX);
+	hash.WriteValue(state.enemyAngle);
+	hash.WriteValue(titleFlag);
+	hash.WriteValue(random.GetState());
+
+	const Position3D playerPos = player.Get3DPoint();
+	hash.WriteValue(playerPos.x);
+	hash.WriteValue(playerPos.y);
+	hash.WriteValue(playerPos.z);
+
+	enemies.WriteState(hash);
+	bullets.WriteState(hash);
+	return hash.Get();
+}
+
+void GameSimulation::TitleUpdate(const SimInput &input, const float deltaTime)
+{
+	state.timer += deltaTime;
+	if (state.timer > 1.0f) {
+		state.timer = 0;
+	}
+	if (input.GetKeyDown(SimButton_Fire)) {
+		titleFlag = true;
+	}
+
+	if (titleFlag == true) {
+		state.alpha -= 180.0f * deltaTime;
+	}
+
+	if (state.alpha <= 0.1f) {
+		state.scene = SceneType::Game;
+		titleFlag = false;
+	}
+}
+
+void GameSimulation::GameSceneUpdate(const SimInput &input, const float deltaTime)
+{
+#pragma region UpdateProcess
+	//Background position adjust
+	for (int i = 0; i < 2; i++) {
+		if (state.backgroundX[i] <= -1.99f) {
+			state.backgroundX[i] = 2.0f;
+		}
+		state.backgroundX[i] -= 0.6f * deltaTime;
+	}
+
+	//Enemy
+	ResolveBulletHits();
+
+	float *enemyX = enemies.GetX();
+	float *enemyY = enemies.GetY();
+	float *enemyVelocityY = enemies.GetVelocityY();
+	float *enemyWaitTime = enemies.GetTimer();
+	uint32_t *enemyFlags = enemies.GetFlags();
+	const uint32_t count = enemies.GetCount();
+
+	//Respawn in enemy order, random is drawn in the same sequence every run
+	for (uint32_t i = 0; i < count; ++i) {
+		if ((enemyFlags[i] & EnemyFlag_Active) == 0) {
+			enemyWaitTime[i] += deltaTime;
+
+			if (enemyWaitTime[i] > 1.0f) {
+				enemyX[i] = (float)random.Range(51);
+				enemyY[i] = (float)random.Range(50) - 25;
+				enemyWaitTime[i] = 0;
+				enemyFlags[i] |= EnemyFlag_Active;
+			}
+		}
+	}
+
+	//Turn at the edges, waiting enemies keep their direction
+	for (uint32_t i = 0; i < count; ++i) {
+		if ((enemyFlags[i] & EnemyFlag_Active) != 0) {
+			if (enemyY[i] <= -25) { enemyVelocityY[i] = std::fabs(enemyVelocityY[i]); }
+			if (enemyY[i] >= 25) { enemyVelocityY[i] = -std::fabs(enemyVelocityY[i]); }
+		}
+	}
+	enemies.Integrate(deltaTime);
+	state.enemyAngle -= 600.0f * deltaTime;
+
+	player.Update(input, deltaTime);
+	bullets.Update(input, player.Get3DPoint(), deltaTime);
+#pragma endregion
+
+#pragma region SceneSetting
+	if (input.GetKeyDown(SimButton_Home)) {
+		titleFlag = true;
+	}
+
+	if (titleFlag == true) {
+		state.alpha -= 180.0f * deltaTime;
+
+		if (state.alpha <= 0.1f) {
+			state.scene = SceneType::Title;
+			titleFlag = false;
+			state.alpha = 255;
+		}
+	}
+	else {
+		if (state.alpha <= 255) {
+			state.alpha += 180.0f * deltaTime;
+		}
+		if (state.alpha > 255) {
+			state.alpha = 255;
+		}
+	}
+#pragma endregion
+}
+
+void GameSimulation::ResolveBulletHits()
+{
+	const EntityStore &live = bullets.GetBullets();
+	if (live.GetCount() == 0) {
+		return;
+	}
+
+	collision.Clear();
+
+	//Enemy i is body i, bullet n is body enemyCount + n, so a pair is always (enemy, bullet)
+	for (uint32_t i = 0; i < enemies.GetCount(); ++i) {
+		collision.Insert(enemies.GetX()[i], enemies.GetY()[i], enemyRadius, CollisionGroup_Enemy, CollisionGroup_Bullet);
+	}
+	for (uint32_t i = 0; i < live.GetCount(); ++i) {
+		collision.Insert(live.GetX()[i], live.GetY()[i], bullets.GetRadius(), CollisionGroup_Bullet, CollisionGroup_Enemy);
+	}
+	collision.Build();
+
+	if (collision.QueryPairs(collisionPairs) == 0) {
+		return;
+	}
+
+	//Per bullet, lowest enemy first
+	std::sort(collisionPairs.begin(), collisionPairs.end(), [](const CollisionPair &l, const CollisionPair &r) {
+		return l.b != r.b ? l.b < r.b : l.a < r.a;
+	});
+
+	expiredBullets.clear();
+	for (auto &pair : collisionPairs) {
+		const uint32_t bullet = pair.b - enemies.GetCount();
+		if (!expiredBullets.empty() && expiredBullets.back() == bullet) {
+			continue;
+		}
+		enemies.GetFlags()[pair.a] &= ~EnemyFlag_Active;
+		expiredBullets.push_back(bullet);
+	}
+
+	//Highest index first, so the ones still to expire keep their index
+	for (auto i = expiredBullets.rbegin(); i != expiredBullets.rend(); ++i) {
+		bullets.ExpireAt(*i);
+	}
+}
+
+void GameSimulation::WriteSnapshot()
+{
+	state.player = player.Get3DPoint();
+	const EntityStore &live = bullets.GetBullets();
+	state.bulletCount = std::min(live.GetCount(), bulletCapacity);
+	for (uint32_t i = 0; i < state.bulletCount; ++i) {
+		state.bulletId[i] = live.GetHandle(i);
+		state.bullet[i] = { live.GetX()[i], live.GetY()[i], 0 };
+	}
+
+	for (uint32_t i = 0; i < enemies.GetCount(); ++i) {
+		state.enemy[i] = { enemies.GetX()[i], enemies.GetY()[i], 0 };
+		state.enemyActive[i] = (enemies.GetFlags()[i] & EnemyFlag_Active) != 0;
+	}
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "SimulationTypes.h"
+#include "PlayerOP.h"
+#include "BulletPool.h"
+#include "EntityStore.h"
+#include "SimRandom.h"
+#include "SpatialHash.h"
+
+enum class SceneType {
+	Title,
+	Game
+};
+
+const int enemyCount = 2;
+const uint32_t bulletCapacity = 64;
+const float enemyRadius = 2.0f;
+
+//EntityStore flags of an enemy
+enum EnemyFlag : uint32_t {
+	EnemyFlag_Active = 1 << 0,	//Off while waiting to respawn
+};
+
+//SpatialHash group / mask bits
+enum CollisionGroup : uint32_t {
+	CollisionGroup_Bullet	= 1 << 0,
+	CollisionGroup_Enemy	= 1 << 1,
+};
+
+//Read only view of the simulation for the renderer
+struct SimulationSnapshot
+{
+	SceneType scene = SceneType::Title;
+	uint64_t tick = 0;
+
+	//Title / fade
+	float alpha = 255;
+	float timer = 0;
+
+	//Background scroll (screen units, -2 - 2)
+	float backgroundX[2] = { 0, 2 };
+
+	Position3D player;
+
+	//Live bullets, id matches the same bullet across snapshots
+	uint32_t bulletCount = 0;
+	EntityHandle bulletId[bulletCapacity];
+	Position3D bullet[bulletCapacity];
+
+	bool enemyActive[enemyCount] = {};
+	Position3D enemy[enemyCount];
+	float enemyAngle = 0;	//degrees
+};
+
+class GameSimulation
+{
+public:
+	/// <param name="seed">Enemy respawns, the same seed and inputs replay the same game</param>
+	GameSimulation(const uint64_t seed = 0);
+
+	//Start over as if constructed with seed
+	void Reset(const uint64_t seed);
+
+	/// <summary>
+	/// Advance the simulation by one fixed tick
+	/// </summary>
+	/// <param name="input">Button state for this tick</param>
+	/// <param name="deltaTime">Tick length (seconds)</param>
+	void Tick(const SimInput &input, const float deltaTime);
+
+	const SimulationSnapshot &GetSnapshot() const;
+
+	/// <summary>
+	/// Hash of everything the next tick depends on (InputRecorder / InputReplay divergence checks)
+	/// </summary>
+	uint64_t GetStateHash() const;
+
+private:
+	void TitleUpdate(const SimInput &input, const float deltaTime);
+	void GameSceneUpdate(const SimInput &input, const float deltaTime);
+
+	/// <summary>
+	/// Every bullet touching an enemy expires and takes down the lowest numbered enemy it touches
+	/// </summary>
+	void ResolveBulletHits();
+	void WriteSnapshot();
+
+private:
+	SimulationSnapshot state;
+	SimRandom random;
+
+	PlayerOP player;
+	BulletPool bullets;
+
+	//Rebuilt every tick, buffers are kept
+	SpatialHash collision;
+	std::vector<CollisionPair> collisionPairs;
+	std::vector<uint32_t> expiredBullets;
+
+	//Never despawned, dense index = enemy number.
+	//Velocity y is +-speed (sign = direction), timer is the respawn wait
+	EntityStore enemies;
+
+	bool titleFlag;
+};
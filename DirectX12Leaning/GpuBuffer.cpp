@@ -0,0 +1,88 @@
+//API
+#include <Windows.h>
+#include <d3d12.h>
+#include <d3dx12.h>
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+
+//STL
+#include <vector>
+#include <assert.h>
+
+//Utility
+#include "DirectX12.h"
+
+//this
+#include "GpuBuffer.h"
+
+GpuBuffer::GpuBuffer() :
+	dx12(nullptr),
+	buffer(nullptr),
+	size(0),
+	readState(D3D12_RESOURCE_STATE_COMMON),
+	state(D3D12_RESOURCE_STATE_COMMON)
+{
+}
+
+GpuBuffer::~GpuBuffer()
+{
+	if (buffer != nullptr) {
+		buffer->Release();
+	}
+}
+
+void GpuBuffer::Create(DirectX12 *dx12, const uint64_t size, const D3D12_RESOURCE_STATES readState)
+{
+	this->dx12 = dx12;
+	this->size = size;
+	this->readState = readState;
+	this->state = D3D12_RESOURCE_STATE_COMMON;
+
+	//D3D12 creates buffers in COMMON whatever state is passed
+	result = dx12->GetDevice()->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(size),
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&buffer)
+	);
+	assert(result == S_OK);
+}
+
+bool GpuBuffer::Upload(const void *data, const uint64_t offset, const uint64_t size)
+{
+	assert(offset + size <= this->size);
+
+	//Staging memory is recycled with the frame
+	const UploadAllocation staging = dx12->GetUploadRing()->Allocate(size);
+	if (staging.cpu == nullptr) {
+		return false;
+	}
+	memcpy(staging.cpu, data, (size_t)size);
+
+	RenderCommandList *cmdList = dx12->GetCommandList();
+	cmdList->Upload(size);
+	if (state != D3D12_RESOURCE_STATE_COPY_DEST) {
+		cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(buffer, state, D3D12_RESOURCE_STATE_COPY_DEST));
+	}
+	cmdList->CopyBufferRegion(buffer, offset, staging.resource, staging.offset, size);
+	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(buffer, D3D12_RESOURCE_STATE_COPY_DEST, readState));
+	state = readState;
+	return true;
+}
+
+ID3D12Resource *GpuBuffer::GetResource() const
+{
+	return buffer;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS GpuBuffer::GetGPUVirtualAddress() const
+{
+	return buffer->GetGPUVirtualAddress();
+}
+
+uint64_t GpuBuffer::GetSize() const
+{
+	return size;
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+class DirectX12;
+
+/// <summary>
+/// Buffer in DEFAULT heap, written only through copies from the upload ring
+/// </summary>
+class GpuBuffer
+{
+public:
+	GpuBuffer();
+	~GpuBuffer();
+
+	/// <summary>
+	/// Buffers are created in COMMON, the first Upload moves it to readState
+	/// </summary>
+	/// <param name="readState">State the buffer is used in (vertex / index / ...)</param>
+	void Create(DirectX12 *dx12, const uint64_t size, const D3D12_RESOURCE_STATES readState);
+
+	/// <summary>
+	/// Copy data into [offset, offset + size) on the frame command list
+	/// </summary>
+	/// <returns>false when the upload ring cannot hold it (nothing recorded)</returns>
+	bool Upload(const void *data, const uint64_t offset, const uint64_t size);
+
+	ID3D12Resource *GetResource() const;
+	D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const;
+	uint64_t GetSize() const;
+
+private:
+	HRESULT result;
+	DirectX12 *dx12;
+	ID3D12Resource *buffer;
+	uint64_t size;
+	D3D12_RESOURCE_STATES readState;
+	D3D12_RESOURCE_STATES state;	//After the last recorded barrier
+};
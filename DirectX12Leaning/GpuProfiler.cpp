@@ -0,0 +1,183 @@
+//API
+#include <Windows.h>
+#include <d3d12.h>
+#include <d3dx12.h>
+
+//STL
+#include <assert.h>
+
+//Utility
+#include "Profiler.h"
+
+//this
+#include "GpuProfiler.h"
+
+GpuProfiler::GpuProfiler(const int frameCount, const uint32_t regionCount) :
+	result(S_FALSE),
+	queue(nullptr),
+	queryHeap(nullptr),
+	readback(nullptr),
+	regionCount(regionCount),
+	frames(frameCount),
+	frameIndex(0),
+	gpuFrequency(1),
+	calibrationGpu(0),
+	calibrationCpu(0)
+{
+	for (auto &frame : frames) {
+		frame.names.reserve(regionCount);
+		frame.fenceValue = 0;
+		frame.pending = false;
+	}
+}
+
+GpuProfiler::~GpuProfiler()
+{
+	if (queryHeap != nullptr) {
+		queryHeap->Release();
+	}
+	if (readback != nullptr) {
+		readback->Release();
+	}
+}
+
+void GpuProfiler::Initialize(ID3D12Device *dev, ID3D12CommandQueue *queue)
+{
+	this->queue = queue;
+	const uint32_t queryCount = (uint32_t)frames.size() * regionCount * 2;
+
+	D3D12_QUERY_HEAP_DESC heapDesc{};
+	heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+	heapDesc.Count = queryCount;
+	result = dev->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&queryHeap));
+	assert(result == S_OK);
+
+	result = dev->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(sizeof(uint64_t) * queryCount),
+		D3D12_RESOURCE_STATE_COPY_DEST,
+		nullptr,
+		IID_PPV_ARGS(&readback)
+	);
+	assert(result == S_OK);
+
+	result = queue->GetTimestampFrequency(&gpuFrequency);
+	assert(result == S_OK);
+	Calibrate();
+}
+
+uint32_t GpuProfiler::Begin(RenderCommandList *cmdList, const char *name)
+{
+	if (!Profiler::Get().IsCapturing()) {
+		return invalidRegion;
+	}
+
+	std::unique_lock<std::mutex> lock(beginMutex);
+	Frame &frame = frames[frameIndex];
+
+	//Slot not read back yet (more frames in flight than slots) or full
+	if (frame.pending || frame.names.size() >= regionCount) {
+		return invalidRegion;
+	}
+
+	const uint32_t region = (uint32_t)frame.names.size();
+	frame.names.push_back(name);
+	lock.unlock();
+
+	cmdList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, GetQuery(region));
+	return region;
+}
+
+void GpuProfiler::End(RenderCommandList *cmdList, const uint32_t region)
+{
+	if (region == invalidRegion) {
+		return;
+	}
+	cmdList->EndQuery(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, GetQuery(region) + 1);
+}
+
+void GpuProfiler::Resolve(RenderCommandList *cmdList)
+{
+	const Frame &frame = frames[frameIndex];
+	if (frame.pending || frame.names.empty()) {
+		return;
+	}
+
+	const uint32_t first = GetQuery(0);
+	cmdList->ResolveQueryData(queryHeap, D3D12_QUERY_TYPE_TIMESTAMP, first, (UINT)frame.names.size() * 2, readback, sizeof(uint64_t) * first);
+}
+
+void GpuProfiler::EndFrame(const uint64_t fenceValue)
+{
+	Frame &frame = frames[frameIndex];
+	if (!frame.pending && !frame.names.empty()) {
+		frame.fenceValue = fenceValue;
+		frame.pending = true;
+	}
+
+	frameIndex = (frameIndex + 1) % (int)frames.size();
+}
+
+void GpuProfiler::Retire(const uint64_t completedFenceValue)
+{
+	bool calibrated = false;
+
+	for (int i = 0; i < (int)frames.size(); ++i) {
+		Frame &frame = frames[i];
+		if (!frame.pending || frame.fenceValue > completedFenceValue) {
+			continue;
+		}
+
+		//Clocks drift apart, calibrate once per read back
+		if (!calibrated) {
+			Calibrate();
+			calibrated = true;
+		}
+
+		const uint32_t first = (uint32_t)i * regionCount * 2;
+		const uint32_t count = (uint32_t)frame.names.size() * 2;
+		const D3D12_RANGE readRange = { sizeof(uint64_t) * first, sizeof(uint64_t) * (first + count) };
+		const D3D12_RANGE writeRange = { 0, 0 };
+
+		uint64_t *ticks = nullptr;
+		result = readback->Map(0, &readRange, (void **)&ticks);
+		assert(result == S_OK);
+
+		for (uint32_t region = 0; region < (uint32_t)frame.names.size(); ++region) {
+			const uint64_t begin = ticks[first + region * 2];
+			const uint64_t end = ticks[first + region * 2 + 1];
+			Profiler::Get().RecordGpu(frame.names[region], ToCpuTime(begin), ToCpuTime(end));
+		}
+
+		readback->Unmap(0, &writeRange);
+
+		frame.names.clear();
+		frame.pending = false;
+	}
+}
+
+uint32_t GpuProfiler::GetQuery(const uint32_t region) const
+{
+	return ((uint32_t)frameIndex * regionCount + region) * 2;
+}
+
+int64_t GpuProfiler::ToCpuTime(const uint64_t ticks) const
+{
+	const int64_t elapsed = (int64_t)(ticks - calibrationGpu);
+	return calibrationCpu + (int64_t)((double)elapsed * 1e9 / (double)gpuFrequency);
+}
+
+void GpuProfiler::Calibrate()
+{
+	uint64_t cpuTicks = 0;
+	result = queue->GetClockCalibration(&calibrationGpu, &cpuTicks);
+	assert(result == S_OK);
+
+	//QueryPerformanceCounter -> nanoseconds the way MSVC steady_clock converts it
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	const int64_t qpcFrequency = frequency.QuadPart;
+	const int64_t counter = (int64_t)cpuTicks;
+	calibrationCpu = (counter / qpcFrequency) * 1000000000 + (counter % qpcFrequency) * 1000000000 / qpcFrequency;
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <mutex>
+#include <vector>
+#include "Profiler.h"
+#include "RenderCommandList.h"
+
+//Timestamp regions one frame may record, later ones are skipped
+const uint32_t gpuProfileRegionCount = 256;
+
+/// <summary>
+/// GPU time of command list regions as timestamp queries, reported to Profiler
+/// </summary>
+/// <remarks>
+/// Each frame slot owns a range of the query heap and of the readback buffer.
+/// ScreenFlip resolves the frame before closing the list; once its fence completes the
+/// ticks are moved onto the Profiler::Now clock (GetClockCalibration) and recorded.
+/// Nothing is recorded while Profiler is not capturing.
+/// </remarks>
+class GpuProfiler
+{
+public:
+	static const uint32_t invalidRegion = UINT32_MAX;
+
+	/// <param name="frameCount">Frame slots, more than the frames in flight</param>
+	GpuProfiler(const int frameCount, const uint32_t regionCount = gpuProfileRegionCount);
+	~GpuProfiler();
+	void Initialize(ID3D12Device *dev, ID3D12CommandQueue *queue);
+
+	/// <summary>
+	/// Timestamp before the following commands
+	/// </summary>
+	/// <param name="name">String literal</param>
+	/// <returns>invalidRegion when not capturing / out of regions</returns>
+	/// <remarks>Any thread (parallel command lists), End / Resolve / frame calls stay on the render thread</remarks>
+	uint32_t Begin(RenderCommandList *cmdList, const char *name);
+	void End(RenderCommandList *cmdList, const uint32_t region);
+
+	//Copy the timestamps of this frame to the readback buffer (last command of the frame)
+	void Resolve(RenderCommandList *cmdList);
+
+	//Called by DirectX12::ScreenFlip
+	void EndFrame(const uint64_t fenceValue);
+	void Retire(const uint64_t completedFenceValue);
+
+private:
+	struct Frame
+	{
+		std::vector<const char *> names;	//Region -> name
+		uint64_t fenceValue;
+		bool pending;						//Submitted, not read back yet
+	};
+
+	//First query of region in the current frame slot
+	uint32_t GetQuery(const uint32_t region) const;
+
+	//GPU ticks -> Profiler::Now
+	int64_t ToCpuTime(const uint64_t ticks) const;
+	void Calibrate();
+
+private:
+	HRESULT result;
+	ID3D12CommandQueue *queue;
+	ID3D12QueryHeap *queryHeap;
+	ID3D12Resource *readback;
+
+	const uint32_t regionCount;
+	std::vector<Frame> frames;
+	int frameIndex;
+	std::mutex beginMutex;		//Region allocation of parallel recording threads
+
+	//Clock calibration
+	uint64_t gpuFrequency;
+	uint64_t calibrationGpu;
+	int64_t calibrationCpu;
+};
+
+/// <summary>
+/// GPU time of the enclosing block's commands
+/// </summary>
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(GpuProfiler *profiler, RenderCommandList *cmdList, const char *name) :
+		profiler(profiler),
+		cmdList(cmdList),
+		region(profiler->Begin(cmdList, name))
+	{
+	}
+
+	~GpuProfileScope()
+	{
+		profiler->End(cmdList, region);
+	}
+
+	GpuProfileScope(const GpuProfileScope &) = delete;
+	GpuProfileScope &operator=(const GpuProfileScope &) = delete;
+
+private:
+	GpuProfiler *profiler;
+	RenderCommandList *cmdList;
+	uint32_t region;
+};
+
+#if PROFILER_ENABLED
+#define GPU_PROFILE_SCOPE(profiler, cmdList, name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(profiler, cmdList, name)
+#else
+#define GPU_PROFILE_SCOPE(profiler, cmdList, name) ((void)0)
+#endif
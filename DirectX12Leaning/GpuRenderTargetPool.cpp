@@ -0,0 +1,167 @@
+//API
+#include <d3d12.h>
+#include <d3dx12.h>
+
+//STL
+#include <assert.h>
+
+//this
+#include "GpuRenderTargetPool.h"
+
+namespace
+{
+	bool IsDepthFormat(const DXGI_FORMAT format)
+	{
+		return format == DXGI_FORMAT_D32_FLOAT || format == DXGI_FORMAT_D24_UNORM_S8_UINT ||
+			format == DXGI_FORMAT_D16_UNORM || format == DXGI_FORMAT_D32_FLOAT_S8X24_UINT;
+	}
+}
+
+GpuRenderTargetPool::GpuRenderTargetPool(const uint32_t rtvCapacity, const uint32_t dsvCapacity) :
+	dev(nullptr),
+	rtvHeap(nullptr),
+	dsvHeap(nullptr),
+	rtvAllocator(rtvCapacity, 0),
+	dsvAllocator(dsvCapacity, 0),
+	rtvSize(0),
+	dsvSize(0)
+{
+}
+
+GpuRenderTargetPool::~GpuRenderTargetPool()
+{
+	pool.Clear();
+
+	if (rtvHeap != nullptr) {
+		rtvHeap->Release();
+	}
+	if (dsvHeap != nullptr) {
+		dsvHeap->Release();
+	}
+}
+
+void GpuRenderTargetPool::Initialize(ID3D12Device *dev)
+{
+	this->dev = dev;
+
+	D3D12_DESCRIPTOR_HEAP_DESC heapDesc{};
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_RTV;
+	heapDesc.NumDescriptors = rtvAllocator.GetCapacity();
+	result = dev->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&rtvHeap));
+	assert(result == S_OK);
+
+	heapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_DSV;
+	heapDesc.NumDescriptors = dsvAllocator.GetCapacity();
+	result = dev->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&dsvHeap));
+	assert(result == S_OK);
+
+	rtvSize = dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+	dsvSize = dev->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+
+	pool.Initialize(
+		[this](const RenderTargetDesc &desc, uint64_t &sizeInBytes) { return Create(desc, sizeInBytes); },
+		[this](GpuRenderTarget *target) { Destroy(target); }
+	);
+}
+
+GpuRenderTarget *GpuRenderTargetPool::Acquire(const uint32_t width, const uint32_t height, const DXGI_FORMAT format)
+{
+	RenderTargetDesc desc{};
+	desc.width = width;
+	desc.height = height;
+	desc.format = (uint32_t)format;
+	return pool.Acquire(desc);
+}
+
+void GpuRenderTargetPool::Release(GpuRenderTarget *target)
+{
+	pool.Release(target);
+}
+
+void GpuRenderTargetPool::EndFrame(const uint64_t fenceValue)
+{
+	pool.EndFrame(fenceValue);
+	rtvAllocator.EndFrame(fenceValue);
+	dsvAllocator.EndFrame(fenceValue);
+}
+
+void GpuRenderTargetPool::Retire(const uint64_t completedFenceValue)
+{
+	pool.Retire(completedFenceValue);
+	rtvAllocator.Retire(completedFenceValue);
+	dsvAllocator.Retire(completedFenceValue);
+}
+
+uint64_t GpuRenderTargetPool::GetAllocatedBytes() const
+{
+	return pool.GetAllocatedBytes();
+}
+
+size_t GpuRenderTargetPool::GetTargetCount() const
+{
+	return pool.GetTargetCount();
+}
+
+GpuRenderTarget *GpuRenderTargetPool::Create(const RenderTargetDesc &desc, uint64_t &sizeInBytes)
+{
+	const DXGI_FORMAT format = (DXGI_FORMAT)desc.format;
+	const bool depth = IsDepthFormat(format);
+
+	const CD3DX12_RESOURCE_DESC resDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+		format,
+		desc.width,
+		desc.height,
+		1, 1,
+		1, 0,
+		depth ? D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL : D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET
+	);
+
+	//Fast clear value
+	const float clearColor[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	const CD3DX12_CLEAR_VALUE clearValue = depth ? CD3DX12_CLEAR_VALUE(format, 1.0f, 0) : CD3DX12_CLEAR_VALUE(format, clearColor);
+
+	GpuRenderTarget *target = new GpuRenderTarget();
+	target->depth = depth;
+
+	result = dev->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&resDesc,
+		depth ? D3D12_RESOURCE_STATE_DEPTH_WRITE : D3D12_RESOURCE_STATE_RENDER_TARGET,
+		&clearValue,
+		IID_PPV_ARGS(&target->resource)
+	);
+	assert(result == S_OK);
+
+	sizeInBytes = dev->GetResourceAllocationInfo(0, 1, &resDesc).SizeInBytes;
+
+	if (depth) {
+		target->viewIndex = dsvAllocator.Allocate();
+		assert(target->viewIndex != DescriptorAllocator::invalidIndex);
+		target->view = CD3DX12_CPU_DESCRIPTOR_HANDLE(dsvHeap->GetCPUDescriptorHandleForHeapStart(), target->viewIndex, dsvSize);
+
+		D3D12_DEPTH_STENCIL_VIEW_DESC dsvDesc{};
+		dsvDesc.Format = format;
+		dsvDesc.ViewDimension = D3D12_DSV_DIMENSION_TEXTURE2D;
+		dev->CreateDepthStencilView(target->resource, &dsvDesc, target->view);
+	}
+	else {
+		target->viewIndex = rtvAllocator.Allocate();
+		assert(target->viewIndex != DescriptorAllocator::invalidIndex);
+		target->view = CD3DX12_CPU_DESCRIPTOR_HANDLE(rtvHeap->GetCPUDescriptorHandleForHeapStart(), target->viewIndex, rtvSize);
+		dev->CreateRenderTargetView(target->resource, nullptr, target->view);
+	}
+	return target;
+}
+
+void GpuRenderTargetPool::Destroy(GpuRenderTarget *target)
+{
+	if (target->depth) {
+		dsvAllocator.Free(target->viewIndex);
+	}
+	else {
+		rtvAllocator.Free(target->viewIndex);
+	}
+	target->resource->Release();
+	delete target;
+}
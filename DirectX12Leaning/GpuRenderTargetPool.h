@@ -0,0 +1,55 @@
+#pragma once
+#include "RenderTargetPool.h"
+#include "DescriptorAllocator.h"
+
+struct GpuRenderTarget
+{
+	ID3D12Resource *resource;
+
+	//RTV or DSV depending on the format
+	D3D12_CPU_DESCRIPTOR_HANDLE view;
+	uint32_t viewIndex;
+	bool depth;
+};
+
+/// <summary>
+/// Render / depth targets and their RTV / DSV heaps, shared by size and format
+/// </summary>
+class GpuRenderTargetPool
+{
+public:
+	GpuRenderTargetPool(const uint32_t rtvCapacity, const uint32_t dsvCapacity);
+	~GpuRenderTargetPool();
+	void Initialize(ID3D12Device *dev);
+
+	/// <summary>
+	/// Target in its write state (RENDER_TARGET / DEPTH_WRITE)
+	/// </summary>
+	/// <param name="format">D32 / D24S8 / D16 make a depth target</param>
+	GpuRenderTarget *Acquire(const uint32_t width, const uint32_t height, const DXGI_FORMAT format);
+	void Release(GpuRenderTarget *target);
+
+	//Called by DirectX12::ScreenFlip
+	void EndFrame(const uint64_t fenceValue);
+	void Retire(const uint64_t completedFenceValue);
+
+	//Video memory held by the pool
+	uint64_t GetAllocatedBytes() const;
+	size_t GetTargetCount() const;
+
+private:
+	GpuRenderTarget *Create(const RenderTargetDesc &desc, uint64_t &sizeInBytes);
+	void Destroy(GpuRenderTarget *target);
+
+private:
+	HRESULT result;
+	ID3D12Device *dev;
+	RenderTargetPool<GpuRenderTarget> pool;
+
+	ID3D12DescriptorHeap *rtvHeap;
+	ID3D12DescriptorHeap *dsvHeap;
+	DescriptorAllocator rtvAllocator;
+	DescriptorAllocator dsvAllocator;
+	UINT rtvSize;
+	UINT dsvSize;
+};
@@ -0,0 +1,595 @@
+//STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+//Utility
+#include "CacheKey.h"
+
+//this
+#include "ImageCodec.h"
+
+namespace
+{
+	uint16_t ReadU16(const uint8_t *p)
+	{
+		return (uint16_t)(p[0] | (p[1] << 8));
+	}
+
+	uint32_t ReadU32(const uint8_t *p)
+	{
+		return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	}
+
+	uint32_t FourCC(const char a, const char b, const char c, const char d)
+	{
+		return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+	}
+
+	std::string Extension(const std::string &path)
+	{
+		const size_t dot = path.find_last_of('.');
+		if (dot == std::string::npos) {
+			return std::string();
+		}
+
+		std::string ext = path.substr(dot + 1);
+		for (auto &c : ext) {
+			if (c >= 'A' && c <= 'Z') {
+				c = (char)(c - 'A' + 'a');
+			}
+		}
+		return ext;
+	}
+
+	//Radiance scanline: 4 channels, each run length encoded
+	bool ReadHDRScanline(const uint8_t *&p, const uint8_t *end, const uint32_t width, uint8_t *rgbe)
+	{
+		//Flat (uncompressed) scanline
+		const bool rle = width >= 8 && width < 0x8000 && end - p >= 4 && p[0] == 2 && p[1] == 2 && (((uint32_t)p[2] << 8) | p[3]) == width;
+		if (!rle) {
+			if ((size_t)(end - p) < (size_t)width * 4) {
+				return false;
+			}
+
+			//Old style RLE is not supported
+			if (width > 0 && p[0] == 1 && p[1] == 1 && p[2] == 1) {
+				return false;
+			}
+			memcpy(rgbe, p, (size_t)width * 4);
+			p += (size_t)width * 4;
+			return true;
+		}
+		p += 4;
+
+		for (uint32_t channel = 0; channel < 4; ++channel) {
+			uint32_t x = 0;
+			while (x < width) {
+				if (p >= end) {
+					return false;
+				}
+
+				uint32_t count = *p++;
+				if (count > 128) {
+					//Run
+					count -= 128;
+					if (count > width - x || p >= end) {
+						return false;
+					}
+					const uint8_t value = *p++;
+					for (uint32_t i = 0; i < count; ++i) {
+						rgbe[(x++) * 4 + channel] = value;
+					}
+				}
+				else {
+					//Literal
+					if (count == 0 || count > width - x || (size_t)(end - p) < count) {
+						return false;
+					}
+					for (uint32_t i = 0; i < count; ++i) {
+						rgbe[(x++) * 4 + channel] = *p++;
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	float SRGBToLinear(const float value)
+	{
+		return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+	}
+
+	float LinearToSRGB(const float value)
+	{
+		return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+	}
+
+	uint8_t ToUnorm8(const float value)
+	{
+		return (uint8_t)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f);
+	}
+
+	//2x2 box of the previous level, edge texels repeat on odd sizes
+	template<class Load, class Store>
+	void DownsampleMip(const uint8_t *src, const ImageMip &srcMip, uint8_t *dst, const ImageMip &dstMip, const uint32_t texelSize, Load load, Store store)
+	{
+		for (uint32_t y = 0; y < dstMip.height; ++y) {
+			const uint32_t y0 = std::min(y * 2, srcMip.height - 1);
+			const uint32_t y1 = std::min(y * 2 + 1, srcMip.height - 1);
+			for (uint32_t x = 0; x < dstMip.width; ++x) {
+				const uint32_t x0 = std::min(x * 2, srcMip.width - 1);
+				const uint32_t x1 = std::min(x * 2 + 1, srcMip.width - 1);
+
+				float a[4], b[4], c[4], d[4], out[4];
+				load(src + y0 * srcMip.rowPitch + x0 * texelSize, a);
+				load(src + y0 * srcMip.rowPitch + x1 * texelSize, b);
+				load(src + y1 * srcMip.rowPitch + x0 * texelSize, c);
+				load(src + y1 * srcMip.rowPitch + x1 * texelSize, d);
+				for (int i = 0; i < 4; ++i) {
+					out[i] = (a[i] + b[i] + c[i] + d[i]) * 0.25f;
+				}
+				store(out, dst + y * dstMip.rowPitch + x * texelSize);
+			}
+		}
+	}
+}
+
+ImageView ViewImage(const DecodedImage &image)
+{
+	return { image.width, image.height, image.format, image.mips.data(), (uint32_t)image.mips.size(), image.pixels.data() };
+}
+
+bool IsBlockCompressed(const uint32_t format)
+{
+	switch (format)
+	{
+		case ImageFormat_BC1:
+		case ImageFormat_BC2:
+		case ImageFormat_BC3:
+		case ImageFormat_BC4:
+		case ImageFormat_BC5:
+		case ImageFormat_BC7:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+uint32_t ImageElementSize(const uint32_t format)
+{
+	switch (format)
+	{
+		case ImageFormat_RGBA32F:	return 16;
+		case ImageFormat_RGBA16F:	return 8;
+		case ImageFormat_RGBA8:
+		case ImageFormat_RGBA8_SRGB:
+		case ImageFormat_BGRA8:		return 4;
+		case ImageFormat_BC1:
+		case ImageFormat_BC4:		return 8;
+		case ImageFormat_BC2:
+		case ImageFormat_BC3:
+		case ImageFormat_BC5:
+		case ImageFormat_BC7:		return 16;
+
+		default:					return 0;
+	}
+}
+
+uint32_t ImageRowPitch(const uint32_t format, const uint32_t width)
+{
+	if (IsBlockCompressed(format)) {
+		return std::max(1u, (width + 3) / 4) * ImageElementSize(format);
+	}
+	return width * ImageElementSize(format);
+}
+
+uint32_t ImageRowCount(const uint32_t format, const uint32_t height)
+{
+	if (IsBlockCompressed(format)) {
+		return std::max(1u, (height + 3) / 4);
+	}
+	return height;
+}
+
+ImageMip &AppendImageMip(DecodedImage &image, const uint32_t width, const uint32_t height)
+{
+	ImageMip mip{};
+	mip.width = width;
+	mip.height = height;
+	mip.rowPitch = ImageRowPitch(image.format, width);
+	mip.rowCount = ImageRowCount(image.format, height);
+	mip.offset = image.pixels.size();
+
+	image.pixels.resize(image.pixels.size() + (size_t)mip.rowPitch * mip.rowCount);
+	image.mips.push_back(mip);
+	return image.mips.back();
+}
+
+uint32_t ImageMipCount(const uint32_t width, const uint32_t height)
+{
+	uint32_t count = 1;
+	for (uint32_t size = std::max(width, height); size > 1; size /= 2) {
+		++count;
+	}
+	return count;
+}
+
+bool GenerateImageMips(DecodedImage &image)
+{
+	if (image.mips.size() != 1) {
+		return false;
+	}
+
+	//sRGB is averaged in linear space, alpha is always linear
+	float toLinear[256];
+	for (int i = 0; i < 256; ++i) {
+		toLinear[i] = SRGBToLinear(i / 255.0f);
+	}
+
+	const auto loadUnorm = [](const uint8_t *p, float *out) {
+		for (int i = 0; i < 4; ++i) { out[i] = p[i] / 255.0f; }
+	};
+	const auto storeUnorm = [](const float *in, uint8_t *p) {
+		for (int i = 0; i < 4; ++i) { p[i] = ToUnorm8(in[i]); }
+	};
+	const auto loadSRGB = [&toLinear](const uint8_t *p, float *out) {
+		for (int i = 0; i < 3; ++i) { out[i] = toLinear[p[i]]; }
+		out[3] = p[3] / 255.0f;
+	};
+	const auto storeSRGB = [](const float *in, uint8_t *p) {
+		for (int i = 0; i < 3; ++i) { p[i] = ToUnorm8(LinearToSRGB(in[i])); }
+		p[3] = ToUnorm8(in[3]);
+	};
+	const auto loadFloat = [](const uint8_t *p, float *out) {
+		memcpy(out, p, sizeof(float) * 4);
+	};
+	const auto storeFloat = [](const float *in, uint8_t *p) {
+		memcpy(p, in, sizeof(float) * 4);
+	};
+
+	switch (image.format)
+	{
+		case ImageFormat_RGBA8:
+		case ImageFormat_RGBA8_SRGB:
+		case ImageFormat_BGRA8:
+		case ImageFormat_RGBA32F:
+			break;
+
+		default:
+			return false;
+	}
+
+	const uint32_t texelSize = ImageElementSize(image.format);
+	const uint32_t levels = ImageMipCount(image.width, image.height);
+	for (uint32_t level = 1; level < levels; ++level) {
+		const ImageMip &prev = image.mips[level - 1];
+		AppendImageMip(image, std::max(1u, prev.width / 2), std::max(1u, prev.height / 2));
+
+		//Pixels may have moved on append
+		const ImageMip &srcMip = image.mips[level - 1];
+		const ImageMip &dstMip = image.mips[level];
+		const uint8_t *src = image.pixels.data() + srcMip.offset;
+		uint8_t *dst = image.pixels.data() + dstMip.offset;
+
+		switch (image.format)
+		{
+			case ImageFormat_RGBA8_SRGB:	DownsampleMip(src, srcMip, dst, dstMip, texelSize, loadSRGB, storeSRGB); break;
+			case ImageFormat_RGBA32F:		DownsampleMip(src, srcMip, dst, dstMip, texelSize, loadFloat, storeFloat); break;
+			default:						DownsampleMip(src, srcMip, dst, dstMip, texelSize, loadUnorm, storeUnorm); break;
+		}
+	}
+	return true;
+}
+
+uint64_t HashImage(const DecodedImage &image)
+{
+	//Header fields one by one, struct padding is not content
+	uint64_t hash = HashBytes(&image.width, sizeof(image.width));
+	hash = HashBytes(&image.height, sizeof(image.height), hash);
+	hash = HashBytes(&image.format, sizeof(image.format), hash);
+	for (auto &mip : image.mips) {
+		hash = HashBytes(&mip.width, sizeof(mip.width), hash);
+		hash = HashBytes(&mip.height, sizeof(mip.height), hash);
+	}
+	return HashBytes(image.pixels.data(), image.pixels.size(), hash);
+}
+
+bool DecodeTGA(const uint8_t *data, const size_t size, DecodedImage &image)
+{
+	if (size < 18) {
+		return false;
+	}
+
+	const uint8_t idLength = data[0];
+	const uint8_t colorMapType = data[1];
+	const uint8_t imageType = data[2];
+	const uint32_t width = ReadU16(data + 12);
+	const uint32_t height = ReadU16(data + 14);
+	const uint8_t depth = data[16];
+	const uint8_t descriptor = data[17];
+
+	//Truecolor / grayscale, raw or RLE
+	const bool rle = imageType == 10 || imageType == 11;
+	const bool gray = imageType == 3 || imageType == 11;
+	if (colorMapType != 0 || (imageType != 2 && imageType != 3 && !rle) || width == 0 || height == 0) {
+		return false;
+	}
+	if ((gray && depth != 8) || (!gray && depth != 24 && depth != 32)) {
+		return false;
+	}
+
+	const uint32_t bytesPerPixel = depth / 8;
+	const uint8_t *p = data + 18 + idLength;
+	const uint8_t *end = data + size;
+	if (p > end) {
+		return false;
+	}
+
+	image = DecodedImage();
+	image.width = width;
+	image.height = height;
+	image.format = ImageFormat_RGBA8;
+	ImageMip &mip = AppendImageMip(image, width, height);
+
+	//Bottom up unless the descriptor says top left origin
+	const bool topDown = (descriptor & 0x20) != 0;
+
+	const auto store = [&](const uint32_t index, const uint8_t *pixel) {
+		const uint32_t x = index % width;
+		const uint32_t y = topDown ? index / width : height - 1 - index / width;
+		uint8_t *out = image.pixels.data() + mip.offset + (size_t)y * mip.rowPitch + (size_t)x * 4;
+		if (gray) {
+			out[0] = out[1] = out[2] = pixel[0];
+			out[3] = 255;
+		}
+		else {
+			//Stored BGR(A)
+			out[0] = pixel[2];
+			out[1] = pixel[1];
+			out[2] = pixel[0];
+			out[3] = bytesPerPixel == 4 ? pixel[3] : 255;
+		}
+	};
+
+	const uint32_t pixelCount = width * height;
+	uint32_t index = 0;
+	while (index < pixelCount) {
+		if (!rle) {
+			if ((size_t)(end - p) < bytesPerPixel) {
+				return false;
+			}
+			store(index++, p);
+			p += bytesPerPixel;
+			continue;
+		}
+
+		if (p >= end) {
+			return false;
+		}
+		const uint8_t header = *p++;
+		const uint32_t count = (header & 0x7f) + 1u;
+		if (count > pixelCount - index) {
+			return false;
+		}
+
+		if (header & 0x80) {
+			//Run of one pixel
+			if ((size_t)(end - p) < bytesPerPixel) {
+				return false;
+			}
+			for (uint32_t i = 0; i < count; ++i) {
+				store(index++, p);
+			}
+			p += bytesPerPixel;
+		}
+		else {
+			if ((size_t)(end - p) < (size_t)count * bytesPerPixel) {
+				return false;
+			}
+			for (uint32_t i = 0; i < count; ++i) {
+				store(index++, p);
+				p += bytesPerPixel;
+			}
+		}
+	}
+	return true;
+}
+
+bool DecodeHDR(const uint8_t *data, const size_t size, DecodedImage &image)
+{
+	const uint8_t *p = data;
+	const uint8_t *end = data + size;
+
+	const auto readLine = [&](std::string &line) {
+		line.clear();
+		while (p < end && *p != '\n') {
+			line.push_back((char)*p++);
+		}
+		if (p >= end) {
+			return false;
+		}
+		++p;
+		return true;
+	};
+
+	std::string line;
+	if (!readLine(line) || (line.compare(0, 10, "#?RADIANCE") != 0 && line.compare(0, 6, "#?RGBE") != 0)) {
+		return false;
+	}
+
+	//Header ends with an empty line
+	bool rgbeFormat = false;
+	while (true) {
+		if (!readLine(line)) {
+			return false;
+		}
+		if (line.empty()) {
+			break;
+		}
+		if (line == "FORMAT=32-bit_rle_rgbe") {
+			rgbeFormat = true;
+		}
+		else if (line.compare(0, 7, "FORMAT=") == 0) {
+			return false;
+		}
+	}
+
+	//Only the standard orientation "-Y height +X width"
+	if (!rgbeFormat || !readLine(line)) {
+		return false;
+	}
+
+	std::istringstream resolution(line);
+	std::string axisY, axisX;
+	uint32_t width = 0;
+	uint32_t height = 0;
+	if (!(resolution >> axisY >> height >> axisX >> width) || axisY != "-Y" || axisX != "+X" || width == 0 || height == 0) {
+		return false;
+	}
+
+	image = DecodedImage();
+	image.width = width;
+	image.height = height;
+	image.format = ImageFormat_RGBA32F;
+	ImageMip &mip = AppendImageMip(image, width, height);
+
+	std::vector<uint8_t> rgbe((size_t)width * 4);
+	for (uint32_t y = 0; y < height; ++y) {
+		if (!ReadHDRScanline(p, end, width, rgbe.data())) {
+			return false;
+		}
+
+		float *out = reinterpret_cast<float *>(image.pixels.data() + mip.offset + (size_t)y * mip.rowPitch);
+		for (uint32_t x = 0; x < width; ++x) {
+			const uint8_t *texel = &rgbe[(size_t)x * 4];
+			const float scale = texel[3] == 0 ? 0.0f : std::ldexp(1.0f, (int)texel[3] - (128 + 8));
+			out[x * 4 + 0] = texel[0] * scale;
+			out[x * 4 + 1] = texel[1] * scale;
+			out[x * 4 + 2] = texel[2] * scale;
+			out[x * 4 + 3] = 1.0f;
+		}
+	}
+	return true;
+}
+
+bool DecodeDDS(const uint8_t *data, const size_t size, DecodedImage &image)
+{
+	//"DDS " + 124 byte header
+	if (size < 128 || ReadU32(data) != FourCC('D', 'D', 'S', ' ') || ReadU32(data + 4) != 124) {
+		return false;
+	}
+
+	const uint32_t height = ReadU32(data + 12);
+	const uint32_t width = ReadU32(data + 16);
+	const uint32_t depth = ReadU32(data + 24);
+	const uint32_t mipCount = std::max(1u, ReadU32(data + 28));
+	const uint32_t pfFlags = ReadU32(data + 80);
+	const uint32_t fourCC = ReadU32(data + 84);
+	const uint32_t bitCount = ReadU32(data + 88);
+	const uint32_t rMask = ReadU32(data + 92);
+	const uint32_t gMask = ReadU32(data + 96);
+	const uint32_t bMask = ReadU32(data + 100);
+	const uint32_t aMask = ReadU32(data + 104);
+	const uint32_t caps2 = ReadU32(data + 112);
+
+	//2D only (no volume / cube map)
+	if (width == 0 || height == 0 || depth > 1 || (caps2 & 0x200) != 0) {
+		return false;
+	}
+
+	const uint32_t DDPF_FOURCC = 0x4;
+	const uint32_t DDPF_RGB = 0x40;
+
+	uint32_t format = ImageFormat_Unknown;
+	size_t offset = 128;
+
+	if ((pfFlags & DDPF_FOURCC) && fourCC == FourCC('D', 'X', '1', '0')) {
+		if (size < 148) {
+			return false;
+		}
+
+		//Resource dimension must be TEXTURE2D, array size 1
+		if (ReadU32(data + 132) != 3 || ReadU32(data + 140) > 1) {
+			return false;
+		}
+		format = ReadU32(data + 128);
+		offset = 148;
+	}
+	else if (pfFlags & DDPF_FOURCC) {
+		if (fourCC == FourCC('D', 'X', 'T', '1'))		{ format = ImageFormat_BC1; }
+		else if (fourCC == FourCC('D', 'X', 'T', '3'))	{ format = ImageFormat_BC2; }
+		else if (fourCC == FourCC('D', 'X', 'T', '5'))	{ format = ImageFormat_BC3; }
+		else if (fourCC == FourCC('A', 'T', 'I', '1') || fourCC == FourCC('B', 'C', '4', 'U')) { format = ImageFormat_BC4; }
+		else if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U')) { format = ImageFormat_BC5; }
+	}
+	else if ((pfFlags & DDPF_RGB) && bitCount == 32) {
+		if (rMask == 0x000000ff && gMask == 0x0000ff00 && bMask == 0x00ff0000 && aMask == 0xff000000) {
+			format = ImageFormat_RGBA8;
+		}
+		else if (rMask == 0x00ff0000 && gMask == 0x0000ff00 && bMask == 0x000000ff && aMask == 0xff000000) {
+			format = ImageFormat_BGRA8;
+		}
+	}
+
+	if (ImageElementSize(format) == 0) {
+		return false;
+	}
+
+	image = DecodedImage();
+	image.width = width;
+	image.height = height;
+	image.format = format;
+
+	uint32_t mipWidth = width;
+	uint32_t mipHeight = height;
+	for (uint32_t level = 0; level < mipCount; ++level) {
+		const size_t mipSize = (size_t)ImageRowPitch(format, mipWidth) * ImageRowCount(format, mipHeight);
+		if (size - offset < mipSize) {
+			return false;
+		}
+
+		const ImageMip &mip = AppendImageMip(image, mipWidth, mipHeight);
+		memcpy(image.pixels.data() + mip.offset, data + offset, mipSize);
+		offset += mipSize;
+
+		mipWidth = std::max(1u, mipWidth / 2);
+		mipHeight = std::max(1u, mipHeight / 2);
+	}
+	return true;
+}
+
+bool IsPortableImageFile(const std::string &path)
+{
+	const std::string ext = Extension(path);
+	return ext == "tga" || ext == "hdr" || ext == "dds";
+}
+
+bool DecodeImageData(const std::string &path, const uint8_t *data, const size_t size, DecodedImage &image)
+{
+	const std::string ext = Extension(path);
+	if (ext == "tga") {
+		return DecodeTGA(data, size, image);
+	}
+	if (ext == "hdr") {
+		return DecodeHDR(data, size, image);
+	}
+	if (ext == "dds") {
+		return DecodeDDS(data, size, image);
+	}
+	return false;
+}
+
+bool DecodeImageFile(const std::string &path, DecodedImage &image)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file) {
+		return false;
+	}
+	const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	return DecodeImageData(path, data.data(), data.size(), image);
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//Pixel formats, values are the matching DXGI_FORMAT
+enum ImageFormat : uint32_t
+{
+	ImageFormat_Unknown = 0,
+	ImageFormat_RGBA32F = 2,
+	ImageFormat_RGBA16F = 10,
+	ImageFormat_RGBA8 = 28,
+	ImageFormat_RGBA8_SRGB = 29,
+	ImageFormat_BC1 = 71,
+	ImageFormat_BC2 = 74,
+	ImageFormat_BC3 = 77,
+	ImageFormat_BC4 = 80,
+	ImageFormat_BC5 = 83,
+	ImageFormat_BGRA8 = 87,
+	ImageFormat_BC7 = 98,
+};
+
+//One mip level inside DecodedImage::pixels
+struct ImageMip
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t rowPitch;		//Bytes per row (per block row when compressed)
+	uint32_t rowCount;		//Rows (block rows when compressed)
+	size_t offset;
+};
+
+struct DecodedImage
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t format = ImageFormat_Unknown;
+	std::vector<ImageMip> mips;
+	std::vector<uint8_t> pixels;
+};
+
+//Non owning image: a DecodedImage, or texels inside a mapped archive
+struct ImageView
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	const ImageMip *mips;
+	uint32_t mipCount;
+	const uint8_t *pixels;
+};
+
+ImageView ViewImage(const DecodedImage &image);
+
+//4x4 block formats
+bool IsBlockCompressed(const uint32_t format);
+
+//Bytes per pixel, bytes per block for BC formats, 0 when unknown
+uint32_t ImageElementSize(const uint32_t format);
+
+/// <summary>
+/// Tight row pitch / row count of a width x height level
+/// </summary>
+uint32_t ImageRowPitch(const uint32_t format, const uint32_t width);
+uint32_t ImageRowCount(const uint32_t format, const uint32_t height);
+
+/// <summary>
+/// Append a mip level of the image format at the end of pixels
+/// </summary>
+/// <returns>The new level</returns>
+ImageMip &AppendImageMip(DecodedImage &image, const uint32_t width, const uint32_t height);
+
+//Levels of a full chain down to 1x1
+uint32_t ImageMipCount(const uint32_t width, const uint32_t height);
+
+/// <summary>
+/// Box filter a full mip chain below level 0 (RGBA8 / RGBA8_SRGB / BGRA8 / RGBA32F)
+/// </summary>
+/// <returns>false when the image already has mips or the format can not be filtered (left as is)</returns>
+bool GenerateImageMips(DecodedImage &image);
+
+/// <summary>
+/// Content hash of the decoded texels (size, format, mips and pixels)
+/// </summary>
+/// <returns>Equal for identical images, whichever file they came from</returns>
+uint64_t HashImage(const DecodedImage &image);
+
+/// <summary>
+/// CPU codecs that run anywhere (no WIC)
+/// </summary>
+/// <returns>false when the data is malformed / unsupported</returns>
+bool DecodeTGA(const uint8_t *data, const size_t size, DecodedImage &image);	//RGBA8
+bool DecodeHDR(const uint8_t *data, const size_t size, DecodedImage &image);	//RGBA32F
+bool DecodeDDS(const uint8_t *data, const size_t size, DecodedImage &image);	//As stored, every mip
+
+//.tga / .hdr / .dds
+bool IsPortableImageFile(const std::string &path);
+
+/// <summary>
+/// Decode file contents already in memory, codec picked by the extension of path
+/// </summary>
+bool DecodeImageData(const std::string &path, const uint8_t *data, const size_t size, DecodedImage &image);
+
+/// <summary>
+/// Read and decode a .tga / .hdr / .dds file
+/// </summary>
+bool DecodeImageFile(const std::string &path, DecodedImage &image);
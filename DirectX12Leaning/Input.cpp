@@ -1,13 +1,14 @@
 //API(Win32)
 #include <Windows.h>
 
+//STL
+#include <algorithm>
+
 #include "Input.h"
 
 Input::Input(const WNDCLASSEX &w, const HWND &hwnd)
 {
-	//Initialize array
-	memset(latest_Key, 0, size_t(key_size));
-	memset(old_Key, 0, size_t(key_size));
+	lastEventTime = INT64_MIN;
 
 	//Initialize DirectInput
 	dinput = nullptr;
@@ -26,6 +27,15 @@ Input::Input(const WNDCLASSEX &w, const HWND &hwnd)
 	//Set data format
 	result = devkeybord->SetDataFormat(&c_dfDIKeyboard);
 
+	//Buffered data: every transition with its time instead of one snapshot per frame
+	DIPROPDWORD bufferSize = {};
+	bufferSize.diph.dwSize = sizeof(DIPROPDWORD);
+	bufferSize.diph.dwHeaderSize = sizeof(DIPROPHEADER);
+	bufferSize.diph.dwObj = 0;
+	bufferSize.diph.dwHow = DIPH_DEVICE;
+	bufferSize.dwData = inputBufferSize;
+	result = devkeybord->SetProperty(DIPROP_BUFFERSIZE, &bufferSize.diph);
+
 	//Set cooperativel level
 	//Active window IO only
 	//No exclusive IO
@@ -33,29 +43,60 @@ Input::Input(const WNDCLASSEX &w, const HWND &hwnd)
 	result = devkeybord->SetCooperativeLevel( hwnd, DISCL_FOREGROUND | DISCL_NONEXCLUSIVE | DISCL_NOWINKEY );
 }
 
-HRESULT Input::Update()
+Input::~Input()
 {
-	//Copy key data from the last frame
-	memcpy(old_Key, latest_Key, size_t(key_size));
+	devkeybord->Unacquire();
+	devkeybord->Release();
+	dinput->Release();
+}
 
-	//Update latest key data
+bool Input::Poll(InputQueue &queue, const int64_t now)
+{
+	//S_FALSE when already acquired
 	result = devkeybord->Acquire();
-	result = devkeybord->GetDeviceState(sizeof(latest_Key), &latest_Key);
+	if (FAILED(result)) {
+		queue.ReleaseAll(now);
+		return false;
+	}
 
-	return result;
-}
+	DIDEVICEOBJECTDATA data[inputBufferSize];
+	DWORD count = inputBufferSize;
+	do {
+		count = inputBufferSize;
+		result = devkeybord->GetDeviceData(sizeof(DIDEVICEOBJECTDATA), data, &count, 0);
+		if (FAILED(result)) {
+			queue.ReleaseAll(now);
+			return false;
+		}
 
-bool Input::GetKey(keycode KeyCode)
-{
-	return latest_Key[static_cast<int>(KeyCode)];
-}
+		//dwTimeStamp is GetTickCount milliseconds, move it onto the caller's clock
+		const DWORD tickNow = GetTickCount();
+		for (DWORD i = 0; i < count; ++i) {
+			const int64_t age = (int64_t)(DWORD)(tickNow - data[i].dwTimeStamp) * 1000000;
+			lastEventTime = std::max(lastEventTime, std::min(now - age, now));
+			queue.Push({ lastEventTime, (uint8_t)data[i].dwOfs, (data[i].dwData & 0x80) != 0 });
+		}
 
-bool Input::GetKeyDown(keycode KeyCode)
-{
-	return !(old_Key[static_cast<int>(KeyCode)]) && latest_Key[static_cast<int>(KeyCode)];
+		if (result == DI_BUFFEROVERFLOW) {
+			Resync(queue, now);
+		}
+	} while (count == inputBufferSize);
+
+	return true;
 }
 
-bool Input::GetKeyUp(keycode KeyCode)
+void Input::Resync(InputQueue &queue, const int64_t now)
 {
-	return old_Key[static_cast<int>(KeyCode)] && !(latest_Key[static_cast<int>(KeyCode)]);
+	BYTE keys[key_size];
+	if (FAILED(devkeybord->GetDeviceState(sizeof(keys), keys))) {
+		return;
+	}
+
+	lastEventTime = std::max(lastEventTime, now);
+	for (int key = 0; key < key_size; ++key) {
+		const bool down = (keys[key] & 0x80) != 0;
+		if (down != queue.GetLatestKey((keycode)key)) {
+			queue.Push({ lastEventTime, (uint8_t)key, down });
+		}
+	}
 }
@@ -0,0 +1,96 @@
+//this
+#include "InputQueue.h"
+
+void InputQueue::Push(const KeyEvent &event)
+{
+	pending.push_back(event);
+
+	if (event.down) { latest.Set(event.key); }
+	else			{ latest.Reset(event.key); }
+}
+
+void InputQueue::AdvanceTo(const int64_t time)
+{
+	pressed.Clear();
+	released.Clear();
+
+	while (!pending.empty() && pending.front().time <= time) {
+		const KeyEvent &event = pending.front();
+		if (event.down) {
+			//Key repeat sends down again while held, only the first one is an edge
+			if (!held.Get(event.key)) {
+				pressed.Set(event.key);
+			}
+			held.Set(event.key);
+		}
+		else {
+			if (held.Get(event.key)) {
+				released.Set(event.key);
+			}
+			held.Reset(event.key);
+		}
+		pending.pop_front();
+	}
+}
+
+void InputQueue::ReleaseAll(const int64_t time)
+{
+	for (int key = 0; key < key_size; ++key) {
+		if (latest.Get((uint8_t)key)) {
+			Push({ time, (uint8_t)key, false });
+		}
+	}
+}
+
+bool InputQueue::GetKey(const keycode key) const
+{
+	return held.Get((uint8_t)key);
+}
+
+bool InputQueue::GetKeyDown(const keycode key) const
+{
+	return pressed.Get((uint8_t)key);
+}
+
+bool InputQueue::GetKeyUp(const keycode key) const
+{
+	return released.Get((uint8_t)key);
+}
+
+bool InputQueue::GetLatestKey(const keycode key) const
+{
+	return latest.Get((uint8_t)key);
+}
+
+const KeyState &InputQueue::GetHeld() const
+{
+	return held;
+}
+
+size_t InputQueue::GetPendingCount() const
+{
+	return pending.size();
+}
+
+SimInput ReadSimInput(const InputQueue &keys)
+{
+	SimInput result;
+
+	const auto map = [&](SimButton button, keycode key) {
+		if (keys.GetKey(key))		{ result.held |= button; }
+		if (keys.GetKeyDown(key))	{ result.pressed |= button; }
+	};
+
+	map(SimButton_Up, keycode::W);
+	map(SimButton_Up, keycode::UpArrow);
+	map(SimButton_Down, keycode::S);
+	map(SimButton_Down, keycode::DownAllow);
+	map(SimButton_Left, keycode::A);
+	map(SimButton_Left, keycode::LeftArrow);
+	map(SimButton_Right, keycode::D);
+	map(SimButton_Right, keycode::RightArrow);
+	map(SimButton_Fire, keycode::Space);
+	map(SimButton_Home, keycode::H);
+
+	return result;
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include "KeyCodes.h"
+#include "SimulationTypes.h"
+
+//One key transition, time in nanoseconds on the clock the backend and the caller of AdvanceTo share
+struct KeyEvent
+{
+	int64_t time;
+	uint8_t key;	//keycode
+	bool down;
+};
+
+//256 keys as bits
+struct KeyState
+{
+	uint64_t bits[key_size / 64] = {};
+
+	bool Get(const uint8_t key) const { return (bits[key >> 6] >> (key & 63)) & 1; }
+	void Set(const uint8_t key)		{ bits[key >> 6] |= uint64_t(1) << (key & 63); }
+	void Reset(const uint8_t key)	{ bits[key >> 6] &= ~(uint64_t(1) << (key & 63)); }
+	void Clear()					{ for (auto &word : bits) { word = 0; } }
+};
+
+/// <summary>
+/// Timestamped key events, consumed one simulation tick at a time
+/// </summary>
+/// <remarks>
+/// Each AdvanceTo closes a tick: events up to that time are applied in order and every key that
+/// went down inside the tick reads as down once, even when it was released before the tick ended.
+/// Events later than the tick wait for the next one, so a press lands in the tick it happened in
+/// however many ticks a frame runs.
+/// </remarks>
+class InputQueue
+{
+public:
+	//Events must come in time order (per backend)
+	void Push(const KeyEvent &event);
+
+	/// <summary>
+	/// Apply events up to time (inclusive) as one tick
+	/// </summary>
+	void AdvanceTo(const int64_t time);
+
+	//Key up at time for every key still down (focus / device lost)
+	void ReleaseAll(const int64_t time);
+
+	//State after the last AdvanceTo
+	bool GetKey(const keycode key) const;
+	bool GetKeyDown(const keycode key) const;
+	bool GetKeyUp(const keycode key) const;
+
+	//Held once every queued event is applied (not tied to a tick)
+	bool GetLatestKey(const keycode key) const;
+
+	const KeyState &GetHeld() const;
+	size_t GetPendingCount() const;
+
+private:
+	std::deque<KeyEvent> pending;
+
+	KeyState held;
+	KeyState pressed;
+	KeyState released;
+
+	//held with every pending event applied
+	KeyState latest;
+};
+
+/// <summary>
+/// Source of key events (DirectInput on Windows, scripted on other platforms / tests)
+/// </summary>
+class InputBackend
+{
+public:
+	virtual ~InputBackend() {}
+
+	/// <summary>
+	/// Push events that happened up to now into queue
+	/// </summary>
+	/// <returns>false when the device is lost (keys are released)</returns>
+	virtual bool Poll(InputQueue &queue, const int64_t now) = 0;
+};
+
+/// <summary>
+/// Game bindings: keys of the last tick -> SimInput
+/// </summary>
+SimInput ReadSimInput(const InputQueue &keys);
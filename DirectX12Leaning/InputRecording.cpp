@@ -0,0 +1,246 @@
+//STL
+#include <cstring>
+
+//this
+#include "InputRecording.h"
+
+namespace
+{
+	//Tag bits of a tick
+	const uint8_t tickInputChanged = 1 << 0;
+	const uint8_t tickHash = 1 << 1;
+
+	const uint32_t flagHashes = 1 << 0;
+
+	void WriteU32(std::ostream &out, const uint32_t value)
+	{
+		char bytes[4];
+		for (int i = 0; i < 4; ++i) {
+			bytes[i] = (char)(value >> (i * 8));
+		}
+		out.write(bytes, 4);
+	}
+
+	void WriteU64(std::ostream &out, const uint64_t value)
+	{
+		WriteU32(out, (uint32_t)value);
+		WriteU32(out, (uint32_t)(value >> 32));
+	}
+
+	void WriteVarint(std::ostream &out, uint32_t value)
+	{
+		while (value >= 0x80) {
+			out.put((char)(value | 0x80));
+			value >>= 7;
+		}
+		out.put((char)value);
+	}
+
+	bool ReadU32(std::istream &in, uint32_t &value)
+	{
+		unsigned char bytes[4];
+		if (!in.read((char *)bytes, 4)) {
+			return false;
+		}
+		value = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+		return true;
+	}
+
+	bool ReadU64(std::istream &in, uint64_t &value)
+	{
+		uint32_t low, high;
+		if (!ReadU32(in, low) || !ReadU32(in, high)) {
+			return false;
+		}
+		value = low | ((uint64_t)high << 32);
+		return true;
+	}
+
+	bool ReadVarint(std::istream &in, uint32_t &value)
+	{
+		value = 0;
+		for (int shift = 0; shift < 35; shift += 7) {
+			const int c = in.get();
+			if (c == std::char_traits<char>::eof()) {
+				return false;
+			}
+			value |= (uint32_t)(c & 0x7f) << shift;
+			if ((c & 0x80) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+InputRecorder::InputRecorder() : stream(nullptr), hashes(false), ticks(0) {}
+
+bool InputRecorder::Begin(std::ostream *stream, const uint64_t seed, const double tickRate, const bool hashes)
+{
+	this->stream = nullptr;
+	this->hashes = hashes;
+	last = SimInput();
+	ticks = 0;
+
+	uint64_t rateBits;
+	memcpy(&rateBits, &tickRate, sizeof(rateBits));
+
+	WriteU32(*stream, inputRecordingMagic);
+	WriteU32(*stream, inputRecordingVersion);
+	WriteU64(*stream, seed);
+	WriteU64(*stream, rateBits);
+	WriteU32(*stream, hashes ? flagHashes : 0);
+	if (!*stream) {
+		return false;
+	}
+
+	this->stream = stream;
+	return true;
+}
+
+void InputRecorder::Record(const SimInput &input, const uint64_t stateHash)
+{
+	if (stream == nullptr) {
+		return;
+	}
+
+	const bool changed = input.held != last.held || input.pressed != last.pressed;
+	stream->put((char)((changed ? tickInputChanged : 0) | (hashes ? tickHash : 0)));
+	if (changed) {
+		WriteVarint(*stream, input.held);
+		WriteVarint(*stream, input.pressed);
+		last = input;
+	}
+	if (hashes) {
+		WriteU32(*stream, (uint32_t)stateHash);
+	}
+	++ticks;
+}
+
+void InputRecorder::End()
+{
+	if (stream != nullptr) {
+		stream->flush();
+		stream = nullptr;
+	}
+}
+
+bool InputRecorder::IsRecording() const
+{
+	return stream != nullptr;
+}
+
+uint64_t InputRecorder::GetTickCount() const
+{
+	return ticks;
+}
+
+InputReplay::InputReplay() :
+	stream(nullptr),
+	seed(0),
+	tickRate(0),
+	hashes(false),
+	ticks(0),
+	hashPending(false),
+	expectedHash(0),
+	diverged(false),
+	divergedTick(0)
+{
+}
+
+bool InputReplay::Open(std::istream *stream)
+{
+	*this = InputReplay();
+
+	uint32_t magic, version, flags;
+	uint64_t rateBits;
+	if (!ReadU32(*stream, magic) || !ReadU32(*stream, version) || !ReadU64(*stream, seed) ||
+		!ReadU64(*stream, rateBits) || !ReadU32(*stream, flags) ||
+		magic != inputRecordingMagic || version != inputRecordingVersion) {
+		return false;
+	}
+
+	memcpy(&tickRate, &rateBits, sizeof(tickRate));
+	if (!(tickRate > 0)) {
+		return false;
+	}
+
+	this->stream = stream;
+	hashes = (flags & flagHashes) != 0;
+	return true;
+}
+
+bool InputReplay::Next(SimInput &input)
+{
+	hashPending = false;
+	if (stream == nullptr) {
+		return false;
+	}
+
+	//A tick cut short by a crash while recording counts as the end
+	const int tag = stream->get();
+	if (tag == std::char_traits<char>::eof()) {
+		return false;
+	}
+	if ((tag & tickInputChanged) != 0) {
+		uint32_t held, pressed;
+		if (!ReadVarint(*stream, held) || !ReadVarint(*stream, pressed)) {
+			return false;
+		}
+		last.held = held;
+		last.pressed = pressed;
+	}
+	if ((tag & tickHash) != 0) {
+		if (!ReadU32(*stream, expectedHash)) {
+			return false;
+		}
+		hashPending = true;
+	}
+
+	input = last;
+	++ticks;
+	return true;
+}
+
+bool InputReplay::Check(const uint64_t stateHash)
+{
+	if (!hashPending || (uint32_t)stateHash == expectedHash) {
+		return true;
+	}
+
+	if (!diverged) {
+		diverged = true;
+		divergedTick = ticks;
+	}
+	return false;
+}
+
+uint64_t InputReplay::GetSeed() const
+{
+	return seed;
+}
+
+double InputReplay::GetTickRate() const
+{
+	return tickRate;
+}
+
+bool InputReplay::HasHashes() const
+{
+	return hashes;
+}
+
+uint64_t InputReplay::GetTickCount() const
+{
+	return ticks;
+}
+
+bool InputReplay::HasDiverged() const
+{
+	return diverged;
+}
+
+uint64_t InputReplay::GetDivergedTick() const
+{
+	return divergedTick;
+}
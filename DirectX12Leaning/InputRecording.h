@@ -0,0 +1,84 @@
+#pragma once
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include "SimulationTypes.h"
+
+//'DXLR'
+const uint32_t inputRecordingMagic = 0x524c5844;
+const uint32_t inputRecordingVersion = 1;
+
+/// <summary>
+/// Writes the SimInput of every tick (and optionally the state hash after it) to a stream
+/// </summary>
+/// <remarks>
+/// Layout: magic, version, seed, tick rate, flags; then per tick a tag byte,
+/// held / pressed as varints when they changed, the low 32 bits of the state hash when enabled.
+/// An idle tick is 1 byte (5 with hashes).
+/// </remarks>
+class InputRecorder
+{
+public:
+	InputRecorder();
+
+	/// <param name="stream">Binary stream, kept until End</param>
+	/// <param name="seed">Seed the GameSimulation was started with</param>
+	/// <param name="hashes">Store a state hash per tick for divergence checks</param>
+	bool Begin(std::ostream *stream, const uint64_t seed, const double tickRate, const bool hashes = true);
+
+	void Record(const SimInput &input, const uint64_t stateHash);
+	void End();
+
+	bool IsRecording() const;
+	uint64_t GetTickCount() const;
+
+private:
+	std::ostream *stream;
+	SimInput last;
+	bool hashes;
+	uint64_t ticks;
+};
+
+/// <summary>
+/// Reads an InputRecorder stream back tick by tick
+/// </summary>
+class InputReplay
+{
+public:
+	InputReplay();
+
+	/// <returns>false when the header is missing or from another version</returns>
+	bool Open(std::istream *stream);
+
+	/// <summary>
+	/// Input of the next tick
+	/// </summary>
+	/// <returns>false at the end of the recording</returns>
+	bool Next(SimInput &input);
+
+	/// <summary>
+	/// Compare the state after the tick returned by Next with the recording
+	/// </summary>
+	/// <returns>false when it differs (the first such tick is kept), true without hashes</returns>
+	bool Check(const uint64_t stateHash);
+
+	uint64_t GetSeed() const;
+	double GetTickRate() const;
+	bool HasHashes() const;
+	uint64_t GetTickCount() const;		//Ticks read so far
+	bool HasDiverged() const;
+	uint64_t GetDivergedTick() const;	//1 based, like SimulationSnapshot::tick after that tick
+
+private:
+	std::istream *stream;
+	SimInput last;
+	uint64_t seed;
+	double tickRate;
+	bool hashes;
+	uint64_t ticks;
+
+	bool hashPending;
+	uint32_t expectedHash;
+	bool diverged;
+	uint64_t divergedTick;
+};
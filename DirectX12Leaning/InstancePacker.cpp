@@ -0,0 +1,93 @@
+//STL
+#include <algorithm>
+
+//this
+#include "InstancePacker.h"
+
+namespace
+{
+	const float identity[16] = {
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1,
+	};
+}
+
+InstancePacker::InstancePacker(const uint32_t capacity) : capacity(capacity)
+{
+	instances.reserve(capacity);
+	std::copy(identity, identity + 16, base);
+}
+
+void InstancePacker::Begin(const float *baseMatrix)
+{
+	instances.clear();
+
+	const float *src = baseMatrix != nullptr ? baseMatrix : identity;
+	std::copy(src, src + 16, base);
+}
+
+bool InstancePacker::Add(const Position3D &position, const float *color)
+{
+	if (instances.size() >= capacity) {
+		return false;
+	}
+
+	//base * translation: only the xyz columns pick up row[3] * t
+	const float t[3] = { position.x, position.y, position.z };
+
+	InstanceData data;
+	for (auto row = 0; row < 4; ++row) {
+		for (auto col = 0; col < 3; ++col) {
+			data.world[row * 4 + col] = base[row * 4 + col] + base[row * 4 + 3] * t[col];
+		}
+		data.world[row * 4 + 3] = base[row * 4 + 3];
+	}
+	std::copy(color, color + 4, data.color);
+
+	instances.push_back(data);
+	return true;
+}
+
+bool InstancePacker::Add(const float *matrix, const float *color)
+{
+	if (instances.size() >= capacity) {
+		return false;
+	}
+
+	InstanceData data;
+	for (auto row = 0; row < 4; ++row) {
+		for (auto col = 0; col < 4; ++col) {
+			float sum = 0;
+			for (auto k = 0; k < 4; ++k) {
+				sum += base[row * 4 + k] * matrix[k * 4 + col];
+			}
+			data.world[row * 4 + col] = sum;
+		}
+	}
+	std::copy(color, color + 4, data.color);
+
+	instances.push_back(data);
+	return true;
+}
+
+const InstanceData *InstancePacker::GetData() const
+{
+	return instances.data();
+}
+
+uint32_t InstancePacker::GetCount() const
+{
+	return (uint32_t)instances.size();
+}
+
+uint32_t InstancePacker::GetCapacity() const
+{
+	return capacity;
+}
+
+size_t InstancePacker::GetSizeInBytes() const
+{
+	return sizeof(InstanceData) * instances.size();
+}
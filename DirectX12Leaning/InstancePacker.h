@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "SimulationTypes.h"
+
+//Per instance data (StructuredBuffer element, matches BasicVS3DInstanced.hlsl)
+struct InstanceData
+{
+	float world[16];	//Row major (DirectXMath layout)
+	float color[4];
+};
+
+class InstancePacker
+{
+public:
+	InstancePacker(const uint32_t capacity);
+
+	/// <summary>
+	/// Start a new instance list
+	/// </summary>
+	/// <param name="baseMatrix">Transform shared by every instance (16 floats, row major), nullptr = identity</param>
+	void Begin(const float *baseMatrix = nullptr);
+
+	/// <summary>
+	/// Add an instance at position (world = base * translation)
+	/// </summary>
+	/// <returns>false when full</returns>
+	bool Add(const Position3D &position, const float *color);
+
+	/// <summary>
+	/// Add an instance with a full world matrix (world = base * matrix)
+	/// </summary>
+	/// <returns>false when full</returns>
+	bool Add(const float *matrix, const float *color);
+
+	const InstanceData *GetData() const;
+	uint32_t GetCount() const;
+	uint32_t GetCapacity() const;
+	size_t GetSizeInBytes() const;
+
+private:
+	uint32_t capacity;
+	float base[16];
+	std::vector<InstanceData> instances;
+};
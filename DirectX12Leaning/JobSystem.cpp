@@ -0,0 +1,224 @@
+//this
+#include "JobSystem.h"
+
+namespace
+{
+	static_assert((jobQueueSize & (jobQueueSize - 1)) == 0, "jobQueueSize must be a power of two");
+
+	//Empty looks before a worker sleeps (each one yields the core)
+	const int idleSpinCount = 64;
+}
+
+thread_local const JobSystem *JobSystem::threadSystem = nullptr;
+thread_local uint32_t JobSystem::threadWorker = JobSystem::invalidWorker;
+
+JobSystem::JobSystem(const uint32_t workerCount) :
+	queued(0),
+	sleeping(0),
+	stopping(false)
+{
+	uint32_t count = workerCount;
+	if (count == 0) {
+		count = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		std::unique_ptr<Worker> worker(new Worker);
+		worker->jobs.reset(new Job[jobQueueSize]);
+		worker->front = 0;
+		worker->back = 0;
+		worker->executed.store(0, std::memory_order_relaxed);
+		worker->stolen.store(0, std::memory_order_relaxed);
+		workers.push_back(std::move(worker));
+	}
+
+	//The creating thread is worker 0
+	threadSystem = this;
+	threadWorker = 0;
+
+	for (uint32_t i = 1; i < count; ++i) {
+		threads.emplace_back(&JobSystem::WorkerMain, this, i);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping.store(true);
+	}
+	wakeup.notify_all();
+
+	for (auto &thread : threads) {
+		thread.join();
+	}
+
+	if (threadSystem == this) {
+		threadSystem = nullptr;
+		threadWorker = invalidWorker;
+	}
+}
+
+void JobSystem::Run(JobCounter &counter, const JobFunction function, void *data)
+{
+	const Job job = { function, data, &counter };
+	counter.pending.fetch_add(1, std::memory_order_relaxed);
+
+	const uint32_t index = GetWorkerIndex();
+	Worker &worker = *workers[index != invalidWorker ? index : 0];
+
+	//Counted before the push so a thief never takes it below zero; pairs with the
+	//sleeping increment in WorkerMain (one side always sees the other)
+	queued.fetch_add(1);
+
+	//Queue full: the caller is the only free worker anyway
+	if (!Push(worker, job)) {
+		queued.fetch_sub(1);
+		Execute(index, job);
+		return;
+	}
+
+	if (sleeping.load() > 0) {
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+		}
+		wakeup.notify_one();
+	}
+}
+
+void JobSystem::Wait(JobCounter &counter)
+{
+	const uint32_t index = GetWorkerIndex();
+	while (!counter.IsDone()) {
+		//Help instead of blocking: the jobs waited for may be in this thread's queue
+		if (!RunOne(index)) {
+			std::this_thread::yield();
+		}
+	}
+}
+
+uint32_t JobSystem::GetWorkerCount() const
+{
+	return (uint32_t)workers.size();
+}
+
+uint32_t JobSystem::GetWorkerIndex() const
+{
+	return threadSystem == this ? threadWorker : invalidWorker;
+}
+
+JobStats JobSystem::GetStats() const
+{
+	JobStats stats = {};
+	for (auto &worker : workers) {
+		stats.executed += worker->executed.load(std::memory_order_relaxed);
+		stats.stolen += worker->stolen.load(std::memory_order_relaxed);
+	}
+	return stats;
+}
+
+void JobSystem::WorkerMain(const uint32_t index)
+{
+	threadSystem = this;
+	threadWorker = index;
+
+	for (;;) {
+		if (RunOne(index)) {
+			continue;
+		}
+
+		//Short spin: frame jobs usually come in bursts
+		int spin = 0;
+		while (spin < idleSpinCount && queued.load(std::memory_order_relaxed) == 0 && !stopping.load(std::memory_order_relaxed)) {
+			std::this_thread::yield();
+			++spin;
+		}
+		if (spin < idleSpinCount && !stopping.load(std::memory_order_relaxed)) {
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleeping.fetch_add(1);
+		wakeup.wait(lock, [this]() { return stopping.load() || queued.load() > 0; });
+		sleeping.fetch_sub(1);
+
+		if (stopping.load() && queued.load() == 0) {
+			return;
+		}
+	}
+}
+
+bool JobSystem::Push(Worker &worker, const Job &job)
+{
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	if (worker.back - worker.front >= jobQueueSize) {
+		return false;
+	}
+	worker.jobs[worker.back & (jobQueueSize - 1)] = job;
+	++worker.back;
+	return true;
+}
+
+bool JobSystem::Pop(Worker &worker, Job &job)
+{
+	std::lock_guard<std::mutex> lock(worker.mutex);
+	if (worker.back == worker.front) {
+		return false;
+	}
+	--worker.back;
+	job = worker.jobs[worker.back & (jobQueueSize - 1)];
+	return true;
+}
+
+bool JobSystem::Steal(const uint32_t thief, Job &job)
+{
+	const uint32_t count = (uint32_t)workers.size();
+
+	//Start after the thief so victims are spread over the workers
+	const uint32_t start = thief != invalidWorker ? thief + 1 : 0;
+	for (uint32_t i = 0; i < count; ++i) {
+		const uint32_t victim = (start + i) % count;
+		if (victim == thief) {
+			continue;
+		}
+
+		Worker &worker = *workers[victim];
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		if (worker.back != worker.front) {
+			job = worker.jobs[worker.front & (jobQueueSize - 1)];
+			++worker.front;
+			return true;
+		}
+	}
+	return false;
+}
+
+bool JobSystem::RunOne(const uint32_t index)
+{
+	if (queued.load(std::memory_order_relaxed) == 0) {
+		return false;
+	}
+
+	Job job;
+	if (index != invalidWorker && Pop(*workers[index], job)) {
+		queued.fetch_sub(1);
+		Execute(index, job);
+		return true;
+	}
+	if (Steal(index, job)) {
+		queued.fetch_sub(1);
+		workers[index != invalidWorker ? index : 0]->stolen.fetch_add(1, std::memory_order_relaxed);
+		Execute(index, job);
+		return true;
+	}
+	return false;
+}
+
+void JobSystem::Execute(const uint32_t index, const Job &job)
+{
+	job.function(job.data);
+	workers[index != invalidWorker ? index : 0]->executed.fetch_add(1, std::memory_order_relaxed);
+
+	//Last access to the job: Wait may return and destroy the counter after this
+	job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
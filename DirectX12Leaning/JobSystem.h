@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Jobs one worker queue holds, later pushes run inline (power of two)
+const uint32_t jobQueueSize = 4096;
+
+//Called on any worker with the data passed to Run
+typedef void (*JobFunction)(void *data);
+
+/// <summary>
+/// Jobs of one batch still queued or running, Wait returns when it reaches 0
+/// </summary>
+class JobCounter
+{
+public:
+	JobCounter() :
+		pending(0)
+	{
+	}
+
+	bool IsDone() const
+	{
+		return pending.load(std::memory_order_acquire) == 0;
+	}
+
+	JobCounter(const JobCounter &) = delete;
+	JobCounter &operator=(const JobCounter &) = delete;
+
+private:
+	friend class JobSystem;
+	std::atomic<uint32_t> pending;
+};
+
+struct JobStats
+{
+	uint64_t executed;	//Jobs run (inline runs of full queues included)
+	uint64_t stolen;	//Jobs taken from another worker's queue
+};
+
+/// <summary>
+/// Work stealing job system: one queue per worker, idle workers take jobs from the others
+/// </summary>
+/// <remarks>
+/// The thread that creates the system is worker 0, it only runs jobs inside Wait / ParallelFor;
+/// workerCount - 1 threads run the rest. A worker pushes and pops the back of its own queue
+/// (newest first, still in cache), thieves take the front. Threads outside the system may Run
+/// (jobs go to worker 0's queue) and Wait. Jobs may Run and Wait themselves (nested fork / join).
+/// Nothing allocates after the constructor; Wait every counter before destroying the system.
+/// </remarks>
+class JobSystem
+{
+public:
+	static const uint32_t invalidWorker = UINT32_MAX;
+
+	/// <param name="workerCount">Threads running jobs with the caller, 0 = hardware threads</param>
+	explicit JobSystem(const uint32_t workerCount = 0);
+	~JobSystem();
+
+	/// <summary>
+	/// Queue function(data), counter counts it until it has run
+	/// </summary>
+	void Run(JobCounter &counter, const JobFunction function, void *data);
+
+	/// <summary>
+	/// Run queued jobs until every job of counter has finished
+	/// </summary>
+	void Wait(JobCounter &counter);
+
+	/// <summary>
+	/// function(index) for every index in [0, count), batchSize indices at a time, returns when all ran
+	/// </summary>
+	template<class Function>
+	void ParallelFor(const uint32_t count, const uint32_t batchSize, const Function &function)
+	{
+		ForRange<Function> range(function, count, std::max(batchSize, 1u));
+		const uint32_t batches = (count + range.batchSize - 1) / range.batchSize;
+		const uint32_t jobs = std::min(batches, GetWorkerCount());
+
+		//Every job claims batches until none are left; the caller runs one of them
+		JobCounter counter;
+		for (uint32_t i = 1; i < jobs; ++i) {
+			Run(counter, &ForRange<Function>::Execute, &range);
+		}
+		if (jobs > 0) {
+			ForRange<Function>::Execute(&range);
+		}
+		Wait(counter);
+	}
+
+	uint32_t GetWorkerCount() const;
+
+	//Worker index of the calling thread, invalidWorker outside this system
+	uint32_t GetWorkerIndex() const;
+
+	JobStats GetStats() const;
+
+private:
+	struct Job
+	{
+		JobFunction function;
+		void *data;
+		JobCounter *counter;
+	};
+
+	//Queue fields and counters of a worker on their own cache lines
+	struct Worker
+	{
+		std::mutex mutex;
+		std::unique_ptr<Job[]> jobs;
+		uint32_t front;		//Monotonic, index = position % jobQueueSize
+		uint32_t back;
+
+		std::atomic<uint64_t> executed;
+		std::atomic<uint64_t> stolen;
+		char padding[64];
+	};
+
+	//Batches of one ParallelFor, on the caller's stack
+	template<class Function>
+	struct ForRange
+	{
+		ForRange(const Function &function, const uint32_t count, const uint32_t batchSize) :
+			function(function),
+			next(0),
+			count(count),
+			batchSize(batchSize)
+		{
+		}
+
+		static void Execute(void *data)
+		{
+			ForRange &range = *(ForRange *)data;
+			for (;;) {
+				const uint32_t begin = range.next.fetch_add(range.batchSize, std::memory_order_relaxed);
+				if (begin >= range.count) {
+					return;
+				}
+				const uint32_t end = std::min(begin + range.batchSize, range.count);
+				for (uint32_t i = begin; i < end; ++i) {
+					range.function(i);
+				}
+			}
+		}
+
+		const Function &function;
+		std::atomic<uint32_t> next;
+		uint32_t count;
+		uint32_t batchSize;
+	};
+
+	void WorkerMain(const uint32_t index);
+	bool Push(Worker &worker, const Job &job);
+	bool Pop(Worker &worker, Job &job);
+	bool Steal(const uint32_t thief, Job &job);
+	bool RunOne(const uint32_t index);
+	void Execute(const uint32_t index, const Job &job);
+
+	//System / worker index of the calling thread
+	static thread_local const JobSystem *threadSystem;
+	static thread_local uint32_t threadWorker;
+
+private:
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::vector<std::thread> threads;
+
+	//Jobs sitting in queues, sleeping workers wait for it to be non zero
+	std::atomic<uint32_t> queued;
+	std::atomic<uint32_t> sleeping;
+	std::atomic<bool> stopping;
+	std::mutex sleepMutex;
+	std::condition_variable wakeup;
+};
@@ -0,0 +1,147 @@
+//JobSystem scaling: parallel for over compute work, fork / join overhead, nested (stolen) jobs
+//Results are checked, a wrong result fails the run
+//usage: JobSystemBench [maxWorkers]   (default hardware threads, at least 4)
+
+//STL
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+//Utility
+#include "JobSystem.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	double Milliseconds(const Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	}
+
+	//About 0.5 us of floating point work per item
+	float Work(const uint32_t index)
+	{
+		float value = (float)(index & 1023) * 0.001f;
+		for (int i = 0; i < 64; ++i) {
+			value = std::sqrt(value * value + 1.0f) * 0.5f;
+		}
+		return value;
+	}
+
+	//Recursive split: every level runs one half as a job, the other inline
+	struct Fibonacci
+	{
+		JobSystem *jobs;
+		int n;
+		uint64_t result;
+	};
+
+	void FibonacciJob(void *data)
+	{
+		Fibonacci &task = *(Fibonacci *)data;
+		if (task.n < 12) {
+			uint64_t a = 0, b = 1;
+			for (int i = 0; i < task.n; ++i) {
+				const uint64_t next = a + b;
+				a = b;
+				b = next;
+			}
+			task.result = a;
+			return;
+		}
+
+		Fibonacci left = { task.jobs, task.n - 1, 0 };
+		Fibonacci right = { task.jobs, task.n - 2, 0 };
+		JobCounter counter;
+		task.jobs->Run(counter, &FibonacciJob, &left);
+		FibonacciJob(&right);
+		task.jobs->Wait(counter);
+		task.result = left.result + right.result;
+	}
+
+	void EmptyJob(void *)
+	{
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const uint32_t hardware = std::max(std::thread::hardware_concurrency(), 1u);
+	const uint32_t maxWorkers = argc > 1 ? (uint32_t)std::strtoul(argv[1], nullptr, 10) : std::max(hardware, 4u);
+
+	const uint32_t itemCount = 1 << 20;
+	const uint32_t emptyJobCount = 100000;
+	const int fibonacciN = 32;
+	const uint64_t fibonacciResult = 2178309;
+
+	//Reference result of the parallel for
+	double expected = 0;
+	for (uint32_t i = 0; i < itemCount; ++i) {
+		expected += Work(i);
+	}
+
+	std::vector<float> results(itemCount);
+	bool failed = false;
+	double parallelForBase = 0, fibonacciBase = 0;
+
+	printf("hardware threads: %u\n\n", hardware);
+	printf("%-8s %14s %8s %16s %14s %8s %10s\n", "workers", "parallel for", "speedup", "fork/join ns/job", "nested jobs", "speedup", "stolen");
+
+	for (uint32_t workers = 1; workers <= maxWorkers; workers *= 2) {
+		JobSystem jobs(workers);
+
+		//Parallel for, 256 items per batch
+		auto start = Clock::now();
+		jobs.ParallelFor(itemCount, 256, [&](const uint32_t i) { results[i] = Work(i); });
+		const double parallelFor = Milliseconds(start);
+
+		double sum = 0;
+		for (uint32_t i = 0; i < itemCount; ++i) {
+			sum += results[i];
+		}
+		if (std::fabs(sum - expected) > 1e-6 * std::fabs(expected)) {
+			printf("parallel for: wrong sum with %u workers\n", workers);
+			failed = true;
+		}
+
+		//Fork / join of empty jobs (queue + counter overhead)
+		start = Clock::now();
+		{
+			JobCounter counter;
+			for (uint32_t i = 0; i < emptyJobCount; ++i) {
+				jobs.Run(counter, &EmptyJob, nullptr);
+			}
+			jobs.Wait(counter);
+		}
+		const double forkJoin = Milliseconds(start) * 1e6 / emptyJobCount;
+
+		//Nested jobs, only stealing spreads them
+		const uint64_t stolenBefore = jobs.GetStats().stolen;
+		Fibonacci root = { &jobs, fibonacciN, 0 };
+		start = Clock::now();
+		{
+			JobCounter counter;
+			jobs.Run(counter, &FibonacciJob, &root);
+			jobs.Wait(counter);
+		}
+		const double fibonacci = Milliseconds(start);
+		if (root.result != fibonacciResult) {
+			printf("nested jobs: wrong result with %u workers\n", workers);
+			failed = true;
+		}
+
+		if (workers == 1) {
+			parallelForBase = parallelFor;
+			fibonacciBase = fibonacci;
+		}
+		printf("%-8u %11.1f ms %7.2fx %16.1f %11.1f ms %7.2fx %10llu\n",
+			workers, parallelFor, parallelForBase / parallelFor, forkJoin,
+			fibonacci, fibonacciBase / fibonacci, (unsigned long long)(jobs.GetStats().stolen - stolenBefore));
+	}
+
+	return failed ? 1 : 0;
+}
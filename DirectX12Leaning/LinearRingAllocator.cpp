@@ -0,0 +1,86 @@
+//Utility
+#include "FramePacer.h"
+
+//this
+#include "LinearRingAllocator.h"
+
+LinearRingAllocator::LinearRingAllocator(const uint64_t capacity) :
+	capacity(capacity),
+	head(0),
+	tail(0),
+	failedCount(0),
+	waitCount(0)
+{
+}
+
+uint64_t LinearRingAllocator::Allocate(const uint64_t size, const uint64_t alignment)
+{
+	const uint64_t offset = head % capacity;
+	uint64_t padding = ((offset + alignment - 1) & ~(alignment - 1)) - offset;
+
+	//Does not fit before the end: skip to the start of the ring
+	if (offset + padding + size > capacity) {
+		padding = capacity - offset;
+	}
+
+	//Would overwrite data the GPU may still read
+	if (size > capacity || head + padding + size - tail > capacity) {
+		++failedCount;
+		return invalidOffset;
+	}
+
+	head += padding;
+	const uint64_t result = head % capacity;
+	head += size;
+	return result;
+}
+
+uint64_t LinearRingAllocator::AllocateWaiting(const uint64_t size, const uint64_t alignment, FrameFence *fence)
+{
+	uint64_t offset = Allocate(size, alignment);
+
+	//Oldest frame first: each one gives back the space it used
+	while (offset == invalidOffset && !frames.empty()) {
+		const uint64_t fenceValue = frames.front().fenceValue;
+		if (fence->GetCompletedValue() < fenceValue) {
+			fence->WaitForValue(fenceValue);
+			++waitCount;
+		}
+		Retire(fenceValue);
+		offset = Allocate(size, alignment);
+	}
+	return offset;
+}
+
+void LinearRingAllocator::EndFrame(const uint64_t fenceValue)
+{
+	frames.push_back({ fenceValue, head });
+}
+
+void LinearRingAllocator::Retire(const uint64_t completedFenceValue)
+{
+	while (!frames.empty() && frames.front().fenceValue <= completedFenceValue) {
+		tail = frames.front().head;
+		frames.pop_front();
+	}
+}
+
+uint64_t LinearRingAllocator::GetCapacity() const
+{
+	return capacity;
+}
+
+uint64_t LinearRingAllocator::GetUsedSize() const
+{
+	return head - tail;
+}
+
+uint64_t LinearRingAllocator::GetFailedCount() const
+{
+	return failedCount;
+}
+
+uint64_t LinearRingAllocator::GetWaitCount() const
+{
+	return waitCount;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+class FrameFence;
+
+/// <summary>
+/// Ring of bytes handed out linearly and given back a whole frame at a time by fence value
+/// </summary>
+class LinearRingAllocator
+{
+public:
+	static const uint64_t invalidOffset = UINT64_MAX;
+
+	LinearRingAllocator(const uint64_t capacity);
+
+	/// <summary>
+	/// Reserve size bytes (never split across the end of the ring)
+	/// </summary>
+	/// <param name="alignment">Power of two</param>
+	/// <returns>Offset into the ring, invalidOffset when full</returns>
+	uint64_t Allocate(const uint64_t size, const uint64_t alignment = 256);
+
+	/// <summary>
+	/// Allocate, waiting on fence for the oldest frames in flight while the ring is full
+	/// </summary>
+	/// <param name="fence">Fence the EndFrame values were signaled on</param>
+	/// <returns>invalidOffset when size does not fit even with every ended frame retired</returns>
+	uint64_t AllocateWaiting(const uint64_t size, const uint64_t alignment, FrameFence *fence);
+
+	/// <summary>
+	/// Everything allocated since the last call belongs to the frame signaled with fenceValue
+	/// </summary>
+	void EndFrame(const uint64_t fenceValue);
+
+	/// <summary>
+	/// Free frames whose fence value has been reached
+	/// </summary>
+	void Retire(const uint64_t completedFenceValue);
+
+	uint64_t GetCapacity() const;
+	uint64_t GetUsedSize() const;
+
+	//Allocate calls that found the ring full
+	uint64_t GetFailedCount() const;
+
+	//Frames AllocateWaiting had to wait for
+	uint64_t GetWaitCount() const;
+
+private:
+	struct FrameMark
+	{
+		uint64_t fenceValue;
+		uint64_t head;
+	};
+
+	uint64_t capacity;
+
+	//Monotonic byte positions, offset = position % capacity
+	uint64_t head;
+	uint64_t tail;
+
+	std::deque<FrameMark> frames;
+	uint64_t failedCount;
+	uint64_t waitCount;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+/// <summary>
+/// Read only view of a whole file (mmap / MapViewOfFile), pages are read on first touch
+/// </summary>
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	/// <param name="path">UTF-8</param>
+	/// <returns>false when the file can not be opened / mapped (empty files included)</returns>
+	bool Open(const std::string &path);
+	void Close();
+
+	bool IsOpen() const;
+	const uint8_t *GetData() const;
+	size_t GetSize() const;
+
+private:
+	const uint8_t *data;
+	size_t size;
+
+#ifdef _WIN32
+	void *file;
+	void *mapping;
+#endif
+};
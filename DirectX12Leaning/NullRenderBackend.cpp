@@ -0,0 +1,223 @@
+//STL
+#include <cstring>
+
+//this
+#include "NullRenderBackend.h"
+
+namespace
+{
+	bool SameView(const RenderVertexBufferView &a, const RenderVertexBufferView &b)
+	{
+		return a.address == b.address && a.size == b.size && a.stride == b.stride;
+	}
+
+	bool SameView(const RenderIndexBufferView &a, const RenderIndexBufferView &b)
+	{
+		return a.address == b.address && a.size == b.size && a.format == b.format;
+	}
+}
+
+void RenderStats::Add(const RenderStats &other)
+{
+	commands += other.commands;
+	streamBytes += other.streamBytes;
+	draws += other.draws;
+	instances += other.instances;
+	indices += other.indices;
+	uploadBytes += other.uploadBytes;
+	copyBytes += other.copyBytes;
+	stateCalls += other.stateCalls;
+	redundantCalls += other.redundantCalls;
+
+	for (uint32_t i = 0; i < renderCommandTypeCount; ++i) {
+		calls[i] += other.calls[i];
+		redundant[i] += other.redundant[i];
+	}
+}
+
+void NullRenderBackend::Execute(const RenderCommandList &list)
+{
+	Execute((const RenderCommandHeader *)list.GetData(), (const RenderCommandHeader *)(list.GetData() + list.GetSize()));
+}
+
+void NullRenderBackend::Execute(const RenderCommandHeader *begin, const RenderCommandHeader *end)
+{
+	BoundState state;
+	memset(&state, 0, sizeof(state));
+	UnbindRootArguments(state);
+
+	stats.streamBytes += (const uint8_t *)end - (const uint8_t *)begin;
+
+	for (const RenderCommandHeader *header = begin; header != end; header = RenderCommandList::Next(header)) {
+		const RenderCommandType type = header->type;
+		stats.commands++;
+
+		switch (type) {
+			case RenderCommandType::SetPipelineState: {
+				auto &command = *(const CmdSetPipelineState *)header;
+				if (CountState(type, state.pipelineBound && state.pipeline == command.pipeline)) {
+					state.pipelineBound = true;
+					state.pipeline = command.pipeline;
+				}
+				break;
+			}
+			case RenderCommandType::SetGraphicsRootSignature: {
+				auto &command = *(const CmdSetGraphicsRootSignature *)header;
+				if (CountState(type, state.rootSignatureBound && state.rootSignature == command.rootSignature)) {
+					state.rootSignatureBound = true;
+					state.rootSignature = command.rootSignature;
+					UnbindRootArguments(state);
+				}
+				break;
+			}
+			case RenderCommandType::SetDescriptorHeaps: {
+				auto &command = *(const CmdSetDescriptorHeaps *)header;
+				const bool same = state.heapsBound && state.heapCount == command.count &&
+					memcmp(state.heaps, command.heaps, sizeof(void *) * command.count) == 0;
+				if (CountState(type, same)) {
+					state.heapsBound = true;
+					state.heapCount = command.count;
+					memcpy(state.heaps, command.heaps, sizeof(state.heaps));
+				}
+				break;
+			}
+			case RenderCommandType::SetGraphicsRootConstantBufferView:
+			case RenderCommandType::SetGraphicsRootShaderResourceView:
+			case RenderCommandType::SetGraphicsRootDescriptorTable: {
+				//Same layout: slot, 64 bit value
+				const uint32_t slot = type == RenderCommandType::SetGraphicsRootDescriptorTable ?
+					((const CmdSetGraphicsRootDescriptorTable *)header)->slot : ((const CmdSetRootView *)header)->slot;
+				const uint64_t value = type == RenderCommandType::SetGraphicsRootDescriptorTable ?
+					((const CmdSetGraphicsRootDescriptorTable *)header)->table : ((const CmdSetRootView *)header)->address;
+
+				const bool valid = slot < maxRootSlots;
+				if (CountState(type, valid && state.rootType[slot] == type && state.rootValue[slot] == value) && valid) {
+					state.rootType[slot] = type;
+					state.rootValue[slot] = value;
+				}
+				break;
+			}
+			case RenderCommandType::IASetPrimitiveTopology: {
+				auto &command = *(const CmdIASetPrimitiveTopology *)header;
+				if (CountState(type, state.topologyBound && state.topology == command.topology)) {
+					state.topologyBound = true;
+					state.topology = command.topology;
+				}
+				break;
+			}
+			case RenderCommandType::IASetVertexBuffer: {
+				auto &command = *(const CmdIASetVertexBuffer *)header;
+				const bool valid = command.slot < maxVertexSlots;
+				if (CountState(type, valid && state.vertexBound[command.slot] && SameView(state.vertex[command.slot], command.view)) && valid) {
+					state.vertexBound[command.slot] = true;
+					state.vertex[command.slot] = command.view;
+				}
+				break;
+			}
+			case RenderCommandType::IASetIndexBuffer: {
+				auto &command = *(const CmdIASetIndexBuffer *)header;
+				if (CountState(type, state.indexBound && SameView(state.index, command.view))) {
+					state.indexBound = true;
+					state.index = command.view;
+				}
+				break;
+			}
+			case RenderCommandType::RSSetViewport: {
+				auto &command = *(const CmdRSSetViewport *)header;
+				const bool same = state.viewportBound &&
+					state.viewport.x == command.x && state.viewport.y == command.y &&
+					state.viewport.width == command.width && state.viewport.height == command.height &&
+					state.viewport.minDepth == command.minDepth && state.viewport.maxDepth == command.maxDepth;
+				if (CountState(type, same)) {
+					state.viewportBound = true;
+					state.viewport = command;
+				}
+				break;
+			}
+			case RenderCommandType::RSSetScissorRect: {
+				auto &command = *(const CmdRSSetScissorRect *)header;
+				const bool same = state.scissorBound &&
+					state.scissor.left == command.left && state.scissor.top == command.top &&
+					state.scissor.right == command.right && state.scissor.bottom == command.bottom;
+				if (CountState(type, same)) {
+					state.scissorBound = true;
+					state.scissor = command;
+				}
+				break;
+			}
+			case RenderCommandType::OMSetRenderTargets: {
+				auto &command = *(const CmdOMSetRenderTargets *)header;
+				const bool same = state.targetsBound && state.renderTarget == command.renderTarget && state.depthStencil == command.depthStencil;
+				if (CountState(type, same)) {
+					state.targetsBound = true;
+					state.renderTarget = command.renderTarget;
+					state.depthStencil = command.depthStencil;
+				}
+				break;
+			}
+			case RenderCommandType::DrawIndexedInstanced: {
+				auto &command = *(const CmdDrawIndexedInstanced *)header;
+				stats.draws++;
+				stats.instances += command.instanceCount;
+				stats.indices += (uint64_t)command.indexCount * command.instanceCount;
+				stats.calls[(uint32_t)type]++;
+				break;
+			}
+			case RenderCommandType::DrawInstanced: {
+				auto &command = *(const CmdDrawInstanced *)header;
+				stats.draws++;
+				stats.instances += command.instanceCount;
+				stats.indices += (uint64_t)command.vertexCount * command.instanceCount;
+				stats.calls[(uint32_t)type]++;
+				break;
+			}
+			case RenderCommandType::CopyBufferRegion: {
+				stats.copyBytes += ((const CmdCopyBufferRegion *)header)->size;
+				stats.calls[(uint32_t)type]++;
+				break;
+			}
+			case RenderCommandType::Upload: {
+				stats.uploadBytes += ((const CmdUpload *)header)->bytes;
+				stats.calls[(uint32_t)type]++;
+				break;
+			}
+
+			//Clears, barriers, queries: counted only
+			default: {
+				if ((uint32_t)type < renderCommandTypeCount) {
+					stats.calls[(uint32_t)type]++;
+				}
+				break;
+			}
+		}
+	}
+}
+
+const RenderStats &NullRenderBackend::GetStats() const
+{
+	return stats;
+}
+
+void NullRenderBackend::ResetStats()
+{
+	stats = RenderStats();
+}
+
+bool NullRenderBackend::CountState(const RenderCommandType type, const bool same)
+{
+	stats.calls[(uint32_t)type]++;
+	stats.stateCalls++;
+	if (same) {
+		stats.redundant[(uint32_t)type]++;
+		stats.redundantCalls++;
+	}
+	return !same;
+}
+
+void NullRenderBackend::UnbindRootArguments(BoundState &state)
+{
+	for (uint32_t i = 0; i < maxRootSlots; ++i) {
+		state.rootType[i] = RenderCommandType::Count;
+		state.rootValue[i] = 0;
+	}
+}
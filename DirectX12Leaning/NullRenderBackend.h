@@ -0,0 +1,85 @@
+#pragma once
+#include "RenderCommandList.h"
+
+//What a command list asked of the GPU
+struct RenderStats
+{
+	uint32_t commands = 0;
+	uint64_t streamBytes = 0;
+
+	uint32_t draws = 0;
+	uint64_t instances = 0;
+	uint64_t indices = 0;			//Indices / vertices of every instance
+	uint64_t uploadBytes = 0;		//Upload markers
+	uint64_t copyBytes = 0;			//CopyBufferRegion
+
+	uint32_t stateCalls = 0;		//State setting calls (pipeline, root signature / arguments, heaps, IA, RS, OM)
+	uint32_t redundantCalls = 0;	//... that set the value already bound
+
+	uint32_t calls[renderCommandTypeCount] = {};
+	uint32_t redundant[renderCommandTypeCount] = {};
+
+	void Add(const RenderStats &other);
+};
+
+/// <summary>
+/// Backend without a GPU: walks a RenderCommandList and counts it
+/// </summary>
+/// <remarks>
+/// Bound state is tracked the way D3D12 tracks it for one command list (a new root signature
+/// drops the root arguments), so a call is redundant only when D3D12 would ignore it too.
+/// </remarks>
+class NullRenderBackend
+{
+public:
+	static const uint32_t maxRootSlots = 16;
+	static const uint32_t maxVertexSlots = 8;
+
+	/// <summary>
+	/// Count list as one command list (state starts unbound), added to the stats
+	/// </summary>
+	void Execute(const RenderCommandList &list);
+
+	//Commands [begin, end) as one command list (RenderSubmission range)
+	void Execute(const RenderCommandHeader *begin, const RenderCommandHeader *end);
+
+	const RenderStats &GetStats() const;
+	void ResetStats();
+
+private:
+	struct BoundState
+	{
+		bool pipelineBound;
+		void *pipeline;
+		bool rootSignatureBound;
+		void *rootSignature;
+		bool heapsBound;
+		uint32_t heapCount;
+		void *heaps[CmdSetDescriptorHeaps::maxHeaps];
+		bool topologyBound;
+		uint32_t topology;
+
+		//Root arguments: command type + value, unbound = Count
+		RenderCommandType rootType[maxRootSlots];
+		uint64_t rootValue[maxRootSlots];
+
+		bool vertexBound[maxVertexSlots];
+		RenderVertexBufferView vertex[maxVertexSlots];
+		bool indexBound;
+		RenderIndexBufferView index;
+		bool viewportBound;
+		CmdRSSetViewport viewport;
+		bool scissorBound;
+		CmdRSSetScissorRect scissor;
+		bool targetsBound;
+		CpuDescriptor renderTarget;
+		CpuDescriptor depthStencil;
+	};
+
+	//Count a state call, true when it changes the bound state
+	bool CountState(const RenderCommandType type, const bool same);
+	void UnbindRootArguments(BoundState &state);
+
+private:
+	RenderStats stats;
+};
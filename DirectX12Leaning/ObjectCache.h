@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "CacheKey.h"
+
+/// <summary>
+/// Dedup table: one object per distinct key content
+/// </summary>
+template<class T>
+class ObjectCache
+{
+public:
+	ObjectCache() : hitCount(0), missCount(0), size(0) {}
+
+	/// <summary>
+	/// Find the object for key
+	/// </summary>
+	/// <returns>false when not cached</returns>
+	bool Find(const CacheKey &key, T &value) const
+	{
+		auto bucket = buckets.find(key.GetHash());
+		if (bucket == buckets.end()) {
+			return false;
+		}
+
+		//Same hash, compare the full key
+		for (auto &entry : bucket->second) {
+			if (entry.key == key) {
+				value = entry.value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void Insert(const CacheKey &key, const T &value)
+	{
+		buckets[key.GetHash()].push_back({ key, value });
+		++size;
+	}
+
+	/// <summary>
+	/// Return the cached object or create it once with create()
+	/// </summary>
+	template<class Create>
+	T GetOrCreate(const CacheKey &key, Create create)
+	{
+		T value;
+		if (Find(key, value)) {
+			++hitCount;
+			return value;
+		}
+
+		++missCount;
+		value = create();
+		Insert(key, value);
+		return value;
+	}
+
+	template<class Func>
+	void ForEach(Func func)
+	{
+		for (auto &bucket : buckets) {
+			for (auto &entry : bucket.second) {
+				func(entry.value);
+			}
+		}
+	}
+
+	void Clear()
+	{
+		buckets.clear();
+		size = 0;
+	}
+
+	size_t GetSize() const { return size; }
+	uint64_t GetHitCount() const { return hitCount; }
+	uint64_t GetMissCount() const { return missCount; }
+
+private:
+	struct Entry
+	{
+		CacheKey key;
+		T value;
+	};
+
+	std::unordered_map<uint64_t, std::vector<Entry>> buckets;
+	uint64_t hitCount;
+	uint64_t missCount;
+	size_t size;
+};
@@ -0,0 +1,199 @@
+//API
+#include <d3d12.h>
+#pragma comment(lib, "d3d12.lib")
+
+//STL
+#include <assert.h>
+
+//Utility
+#include "PipelineKey.h"
+
+//this
+#include "PipelineCache.h"
+
+namespace
+{
+	PipelineShader ToPipelineShader(const D3D12_SHADER_BYTECODE &shader)
+	{
+		PipelineShader out;
+		out.bytecode = shader.pShaderBytecode;
+		out.size = shader.BytecodeLength;
+		return out;
+	}
+
+	PipelineStencilOp ToPipelineStencilOp(const D3D12_DEPTH_STENCILOP_DESC &op)
+	{
+		PipelineStencilOp out;
+		out.failOp = op.StencilFailOp;
+		out.depthFailOp = op.StencilDepthFailOp;
+		out.passOp = op.StencilPassOp;
+		out.func = op.StencilFunc;
+		return out;
+	}
+
+	//Copy of desc in the portable key layout (pointers still refer to desc's arrays / strings)
+	PipelineKeyDesc ToPipelineKeyDesc(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc)
+	{
+		PipelineKeyDesc out;
+		out.rootSignature = desc.pRootSignature;
+
+		out.vs = ToPipelineShader(desc.VS);
+		out.ps = ToPipelineShader(desc.PS);
+		out.ds = ToPipelineShader(desc.DS);
+		out.hs = ToPipelineShader(desc.HS);
+		out.gs = ToPipelineShader(desc.GS);
+
+		//Stream output
+		for (UINT i = 0; i < desc.StreamOutput.NumEntries; ++i) {
+			const D3D12_SO_DECLARATION_ENTRY &entry = desc.StreamOutput.pSODeclaration[i];
+			PipelineStreamOutputEntry so;
+			so.stream = entry.Stream;
+			so.semanticName = entry.SemanticName;
+			so.semanticIndex = entry.SemanticIndex;
+			so.startComponent = entry.StartComponent;
+			so.componentCount = entry.ComponentCount;
+			so.outputSlot = entry.OutputSlot;
+			out.streamOutput.push_back(so);
+		}
+		out.streamOutputStrides.assign(desc.StreamOutput.pBufferStrides, desc.StreamOutput.pBufferStrides + desc.StreamOutput.NumStrides);
+		out.rasterizedStream = desc.StreamOutput.RasterizedStream;
+
+		//Blend
+		out.alphaToCoverageEnable = desc.BlendState.AlphaToCoverageEnable;
+		out.independentBlendEnable = desc.BlendState.IndependentBlendEnable;
+		for (UINT i = 0; i < pipelineMaxRenderTargets; ++i) {
+			const D3D12_RENDER_TARGET_BLEND_DESC &rt = desc.BlendState.RenderTarget[i];
+			PipelineRenderTargetBlend &blend = out.blend[i];
+			blend.blendEnable = rt.BlendEnable;
+			blend.logicOpEnable = rt.LogicOpEnable;
+			blend.srcBlend = rt.SrcBlend;
+			blend.destBlend = rt.DestBlend;
+			blend.blendOp = rt.BlendOp;
+			blend.srcBlendAlpha = rt.SrcBlendAlpha;
+			blend.destBlendAlpha = rt.DestBlendAlpha;
+			blend.blendOpAlpha = rt.BlendOpAlpha;
+			blend.logicOp = rt.LogicOp;
+			blend.writeMask = rt.RenderTargetWriteMask;
+		}
+		out.sampleMask = desc.SampleMask;
+
+		//Rasterizer
+		const D3D12_RASTERIZER_DESC &rasterizer = desc.RasterizerState;
+		out.rasterizer.fillMode = rasterizer.FillMode;
+		out.rasterizer.cullMode = rasterizer.CullMode;
+		out.rasterizer.frontCounterClockwise = rasterizer.FrontCounterClockwise;
+		out.rasterizer.depthBias = rasterizer.DepthBias;
+		out.rasterizer.depthBiasClamp = rasterizer.DepthBiasClamp;
+		out.rasterizer.slopeScaledDepthBias = rasterizer.SlopeScaledDepthBias;
+		out.rasterizer.depthClipEnable = rasterizer.DepthClipEnable;
+		out.rasterizer.multisampleEnable = rasterizer.MultisampleEnable;
+		out.rasterizer.antialiasedLineEnable = rasterizer.AntialiasedLineEnable;
+		out.rasterizer.forcedSampleCount = rasterizer.ForcedSampleCount;
+		out.rasterizer.conservativeRaster = rasterizer.ConservativeRaster;
+
+		//Depth stencil
+		const D3D12_DEPTH_STENCIL_DESC &depth = desc.DepthStencilState;
+		out.depthStencil.depthEnable = depth.DepthEnable;
+		out.depthStencil.depthWriteMask = depth.DepthWriteMask;
+		out.depthStencil.depthFunc = depth.DepthFunc;
+		out.depthStencil.stencilEnable = depth.StencilEnable;
+		out.depthStencil.stencilReadMask = depth.StencilReadMask;
+		out.depthStencil.stencilWriteMask = depth.StencilWriteMask;
+		out.depthStencil.frontFace = ToPipelineStencilOp(depth.FrontFace);
+		out.depthStencil.backFace = ToPipelineStencilOp(depth.BackFace);
+
+		//Input layout
+		for (UINT i = 0; i < desc.InputLayout.NumElements; ++i) {
+			const D3D12_INPUT_ELEMENT_DESC &element = desc.InputLayout.pInputElementDescs[i];
+			PipelineInputElement input;
+			input.semanticName = element.SemanticName;
+			input.semanticIndex = element.SemanticIndex;
+			input.format = element.Format;
+			input.inputSlot = element.InputSlot;
+			input.alignedByteOffset = element.AlignedByteOffset;
+			input.inputSlotClass = element.InputSlotClass;
+			input.instanceDataStepRate = element.InstanceDataStepRate;
+			out.inputLayout.push_back(input);
+		}
+
+		out.ibStripCutValue = desc.IBStripCutValue;
+		out.primitiveTopologyType = desc.PrimitiveTopologyType;
+		out.numRenderTargets = desc.NumRenderTargets;
+		for (UINT i = 0; i < desc.NumRenderTargets && i < pipelineMaxRenderTargets; ++i) {
+			out.rtvFormats[i] = desc.RTVFormats[i];
+		}
+		out.dsvFormat = desc.DSVFormat;
+		out.sampleCount = desc.SampleDesc.Count;
+		out.sampleQuality = desc.SampleDesc.Quality;
+		out.nodeMask = desc.NodeMask;
+		out.flags = desc.Flags;
+		return out;
+	}
+}
+
+PipelineCache::PipelineCache() : dev(nullptr) {}
+
+PipelineCache::~PipelineCache()
+{
+	pipelineStates.ForEach([](ID3D12PipelineState *v) { v->Release(); });
+	rootSignatures.ForEach([](ID3D12RootSignature *v) { v->Release(); });
+}
+
+void PipelineCache::Initialize(ID3D12Device *dev)
+{
+	this->dev = dev;
+}
+
+ID3D12RootSignature *PipelineCache::GetRootSignature(const D3D12_ROOT_SIGNATURE_DESC &desc)
+{
+	ID3DBlob *rootSigBlob = nullptr;
+	ID3DBlob *errorBlob = nullptr;
+	result = D3D12SerializeRootSignature(&desc, D3D_ROOT_SIGNATURE_VERSION_1_0, &rootSigBlob, &errorBlob);
+	assert(result == S_OK);
+
+	CacheKey key;
+	key.Write(rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize());
+
+	ID3D12RootSignature *rootsignature = rootSignatures.GetOrCreate(key, [&]() {
+		ID3D12RootSignature *created = nullptr;
+		result = dev->CreateRootSignature(0, rootSigBlob->GetBufferPointer(), rootSigBlob->GetBufferSize(), IID_PPV_ARGS(&created));
+		assert(result == S_OK);
+		return created;
+	});
+
+	rootSigBlob->Release();
+	return rootsignature;
+}
+
+ID3D12PipelineState *PipelineCache::GetPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc)
+{
+	CacheKey key;
+	WritePipelineKey(key, ToPipelineKeyDesc(desc));
+
+	return pipelineStates.GetOrCreate(key, [&]() {
+		ID3D12PipelineState *created = nullptr;
+		result = dev->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&created));
+		assert(result == S_OK);
+		return created;
+	});
+}
+
+size_t PipelineCache::GetRootSignatureCount() const
+{
+	return rootSignatures.GetSize();
+}
+
+size_t PipelineCache::GetPipelineStateCount() const
+{
+	return pipelineStates.GetSize();
+}
+
+uint64_t PipelineCache::GetHitCount() const
+{
+	return rootSignatures.GetHitCount() + pipelineStates.GetHitCount();
+}
+
+uint64_t PipelineCache::GetMissCount() const
+{
+	return rootSignatures.GetMissCount() + pipelineStates.GetMissCount();
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "ObjectCache.h"
+
+/// <summary>
+/// Shares root signatures and pipeline states between objects with identical descriptions
+/// </summary>
+class PipelineCache
+{
+public:
+	PipelineCache();
+	~PipelineCache();
+	void Initialize(ID3D12Device *dev);
+
+	/// <summary>
+	/// Root signature for desc (key = serialized blob)
+	/// </summary>
+	ID3D12RootSignature *GetRootSignature(const D3D12_ROOT_SIGNATURE_DESC &desc);
+
+	/// <summary>
+	/// Pipeline state for desc (key = desc content, shader bytecode included)
+	/// </summary>
+	/// <returns>Owned by the cache, do not Release</returns>
+	ID3D12PipelineState *GetPipelineState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC &desc);
+
+	size_t GetRootSignatureCount() const;
+	size_t GetPipelineStateCount() const;
+	uint64_t GetHitCount() const;
+	uint64_t GetMissCount() const;
+
+private:
+	ID3D12Device *dev;
+	HRESULT result;
+
+	ObjectCache<ID3D12RootSignature *> rootSignatures;
+	ObjectCache<ID3D12PipelineState *> pipelineStates;
+};
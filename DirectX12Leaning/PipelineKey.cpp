@@ -0,0 +1,119 @@
+//this
+#include "PipelineKey.h"
+
+namespace
+{
+	void WriteShader(CacheKey &key, const PipelineShader &shader)
+	{
+		key.WriteValue(shader.size);
+		key.Write(shader.bytecode, static_cast<size_t>(shader.size));
+	}
+
+	//Field by field: the structs contain padding
+	void WriteBlend(CacheKey &key, const PipelineRenderTargetBlend &rt)
+	{
+		key.WriteValue(rt.blendEnable);
+		key.WriteValue(rt.logicOpEnable);
+		key.WriteValue(rt.srcBlend);
+		key.WriteValue(rt.destBlend);
+		key.WriteValue(rt.blendOp);
+		key.WriteValue(rt.srcBlendAlpha);
+		key.WriteValue(rt.destBlendAlpha);
+		key.WriteValue(rt.blendOpAlpha);
+		key.WriteValue(rt.logicOp);
+		key.WriteValue(rt.writeMask);
+	}
+
+	void WriteRasterizer(CacheKey &key, const PipelineRasterizer &rasterizer)
+	{
+		key.WriteValue(rasterizer.fillMode);
+		key.WriteValue(rasterizer.cullMode);
+		key.WriteValue(rasterizer.frontCounterClockwise);
+		key.WriteValue(rasterizer.depthBias);
+		key.WriteValue(rasterizer.depthBiasClamp);
+		key.WriteValue(rasterizer.slopeScaledDepthBias);
+		key.WriteValue(rasterizer.depthClipEnable);
+		key.WriteValue(rasterizer.multisampleEnable);
+		key.WriteValue(rasterizer.antialiasedLineEnable);
+		key.WriteValue(rasterizer.forcedSampleCount);
+		key.WriteValue(rasterizer.conservativeRaster);
+	}
+
+	void WriteStencilOp(CacheKey &key, const PipelineStencilOp &op)
+	{
+		key.WriteValue(op.failOp);
+		key.WriteValue(op.depthFailOp);
+		key.WriteValue(op.passOp);
+		key.WriteValue(op.func);
+	}
+
+	void WriteDepthStencil(CacheKey &key, const PipelineDepthStencil &depth)
+	{
+		key.WriteValue(depth.depthEnable);
+		key.WriteValue(depth.depthWriteMask);
+		key.WriteValue(depth.depthFunc);
+		key.WriteValue(depth.stencilEnable);
+		key.WriteValue(depth.stencilReadMask);
+		key.WriteValue(depth.stencilWriteMask);
+		WriteStencilOp(key, depth.frontFace);
+		WriteStencilOp(key, depth.backFace);
+	}
+}
+
+void WritePipelineKey(CacheKey &key, const PipelineKeyDesc &desc)
+{
+	key.WriteValue(desc.rootSignature);
+
+	WriteShader(key, desc.vs);
+	WriteShader(key, desc.ps);
+	WriteShader(key, desc.ds);
+	WriteShader(key, desc.hs);
+	WriteShader(key, desc.gs);
+
+	//Stream output
+	key.WriteValue(static_cast<uint32_t>(desc.streamOutput.size()));
+	for (auto &entry : desc.streamOutput) {
+		key.WriteValue(entry.stream);
+		key.WriteString(entry.semanticName);
+		key.WriteValue(entry.semanticIndex);
+		key.WriteValue(entry.startComponent);
+		key.WriteValue(entry.componentCount);
+		key.WriteValue(entry.outputSlot);
+	}
+	key.WriteValue(static_cast<uint32_t>(desc.streamOutputStrides.size()));
+	key.Write(desc.streamOutputStrides.data(), sizeof(uint32_t) * desc.streamOutputStrides.size());
+	key.WriteValue(desc.rasterizedStream);
+
+	key.WriteValue(desc.alphaToCoverageEnable);
+	key.WriteValue(desc.independentBlendEnable);
+	for (auto &rt : desc.blend) {
+		WriteBlend(key, rt);
+	}
+	key.WriteValue(desc.sampleMask);
+	WriteRasterizer(key, desc.rasterizer);
+	WriteDepthStencil(key, desc.depthStencil);
+
+	//Input layout
+	key.WriteValue(static_cast<uint32_t>(desc.inputLayout.size()));
+	for (auto &element : desc.inputLayout) {
+		key.WriteString(element.semanticName);
+		key.WriteValue(element.semanticIndex);
+		key.WriteValue(element.format);
+		key.WriteValue(element.inputSlot);
+		key.WriteValue(element.alignedByteOffset);
+		key.WriteValue(element.inputSlotClass);
+		key.WriteValue(element.instanceDataStepRate);
+	}
+
+	key.WriteValue(desc.ibStripCutValue);
+	key.WriteValue(desc.primitiveTopologyType);
+	key.WriteValue(desc.numRenderTargets);
+	for (uint32_t i = 0; i < desc.numRenderTargets && i < pipelineMaxRenderTargets; ++i) {
+		key.WriteValue(desc.rtvFormats[i]);
+	}
+	key.WriteValue(desc.dsvFormat);
+	key.WriteValue(desc.sampleCount);
+	key.WriteValue(desc.sampleQuality);
+	key.WriteValue(desc.nodeMask);
+	key.WriteValue(desc.flags);
+}
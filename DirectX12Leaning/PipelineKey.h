@@ -0,0 +1,126 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "CacheKey.h"
+
+//Portable mirror of D3D12_GRAPHICS_PIPELINE_STATE_DESC: enums keep their D3D12 values as
+//uint32_t, BOOL as int32_t. PipelineCache fills it, so the key builds without d3d12.h.
+
+struct PipelineShader
+{
+	const void *bytecode = nullptr;
+	uint64_t size = 0;
+};
+
+struct PipelineStreamOutputEntry
+{
+	uint32_t stream = 0;
+	const char *semanticName = nullptr;
+	uint32_t semanticIndex = 0;
+	uint8_t startComponent = 0;
+	uint8_t componentCount = 0;
+	uint8_t outputSlot = 0;
+};
+
+struct PipelineRenderTargetBlend
+{
+	int32_t blendEnable = 0;
+	int32_t logicOpEnable = 0;
+	uint32_t srcBlend = 0;
+	uint32_t destBlend = 0;
+	uint32_t blendOp = 0;
+	uint32_t srcBlendAlpha = 0;
+	uint32_t destBlendAlpha = 0;
+	uint32_t blendOpAlpha = 0;
+	uint32_t logicOp = 0;
+	uint8_t writeMask = 0;
+};
+
+struct PipelineRasterizer
+{
+	uint32_t fillMode = 0;
+	uint32_t cullMode = 0;
+	int32_t frontCounterClockwise = 0;
+	int32_t depthBias = 0;
+	float depthBiasClamp = 0;
+	float slopeScaledDepthBias = 0;
+	int32_t depthClipEnable = 0;
+	int32_t multisampleEnable = 0;
+	int32_t antialiasedLineEnable = 0;
+	uint32_t forcedSampleCount = 0;
+	uint32_t conservativeRaster = 0;
+};
+
+struct PipelineStencilOp
+{
+	uint32_t failOp = 0;
+	uint32_t depthFailOp = 0;
+	uint32_t passOp = 0;
+	uint32_t func = 0;
+};
+
+struct PipelineDepthStencil
+{
+	int32_t depthEnable = 0;
+	uint32_t depthWriteMask = 0;
+	uint32_t depthFunc = 0;
+	int32_t stencilEnable = 0;
+	uint8_t stencilReadMask = 0;
+	uint8_t stencilWriteMask = 0;
+	PipelineStencilOp frontFace;
+	PipelineStencilOp backFace;
+};
+
+struct PipelineInputElement
+{
+	const char *semanticName = nullptr;
+	uint32_t semanticIndex = 0;
+	uint32_t format = 0;
+	uint32_t inputSlot = 0;
+	uint32_t alignedByteOffset = 0;
+	uint32_t inputSlotClass = 0;
+	uint32_t instanceDataStepRate = 0;
+};
+
+const uint32_t pipelineMaxRenderTargets = 8;
+
+struct PipelineKeyDesc
+{
+	//Root signatures come from PipelineCache, so the pointer identifies the content
+	const void *rootSignature = nullptr;
+
+	PipelineShader vs;
+	PipelineShader ps;
+	PipelineShader ds;
+	PipelineShader hs;
+	PipelineShader gs;
+
+	std::vector<PipelineStreamOutputEntry> streamOutput;
+	std::vector<uint32_t> streamOutputStrides;
+	uint32_t rasterizedStream = 0;
+
+	int32_t alphaToCoverageEnable = 0;
+	int32_t independentBlendEnable = 0;
+	PipelineRenderTargetBlend blend[pipelineMaxRenderTargets];
+
+	uint32_t sampleMask = 0;
+	PipelineRasterizer rasterizer;
+	PipelineDepthStencil depthStencil;
+
+	std::vector<PipelineInputElement> inputLayout;
+
+	uint32_t ibStripCutValue = 0;
+	uint32_t primitiveTopologyType = 0;
+	uint32_t numRenderTargets = 0;
+	uint32_t rtvFormats[pipelineMaxRenderTargets] = {};
+	uint32_t dsvFormat = 0;
+	uint32_t sampleCount = 0;
+	uint32_t sampleQuality = 0;
+	uint32_t nodeMask = 0;
+	uint32_t flags = 0;
+};
+
+/// <summary>
+/// Write a pipeline description into key (shader bytecode by content, strings by text)
+/// </summary>
+void WritePipelineKey(CacheKey &key, const PipelineKeyDesc &desc);
@@ -1,21 +1,18 @@
 #pragma once
+#include "SimulationTypes.h"
+
 class PlayerOP
 {
 public:
 	PlayerOP();
-	PlayerOP(float x, float y, float z, float r, Input *input);
-	void Update();
-	const DirectX::XMMATRIX GetPlayerPositionMatrix() const;
-	DirectX::XMFLOAT2 GetPosition() const;
+	PlayerOP(float x, float y, float z, float r);
+	void Update(const SimInput &input, const float deltaTime);
 	Position3D Get3DPoint() const;
 
 private:
 	bool GetCollition(Position3D targetPos, float targetRadius) const;
 
 private:
-	Input *input;
-
 	float radius;
 	Position3D position;
-	DirectX::XMMATRIX matrixTranslation;
-};
\ No newline at end of file
+};
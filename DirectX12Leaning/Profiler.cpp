@@ -0,0 +1,294 @@
+//STL
+#include <cstdio>
+#include <string>
+
+//this
+#include "Profiler.h"
+
+namespace
+{
+	static_assert((profileRingSize & (profileRingSize - 1)) == 0, "profileRingSize must be a power of two");
+
+	//JSON string body (quotes / backslashes / control characters escaped)
+	void AppendEscaped(std::string &out, const char *text)
+	{
+		for (const char *c = text; *c != '\0'; ++c) {
+			switch (*c) {
+				case '"':	out += "\\\""; break;
+				case '\\':	out += "\\\\"; break;
+				default: {
+					if ((unsigned char)*c < 0x20) {
+						char code[8];
+						snprintf(code, sizeof(code), "\\u%04x", (unsigned)(unsigned char)*c);
+						out += code;
+					}
+					else {
+						out += *c;
+					}
+					break;
+				}
+			}
+		}
+	}
+
+	//Nanoseconds -> trace microseconds (fixed point, no locale / printf per value)
+	void AppendMicroseconds(std::string &out, const int64_t nanoseconds)
+	{
+		const uint64_t magnitude = nanoseconds < 0 ? (uint64_t)-nanoseconds : (uint64_t)nanoseconds;
+		const uint64_t fraction = magnitude % 1000;
+		if (nanoseconds < 0) {
+			out += '-';
+		}
+		out += std::to_string(magnitude / 1000);
+		out += '.';
+		out += (char)('0' + fraction / 100);
+		out += (char)('0' + fraction / 10 % 10);
+		out += (char)('0' + fraction % 10);
+	}
+}
+
+thread_local Profiler::Ring *Profiler::threadRing = nullptr;
+
+Profiler &Profiler::Get()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler() :
+	capturing(false),
+	captureDropped(0),
+	captureStart(0)
+{
+	gpuRing = CreateRing(profileGpuTrack);
+	gpuRing->name = "GPU";
+}
+
+Profiler::~Profiler()
+{
+}
+
+void Profiler::Start()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	//Leftovers of the last capture
+	for (auto &ring : rings) {
+		ring->read.store(ring->write.load(std::memory_order_acquire), std::memory_order_release);
+		ring->dropped.store(0, std::memory_order_relaxed);
+	}
+	captured.clear();
+	counters.clear();
+	captureDropped = 0;
+
+	captureStart = Now();
+	capturing.store(true, std::memory_order_release);
+}
+
+void Profiler::Stop()
+{
+	capturing.store(false, std::memory_order_release);
+}
+
+void Profiler::Record(const char *name, const int64_t begin, const int64_t end)
+{
+	if (!IsCapturing()) {
+		return;
+	}
+	Push(*GetThreadRing(), { name, begin, end });
+}
+
+void Profiler::RecordGpu(const char *name, const int64_t begin, const int64_t end)
+{
+	if (!IsCapturing()) {
+		return;
+	}
+	Push(*gpuRing, { name, begin, end });
+}
+
+void Profiler::RecordCounter(const char *name, const int64_t value)
+{
+	if (!IsCapturing()) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	if (counters.size() < profileCaptureLimit) {
+		counters.push_back({ name, Now(), value });
+	}
+	else {
+		++captureDropped;
+	}
+}
+
+void Profiler::SetThreadName(const char *name)
+{
+	Ring *ring = GetThreadRing();
+
+	std::lock_guard<std::mutex> lock(mutex);
+	ring->name = name;
+}
+
+void Profiler::Collect()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	for (auto &ring : rings) {
+		Drain(*ring);
+	}
+}
+
+bool Profiler::WriteChromeTrace(std::ostream &out) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	//Built in chunks, one stream write per chunk
+	std::string text = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+	//Track names: CPU threads in process 1, GPU queue in process 2
+	text += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"CPU\"}},\n";
+	text += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"tid\":0,\"args\":{\"name\":\"GPU\"}}";
+	for (auto &ring : rings) {
+		const int pid = ring->track == profileGpuTrack ? 2 : 1;
+		text += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(ring->track) + ",\"args\":{\"name\":\"";
+		if (ring->name != nullptr) {
+			AppendEscaped(text, ring->name);
+		}
+		else {
+			text += "Thread " + std::to_string(ring->track);
+		}
+		text += "\"}}";
+	}
+
+	//Complete events, times relative to Start
+	for (auto &item : captured) {
+		const ProfileEvent &event = item.event;
+		const int pid = item.track == profileGpuTrack ? 2 : 1;
+
+		text += ",\n{\"name\":\"";
+		AppendEscaped(text, event.name);
+		text += "\",\"ph\":\"X\",\"pid\":";
+		text += (char)('0' + pid);
+		text += ",\"tid\":";
+		text += std::to_string(item.track);
+		text += ",\"ts\":";
+		AppendMicroseconds(text, event.begin - captureStart);
+		text += ",\"dur\":";
+		AppendMicroseconds(text, event.end - event.begin);
+		text += '}';
+
+		if (text.size() >= 64 * 1024) {
+			out.write(text.data(), text.size());
+			text.clear();
+		}
+	}
+
+	//Counter tracks (CPU process)
+	for (auto &counter : counters) {
+		text += ",\n{\"name\":\"";
+		AppendEscaped(text, counter.name);
+		text += "\",\"ph\":\"C\",\"pid\":1,\"ts\":";
+		AppendMicroseconds(text, counter.time - captureStart);
+		text += ",\"args\":{\"value\":";
+		text += std::to_string(counter.value);
+		text += "}}";
+
+		if (text.size() >= 64 * 1024) {
+			out.write(text.data(), text.size());
+			text.clear();
+		}
+	}
+
+	text += "\n]}\n";
+	out.write(text.data(), text.size());
+	return (bool)out;
+}
+
+std::vector<CapturedEvent> Profiler::GetEvents() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return captured;
+}
+
+std::vector<ProfileCounter> Profiler::GetCounters() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return counters;
+}
+
+uint64_t Profiler::GetDroppedCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint64_t count = captureDropped;
+	for (auto &ring : rings) {
+		count += ring->dropped.load(std::memory_order_relaxed);
+	}
+	return count;
+}
+
+uint32_t Profiler::GetThreadCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	//Without the GPU ring
+	return (uint32_t)rings.size() - 1;
+}
+
+Profiler::Ring *Profiler::CreateRing(const uint32_t track)
+{
+	std::unique_ptr<Ring> ring(new Ring);
+	ring->events.reset(new ProfileEvent[profileRingSize]);
+	ring->write.store(0, std::memory_order_relaxed);
+	ring->cachedRead = 0;
+	ring->dropped.store(0, std::memory_order_relaxed);
+	ring->read.store(0, std::memory_order_relaxed);
+	ring->name = nullptr;
+	ring->track = track;
+
+	rings.push_back(std::move(ring));
+	return rings.back().get();
+}
+
+Profiler::Ring *Profiler::GetThreadRing()
+{
+	//Only one profiler records (Get), the thread local pointer belongs to it
+	if (threadRing == nullptr) {
+		std::lock_guard<std::mutex> lock(mutex);
+		threadRing = CreateRing((uint32_t)rings.size());
+	}
+	return threadRing;
+}
+
+void Profiler::Push(Ring &ring, const ProfileEvent &event)
+{
+	//Only this thread writes write, only Collect writes read
+	const uint32_t write = ring.write.load(std::memory_order_relaxed);
+	if (write - ring.cachedRead >= profileRingSize) {
+		ring.cachedRead = ring.read.load(std::memory_order_acquire);
+		if (write - ring.cachedRead >= profileRingSize) {
+			ring.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	ring.events[write & (profileRingSize - 1)] = event;
+	ring.write.store(write + 1, std::memory_order_release);
+}
+
+void Profiler::Drain(Ring &ring)
+{
+	const uint32_t read = ring.read.load(std::memory_order_relaxed);
+	const uint32_t write = ring.write.load(std::memory_order_acquire);
+
+	for (uint32_t i = read; i != write; ++i) {
+		if (captured.size() < profileCaptureLimit) {
+			captured.push_back({ ring.events[i & (profileRingSize - 1)], ring.track });
+		}
+		else {
+			++captureDropped;
+		}
+	}
+
+	//The slots may be written again
+	ring.read.store(write, std::memory_order_release);
+}
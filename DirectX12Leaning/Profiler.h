@@ -0,0 +1,180 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+//0 compiles every PROFILE_SCOPE out
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+//Events a thread can record between two Collect calls, later ones are dropped (power of two)
+const uint32_t profileRingSize = 16 * 1024;
+
+//Events kept by one capture
+const size_t profileCaptureLimit = 4 * 1024 * 1024;
+
+//Track of GPU regions in the capture (GpuProfiler)
+const uint32_t profileGpuTrack = 0;
+
+//One timed region, name must outlive the capture (string literal)
+struct ProfileEvent
+{
+	const char *name;
+	int64_t begin;	//Profiler::Now
+	int64_t end;
+};
+
+//Value sampled at one time (Chrome trace counter track)
+struct ProfileCounter
+{
+	const char *name;
+	int64_t time;	//Profiler::Now
+	int64_t value;
+};
+
+struct CapturedEvent
+{
+	ProfileEvent event;
+	uint32_t track;		//Thread (registration order from 1) or profileGpuTrack
+};
+
+/// <summary>
+/// CPU scopes of every thread (and GPU regions) collected into one capture
+/// </summary>
+/// <remarks>
+/// Each thread writes to its own single producer ring, so recording never takes a lock;
+/// the mutex only guards the first event of a thread (ring registration), counters and Collect.
+/// Collect drains every ring into the capture, call it once per frame on one thread.
+/// Rings of finished threads stay registered until the profiler is destroyed.
+/// </remarks>
+class Profiler
+{
+public:
+	static Profiler &Get();
+
+	//steady_clock in nanoseconds (QueryPerformanceCounter on MSVC)
+	static int64_t Now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	Profiler();
+	~Profiler();
+
+	//Start / stop recording, Start clears the previous capture
+	void Start();
+	void Stop();
+	bool IsCapturing() const
+	{
+		return capturing.load(std::memory_order_relaxed);
+	}
+
+	//Called by ProfileScope on the thread that ran the scope
+	void Record(const char *name, const int64_t begin, const int64_t end);
+
+	//GPU region already converted to the Now clock (render thread only)
+	void RecordGpu(const char *name, const int64_t begin, const int64_t end);
+
+	//Counter sample, takes the lock (a few per frame, not per scope)
+	void RecordCounter(const char *name, const int64_t value);
+
+	//Label of the calling thread in the trace (string literal)
+	void SetThreadName(const char *name);
+
+	/// <summary>
+	/// Move recorded events of every thread into the capture
+	/// </summary>
+	void Collect();
+
+	/// <summary>
+	/// Capture as Chrome trace JSON (chrome://tracing, Perfetto)
+	/// </summary>
+	bool WriteChromeTrace(std::ostream &out) const;
+
+	//Copies taken under the lock, Collect / RecordCounter may run on other threads
+	std::vector<CapturedEvent> GetEvents() const;
+	std::vector<ProfileCounter> GetCounters() const;
+	uint64_t GetDroppedCount() const;	//Full rings + capture limit, up to the last Collect
+	uint32_t GetThreadCount() const;
+
+private:
+	//Producer and collector fields on their own cache lines
+	struct Ring
+	{
+		//Recording thread
+		std::atomic<uint32_t> write;
+		uint32_t cachedRead;			//Last read seen, reloaded only when the ring looks full
+		std::atomic<uint64_t> dropped;
+		char producerPadding[64];
+
+		//Collect
+		std::atomic<uint32_t> read;
+		char consumerPadding[64];
+
+		std::unique_ptr<ProfileEvent[]> events;
+		const char *name;
+		uint32_t track;
+	};
+
+	Ring *CreateRing(const uint32_t track);
+	Ring *GetThreadRing();
+	void Push(Ring &ring, const ProfileEvent &event);
+	void Drain(Ring &ring);
+
+	//Ring of the calling thread, registered on its first event
+	static thread_local Ring *threadRing;
+
+private:
+	std::atomic<bool> capturing;
+	uint64_t captureDropped;	//Over profileCaptureLimit
+	int64_t captureStart;
+
+	mutable std::mutex mutex;
+	std::vector<std::unique_ptr<Ring>> rings;
+	Ring *gpuRing;
+
+	std::vector<CapturedEvent> captured;
+	std::vector<ProfileCounter> counters;
+};
+
+/// <summary>
+/// Times the enclosing block
+/// </summary>
+class ProfileScope
+{
+public:
+	explicit ProfileScope(const char *name) :
+		name(name),
+		begin(Profiler::Get().IsCapturing() ? Profiler::Now() : 0)
+	{
+	}
+
+	~ProfileScope()
+	{
+		//Scopes that started before Start are not recorded
+		if (begin != 0) {
+			Profiler::Get().Record(name, begin, Profiler::Now());
+		}
+	}
+
+	ProfileScope(const ProfileScope &) = delete;
+	ProfileScope &operator=(const ProfileScope &) = delete;
+
+private:
+	const char *name;
+	int64_t begin;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if PROFILER_ENABLED
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) ((void)0)
+#endif
@@ -0,0 +1,159 @@
+//PROFILE_SCOPE cost per scope, idle and capturing, one and several threads
+//usage: ProfilerBench [scopes per thread] [threads] [trace.json]   (default 1000000 4)
+
+//STL
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+//Utility
+#include "Profiler.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	//Keeps the loop body from being optimized away (per thread, the workers share ScopeLoop)
+	thread_local volatile uint32_t sink = 0;
+
+	double Nanoseconds(const Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+	void EmptyLoop(const uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i) {
+			sink = sink + 1;
+		}
+	}
+
+	void ScopeLoop(const uint32_t count)
+	{
+		for (uint32_t i = 0; i < count; ++i) {
+			PROFILE_SCOPE("Scope");
+			sink = sink + 1;
+		}
+	}
+
+	//Scopes in batches that fit a ring, Collect between them like one per frame
+	double CaptureLoop(const uint32_t count, const uint32_t batch)
+	{
+		double elapsed = 0;
+		for (uint32_t done = 0; done < count; done += batch) {
+			const auto start = Clock::now();
+			ScopeLoop(std::min(batch, count - done));
+			elapsed += Nanoseconds(start);
+			Profiler::Get().Collect();
+		}
+		return elapsed;
+	}
+
+	double ClockCost(const uint32_t count)
+	{
+		const auto start = Clock::now();
+		for (uint32_t i = 0; i < count; ++i) {
+			sink = sink + (uint32_t)Profiler::Now();
+		}
+		return Nanoseconds(start) / count;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	const uint32_t count = argc > 1 ? (uint32_t)std::strtoul(argv[1], nullptr, 10) : 1000000;
+	const uint32_t threadCount = argc > 2 ? (uint32_t)std::strtoul(argv[2], nullptr, 10) : 4;
+	const char *tracePath = argc > 3 ? argv[3] : nullptr;
+	Profiler &profiler = Profiler::Get();
+	profiler.SetThreadName("Main");
+
+	auto start = Clock::now();
+	EmptyLoop(count);
+	const double baseline = Nanoseconds(start) / count;
+
+	//Not capturing: one relaxed load per scope
+	start = Clock::now();
+	ScopeLoop(count);
+	const double idle = std::max(0.0, Nanoseconds(start) / count - baseline);
+
+	//Capturing, one thread, the ring never fills
+	const uint32_t batch = profileRingSize / 2;
+	profiler.Start();
+	const double capture = CaptureLoop(count, batch) / count - baseline;
+	profiler.Stop();
+	profiler.Collect();
+	const size_t singleEvents = profiler.GetEvents().size();
+	const uint64_t singleDropped = profiler.GetDroppedCount();
+
+	//Capturing on several threads at once, this one collects after every "frame" of batch scopes.
+	//Cost per scope = busy time / scopes (collect included), so it does not depend on the core count
+	const uint32_t frameCount = (count + batch - 1) / batch;
+	std::atomic<uint32_t> frame(0);
+	std::atomic<uint32_t> finished(0);
+	std::vector<std::thread> threads;
+
+	profiler.Start();
+	start = Clock::now();
+	for (uint32_t t = 0; t < threadCount; ++t) {
+		threads.emplace_back([&] {
+			Profiler::Get().SetThreadName("Worker");
+			for (uint32_t f = 0; f < frameCount; ++f) {
+				ScopeLoop(std::min(batch, count - f * batch));
+				++finished;
+				while (frame.load() == f) {
+					std::this_thread::yield();
+				}
+			}
+		});
+	}
+	for (uint32_t f = 0; f < frameCount; ++f) {
+		while (finished.load() < threadCount * (f + 1)) {
+			std::this_thread::yield();
+		}
+		profiler.Collect();
+		++frame;
+	}
+	for (auto &thread : threads) {
+		thread.join();
+	}
+	const double threadedWall = Nanoseconds(start);
+	profiler.Stop();
+	profiler.Collect();
+
+	const uint32_t cores = std::max(1u, std::min(std::thread::hardware_concurrency(), threadCount));
+	const double threaded = threadedWall * cores / ((double)count * threadCount) - baseline;
+	const size_t threadedEvents = profiler.GetEvents().size();
+	const uint64_t threadedDropped = profiler.GetDroppedCount();
+
+	//Export cost of the last capture
+	double exportTime = 0;
+	if (tracePath != nullptr) {
+		std::ofstream trace(tracePath, std::ios::trunc);
+		start = Clock::now();
+		if (!trace || !profiler.WriteChromeTrace(trace)) {
+			printf("cannot write %s\n", tracePath);
+			return 1;
+		}
+		exportTime = Nanoseconds(start) / 1e6;
+	}
+
+	printf("scopes          : %u per thread\n", count);
+	printf("Profiler::Now   : %.2f ns\n", ClockCost(count));
+	printf("idle scope      : %.2f ns\n", idle);
+	printf("capture scope   : %.2f ns (1 thread, %zu events, %llu dropped)\n", capture, singleEvents, (unsigned long long)singleDropped);
+	printf("capture scope   : %.2f ns (%u threads, %zu events, %llu dropped)\n", threaded, threadCount, threadedEvents, (unsigned long long)threadedDropped);
+	if (tracePath != nullptr) {
+		printf("trace export    : %.1f ms -> %s\n", exportTime, tracePath);
+	}
+
+	//Collected every frame: nothing may be lost below the capture limit
+	const uint64_t expected = (uint64_t)count * threadCount;
+	const bool complete = singleDropped == 0 && singleEvents == count &&
+		threadedEvents + threadedDropped == expected && (threadedDropped == 0 || threadedEvents == profileCaptureLimit);
+	return complete ? 0 : 1;
+}
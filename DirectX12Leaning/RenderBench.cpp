@@ -0,0 +1,327 @@
+//Records the game's draw pattern into a RenderCommandList and counts it with NullRenderBackend
+//with the state filter off and on, then recorded in parallel lists (one per worker) and merged
+//usage: RenderBench [meshes] [frames] [maxWorkers]   (default 1000 300, hardware threads / at least 4)
+
+//STL
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+//Utility
+#include "JobSystem.h"
+#include "NullRenderBackend.h"
+#include "RenderCommandListPool.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	//Counted by the replaced operator new below
+	uint64_t allocationCount = 0;
+
+	//D3D12 values the draw classes pass
+	const uint32_t topologyTriangleList = 4;	//D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+	const uint32_t formatR16Uint = 57;			//DXGI_FORMAT_R16_UINT
+	const uint32_t statePresent = 0;
+	const uint32_t stateRenderTarget = 4;
+
+	//Stand ins for D3D12 objects / addresses, only compared
+	void *Object(const uintptr_t id)
+	{
+		return (void *)(id * 64);
+	}
+
+	double Nanoseconds(const Clock::time_point start)
+	{
+		return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+	}
+
+	//Stands in for D3D12_VERTEX_BUFFER_VIEW (IASetVertexBuffers reads the D3D12 member names)
+	struct VertexBufferView
+	{
+		GpuAddress BufferLocation;
+		uint32_t SizeInBytes;
+		uint32_t StrideInBytes;
+	};
+
+	//Mesh kinds of the scene (player / bullet / enemy): one Draw3D each
+	struct Mesh
+	{
+		VertexBufferView vertices;
+		RenderIndexBufferView indices;
+		uint32_t indexCount;
+		GpuDescriptor texture;
+	};
+
+	//Frame data both runs share
+	struct Scene
+	{
+		const Mesh *meshes;
+		uint32_t meshKinds;
+		uint32_t meshCount;
+		uint32_t frames;
+	};
+
+	//Same stand ins in every part of the frame
+	void *const pipeline3D = Object(1);		//PipelineCache shares one PSO / root signature
+	void *const rootSignature3D = Object(2);
+	void *const spritePipeline = Object(3);
+	void *const spriteRootSignature = Object(4);
+	void *const frameHeap = Object(5);
+	void *const backBuffer = Object(6);
+
+	//The calls DirectX12 / SpriteRenderer record before the 3D objects
+	void RecordFrameBegin(RenderCommandList &list)
+	{
+		//ScreenFlip -> SetFrameDescriptorHeaps
+		void *heap = frameHeap;
+		list.SetDescriptorHeaps(1, &heap);
+
+		//ClearDrawScreen
+		const float clearColor[4] = { 0.1f, 0.1f, 0.1f, 1.0f };
+		list.ResourceBarrier(backBuffer, statePresent, stateRenderTarget, UINT32_MAX);
+		list.OMSetRenderTargets(0x1000, 0x2000);
+		list.ClearRenderTargetView(0x1000, clearColor);
+		list.ClearDepthStencilView(0x2000, 1, 1.0f, 0);
+		list.RSSetViewport(0, 0, 1920, 1080, 0, 1);
+		list.RSSetScissorRect(0, 0, 1920, 1080);
+		list.IASetPrimitiveTopology(topologyTriangleList);
+
+		//SpriteRenderer::Flush, background
+		list.Upload(sizeof(float) * 9 * 4 * 2);
+		list.SetGraphicsRootSignature(spriteRootSignature);
+		list.SetGraphicsRootConstantBufferView(0, 0x200000);
+		list.IASetPrimitiveTopology(topologyTriangleList);
+		list.IASetVertexBuffer(0, { 0x300000, 65536, 36 });
+		list.IASetIndexBuffer({ 0x400000, 16384, formatR16Uint });
+		list.SetPipelineState(spritePipeline);
+		list.SetGraphicsRootDescriptorTable(1, 0x500000);
+		list.DrawIndexedInstanced(12, 1, 0, 0, 0);
+	}
+
+	//DirectX12::SetFrameState: what a list starting mid frame binds first
+	void RecordFrameState(RenderCommandList &list)
+	{
+		void *heap = frameHeap;
+		list.SetDescriptorHeaps(1, &heap);
+		list.OMSetRenderTargets(0x1000, 0x2000);
+		list.RSSetViewport(0, 0, 1920, 1080, 0, 1);
+		list.RSSetScissorRect(0, 0, 1920, 1080);
+		list.IASetPrimitiveTopology(topologyTriangleList);
+	}
+
+	//Draw3D::execute for objects [first, first + count)
+	void RecordMeshes(RenderCommandList &list, const Scene &scene, const uint32_t first, const uint32_t count)
+	{
+		for (uint32_t i = first; i < first + count; ++i) {
+			const Mesh &mesh = scene.meshes[i % scene.meshKinds];
+			list.SetPipelineState(pipeline3D);
+			list.SetGraphicsRootSignature(rootSignature3D);
+			list.SetGraphicsRootConstantBufferView(0, 0x100000 + (GpuAddress)i * 256);
+			list.SetGraphicsRootDescriptorTable(1, mesh.texture);
+			list.Upload(80);
+			list.IASetPrimitiveTopology(topologyTriangleList);
+			list.IASetVertexBuffers(0, 1, &mesh.vertices);
+			list.IASetIndexBuffer(mesh.indices);
+			list.DrawIndexedInstanced(mesh.indexCount, 1, 0, 0, 0);
+		}
+	}
+
+	//ScreenFlip
+	void RecordFrameEnd(RenderCommandList &list)
+	{
+		list.ResourceBarrier(backBuffer, stateRenderTarget, statePresent, UINT32_MAX);
+	}
+
+	void RecordFrame(RenderCommandList &list, const Scene &scene)
+	{
+		RecordFrameBegin(list);
+		RecordMeshes(list, scene, 0, scene.meshCount);
+		RecordFrameEnd(list);
+	}
+
+	//Records / replays scene.frames frames, false when a steady frame allocated
+	bool Run(const Scene &scene, const bool filterState)
+	{
+		RenderCommandList list;
+		list.SetStateFiltering(filterState);
+		NullRenderBackend backend;
+
+		//Warm up: the stream grows to the frame size once
+		RecordFrame(list, scene);
+		list.Reset();
+
+		const uint64_t allocationsBefore = allocationCount;
+		double recordTime = 0, replayTime = 0;
+		uint64_t skipped = 0;
+		uint32_t skippedPerType[renderCommandTypeCount] = {};
+		for (uint32_t f = 0; f < scene.frames; ++f) {
+			auto start = Clock::now();
+			list.Reset();
+			RecordFrame(list, scene);
+			recordTime += Nanoseconds(start);
+
+			start = Clock::now();
+			backend.Execute(list);
+			replayTime += Nanoseconds(start);
+
+			skipped += list.GetSkippedCount();
+			for (uint32_t i = 0; i < renderCommandTypeCount; ++i) {
+				skippedPerType[i] += list.GetSkippedCount((RenderCommandType)i);
+			}
+		}
+		const uint64_t allocations = allocationCount - allocationsBefore;
+
+		const RenderStats &stats = backend.GetStats();
+		const uint32_t frames = scene.frames;
+		const double calls = (double)(stats.commands + skipped);
+
+		printf("== state filter %s ==\n", filterState ? "on" : "off");
+		printf("frame           : %u meshes, %u commands, %zu bytes (%.1f bytes / command)\n",
+			scene.meshCount, list.GetCommandCount(), list.GetSize(), (double)list.GetSize() / list.GetCommandCount());
+		printf("record          : %.2f ns / call, %.1f us / frame\n", recordTime / calls, recordTime / frames / 1000.0);
+		printf("null replay     : %.2f ns / command, %.1f us / frame\n", replayTime / (double)stats.commands, replayTime / frames / 1000.0);
+		printf("heap allocations: %llu in %u frames\n", (unsigned long long)allocations, frames);
+		printf("per frame       : %u draws, %llu upload bytes, %u state calls, %u redundant (%.1f%%), %llu skipped by the filter\n",
+			stats.draws / frames, (unsigned long long)(stats.uploadBytes / frames), stats.stateCalls / frames, stats.redundantCalls / frames,
+			100.0 * stats.redundantCalls / (stats.stateCalls ? stats.stateCalls : 1), (unsigned long long)(skipped / frames));
+
+		printf("\n%-36s %10s %10s %10s\n", "command / frame", "recorded", "redundant", "skipped");
+		for (uint32_t i = 0; i < renderCommandTypeCount; ++i) {
+			if (stats.calls[i] > 0 || skippedPerType[i] > 0) {
+				printf("%-36s %10u %10u %10u\n", GetRenderCommandName((RenderCommandType)i),
+					stats.calls[i] / frames, stats.redundant[i] / frames, skippedPerType[i] / frames);
+			}
+		}
+		printf("\n");
+
+		return allocations == 0;
+	}
+
+	//Objects split over one list per worker (JobSystem), merged in submission order and replayed
+	bool RunParallel(const Scene &scene, const uint32_t workers, double &baseTime)
+	{
+		JobSystem jobs(workers);
+		RenderCommandList main;
+		RenderCommandListPool pool;
+		std::vector<RenderSubmission> submission;
+		NullRenderBackend backend;
+		bool valid = true;
+
+		double recordTime = 0;
+		uint64_t allocationsBefore = 0;
+		uint32_t skipped = 0;
+		for (uint32_t f = 0; f <= scene.frames; ++f) {
+			//Frame 0 warms up the lists / pool / submission
+			if (f == 1) {
+				allocationsBefore = allocationCount;
+				backend.ResetStats();
+			}
+
+			const auto start = Clock::now();
+			main.Reset();
+			pool.Reset();
+			RecordFrameBegin(main);
+
+			//DirectX12::BeginParallelCommandLists
+			const uint32_t first = pool.Begin(main, workers);
+			for (uint32_t i = first; i < first + workers; ++i) {
+				RecordFrameState(*pool.Get(i));
+			}
+			RecordFrameState(main);
+
+			jobs.ParallelFor(workers, 1, [&](const uint32_t i) {
+				const uint32_t begin = (uint32_t)((uint64_t)scene.meshCount * i / workers);
+				const uint32_t end = (uint32_t)((uint64_t)scene.meshCount * (i + 1) / workers);
+				RecordMeshes(*pool.Get(first + i), scene, begin, end - begin);
+			});
+			RecordFrameEnd(main);
+			pool.BuildSubmission(main, submission);
+			if (f > 0) {
+				recordTime += Nanoseconds(start);
+			}
+
+			//Main head, every list in index order, main tail
+			valid &= submission.size() == workers + 2;
+			for (uint32_t i = 0; i < workers && i + 1 < (uint32_t)submission.size(); ++i) {
+				valid &= (const uint8_t *)submission[i + 1].begin == pool.Get(first + i)->GetData();
+			}
+
+			for (auto &range : submission) {
+				backend.Execute(range.begin, range.end);
+			}
+			skipped = main.GetSkippedCount() + pool.GetSkippedCount();
+		}
+		const uint64_t allocations = allocationCount - allocationsBefore;
+
+		const RenderStats &stats = backend.GetStats();
+		valid &= stats.draws == (scene.meshCount + 1) * scene.frames;
+
+		const double perFrame = recordTime / scene.frames / 1000.0;
+		if (workers == 1) {
+			baseTime = perFrame;
+		}
+		printf("%-8u %8u %12u %10u %10.1f us %7.2fx %8u %12llu\n",
+			workers, (uint32_t)submission.size(), stats.commands / scene.frames, stats.redundantCalls / scene.frames,
+			perFrame, baseTime / perFrame, skipped, (unsigned long long)allocations);
+
+		if (!valid) {
+			printf("parallel lists: wrong submission order / draw count with %u workers\n", workers);
+		}
+		return valid && allocations == 0;
+	}
+}
+
+void *operator new(size_t size)
+{
+	++allocationCount;
+	if (void *p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+	std::free(p);
+}
+
+int main(int argc, char *argv[])
+{
+	const Mesh meshes[] = {
+		{ { 0x600000, 4096, 32 }, { 0x700000, 1024, formatR16Uint }, 12, 0x800000 },
+		{ { 0x610000, 4096, 32 }, { 0x710000, 1024, formatR16Uint }, 12, 0x800040 },
+		{ { 0x620000, 4096, 32 }, { 0x720000, 1024, formatR16Uint }, 36, 0x800080 },
+	};
+
+	Scene scene;
+	scene.meshes = meshes;
+	scene.meshKinds = sizeof(meshes) / sizeof(meshes[0]);
+	scene.meshCount = argc > 1 ? (uint32_t)std::strtoul(argv[1], nullptr, 10) : 1000;
+	scene.frames = argc > 2 ? (uint32_t)std::strtoul(argv[2], nullptr, 10) : 300;
+
+	const uint32_t hardware = std::max(std::thread::hardware_concurrency(), 1u);
+	const uint32_t maxWorkers = argc > 3 ? (uint32_t)std::strtoul(argv[3], nullptr, 10) : std::max(hardware, 4u);
+
+	//Every call recorded as made, then with redundant sets dropped
+	bool passed = Run(scene, false);
+	passed &= Run(scene, true);
+
+	printf("== parallel recording, %u hardware threads ==\n", hardware);
+	printf("%-8s %8s %12s %10s %13s %8s %8s %12s\n", "workers", "lists", "commands", "redundant", "record", "speedup", "skipped", "allocations");
+	double baseTime = 0;
+	for (uint32_t workers = 1; workers <= maxWorkers; workers *= 2) {
+		passed &= RunParallel(scene, workers, baseTime);
+	}
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+//STL
+#include <cstring>
+
+//this
+#include "RenderCommandList.h"
+
+const char *GetRenderCommandName(const RenderCommandType type)
+{
+	static const char *const names[renderCommandTypeCount] = {
+		"SetPipelineState",
+		"SetGraphicsRootSignature",
+		"SetDescriptorHeaps",
+		"SetGraphicsRootConstantBufferView",
+		"SetGraphicsRootShaderResourceView",
+		"SetGraphicsRootDescriptorTable",
+		"IASetPrimitiveTopology",
+		"IASetVertexBuffer",
+		"IASetIndexBuffer",
+		"RSSetViewport",
+		"RSSetScissorRect",
+		"OMSetRenderTargets",
+		"ClearRenderTargetView",
+		"ClearDepthStencilView",
+		"ResourceBarrier",
+		"CopyBufferRegion",
+		"DrawIndexedInstanced",
+		"DrawInstanced",
+		"EndQuery",
+		"ResolveQueryData",
+		"Upload",
+		"ParallelLists"
+	};
+	return (uint32_t)type < renderCommandTypeCount ? names[(uint32_t)type] : "Unknown";
+}
+
+RenderCommandList::RenderCommandList(const size_t reserveBytes) :
+	commandCount(0),
+	filterState(true)
+{
+	stream.reserve(reserveBytes / sizeof(uint64_t));
+	Reset();
+}
+
+void RenderCommandList::Reset()
+{
+	stream.clear();
+	commandCount = 0;
+
+	//A new D3D12 command list starts with nothing bound
+	memset(&bound, 0, sizeof(bound));
+	skippedCount = 0;
+	memset(skipped, 0, sizeof(skipped));
+}
+
+void RenderCommandList::SetStateFiltering(const bool enable)
+{
+	filterState = enable;
+}
+
+uint32_t RenderCommandList::GetSkippedCount() const
+{
+	return skippedCount;
+}
+
+uint32_t RenderCommandList::GetSkippedCount(const RenderCommandType type) const
+{
+	return (uint32_t)type < renderCommandTypeCount ? skipped[(uint32_t)type] : 0;
+}
+
+void RenderCommandList::SetPipelineState(void *pipeline)
+{
+	if (Skip(RenderCommandType::SetPipelineState, bound.pipelineBound && bound.pipeline == pipeline)) {
+		return;
+	}
+	bound.pipelineBound = true;
+	bound.pipeline = pipeline;
+
+	Append<CmdSetPipelineState>(RenderCommandType::SetPipelineState).pipeline = pipeline;
+}
+
+void RenderCommandList::SetGraphicsRootSignature(void *rootSignature)
+{
+	//Root arguments are not filtered, so keeping the same signature loses nothing
+	if (Skip(RenderCommandType::SetGraphicsRootSignature, bound.rootSignatureBound && bound.rootSignature == rootSignature)) {
+		return;
+	}
+	bound.rootSignatureBound = true;
+	bound.rootSignature = rootSignature;
+
+	Append<CmdSetGraphicsRootSignature>(RenderCommandType::SetGraphicsRootSignature).rootSignature = rootSignature;
+}
+
+void RenderCommandList::SetDescriptorHeaps(const uint32_t count, void *const *heaps)
+{
+	const uint32_t heapCount = count < CmdSetDescriptorHeaps::maxHeaps ? count : CmdSetDescriptorHeaps::maxHeaps;
+	const bool same = bound.heapsBound && bound.heapCount == heapCount && memcmp(bound.heaps, heaps, sizeof(void *) * heapCount) == 0;
+	if (Skip(RenderCommandType::SetDescriptorHeaps, same)) {
+		return;
+	}
+	bound.heapsBound = true;
+	bound.heapCount = heapCount;
+	memset(bound.heaps, 0, sizeof(bound.heaps));
+	memcpy(bound.heaps, heaps, sizeof(void *) * heapCount);
+
+	CmdSetDescriptorHeaps &command = Append<CmdSetDescriptorHeaps>(RenderCommandType::SetDescriptorHeaps);
+	command.count = heapCount;
+	for (uint32_t i = 0; i < command.count; ++i) {
+		command.heaps[i] = heaps[i];
+	}
+}
+
+void RenderCommandList::SetGraphicsRootConstantBufferView(const uint32_t slot, const GpuAddress address)
+{
+	CmdSetRootView &command = Append<CmdSetRootView>(RenderCommandType::SetGraphicsRootConstantBufferView);
+	command.slot = slot;
+	command.address = address;
+}
+
+void RenderCommandList::SetGraphicsRootShaderResourceView(const uint32_t slot, const GpuAddress address)
+{
+	CmdSetRootView &command = Append<CmdSetRootView>(RenderCommandType::SetGraphicsRootShaderResourceView);
+	command.slot = slot;
+	command.address = address;
+}
+
+void RenderCommandList::SetGraphicsRootDescriptorTable(const uint32_t slot, const GpuDescriptor table)
+{
+	CmdSetGraphicsRootDescriptorTable &command = Append<CmdSetGraphicsRootDescriptorTable>(RenderCommandType::SetGraphicsRootDescriptorTable);
+	command.slot = slot;
+	command.table = table;
+}
+
+void RenderCommandList::IASetPrimitiveTopology(const uint32_t topology)
+{
+	if (Skip(RenderCommandType::IASetPrimitiveTopology, bound.topologyBound && bound.topology == topology)) {
+		return;
+	}
+	bound.topologyBound = true;
+	bound.topology = topology;
+
+	Append<CmdIASetPrimitiveTopology>(RenderCommandType::IASetPrimitiveTopology).topology = topology;
+}
+
+void RenderCommandList::IASetVertexBuffer(const uint32_t slot, const RenderVertexBufferView &view)
+{
+	if (slot < maxVertexSlots) {
+		const RenderVertexBufferView &current = bound.vertex[slot];
+		const bool same = bound.vertexBound[slot] && current.address == view.address && current.size == view.size && current.stride == view.stride;
+		if (Skip(RenderCommandType::IASetVertexBuffer, same)) {
+			return;
+		}
+		bound.vertexBound[slot] = true;
+		bound.vertex[slot] = view;
+	}
+
+	CmdIASetVertexBuffer &command = Append<CmdIASetVertexBuffer>(RenderCommandType::IASetVertexBuffer);
+	command.slot = slot;
+	command.view = view;
+}
+
+void RenderCommandList::IASetIndexBuffer(const RenderIndexBufferView &view)
+{
+	Append<CmdIASetIndexBuffer>(RenderCommandType::IASetIndexBuffer).view = view;
+}
+
+void RenderCommandList::RSSetViewport(const float x, const float y, const float width, const float height, const float minDepth, const float maxDepth)
+{
+	CmdRSSetViewport &command = Append<CmdRSSetViewport>(RenderCommandType::RSSetViewport);
+	command.x = x;
+	command.y = y;
+	command.width = width;
+	command.height = height;
+	command.minDepth = minDepth;
+	command.maxDepth = maxDepth;
+}
+
+void RenderCommandList::RSSetScissorRect(const int32_t left, const int32_t top, const int32_t right, const int32_t bottom)
+{
+	CmdRSSetScissorRect &command = Append<CmdRSSetScissorRect>(RenderCommandType::RSSetScissorRect);
+	command.left = left;
+	command.top = top;
+	command.right = right;
+	command.bottom = bottom;
+}
+
+void RenderCommandList::OMSetRenderTargets(const CpuDescriptor renderTarget, const CpuDescriptor depthStencil)
+{
+	CmdOMSetRenderTargets &command = Append<CmdOMSetRenderTargets>(RenderCommandType::OMSetRenderTargets);
+	command.renderTarget = renderTarget;
+	command.depthStencil = depthStencil;
+}
+
+void RenderCommandList::ClearRenderTargetView(const CpuDescriptor view, const float color[4])
+{
+	CmdClearRenderTargetView &command = Append<CmdClearRenderTargetView>(RenderCommandType::ClearRenderTargetView);
+	for (int i = 0; i < 4; ++i) {
+		command.color[i] = color[i];
+	}
+	command.view = view;
+}
+
+void RenderCommandList::ClearDepthStencilView(const CpuDescriptor view, const uint32_t flags, const float depth, const uint8_t stencil)
+{
+	CmdClearDepthStencilView &command = Append<CmdClearDepthStencilView>(RenderCommandType::ClearDepthStencilView);
+	command.flags = flags;
+	command.view = view;
+	command.depth = depth;
+	command.stencil = stencil;
+}
+
+void RenderCommandList::ResourceBarrier(void *resource, const uint32_t before, const uint32_t after, const uint32_t subresource)
+{
+	CmdResourceBarrier &command = Append<CmdResourceBarrier>(RenderCommandType::ResourceBarrier);
+	command.subresource = subresource;
+	command.resource = resource;
+	command.before = before;
+	command.after = after;
+}
+
+void RenderCommandList::CopyBufferRegion(void *destination, const uint64_t destinationOffset, void *source, const uint64_t sourceOffset, const uint64_t size)
+{
+	CmdCopyBufferRegion &command = Append<CmdCopyBufferRegion>(RenderCommandType::CopyBufferRegion);
+	command.destination = destination;
+	command.destinationOffset = destinationOffset;
+	command.source = source;
+	command.sourceOffset = sourceOffset;
+	command.size = size;
+}
+
+void RenderCommandList::DrawIndexedInstanced(const uint32_t indexCount, const uint32_t instanceCount, const uint32_t startIndex, const int32_t baseVertex, const uint32_t startInstance)
+{
+	CmdDrawIndexedInstanced &command = Append<CmdDrawIndexedInstanced>(RenderCommandType::DrawIndexedInstanced);
+	command.indexCount = indexCount;
+	command.instanceCount = instanceCount;
+	command.startIndex = startIndex;
+	command.baseVertex = baseVertex;
+	command.startInstance = startInstance;
+}
+
+void RenderCommandList::DrawInstanced(const uint32_t vertexCount, const uint32_t instanceCount, const uint32_t startVertex, const uint32_t startInstance)
+{
+	CmdDrawInstanced &command = Append<CmdDrawInstanced>(RenderCommandType::DrawInstanced);
+	command.vertexCount = vertexCount;
+	command.instanceCount = instanceCount;
+	command.startVertex = startVertex;
+	command.startInstance = startInstance;
+}
+
+void RenderCommandList::EndQuery(void *heap, const uint32_t queryType, const uint32_t index)
+{
+	CmdEndQuery &command = Append<CmdEndQuery>(RenderCommandType::EndQuery);
+	command.queryType = queryType;
+	command.heap = heap;
+	command.index = index;
+}
+
+void RenderCommandList::ResolveQueryData(void *heap, const uint32_t queryType, const uint32_t start, const uint32_t count, void *destination, const uint64_t destinationOffset)
+{
+	CmdResolveQueryData &command = Append<CmdResolveQueryData>(RenderCommandType::ResolveQueryData);
+	command.queryType = queryType;
+	command.heap = heap;
+	command.start = start;
+	command.count = count;
+	command.destination = destination;
+	command.destinationOffset = destinationOffset;
+}
+
+void RenderCommandList::Upload(const uint64_t bytes)
+{
+	Append<CmdUpload>(RenderCommandType::Upload).bytes = bytes;
+}
+
+void RenderCommandList::ParallelLists(const uint32_t first, const uint32_t count)
+{
+	CmdParallelLists &command = Append<CmdParallelLists>(RenderCommandType::ParallelLists);
+	command.first = first;
+	command.count = count;
+
+	//Following commands go to a new D3D12 command list
+	memset(&bound, 0, sizeof(bound));
+}
+
+const uint8_t *RenderCommandList::GetData() const
+{
+	return (const uint8_t *)stream.data();
+}
+
+size_t RenderCommandList::GetSize() const
+{
+	return stream.size() * sizeof(uint64_t);
+}
+
+uint32_t RenderCommandList::GetCommandCount() const
+{
+	return commandCount;
+}
+
+bool RenderCommandList::Skip(const RenderCommandType type, const bool same)
+{
+	if (!filterState || !same) {
+		return false;
+	}
+	++skipped[(uint32_t)type];
+	++skippedCount;
+	return true;
+}
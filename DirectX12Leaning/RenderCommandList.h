@@ -0,0 +1,203 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "RenderCommands.h"
+
+/// <summary>
+/// Frame commands recorded as a compact POD stream, replayed later by a backend
+/// </summary>
+/// <remarks>
+/// Method names and arguments follow ID3D12GraphicsCommandList, so the draw classes record the
+/// same calls they used to make; D3D12 structs are read by member name (templates), nothing
+/// here includes d3d12.h. D3D12RenderBackend replays the stream into a real command list,
+/// NullRenderBackend counts it. Reset keeps the memory, a steady frame does not allocate.
+/// Sets of the pipeline, root signature, descriptor heaps, topology and vertex buffers that
+/// are already bound are not recorded (state filter); one list is one D3D12 command list,
+/// so Reset also forgets the bound state.
+/// </remarks>
+class RenderCommandList
+{
+public:
+	explicit RenderCommandList(const size_t reserveBytes = 64 * 1024);
+
+	//Drop every command and the bound state (start of a frame)
+	void Reset();
+
+	//Record every set as called (comparison runs), on by default
+	void SetStateFiltering(const bool enable);
+
+	//Calls dropped by the state filter since Reset
+	uint32_t GetSkippedCount() const;
+	uint32_t GetSkippedCount(const RenderCommandType type) const;
+
+	void SetPipelineState(void *pipeline);
+	void SetGraphicsRootSignature(void *rootSignature);
+	void SetDescriptorHeaps(const uint32_t count, void *const *heaps);
+	void SetGraphicsRootConstantBufferView(const uint32_t slot, const GpuAddress address);
+	void SetGraphicsRootShaderResourceView(const uint32_t slot, const GpuAddress address);
+	void SetGraphicsRootDescriptorTable(const uint32_t slot, const GpuDescriptor table);
+	void IASetPrimitiveTopology(const uint32_t topology);
+	void IASetVertexBuffer(const uint32_t slot, const RenderVertexBufferView &view);
+	void IASetIndexBuffer(const RenderIndexBufferView &view);
+	void RSSetViewport(const float x, const float y, const float width, const float height, const float minDepth, const float maxDepth);
+	void RSSetScissorRect(const int32_t left, const int32_t top, const int32_t right, const int32_t bottom);
+	void OMSetRenderTargets(const CpuDescriptor renderTarget, const CpuDescriptor depthStencil);
+	void ClearRenderTargetView(const CpuDescriptor view, const float color[4]);
+	void ClearDepthStencilView(const CpuDescriptor view, const uint32_t flags, const float depth, const uint8_t stencil);
+	void ResourceBarrier(void *resource, const uint32_t before, const uint32_t after, const uint32_t subresource);
+	void CopyBufferRegion(void *destination, const uint64_t destinationOffset, void *source, const uint64_t sourceOffset, const uint64_t size);
+	void DrawIndexedInstanced(const uint32_t indexCount, const uint32_t instanceCount, const uint32_t startIndex, const int32_t baseVertex, const uint32_t startInstance);
+	void DrawInstanced(const uint32_t vertexCount, const uint32_t instanceCount, const uint32_t startVertex, const uint32_t startInstance);
+	void EndQuery(void *heap, const uint32_t queryType, const uint32_t index);
+	void ResolveQueryData(void *heap, const uint32_t queryType, const uint32_t start, const uint32_t count, void *destination, const uint64_t destinationOffset);
+
+	//Bytes written to upload memory for the following commands (statistics only)
+	void Upload(const uint64_t bytes);
+
+	//Split point for parallel lists (RenderCommandListPool::Begin records it)
+	void ParallelLists(const uint32_t first, const uint32_t count);
+
+#pragma region D3D12 signatures
+	//D3D12 / d3dx12 structs, read by member name
+	template<class Heap>
+	void SetDescriptorHeaps(const uint32_t count, Heap *const *heaps)
+	{
+		void *pointers[CmdSetDescriptorHeaps::maxHeaps] = {};
+		for (uint32_t i = 0; i < count && i < CmdSetDescriptorHeaps::maxHeaps; ++i) {
+			pointers[i] = heaps[i];
+		}
+		SetDescriptorHeaps(count, pointers);
+	}
+
+	template<class Handle, class = typename std::enable_if<std::is_class<Handle>::value>::type>
+	void SetGraphicsRootDescriptorTable(const uint32_t slot, const Handle &table)
+	{
+		SetGraphicsRootDescriptorTable(slot, (GpuDescriptor)table.ptr);
+	}
+
+	template<class View>
+	void IASetVertexBuffers(const uint32_t startSlot, const uint32_t count, const View *views)
+	{
+		for (uint32_t i = 0; i < count; ++i) {
+			IASetVertexBuffer(startSlot + i, { views[i].BufferLocation, views[i].SizeInBytes, views[i].StrideInBytes });
+		}
+	}
+
+	template<class View>
+	void IASetIndexBuffer(const View *view)
+	{
+		IASetIndexBuffer(RenderIndexBufferView{ view->BufferLocation, view->SizeInBytes, (uint32_t)view->Format });
+	}
+
+	template<class Viewport>
+	void RSSetViewports(const uint32_t count, const Viewport *viewports)
+	{
+		for (uint32_t i = 0; i < count; ++i) {
+			const Viewport &v = viewports[i];
+			RSSetViewport(v.TopLeftX, v.TopLeftY, v.Width, v.Height, v.MinDepth, v.MaxDepth);
+		}
+	}
+
+	template<class Rect>
+	void RSSetScissorRects(const uint32_t count, const Rect *rects)
+	{
+		for (uint32_t i = 0; i < count; ++i) {
+			RSSetScissorRect((int32_t)rects[i].left, (int32_t)rects[i].top, (int32_t)rects[i].right, (int32_t)rects[i].bottom);
+		}
+	}
+
+	//One render target, like every caller in this project
+	template<class RenderTargetHandle, class DepthStencilHandle>
+	void OMSetRenderTargets(const uint32_t count, const RenderTargetHandle *renderTargets, const bool /*singleHandle*/, const DepthStencilHandle *depthStencil)
+	{
+		OMSetRenderTargets(count > 0 ? (CpuDescriptor)renderTargets->ptr : 0, depthStencil != nullptr ? (CpuDescriptor)depthStencil->ptr : 0);
+	}
+
+	//Whole view (rects are not recorded)
+	template<class Handle>
+	void ClearRenderTargetView(const Handle &view, const float color[4], const uint32_t /*rectCount*/, const void * /*rects*/)
+	{
+		ClearRenderTargetView((CpuDescriptor)view.ptr, color);
+	}
+
+	template<class Handle, class Flags>
+	void ClearDepthStencilView(const Handle &view, const Flags flags, const float depth, const uint8_t stencil, const uint32_t /*rectCount*/, const void * /*rects*/)
+	{
+		ClearDepthStencilView((CpuDescriptor)view.ptr, (uint32_t)flags, depth, stencil);
+	}
+
+	//Transition barriers only
+	template<class Barrier>
+	void ResourceBarrier(const uint32_t count, const Barrier *barriers)
+	{
+		for (uint32_t i = 0; i < count; ++i) {
+			const auto &transition = barriers[i].Transition;
+			ResourceBarrier(transition.pResource, (uint32_t)transition.StateBefore, (uint32_t)transition.StateAfter, transition.Subresource);
+		}
+	}
+#pragma endregion
+
+	const uint8_t *GetData() const;
+	size_t GetSize() const;				//Bytes
+	uint32_t GetCommandCount() const;
+
+	/// <summary>
+	/// Command after header (end = GetData() + GetSize())
+	/// </summary>
+	static const RenderCommandHeader *Next(const RenderCommandHeader *header)
+	{
+		return (const RenderCommandHeader *)((const uint8_t *)header + header->size);
+	}
+
+private:
+	//Vertex buffer slots the filter tracks, later slots are always recorded
+	static const uint32_t maxVertexSlots = 8;
+
+	//Last recorded value of each filtered state
+	struct BoundState
+	{
+		void *pipeline;
+		void *rootSignature;
+		void *heaps[CmdSetDescriptorHeaps::maxHeaps];
+		uint32_t heapCount;
+		uint32_t topology;
+		RenderVertexBufferView vertex[maxVertexSlots];
+
+		bool pipelineBound;
+		bool rootSignatureBound;
+		bool heapsBound;
+		bool topologyBound;
+		bool vertexBound[maxVertexSlots];
+	};
+
+	//True when the call sets what is bound (counted as skipped)
+	bool Skip(const RenderCommandType type, const bool same);
+
+	//New command of type T at the end of the stream
+	template<class T>
+	T &Append(const RenderCommandType type)
+	{
+		static_assert(sizeof(T) <= 0xfff8, "command size must fit RenderCommandHeader::size");
+		const size_t words = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+		const size_t offset = stream.size();
+		stream.resize(offset + words);
+
+		T *command = new(&stream[offset]) T();
+		command->header.type = type;
+		command->header.size = (uint16_t)(words * sizeof(uint64_t));
+		++commandCount;
+		return *command;
+	}
+
+private:
+	//8 byte words keep every command aligned for its pointers
+	std::vector<uint64_t> stream;
+	uint32_t commandCount;
+
+	bool filterState;
+	BoundState bound;
+	uint32_t skippedCount;
+	uint32_t skipped[renderCommandTypeCount];
+};
@@ -0,0 +1,74 @@
+//STL
+#include <assert.h>
+
+//this
+#include "RenderCommandListPool.h"
+
+RenderCommandListPool::RenderCommandListPool() :
+	used(0)
+{
+}
+
+uint32_t RenderCommandListPool::Begin(RenderCommandList &main, const uint32_t count)
+{
+	const uint32_t first = used;
+	while (lists.size() < first + count) {
+		lists.push_back(std::unique_ptr<RenderCommandList>(new RenderCommandList));
+	}
+	used += count;
+
+	main.ParallelLists(first, count);
+	return first;
+}
+
+RenderCommandList *RenderCommandListPool::Get(const uint32_t index)
+{
+	assert(index < used);
+	return lists[index].get();
+}
+
+uint32_t RenderCommandListPool::GetListCount() const
+{
+	return used;
+}
+
+void RenderCommandListPool::BuildSubmission(const RenderCommandList &main, std::vector<RenderSubmission> &submission) const
+{
+	submission.clear();
+
+	const RenderCommandHeader *begin = (const RenderCommandHeader *)main.GetData();
+	const RenderCommandHeader *end = (const RenderCommandHeader *)(main.GetData() + main.GetSize());
+	for (const RenderCommandHeader *header = begin; header != end; header = RenderCommandList::Next(header)) {
+		if (header->type != RenderCommandType::ParallelLists) {
+			continue;
+		}
+
+		//Main commands so far, then the lists in index order
+		submission.push_back({ begin, header });
+
+		auto &command = *(const CmdParallelLists *)header;
+		for (uint32_t i = command.first; i < command.first + command.count; ++i) {
+			const RenderCommandList &list = *lists[i];
+			submission.push_back({ (const RenderCommandHeader *)list.GetData(), (const RenderCommandHeader *)(list.GetData() + list.GetSize()) });
+		}
+		begin = RenderCommandList::Next(header);
+	}
+	submission.push_back({ begin, end });
+}
+
+uint32_t RenderCommandListPool::GetSkippedCount() const
+{
+	uint32_t count = 0;
+	for (uint32_t i = 0; i < used; ++i) {
+		count += lists[i]->GetSkippedCount();
+	}
+	return count;
+}
+
+void RenderCommandListPool::Reset()
+{
+	for (uint32_t i = 0; i < used; ++i) {
+		lists[i]->Reset();
+	}
+	used = 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <memory>
+#include <vector>
+#include "RenderCommandList.h"
+
+//Commands that go to one D3D12 command list
+struct RenderSubmission
+{
+	const RenderCommandHeader *begin;
+	const RenderCommandHeader *end;
+};
+
+/// <summary>
+/// Command lists recorded in parallel and merged into the frame in submission order
+/// </summary>
+/// <remarks>
+/// Begin records a ParallelLists command into the main list and hands out count lists, each one
+/// may be recorded by its own thread. BuildSubmission splits the main list at those commands:
+/// main commands before, the pool lists in index order, main commands after; every range is
+/// replayed into its own D3D12 command list. A D3D12 list starts with nothing bound, so every
+/// range sets its own state. Begin / BuildSubmission / Reset belong to the render thread, with
+/// no list of an earlier Begin still being recorded.
+/// Lists keep their memory across Reset, a steady frame does not allocate.
+/// </remarks>
+class RenderCommandListPool
+{
+public:
+	RenderCommandListPool();
+
+	/// <summary>
+	/// count lists submitted at this point of main
+	/// </summary>
+	/// <returns>Index of the first list (Get)</returns>
+	uint32_t Begin(RenderCommandList &main, const uint32_t count);
+
+	RenderCommandList *Get(const uint32_t index);
+	uint32_t GetListCount() const;		//Handed out since Reset
+
+	/// <summary>
+	/// Ranges of main and the pool lists in submission order (submission is cleared first)
+	/// </summary>
+	void BuildSubmission(const RenderCommandList &main, std::vector<RenderSubmission> &submission) const;
+
+	//RenderCommandList::GetSkippedCount of every list handed out
+	uint32_t GetSkippedCount() const;
+
+	//End of the frame: every list is empty and free again
+	void Reset();
+
+private:
+	std::vector<std::unique_ptr<RenderCommandList>> lists;
+	uint32_t used;
+};
@@ -0,0 +1,224 @@
+#pragma once
+#include <cstdint>
+
+//GPU virtual address / descriptor handle values (D3D12_GPU_VIRTUAL_ADDRESS, handle.ptr)
+typedef uint64_t GpuAddress;
+typedef uint64_t GpuDescriptor;
+typedef uint64_t CpuDescriptor;
+
+enum class RenderCommandType : uint16_t {
+	SetPipelineState,
+	SetGraphicsRootSignature,
+	SetDescriptorHeaps,
+	SetGraphicsRootConstantBufferView,
+	SetGraphicsRootShaderResourceView,
+	SetGraphicsRootDescriptorTable,
+	IASetPrimitiveTopology,
+	IASetVertexBuffer,
+	IASetIndexBuffer,
+	RSSetViewport,
+	RSSetScissorRect,
+	OMSetRenderTargets,
+	ClearRenderTargetView,
+	ClearDepthStencilView,
+	ResourceBarrier,
+	CopyBufferRegion,
+	DrawIndexedInstanced,
+	DrawInstanced,
+	EndQuery,
+	ResolveQueryData,
+	Upload,			//CPU -> GPU bytes written for the following commands (no API call)
+	ParallelLists,	//Parallel lists submitted here, recording continues in a new D3D12 list (RenderCommandListPool)
+	Count
+};
+
+const uint32_t renderCommandTypeCount = (uint32_t)RenderCommandType::Count;
+
+//Command names for reports ("SetPipelineState", ...)
+const char *GetRenderCommandName(const RenderCommandType type);
+
+//First member of every command, size includes the header (multiple of 8)
+struct RenderCommandHeader
+{
+	RenderCommandType type;
+	uint16_t size;
+};
+
+struct RenderVertexBufferView
+{
+	GpuAddress address;
+	uint32_t size;
+	uint32_t stride;
+};
+
+struct RenderIndexBufferView
+{
+	GpuAddress address;
+	uint32_t size;
+	uint32_t format;	//DXGI_FORMAT
+};
+
+//D3D12 objects are opaque pointers, views / states / enums plain values.
+//Every command is POD, the stream is copied and replayed as bytes.
+
+struct CmdSetPipelineState
+{
+	RenderCommandHeader header;
+	void *pipeline;
+};
+
+struct CmdSetGraphicsRootSignature
+{
+	RenderCommandHeader header;
+	void *rootSignature;
+};
+
+struct CmdSetDescriptorHeaps
+{
+	static const uint32_t maxHeaps = 2;	//CBV_SRV_UAV + sampler
+	RenderCommandHeader header;
+	uint32_t count;
+	void *heaps[maxHeaps];
+};
+
+//SetGraphicsRootConstantBufferView / SetGraphicsRootShaderResourceView
+struct CmdSetRootView
+{
+	RenderCommandHeader header;
+	uint32_t slot;
+	GpuAddress address;
+};
+
+struct CmdSetGraphicsRootDescriptorTable
+{
+	RenderCommandHeader header;
+	uint32_t slot;
+	GpuDescriptor table;
+};
+
+struct CmdIASetPrimitiveTopology
+{
+	RenderCommandHeader header;
+	uint32_t topology;	//D3D_PRIMITIVE_TOPOLOGY
+};
+
+struct CmdIASetVertexBuffer
+{
+	RenderCommandHeader header;
+	uint32_t slot;
+	RenderVertexBufferView view;
+};
+
+struct CmdIASetIndexBuffer
+{
+	RenderCommandHeader header;
+	RenderIndexBufferView view;
+};
+
+struct CmdRSSetViewport
+{
+	RenderCommandHeader header;
+	float x, y, width, height, minDepth, maxDepth;
+};
+
+struct CmdRSSetScissorRect
+{
+	RenderCommandHeader header;
+	int32_t left, top, right, bottom;
+};
+
+//One render target (0 = none) and depth stencil (0 = none)
+struct CmdOMSetRenderTargets
+{
+	RenderCommandHeader header;
+	CpuDescriptor renderTarget;
+	CpuDescriptor depthStencil;
+};
+
+struct CmdClearRenderTargetView
+{
+	RenderCommandHeader header;
+	float color[4];
+	CpuDescriptor view;
+};
+
+struct CmdClearDepthStencilView
+{
+	RenderCommandHeader header;
+	uint32_t flags;		//D3D12_CLEAR_FLAGS
+	CpuDescriptor view;
+	float depth;
+	uint8_t stencil;
+};
+
+//Transition barrier
+struct CmdResourceBarrier
+{
+	RenderCommandHeader header;
+	uint32_t subresource;
+	void *resource;
+	uint32_t before;	//D3D12_RESOURCE_STATES
+	uint32_t after;
+};
+
+struct CmdCopyBufferRegion
+{
+	RenderCommandHeader header;
+	void *destination;
+	uint64_t destinationOffset;
+	void *source;
+	uint64_t sourceOffset;
+	uint64_t size;
+};
+
+struct CmdDrawIndexedInstanced
+{
+	RenderCommandHeader header;
+	uint32_t indexCount;
+	uint32_t instanceCount;
+	uint32_t startIndex;
+	int32_t baseVertex;
+	uint32_t startInstance;
+};
+
+struct CmdDrawInstanced
+{
+	RenderCommandHeader header;
+	uint32_t vertexCount;
+	uint32_t instanceCount;
+	uint32_t startVertex;
+	uint32_t startInstance;
+};
+
+struct CmdEndQuery
+{
+	RenderCommandHeader header;
+	uint32_t queryType;	//D3D12_QUERY_TYPE
+	void *heap;
+	uint32_t index;
+};
+
+struct CmdResolveQueryData
+{
+	RenderCommandHeader header;
+	uint32_t queryType;
+	void *heap;
+	uint32_t start;
+	uint32_t count;
+	void *destination;
+	uint64_t destinationOffset;
+};
+
+struct CmdUpload
+{
+	RenderCommandHeader header;
+	uint64_t bytes;
+};
+
+//Pool lists [first, first + count) run between the commands before and after this one
+struct CmdParallelLists
+{
+	RenderCommandHeader header;
+	uint32_t first;
+	uint32_t count;
+};
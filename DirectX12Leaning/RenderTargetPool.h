@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <vector>
+
+//Size / format a pooled target is matched on (format is the API enum value)
+struct RenderTargetDesc
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint32_t flags;
+
+	bool operator==(const RenderTargetDesc &other) const
+	{
+		return width == other.width && height == other.height && format == other.format && flags == other.flags;
+	}
+};
+
+/// <summary>
+/// Render / depth targets shared by size and format, with byte accounting
+/// </summary>
+template<class Target>
+class RenderTargetPool
+{
+public:
+	//Create a target and report its memory size
+	using CreateFunc = std::function<Target *(const RenderTargetDesc &desc, uint64_t &sizeInBytes)>;
+	using DestroyFunc = std::function<void(Target *target)>;
+
+	RenderTargetPool() : allocatedBytes(0), createCount(0), reuseCount(0) {}
+	~RenderTargetPool() { Clear(); }
+
+	void Initialize(CreateFunc create, DestroyFunc destroy)
+	{
+		this->create = create;
+		this->destroy = destroy;
+	}
+
+	/// <summary>
+	/// Free target with the same desc, created when there is none
+	/// </summary>
+	Target *Acquire(const RenderTargetDesc &desc)
+	{
+		for (auto &entry : entries) {
+			if (!entry.inUse && !entry.pending && entry.desc == desc) {
+				entry.inUse = true;
+				++reuseCount;
+				return entry.target;
+			}
+		}
+
+		Entry entry{};
+		entry.desc = desc;
+		entry.target = create(desc, entry.sizeInBytes);
+		entry.inUse = true;
+		entries.push_back(entry);
+
+		allocatedBytes += entry.sizeInBytes;
+		++createCount;
+		return entry.target;
+	}
+
+	/// <summary>
+	/// Target can be handed out again once the current frame has retired
+	/// </summary>
+	void Release(Target *target)
+	{
+		for (auto &entry : entries) {
+			if (entry.target == target && entry.inUse) {
+				entry.inUse = false;
+				entry.pending = true;
+				releasedThisFrame.push_back(target);
+				return;
+			}
+		}
+	}
+
+	//Same contract as LinearRingAllocator
+	void EndFrame(const uint64_t fenceValue)
+	{
+		if (!releasedThisFrame.empty()) {
+			pendingReleases.push_back({ fenceValue, std::vector<Target *>() });
+			pendingReleases.back().targets.swap(releasedThisFrame);
+		}
+	}
+
+	void Retire(const uint64_t completedFenceValue)
+	{
+		while (!pendingReleases.empty() && pendingReleases.front().fenceValue <= completedFenceValue) {
+			for (auto target : pendingReleases.front().targets) {
+				for (auto &entry : entries) {
+					if (entry.target == target) {
+						entry.pending = false;
+					}
+				}
+			}
+			pendingReleases.pop_front();
+		}
+	}
+
+	/// <summary>
+	/// Destroy every target (GPU must be idle)
+	/// </summary>
+	void Clear()
+	{
+		for (auto &entry : entries) {
+			destroy(entry.target);
+		}
+		entries.clear();
+		releasedThisFrame.clear();
+		pendingReleases.clear();
+		allocatedBytes = 0;
+	}
+
+	uint64_t GetAllocatedBytes() const { return allocatedBytes; }
+	size_t GetTargetCount() const { return entries.size(); }
+	uint64_t GetCreateCount() const { return createCount; }
+	uint64_t GetReuseCount() const { return reuseCount; }
+
+private:
+	struct Entry
+	{
+		RenderTargetDesc desc;
+		Target *target;
+		uint64_t sizeInBytes;
+		bool inUse;
+		bool pending;
+	};
+
+	struct PendingRelease
+	{
+		uint64_t fenceValue;
+		std::vector<Target *> targets;
+	};
+
+	CreateFunc create;
+	DestroyFunc destroy;
+
+	std::vector<Entry> entries;
+	std::vector<Target *> releasedThisFrame;
+	std::deque<PendingRelease> pendingReleases;
+
+	uint64_t allocatedBytes;
+	uint64_t createCount;
+	uint64_t reuseCount;
+};
@@ -0,0 +1,129 @@
+//STL
+#include <algorithm>
+#include <cstdlib>
+#include <sstream>
+
+//this
+#include "ScriptedInput.h"
+
+namespace
+{
+	struct KeyName
+	{
+		const char *name;
+		keycode key;
+	};
+
+	const KeyName keyNames[] = {
+		{ "escape", keycode::Escape },
+		{ "space", keycode::Space },
+		{ "return", keycode::Return },
+		{ "up", keycode::UpArrow },
+		{ "down", keycode::DownAllow },
+		{ "left", keycode::LeftArrow },
+		{ "right", keycode::RightArrow },
+		{ "w", keycode::W },
+		{ "a", keycode::A },
+		{ "s", keycode::S },
+		{ "d", keycode::D },
+		{ "h", keycode::H },
+	};
+
+	bool ParseKey(const std::string &text, keycode &key)
+	{
+		for (auto &entry : keyNames) {
+			if (text == entry.name) {
+				key = entry.key;
+				return true;
+			}
+		}
+
+		//Scan code
+		char *end = nullptr;
+		const unsigned long code = std::strtoul(text.c_str(), &end, 0);
+		if (text.empty() || *end != '\0' || code >= (unsigned long)key_size) {
+			return false;
+		}
+		key = (keycode)code;
+		return true;
+	}
+}
+
+ScriptedInput::ScriptedInput() : next(0), sorted(true) {}
+
+void ScriptedInput::Add(const int64_t time, const keycode key, const bool down)
+{
+	events.push_back({ time, (uint8_t)key, down });
+	sorted = false;
+}
+
+bool ScriptedInput::Load(const std::string &text, std::string &error)
+{
+	std::istringstream stream(text);
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(stream, line)) {
+		++lineNumber;
+
+		const size_t comment = line.find('#');
+		if (comment != std::string::npos) {
+			line.erase(comment);
+		}
+
+		if (line.find_first_not_of(" \t\r") == std::string::npos) {
+			continue;
+		}
+
+		std::istringstream fields(line);
+		std::string keyName, state, extra;
+		double milliseconds = 0;
+		keycode key;
+		if (!(fields >> milliseconds >> keyName >> state) || (fields >> extra) || (state != "down" && state != "up")) {
+			error = "line " + std::to_string(lineNumber) + ": expected \"milliseconds key down|up\"";
+			return false;
+		}
+		if (!ParseKey(keyName, key)) {
+			error = "line " + std::to_string(lineNumber) + ": unknown key \"" + keyName + "\"";
+			return false;
+		}
+
+		Add((int64_t)(milliseconds * 1e6), key, state == "down");
+	}
+	return true;
+}
+
+bool ScriptedInput::Poll(InputQueue &queue, const int64_t now)
+{
+	Sort();
+	while (next < events.size() && events[next].time <= now) {
+		queue.Push(events[next++]);
+	}
+	return true;
+}
+
+bool ScriptedInput::IsFinished() const
+{
+	return next >= events.size();
+}
+
+int64_t ScriptedInput::GetEndTime() const
+{
+	int64_t end = 0;
+	for (auto &event : events) {
+		end = std::max(end, event.time);
+	}
+	return end;
+}
+
+void ScriptedInput::Sort()
+{
+	if (sorted) {
+		return;
+	}
+
+	//Same time keeps the written order (down then up = a tap)
+	std::stable_sort(events.begin() + next, events.end(), [](const KeyEvent &a, const KeyEvent &b) {
+		return a.time < b.time;
+	});
+	sorted = true;
+}
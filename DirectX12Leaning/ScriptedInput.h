@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "InputQueue.h"
+
+/// <summary>
+/// Backend that plays a fixed list of key events (headless runs and platforms without DirectInput)
+/// </summary>
+class ScriptedInput : public InputBackend
+{
+public:
+	ScriptedInput();
+
+	//Events can be added in any order, time in nanoseconds
+	void Add(const int64_t time, const keycode key, const bool down);
+
+	/// <summary>
+	/// Parse "milliseconds key down|up" lines, '#' starts a comment
+	/// </summary>
+	/// <remarks>key is a name (space, w, up, escape ...) or a scan code (57, 0x39)</remarks>
+	/// <param name="error">Line and reason of the first bad line</param>
+	bool Load(const std::string &text, std::string &error);
+
+	bool Poll(InputQueue &queue, const int64_t now) override;
+
+	bool IsFinished() const;
+	int64_t GetEndTime() const;		//Time of the last event
+
+private:
+	void Sort();
+
+	std::vector<KeyEvent> events;
+	size_t next;
+	bool sorted;
+};
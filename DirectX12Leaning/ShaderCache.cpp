@@ -0,0 +1,247 @@
+//API
+#include <Windows.h>
+#include <d3d12.h>
+
+//shader(HLSL)
+#include <d3dcompiler.h>
+#pragma comment(lib, "d3dcompiler.lib")
+
+//STL
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+//this
+#include "ShaderCache.h"
+
+namespace
+{
+	//Shader paths are ASCII
+	std::string ToNarrow(const wchar_t *text)
+	{
+		std::string result;
+		for (; *text != L'\0'; ++text) {
+			result.push_back(static_cast<char>(*text));
+		}
+		return result;
+	}
+
+	std::wstring ToWide(const std::string &text)
+	{
+		return std::wstring(text.begin(), text.end());
+	}
+
+	//Same bits D3DCompile takes for the fxc switches the build used
+	uint32_t ToCompileFlags(const PrecompiledShaderOptions &options)
+	{
+		const uint32_t levels[] = {
+			D3DCOMPILE_OPTIMIZATION_LEVEL0,
+			D3DCOMPILE_OPTIMIZATION_LEVEL1,
+			D3DCOMPILE_OPTIMIZATION_LEVEL2,
+			D3DCOMPILE_OPTIMIZATION_LEVEL3
+		};
+
+		uint32_t flags = levels[options.optimizationLevel];
+		if (options.debugInfo) {
+			flags |= D3DCOMPILE_DEBUG;
+		}
+		if (options.skipOptimization) {
+			flags |= D3DCOMPILE_SKIP_OPTIMIZATION;
+		}
+		return flags;
+	}
+
+	bool ReadText(const std::string &path, std::string &text)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		text.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	ID3DBlob *ReadBlob(const std::string &path)
+	{
+		ID3DBlob *blob = nullptr;
+		if (FAILED(D3DReadFileToBlob(ToWide(path).c_str(), &blob))) {
+			return nullptr;
+		}
+		return blob;
+	}
+}
+
+ShaderCache::ShaderCache() :
+	memoryHitCount(0),
+	diskHitCount(0),
+	precompiledHitCount(0),
+	compileCount(0)
+{
+#ifdef _DEBUG
+	compileFlags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
+#else
+	compileFlags = D3DCOMPILE_OPTIMIZATION_LEVEL3;
+#endif
+}
+
+ShaderCache::~ShaderCache()
+{
+	blobs.ForEach([](ID3DBlob *v) { v->Release(); });
+}
+
+void ShaderCache::Initialize(const std::string &cacheDirectory, const std::string &precompiledDirectory)
+{
+	this->cacheDirectory = cacheDirectory;
+	this->precompiledDirectory = precompiledDirectory;
+
+	//Fails harmlessly when it already exists
+	CreateDirectoryW(ToWide(cacheDirectory).c_str(), nullptr);
+
+	//Settings the build compiled each .cso with (Debug and Release share Shaders/cso, the last build wins)
+	std::unordered_map<std::string, PrecompiledShaderOptions> options;
+	std::string text;
+	precompiledFlags.clear();
+	if (ReadText(precompiledDirectory + "/flags.txt", text) && ParsePrecompiledOptions(text, options)) {
+		for (auto &shader : options) {
+			precompiledFlags[shader.first] = ToCompileFlags(shader.second);
+		}
+	}
+}
+
+ID3DBlob *ShaderCache::Get(const wchar_t *fileName, const char *entry, const char *target, const std::vector<ShaderDefine> &defines)
+{
+	const std::string path = ToNarrow(fileName);
+
+	//Same request again (objects are created many times): no disk access
+	CacheKey request;
+	request.WriteString(path.c_str());
+	WriteShaderOptions(request, entry, target, defines, compileFlags);
+
+	ID3DBlob *cached = nullptr;
+	if (requests.Find(request, cached)) {
+		++memoryHitCount;
+		return cached;
+	}
+
+	//Key = source + includes content, compile options
+	CacheKey key;
+	std::vector<std::string> files;
+	if (!WriteShaderSource(key, path, files)) {
+		//Nothing is cached: the next Get reads the files again
+		OutputDebugStringA(("ShaderCache: can not read " + files.back() + "\n").c_str());
+		return nullptr;
+	}
+	WriteShaderOptions(key, entry, target, defines, compileFlags);
+
+	//Other request with the same content
+	ID3DBlob *bytecode = nullptr;
+	if (blobs.Find(key, bytecode)) {
+		++memoryHitCount;
+		requests.Insert(request, bytecode);
+		return bytecode;
+	}
+
+	const std::string cachePath = cacheDirectory + "/" + ShaderCacheFileName(path, key.GetHash());
+	bytecode = ReadBlob(cachePath);
+	if (bytecode != nullptr) {
+		++diskHitCount;
+	}
+	else {
+		//Build output only matches the default FxCompile options
+		if (defines.empty() && strcmp(entry, "main") == 0) {
+			bytecode = LoadPrecompiled(path, target, files);
+		}
+		if (bytecode != nullptr) {
+			++precompiledHitCount;
+		}
+		else {
+			bytecode = Compile(path, entry, target, defines);
+		}
+
+		//Compile error: not written or cached, the next Get compiles again
+		if (bytecode == nullptr) {
+			return nullptr;
+		}
+		D3DWriteBlobToFile(bytecode, ToWide(cachePath).c_str(), TRUE);
+	}
+
+	blobs.Insert(key, bytecode);
+	requests.Insert(request, bytecode);
+	return bytecode;
+}
+
+ID3DBlob *ShaderCache::LoadPrecompiled(const std::string &path, const char *target, const std::vector<std::string> &files)
+{
+	//FxCompile builds shader model 5.0, the flags come from the build's flags.txt
+	const size_t targetLength = strlen(target);
+	if (targetLength < 4 || strcmp(target + targetLength - 4, "_5_0") != 0) {
+		return nullptr;
+	}
+
+	auto flags = precompiledFlags.find(ShaderFileStem(path));
+	if (flags == precompiledFlags.end() || flags->second != compileFlags) {
+		return nullptr;
+	}
+
+	//Stale when any source / include differs from the copy the build compiled (Shaders/cso/source)
+	if (!ShaderSourcesMatch(files, precompiledDirectory + "/source")) {
+		return nullptr;
+	}
+	return ReadBlob(precompiledDirectory + "/" + ShaderFileStem(path) + ".cso");
+}
+
+ID3DBlob *ShaderCache::Compile(const std::string &path, const char *entry, const char *target, const std::vector<ShaderDefine> &defines)
+{
+	std::vector<D3D_SHADER_MACRO> macros;
+	for (auto &define : defines) {
+		macros.push_back({ define.name.c_str(), define.value.c_str() });
+	}
+	macros.push_back({ nullptr, nullptr });
+
+	ID3DBlob *blob = nullptr;
+	ID3DBlob *errorBlob = nullptr;
+	result = D3DCompileFromFile(
+		ToWide(path).c_str(),
+		macros.data(),
+		D3D_COMPILE_STANDARD_FILE_INCLUDE,
+		entry, target,
+		compileFlags,
+		0,
+		&blob, &errorBlob
+	);
+
+	if (errorBlob != nullptr) {
+		OutputDebugStringA(static_cast<const char *>(errorBlob->GetBufferPointer()));
+		errorBlob->Release();
+	}
+	if (FAILED(result)) {
+		if (blob != nullptr) {
+			blob->Release();
+		}
+		return nullptr;
+	}
+
+	++compileCount;
+	return blob;
+}
+
+uint64_t ShaderCache::GetMemoryHitCount() const
+{
+	//Repeated requests + other requests with the same content
+	return memoryHitCount;
+}
+
+uint64_t ShaderCache::GetDiskHitCount() const
+{
+	return diskHitCount;
+}
+
+uint64_t ShaderCache::GetPrecompiledHitCount() const
+{
+	return precompiledHitCount;
+}
+
+uint64_t ShaderCache::GetCompileCount() const
+{
+	return compileCount;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "ObjectCache.h"
+#include "ShaderSource.h"
+
+/// <summary>
+/// Shader bytecode cache: memory -> ShaderCache/ (content hash) -> precompiled .cso -> compile
+/// </summary>
+class ShaderCache
+{
+public:
+	ShaderCache();
+	~ShaderCache();
+
+	/// <param name="cacheDirectory">Hash named blobs written on compile</param>
+	/// <param name="precompiledDirectory">Build output (FxCompile), used when its source/ copies match the sources and its flags.txt matches the compile flags</param>
+	void Initialize(const std::string &cacheDirectory = "ShaderCache", const std::string &precompiledDirectory = "Shaders/cso");
+
+	/// <summary>
+	/// Bytecode for fileName / entry / target / defines
+	/// </summary>
+	/// <returns>Owned by the cache, do not Release. nullptr when a source can not be read or does not compile (not cached)</returns>
+	ID3DBlob *Get(const wchar_t *fileName, const char *entry, const char *target, const std::vector<ShaderDefine> &defines = {});
+
+	uint64_t GetMemoryHitCount() const;
+	uint64_t GetDiskHitCount() const;
+	uint64_t GetPrecompiledHitCount() const;
+	uint64_t GetCompileCount() const;
+
+private:
+	ID3DBlob *LoadPrecompiled(const std::string &path, const char *target, const std::vector<std::string> &files);
+	ID3DBlob *Compile(const std::string &path, const char *entry, const char *target, const std::vector<ShaderDefine> &defines);
+
+private:
+	HRESULT result;
+	std::string cacheDirectory;
+	std::string precompiledDirectory;
+	uint32_t compileFlags;
+
+	//Shader file stem -> D3DCOMPILE flags of its .cso
+	std::unordered_map<std::string, uint32_t> precompiledFlags;
+
+	//Request (file name + options) -> blob, hits skip reading the sources
+	ObjectCache<ID3DBlob *> requests;
+	uint64_t memoryHitCount;
+
+	//Content key -> blob, owns the blobs
+	ObjectCache<ID3DBlob *> blobs;
+	uint64_t diskHitCount;
+	uint64_t precompiledHitCount;
+	uint64_t compileCount;
+};
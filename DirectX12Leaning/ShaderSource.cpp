@@ -0,0 +1,166 @@
+//STL
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+//this
+#include "ShaderSource.h"
+
+namespace
+{
+	std::string DirectoryOf(const std::string &path)
+	{
+		const size_t slash = path.find_last_of("/\\");
+		return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+	}
+
+	bool ReadFile(const std::string &path, std::string &text)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+
+		std::ostringstream stream;
+		stream << file.rdbuf();
+		text = stream.str();
+		return true;
+	}
+
+	//#include "name" -> name, other lines -> empty
+	std::string IncludeName(const std::string &line)
+	{
+		size_t pos = line.find_first_not_of(" \t");
+		if (pos == std::string::npos || line.compare(pos, 8, "#include") != 0) {
+			return std::string();
+		}
+
+		const size_t open = line.find('"', pos + 8);
+		const size_t close = (open == std::string::npos) ? std::string::npos : line.find('"', open + 1);
+		if (close == std::string::npos) {
+			return std::string();
+		}
+		return line.substr(open + 1, close - open - 1);
+	}
+}
+
+bool WriteShaderSource(CacheKey &key, const std::string &path, std::vector<std::string> &files)
+{
+	//Each file once (include guards / #pragma once)
+	if (std::find(files.begin(), files.end(), path) != files.end()) {
+		return true;
+	}
+	files.push_back(path);
+
+	std::string text;
+	if (!ReadFile(path, text)) {
+		return false;
+	}
+
+	key.WriteString(path.c_str());
+	key.WriteValue(static_cast<uint64_t>(text.size()));
+	key.Write(text.data(), text.size());
+
+	std::istringstream lines(text);
+	std::string line;
+	while (std::getline(lines, line)) {
+		const std::string include = IncludeName(line);
+		if (!include.empty() && !WriteShaderSource(key, DirectoryOf(path) + include, files)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void WriteShaderOptions(CacheKey &key, const std::string &entry, const std::string &target, const std::vector<ShaderDefine> &defines, const uint32_t flags)
+{
+	key.WriteString(entry.c_str());
+	key.WriteString(target.c_str());
+
+	key.WriteValue(static_cast<uint32_t>(defines.size()));
+	for (auto &define : defines) {
+		key.WriteString(define.name.c_str());
+		key.WriteString(define.value.c_str());
+	}
+	key.WriteValue(flags);
+}
+
+bool ShaderSourcesMatch(const std::vector<std::string> &files, const std::string &directory)
+{
+	for (auto &file : files) {
+		std::string text, copy;
+		if (!ReadFile(file, text) || !ReadFile(directory + "/" + file.substr(DirectoryOf(file).size()), copy)) {
+			return false;
+		}
+		if (text != copy) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool ParsePrecompiledOptions(const std::string &text, std::unordered_map<std::string, PrecompiledShaderOptions> &options)
+{
+	std::istringstream lines(text);
+	std::string line;
+	while (std::getline(lines, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		if (line.empty()) {
+			continue;
+		}
+
+		//stem|debugInfo|skipOptimization|additional options (MSBuild metadata, unset = empty)
+		std::vector<std::string> fields;
+		std::istringstream parts(line);
+		std::string field;
+		while (std::getline(parts, field, '|')) {
+			fields.push_back(field);
+		}
+		if (fields.size() == 3 && line.back() == '|') {
+			fields.emplace_back();
+		}
+		if (fields.size() != 4 || fields[0].empty()) {
+			return false;
+		}
+
+		PrecompiledShaderOptions shader;
+		shader.debugInfo = fields[1] == "true";
+		shader.skipOptimization = fields[2] == "true";
+
+		std::istringstream switches(fields[3]);
+		std::string option;
+		while (switches >> option) {
+			if (option == "/Zi") {
+				shader.debugInfo = true;
+			}
+			else if (option == "/Od") {
+				shader.skipOptimization = true;
+			}
+			else if (option.size() == 3 && option.compare(0, 2, "/O") == 0 && option[2] >= '0' && option[2] <= '3') {
+				shader.optimizationLevel = option[2] - '0';
+			}
+		}
+		options[fields[0]] = shader;
+	}
+	return true;
+}
+
+std::string ShaderFileStem(const std::string &path)
+{
+	std::string stem = path.substr(DirectoryOf(path).size());
+	const size_t dot = stem.find_last_of('.');
+	if (dot != std::string::npos) {
+		stem.erase(dot);
+	}
+	return stem;
+}
+
+std::string ShaderCacheFileName(const std::string &path, const uint64_t hash)
+{
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+	return ShaderFileStem(path) + "_" + hex + ".cso";
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "CacheKey.h"
+
+struct ShaderDefine
+{
+	std::string name;
+	std::string value;
+};
+
+/// <summary>
+/// Write a shader source and every #include "..." it pulls in (recursively) into key
+/// </summary>
+/// <param name="path">Source file, includes resolve relative to the including file</param>
+/// <param name="files">Receives every file read (source first)</param>
+/// <returns>false when a file could not be read</returns>
+bool WriteShaderSource(CacheKey &key, const std::string &path, std::vector<std::string> &files);
+
+/// <summary>
+/// Write the compile options (entry, target, defines, flags) into key
+/// </summary>
+void WriteShaderOptions(CacheKey &key, const std::string &entry, const std::string &target, const std::vector<ShaderDefine> &defines, const uint32_t flags);
+
+/// <summary>
+/// Compare files with the copies in directory (same file name, no subdirectories)
+/// </summary>
+/// <returns>true when every copy exists with the same content</returns>
+bool ShaderSourcesMatch(const std::vector<std::string> &files, const std::string &directory);
+
+//FxCompile settings one precompiled .cso was built with
+struct PrecompiledShaderOptions
+{
+	bool debugInfo = false;				//EnableDebuggingInformation, /Zi
+	bool skipOptimization = false;		//DisableOptimizations, /Od
+	uint32_t optimizationLevel = 1;		//fxc default, /O0 - /O3 in the additional options
+};
+
+/// <summary>
+/// Parse the settings file the build writes next to the .cso files
+/// </summary>
+/// <param name="text">One "stem|debugInfo|skipOptimization|additional options" line per shader</param>
+/// <returns>false on a malformed line (options is left with the lines before it)</returns>
+bool ParsePrecompiledOptions(const std::string &text, std::unordered_map<std::string, PrecompiledShaderOptions> &options);
+
+/// <summary>
+/// File name without directory and extension: "Shaders/BasicVS3D.hlsl" -> "BasicVS3D"
+/// </summary>
+std::string ShaderFileStem(const std::string &path);
+
+/// <summary>
+/// Cache file name for a key: "BasicVS3D_0123456789abcdef.cso"
+/// </summary>
+std::string ShaderCacheFileName(const std::string &path, const uint64_t hash);
@@ -9,4 +9,5 @@ struct VSOutput
     float4 svpos : SV_POSITION;
     float3 normal : NORMAL;
     float2 uv : TEXCOORD;
+    float4 color : COLOR;
 };
\ No newline at end of file
@@ -6,5 +6,6 @@ VSOutput main(float4 pos : POSITION, float3 normal : NORMAL, float2 uv : TEXCOOR
     output.normal = normal;
     output.svpos = mul(mat, pos);
     output.uv = uv;
+    output.color = color;
     return output;
 }
\ No newline at end of file
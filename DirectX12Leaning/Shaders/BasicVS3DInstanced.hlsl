@@ -0,0 +1,22 @@
+#include "Basic.hlsli"
+
+//mat = view * projection, world comes from the instance
+struct InstanceData
+{
+    matrix world;
+    float4 color;
+};
+
+StructuredBuffer<InstanceData> instances : register(t1);
+
+VSOutput main(float4 pos : POSITION, float3 normal : NORMAL, float2 uv : TEXCOORD, uint instanceID : SV_InstanceID)
+{
+    InstanceData instance = instances[instanceID];
+
+    VSOutput output;
+    output.normal = normal;
+    output.svpos = mul(mat, mul(instance.world, pos));
+    output.uv = uv;
+    output.color = instance.color;
+    return output;
+}
@@ -0,0 +1,9 @@
+#include "SpriteShader.hlsli"
+
+Texture2D<float4> tex : register(t0);
+SamplerState smp : register(s0);
+
+float4 main(VSOutput input) : SV_TARGET
+{
+    return float4(tex.Sample(smp, input.uv)) * input.color;
+}
\ No newline at end of file
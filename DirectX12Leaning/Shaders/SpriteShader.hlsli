@@ -0,0 +1,11 @@
+cbuffer cbuff0 : register(b0)
+{
+    matrix mat;
+}
+
+struct VSOutput
+{
+    float4 svpos : SV_POSITION;
+    float2 uv : TEXCOORD;
+    float4 color : COLOR;
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+//this
+#include "SimRandom.h"
+
+namespace
+{
+	const uint64_t multiplier = 6364136223846793005ull;
+	const uint64_t increment = 1442695040888963407ull;
+}
+
+SimRandom::SimRandom(const uint64_t seed)
+{
+	Seed(seed);
+}
+
+void SimRandom::Seed(const uint64_t seed)
+{
+	//Reference pcg32 seeding: step, add the seed, step
+	state = 0;
+	Next();
+	state += seed;
+	Next();
+}
+
+uint32_t SimRandom::Next()
+{
+	const uint64_t old = state;
+	state = old * multiplier + increment;
+
+	const uint32_t xorShifted = (uint32_t)(((old >> 18) ^ old) >> 27);
+	const uint32_t rotation = (uint32_t)(old >> 59);
+	return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+}
+
+uint32_t SimRandom::Range(const uint32_t count)
+{
+	//Multiply shift: no division, bias below 2^-32 * count
+	return (uint32_t)(((uint64_t)Next() * count) >> 32);
+}
+
+uint64_t SimRandom::GetState() const
+{
+	return state;
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include <cstdint>
+
+/// <summary>
+/// Seeded PRNG for the simulation (PCG32), the same seed gives the same game on every platform
+/// </summary>
+/// <remarks>
+/// Replaces rand(): its sequence depends on the C runtime and is shared with everything else in the process.
+/// </remarks>
+class SimRandom
+{
+public:
+	SimRandom(const uint64_t seed = 0);
+
+	void Seed(const uint64_t seed);
+
+	uint32_t Next();
+
+	//0 - (count - 1), count 0 gives 0
+	uint32_t Range(const uint32_t count);
+
+	//For state hashes
+	uint64_t GetState() const;
+
+private:
+	uint64_t state;
+};
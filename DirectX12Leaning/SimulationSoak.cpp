@@ -0,0 +1,174 @@
+//Headless soak runner for GameSimulation (no window / GPU)
+//usage: SimulationSoak [ticks] [tickRate] [--seed N] [--record file] [--script file [--fps N]]
+//       SimulationSoak --replay file
+//  --record  save the session (inputs + per tick state hashes)
+//  --replay  fast-forward a recording from the game or --record and check every tick hash
+//  --script  key events ("milliseconds key down|up" lines) through the same InputQueue path as the game,
+//            frames of 1 / fps seconds (default 30) on a virtual clock; runs until the script ends + 1 s
+
+//STL
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+//Utility
+#include "FixedTimestep.h"
+#include "GameSimulation.h"
+#include "InputRecording.h"
+#include "ScriptedInput.h"
+
+namespace
+{
+	//Scripted input: start the game, then weave and fire
+	SimInput ScriptedTickInput(const uint64_t tick)
+	{
+		SimInput input;
+
+		input.held |= (tick / 90) % 2 ? SimButton_Up : SimButton_Down;
+		input.held |= (tick / 240) % 2 ? SimButton_Right : SimButton_Left;
+
+		if (tick % 30 == 0) {
+			input.held |= SimButton_Fire;
+			input.pressed |= SimButton_Fire;
+		}
+		return input;
+	}
+
+	void PrintResult(const GameSimulation &simulation, const uint64_t ticks, const double seconds)
+	{
+		const SimulationSnapshot &state = simulation.GetSnapshot();
+
+		printf("ticks      : %llu\n", (unsigned long long)ticks);
+		printf("time       : %.3f s\n", seconds);
+		printf("ticks/sec  : %.0f\n", seconds > 0 ? ticks / seconds : 0.0);
+		printf("player     : %.2f %.2f\n", state.player.x, state.player.y);
+		printf("scene      : %d\n", static_cast<int>(state.scene));
+		printf("state hash : %016llx\n", (unsigned long long)simulation.GetStateHash());
+	}
+
+	int Replay(const std::string &path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		InputReplay replay;
+		if (!file || !replay.Open(&file)) {
+			printf("cannot read recording %s\n", path.c_str());
+			return 1;
+		}
+
+		FixedTimestep timestep(replay.GetTickRate());
+		GameSimulation simulation(replay.GetSeed());
+
+		SimInput input;
+		auto start = std::chrono::steady_clock::now();
+		while (replay.Next(input)) {
+			simulation.Tick(input, timestep.GetDeltaTime());
+			if (!replay.Check(simulation.GetStateHash())) {
+				break;
+			}
+		}
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		printf("seed       : %llu\n", (unsigned long long)replay.GetSeed());
+		PrintResult(simulation, replay.GetTickCount(), seconds);
+		if (replay.HasDiverged()) {
+			printf("DIVERGED at tick %llu\n", (unsigned long long)replay.GetDivergedTick());
+			return 1;
+		}
+		printf("replay     : %s\n", replay.HasHashes() ? "matches the recording" : "no hashes recorded");
+		return 0;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	uint64_t ticks = 1000000;
+	double tickRate = 120.0;
+	uint64_t seed = 0;
+	std::string recordPath;
+	std::string scriptPath;
+	double fps = 30.0;
+
+	int position = 0;
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			return Replay(argv[i + 1]);
+		}
+		else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)	{ recordPath = argv[++i]; }
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)	{ seed = std::strtoull(argv[++i], nullptr, 10); }
+		else if (strcmp(argv[i], "--script") == 0 && i + 1 < argc)	{ scriptPath = argv[++i]; }
+		else if (strcmp(argv[i], "--fps") == 0 && i + 1 < argc)		{ fps = std::atof(argv[++i]); }
+		else if (position == 0)	{ ticks = std::strtoull(argv[i], nullptr, 10); ++position; }
+		else if (position == 1)	{ tickRate = std::atof(argv[i]); ++position; }
+	}
+
+	FixedTimestep timestep(tickRate);
+	GameSimulation simulation(seed);
+
+	std::ofstream recordFile;
+	InputRecorder recorder;
+	if (!recordPath.empty()) {
+		recordFile.open(recordPath, std::ios::binary | std::ios::trunc);
+		if (!recordFile || !recorder.Begin(&recordFile, seed, tickRate)) {
+			printf("cannot write %s\n", recordPath.c_str());
+			return 1;
+		}
+	}
+
+	const auto step = [&](const SimInput &input) {
+		simulation.Tick(input, timestep.GetDeltaTime());
+		if (recorder.IsRecording()) {
+			recorder.Record(input, simulation.GetStateHash());
+		}
+	};
+
+	if (!scriptPath.empty()) {
+		std::ifstream file(scriptPath);
+		std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()), error;
+		ScriptedInput script;
+		if (!file || !(fps > 0) || !script.Load(text, error)) {
+			printf("%s: %s\n", scriptPath.c_str(), file ? (error.empty() ? "fps must be above 0" : error.c_str()) : "cannot read");
+			return 1;
+		}
+
+		//Same per tick split as GamePlay::Update
+		InputQueue keys;
+		const int64_t frameLength = (int64_t)(1e9 / fps);
+		const int64_t endTime = script.GetEndTime() + 1000000000;
+		uint64_t fired = 0;
+		ticks = 0;
+
+		auto start = std::chrono::steady_clock::now();
+		for (int64_t now = frameLength; now <= endTime + frameLength; now += frameLength) {
+			script.Poll(keys, now);
+
+			const int count = timestep.Advance(frameLength / 1e9);
+			for (int i = 0; i < count; ++i) {
+				keys.AdvanceTo(timestep.GetTickEndTime(now, i, count));
+				const SimInput input = ReadSimInput(keys);
+				fired += input.GetKeyDown(SimButton_Fire) ? 1 : 0;
+				step(input);
+				++ticks;
+			}
+		}
+		auto end = std::chrono::steady_clock::now();
+		recorder.End();
+
+		PrintResult(simulation, ticks, std::chrono::duration<double>(end - start).count());
+		printf("fire ticks : %llu\n", (unsigned long long)fired);
+		return 0;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t i = 0; i < ticks; ++i) {
+		step(ScriptedTickInput(i));
+	}
+	auto end = std::chrono::steady_clock::now();
+	recorder.End();
+
+	PrintResult(simulation, ticks, std::chrono::duration<double>(end - start).count());
+	return 0;
+}
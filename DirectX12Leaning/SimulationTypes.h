@@ -0,0 +1,38 @@
+#pragma once
+#include <cstdint>
+
+//Platform neutral types shared by the simulation and the renderer
+
+struct Position3D
+{
+	float x = 0;
+	float y = 0;
+	float z = 0;
+};
+
+//Circle test on x / y, squared so no sqrtf (touching counts as a hit)
+inline bool CirclesOverlap(const float ax, const float ay, const float ar, const float bx, const float by, const float br)
+{
+	const float dx = ax - bx;
+	const float dy = ay - by;
+	const float r = ar + br;
+	return dx * dx + dy * dy <= r * r;
+}
+
+enum SimButton : uint32_t {
+	SimButton_Up	= 1 << 0,
+	SimButton_Down	= 1 << 1,
+	SimButton_Left	= 1 << 2,
+	SimButton_Right	= 1 << 3,
+	SimButton_Fire	= 1 << 4,
+	SimButton_Home	= 1 << 5,
+};
+
+struct SimInput
+{
+	uint32_t held = 0;		//Button is down this tick
+	uint32_t pressed = 0;	//Button went down this tick
+
+	bool GetKey(SimButton button) const { return (held & button) != 0; }
+	bool GetKeyDown(SimButton button) const { return (pressed & button) != 0; }
+};
@@ -0,0 +1,167 @@
+//STL
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+//Utility
+#include "SimulationTypes.h"
+
+//this
+#include "SpatialHash.h"
+
+namespace
+{
+	const uint32_t minBucketCount = 16;
+
+	int32_t CellOf(const float value, const float inverseCellSize)
+	{
+		return (int32_t)std::floor(value * inverseCellSize);
+	}
+}
+
+SpatialHash::SpatialHash(const float cellSize)
+{
+	SetCellSize(cellSize);
+	bucketMask = 0;
+}
+
+void SpatialHash::Clear()
+{
+	bodies.clear();
+	entries.clear();
+	sorted.clear();
+	bucketStart.clear();
+	bucketMask = 0;
+}
+
+void SpatialHash::Reserve(const uint32_t bodyCount)
+{
+	const size_t entryCount = (size_t)bodyCount * 4;
+
+	uint32_t bucketCount = minBucketCount;
+	while (bucketCount < entryCount * 2) {
+		bucketCount *= 2;
+	}
+
+	bodies.reserve(bodyCount);
+	entries.reserve(entryCount);
+	sorted.reserve(entryCount);
+	entryBucket.reserve(entryCount);
+	bucketStart.reserve(bucketCount + 1);
+	cursor.reserve(bucketCount);
+}
+
+uint32_t SpatialHash::Insert(const float x, const float y, const float radius, const uint32_t group, const uint32_t mask)
+{
+	bodies.push_back({ x, y, radius, group, mask, 0, 0 });
+	return (uint32_t)bodies.size() - 1;
+}
+
+void SpatialHash::Build()
+{
+	entries.clear();
+	for (uint32_t i = 0; i < (uint32_t)bodies.size(); ++i) {
+		Body &body = bodies[i];
+		body.minCellX = CellOf(body.x - body.radius, inverseCellSize);
+		body.minCellY = CellOf(body.y - body.radius, inverseCellSize);
+		const int32_t maxCellX = CellOf(body.x + body.radius, inverseCellSize);
+		const int32_t maxCellY = CellOf(body.y + body.radius, inverseCellSize);
+
+		for (int32_t y = body.minCellY; y <= maxCellY; ++y) {
+			for (int32_t x = body.minCellX; x <= maxCellX; ++x) {
+				entries.push_back({ x, y, i });
+			}
+		}
+	}
+
+	//Twice as many buckets as entries keeps unrelated cells apart
+	uint32_t bucketCount = minBucketCount;
+	while (bucketCount < entries.size() * 2) {
+		bucketCount *= 2;
+	}
+	bucketMask = bucketCount - 1;
+
+	bucketStart.assign(bucketCount + 1, 0);
+	entryBucket.resize(entries.size());
+	for (size_t i = 0; i < entries.size(); ++i) {
+		entryBucket[i] = Bucket(entries[i].cellX, entries[i].cellY);
+		++bucketStart[entryBucket[i] + 1];
+	}
+	for (uint32_t b = 0; b < bucketCount; ++b) {
+		bucketStart[b + 1] += bucketStart[b];
+	}
+
+	//Stable, so bodies stay in Insert order inside a bucket
+	sorted.resize(entries.size());
+	cursor.assign(bucketStart.begin(), bucketStart.end() - 1);
+	for (size_t i = 0; i < entries.size(); ++i) {
+		sorted[cursor[entryBucket[i]]++] = entries[i];
+	}
+}
+
+size_t SpatialHash::QueryPairs(std::vector<CollisionPair> &pairs) const
+{
+	pairs.clear();
+	if (bucketStart.empty()) {
+		return 0;
+	}
+
+	for (uint32_t b = 0; b <= bucketMask; ++b) {
+		const uint32_t end = bucketStart[b + 1];
+		for (uint32_t i = bucketStart[b]; i < end; ++i) {
+			const CellEntry &first = sorted[i];
+			const Body &a = bodies[first.body];
+
+			for (uint32_t j = i + 1; j < end; ++j) {
+				//Another cell hashed into the same bucket
+				const CellEntry &second = sorted[j];
+				if (second.cellX != first.cellX || second.cellY != first.cellY) {
+					continue;
+				}
+
+				const Body &b = bodies[second.body];
+				if ((a.group & b.mask) == 0 || (b.group & a.mask) == 0) {
+					continue;
+				}
+
+				//Only the first shared cell reports the pair
+				if (std::max(a.minCellX, b.minCellX) != first.cellX || std::max(a.minCellY, b.minCellY) != first.cellY) {
+					continue;
+				}
+
+				if (CirclesOverlap(a.x, a.y, a.radius, b.x, b.y, b.radius)) {
+					pairs.push_back({ first.body, second.body });
+				}
+			}
+		}
+	}
+	return pairs.size();
+}
+
+void SpatialHash::SetCellSize(const float size)
+{
+	assert(size > 0);
+	cellSize = size;
+	inverseCellSize = 1.0f / size;
+}
+
+float SpatialHash::GetCellSize() const
+{
+	return cellSize;
+}
+
+uint32_t SpatialHash::GetBodyCount() const
+{
+	return (uint32_t)bodies.size();
+}
+
+size_t SpatialHash::GetCellEntryCount() const
+{
+	return sorted.size();
+}
+
+uint32_t SpatialHash::Bucket(const int32_t cellX, const int32_t cellY) const
+{
+	const uint32_t hash = ((uint32_t)cellX * 73856093u) ^ ((uint32_t)cellY * 19349663u);
+	return hash & bucketMask;
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+//Bodies i < j (Insert order) that overlap
+struct CollisionPair
+{
+	uint32_t a;
+	uint32_t b;
+};
+
+/// <summary>
+/// Uniform grid broadphase for circles, hashed so the world needs no bounds
+/// </summary>
+/// <remarks>
+/// Rebuilt every tick: Clear, Insert everything, Build, then QueryPairs.
+/// A body is put in every cell its bounding box touches; a pair is only tested in the
+/// first cell both boxes share, so each pair is reported once without a visited set.
+/// Cell size around the largest diameter keeps each body in at most 4 cells.
+/// </remarks>
+class SpatialHash
+{
+public:
+	SpatialHash(const float cellSize = 8.0f);
+
+	void Clear();
+
+	/// <summary>
+	/// Allocate for bodyCount bodies up front (each in up to 4 cells), later ticks do not allocate
+	/// </summary>
+	void Reserve(const uint32_t bodyCount);
+
+	/// <summary>
+	/// Add a circle for the next Build
+	/// </summary>
+	/// <param name="group">Category bits of this body</param>
+	/// <param name="mask">Categories it collides with, both sides have to accept the pair</param>
+	/// <returns>Body index (0, 1, 2 ... in Insert order)</returns>
+	uint32_t Insert(const float x, const float y, const float radius, const uint32_t group = 1, const uint32_t mask = UINT32_MAX);
+
+	/// <summary>
+	/// Bucket the inserted bodies (counting sort, no per body allocation)
+	/// </summary>
+	void Build();
+
+	/// <summary>
+	/// Every overlapping pair of the last Build (squared distance narrowphase)
+	/// </summary>
+	/// <param name="pairs">Cleared and filled, order is stable for the same inserts</param>
+	/// <returns>Pair count</returns>
+	size_t QueryPairs(std::vector<CollisionPair> &pairs) const;
+
+	void SetCellSize(const float size);	//Takes effect on the next Build
+	float GetCellSize() const;
+	uint32_t GetBodyCount() const;
+	size_t GetCellEntryCount() const;	//Body / cell records of the last Build
+
+private:
+	struct Body
+	{
+		float x;
+		float y;
+		float radius;
+		uint32_t group;
+		uint32_t mask;
+		int32_t minCellX;
+		int32_t minCellY;
+	};
+
+	struct CellEntry
+	{
+		int32_t cellX;
+		int32_t cellY;
+		uint32_t body;
+	};
+
+	uint32_t Bucket(const int32_t cellX, const int32_t cellY) const;
+
+	float cellSize;
+	float inverseCellSize;
+
+	std::vector<Body> bodies;
+
+	//Entries of bucket b are sorted[bucketStart[b] .. bucketStart[b + 1])
+	std::vector<CellEntry> entries;
+	std::vector<CellEntry> sorted;
+	std::vector<uint32_t> entryBucket;
+	std::vector<uint32_t> bucketStart;
+	std::vector<uint32_t> cursor;
+	uint32_t bucketMask;
+};
@@ -0,0 +1,116 @@
+//STL
+#include <algorithm>
+#include <assert.h>
+
+//this
+#include "SpriteBatch.h"
+
+namespace
+{
+	//layer 8bit | pipeline 12bit | texture 20bit | submission order 24bit
+	uint64_t MakeSortKey(const Sprite &sprite, const uint32_t index)
+	{
+		return (uint64_t(sprite.layer & 0xff) << 56) |
+			(uint64_t(sprite.pipeline & 0xfff) << 44) |
+			(uint64_t(sprite.texture & 0xfffff) << 24) |
+			uint64_t(index & 0xffffff);
+	}
+
+	void WriteVertex(SpriteVertex &vertex, const float x, const float y, const float u, const float v, const float *color)
+	{
+		vertex.pos[0] = x;
+		vertex.pos[1] = y;
+		vertex.pos[2] = 0.0f;
+		vertex.uv[0] = u;
+		vertex.uv[1] = v;
+		std::copy(color, color + 4, vertex.color);
+	}
+}
+
+SpriteBatch::SpriteBatch(const uint32_t capacity) : capacity(capacity)
+{
+	assert(capacity <= 0x1000000);
+
+	sprites.reserve(capacity);
+	sortKeys.reserve(capacity);
+	drawCalls.reserve(capacity);
+}
+
+void SpriteBatch::Begin()
+{
+	sprites.clear();
+	sortKeys.clear();
+	drawCalls.clear();
+}
+
+bool SpriteBatch::Draw(const Sprite &sprite)
+{
+	if (sprites.size() >= capacity) {
+		return false;
+	}
+
+	sortKeys.push_back(MakeSortKey(sprite, (uint32_t)sprites.size()));
+	sprites.push_back(sprite);
+	return true;
+}
+
+uint32_t SpriteBatch::End(SpriteVertex *vertices, const uint32_t maxSprites)
+{
+	//Stable: submission order is the lowest key bits
+	std::sort(sortKeys.begin(), sortKeys.end());
+
+	const uint32_t count = std::min((uint32_t)sortKeys.size(), maxSprites);
+	for (uint32_t i = 0; i < count; ++i) {
+		const Sprite &s = sprites[sortKeys[i] & 0xffffff];
+
+		//Quad
+		SpriteVertex *v = &vertices[i * 4];
+		WriteVertex(v[0], s.x, s.y, s.uv[0], s.uv[1], s.color);
+		WriteVertex(v[1], s.x + s.width, s.y, s.uv[2], s.uv[1], s.color);
+		WriteVertex(v[2], s.x, s.y + s.height, s.uv[0], s.uv[3], s.color);
+		WriteVertex(v[3], s.x + s.width, s.y + s.height, s.uv[2], s.uv[3], s.color);
+
+		//Merge with the previous draw when the state matches
+		if (!drawCalls.empty() && drawCalls.back().pipeline == s.pipeline && drawCalls.back().texture == s.texture) {
+			drawCalls.back().spriteCount++;
+		}
+		else {
+			drawCalls.push_back({ s.pipeline, s.texture, i, 1 });
+		}
+	}
+
+	return count;
+}
+
+const std::vector<SpriteDrawCall> &SpriteBatch::GetDrawCalls() const
+{
+	return drawCalls;
+}
+
+uint32_t SpriteBatch::GetSpriteCount() const
+{
+	return (uint32_t)sprites.size();
+}
+
+uint32_t SpriteBatch::GetCapacity() const
+{
+	return capacity;
+}
+
+std::vector<uint16_t> SpriteBatch::CreateQuadIndices(const uint32_t capacity)
+{
+	//16bit index: 4 vertices per quad
+	assert(capacity * 4 <= 0x10000);
+
+	std::vector<uint16_t> indices(capacity * 6);
+	for (uint32_t i = 0; i < capacity; ++i) {
+		const uint16_t base = (uint16_t)(i * 4);
+		indices[i * 6 + 0] = base + 0;
+		indices[i * 6 + 1] = base + 1;
+		indices[i * 6 + 2] = base + 2;
+		indices[i * 6 + 3] = base + 2;
+		indices[i * 6 + 4] = base + 1;
+		indices[i * 6 + 5] = base + 3;
+	}
+	return indices;
+}
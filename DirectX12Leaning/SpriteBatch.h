@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+struct SpriteVertex
+{
+	float pos[3];
+	float uv[2];
+	float color[4];
+};
+
+struct Sprite
+{
+	uint32_t texture = 0;
+	uint32_t pipeline = 0;
+	uint32_t layer = 0;			//Draw order group (lower first)
+
+	float x = 0;				//Top left (pixel)
+	float y = 0;
+	float width = 0;
+	float height = 0;
+	float uv[4] = { 0, 0, 1, 1 };	//u0 v0 u1 v1
+	float color[4] = { 1, 1, 1, 1 };
+};
+
+struct SpriteDrawCall
+{
+	uint32_t pipeline;
+	uint32_t texture;
+	uint32_t firstSprite;
+	uint32_t spriteCount;
+};
+
+class SpriteBatch
+{
+public:
+	/// <summary>
+	/// Quad collector (CPU side of the sprite renderer)
+	/// </summary>
+	/// <param name="capacity">Max sprites between Begin and End</param>
+	SpriteBatch(const uint32_t capacity);
+
+	void Begin();
+
+	/// <summary>
+	/// Queue a sprite
+	/// </summary>
+	/// <returns>false when the batch is full</returns>
+	bool Draw(const Sprite &sprite);
+
+	/// <summary>
+	/// Sort by layer / pipeline / texture and write the vertex stream
+	/// </summary>
+	/// <param name="vertices">Destination (min(GetSpriteCount(), maxSprites) * 4 vertices)</param>
+	/// <param name="maxSprites">Room in vertices, sprites sorted after it are left out</param>
+	/// <returns>Sprite count written</returns>
+	uint32_t End(SpriteVertex *vertices, const uint32_t maxSprites = UINT32_MAX);
+
+	const std::vector<SpriteDrawCall> &GetDrawCalls() const;
+	uint32_t GetSpriteCount() const;
+	uint32_t GetCapacity() const;
+
+	//Index list shared by every batch: 0 1 2, 2 1 3 per quad
+	static std::vector<uint16_t> CreateQuadIndices(const uint32_t capacity);
+
+private:
+	uint32_t capacity;
+
+	std::vector<Sprite> sprites;
+	std::vector<uint64_t> sortKeys;
+	std::vector<SpriteDrawCall> drawCalls;
+};
@@ -0,0 +1,297 @@
+//API
+#include <Windows.h>
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <DirectXMath.h>
+
+//shader(HLSL)
+#include <d3dcompiler.h>
+#pragma comment(lib, "d3dcompiler.lib")
+
+//STL
+#include <vector>
+#include <assert.h>
+
+//Utility
+#include "DirectX12.h"
+
+//this
+#include "SpriteRenderer.h"
+
+SpriteRenderer::SpriteRenderer(DirectX12 *dx12, const int window_width, const int window_height, const uint32_t capacity) :
+	dx12(dx12),
+	window_width(window_width),
+	window_height(window_height),
+	batch(capacity),
+	capacity(capacity)
+{
+	dev = dx12->GetDevice();
+	cmdList = dx12->GetCommandList();
+
+	frameSerial = UINT64_MAX;
+	spriteCursor = 0;
+	drawCallCount = 0;
+	droppedSprites = 0;
+
+	CreateVertexBuffer();
+	CreateIndexBuffer();
+	CreateConstantBuffer();
+	SetShader();
+	SetRootSignature();
+	SetGraphicsPipeLine(SpriteBlend::Alpha);
+	SetGraphicsPipeLine(SpriteBlend::Add);
+}
+
+SpriteRenderer::~SpriteRenderer()
+{
+	for (auto texture : textures) {
+		dx12->GetTextureStreamer()->Release(texture);
+	}
+
+	verBuff->Unmap(0, nullptr);
+
+	constBuff->Release();
+	indexBuff->Release();
+	verBuff->Release();
+}
+
+uint32_t SpriteRenderer::LoadTexture(const wchar_t *fileName)
+{
+	const TextureHandle texture = dx12->GetTextureStreamer()->Load(fileName);
+	textures.push_back(texture);
+	return texture;
+}
+
+void SpriteRenderer::Begin()
+{
+	batch.Begin();
+}
+
+void SpriteRenderer::Draw(const Sprite &sprite)
+{
+	//Batch full: draw what is queued and start over (layers sort within each flush)
+	if (!batch.Draw(sprite)) {
+		Flush();
+		batch.Draw(sprite);
+	}
+}
+
+void SpriteRenderer::Flush()
+{
+	//New frame: restart at the region of this frame slot
+	const uint64_t serial = dx12->GetFramePacer()->GetSubmittedValue();
+	if (serial != frameSerial) {
+		frameSerial = serial;
+		spriteCursor = 0;
+		drawCallCount = 0;
+	}
+
+	const uint32_t count = batch.GetSpriteCount();
+	if (count == 0) {
+		return;
+	}
+
+	//Out of space for this frame: draw the sprites that fit, count the rest
+	const uint32_t room = capacity - spriteCursor;
+	if (room == 0) {
+		droppedSprites += count;
+		batch.Begin();
+		return;
+	}
+
+	PROFILE_SCOPE("SpriteRenderer::Flush");
+	GPU_PROFILE_SCOPE(dx12->GetGpuProfiler(), cmdList, "SpriteRenderer::Flush");
+
+	const uint32_t baseVertex = (dx12->GetFrameIndex() * capacity + spriteCursor) * 4;
+	const uint32_t written = batch.End(vertMap + baseVertex, room);
+	droppedSprites += count - written;
+	cmdList->Upload(sizeof(SpriteVertex) * 4 * written);
+
+	//State shared by every draw of the batch
+	cmdList->SetGraphicsRootSignature(rootsignature);
+	cmdList->SetGraphicsRootConstantBufferView(0, constBuff->GetGPUVirtualAddress());
+
+	D3D12_VERTEX_BUFFER_VIEW vbView{};
+	vbView.BufferLocation = verBuff->GetGPUVirtualAddress();
+	vbView.SizeInBytes = (UINT)verBuff->GetDesc().Width;
+	vbView.StrideInBytes = sizeof(SpriteVertex);
+
+	cmdList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	cmdList->IASetVertexBuffers(0, 1, &vbView);
+	cmdList->IASetIndexBuffer(&ibView);
+
+	uint32_t pipeline = UINT32_MAX;
+
+	for (auto &draw : batch.GetDrawCalls()) {
+		if (draw.pipeline != pipeline) {
+			pipeline = draw.pipeline;
+			cmdList->SetPipelineState(pipelinestate[pipeline]);
+		}
+
+		cmdList->SetGraphicsRootDescriptorTable(1, dx12->GetTextureStreamer()->GetGpuHandle(draw.texture));
+
+		cmdList->DrawIndexedInstanced(draw.spriteCount * 6, 1, draw.firstSprite * 6, baseVertex, 0);
+		drawCallCount++;
+	}
+
+	spriteCursor += written;
+	batch.Begin();
+}
+
+uint32_t SpriteRenderer::GetDrawCallCount() const
+{
+	return drawCallCount;
+}
+
+uint64_t SpriteRenderer::GetDroppedSpriteCount() const
+{
+	return droppedSprites;
+}
+
+void SpriteRenderer::CreateVertexBuffer()
+{
+	//One region per frame in flight
+	const UINT64 sizeVB = sizeof(SpriteVertex) * 4 * capacity * dx12->GetFrameCount();
+
+	CD3DX12_HEAP_PROPERTIES heapprop(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resdesc = CD3DX12_RESOURCE_DESC::Buffer(sizeVB);
+
+	verBuff = nullptr;
+	result = dev->CreateCommittedResource(
+		&heapprop,
+		D3D12_HEAP_FLAG_NONE,
+		&resdesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&verBuff)
+	);
+	assert(result == S_OK);
+
+	//Kept mapped for the lifetime of the renderer
+	vertMap = nullptr;
+	result = verBuff->Map(0, nullptr, (void **)&vertMap);
+	assert(result == S_OK);
+}
+
+void SpriteRenderer::CreateIndexBuffer()
+{
+	std::vector<uint16_t> indices = SpriteBatch::CreateQuadIndices(capacity);
+	const UINT sizeIB = (UINT)(sizeof(uint16_t) * indices.size());
+
+	CD3DX12_HEAP_PROPERTIES heapprop(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resdesc = CD3DX12_RESOURCE_DESC::Buffer(sizeIB);
+
+	indexBuff = nullptr;
+	result = dev->CreateCommittedResource(
+		&heapprop,
+		D3D12_HEAP_FLAG_NONE,
+		&resdesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&indexBuff)
+	);
+	assert(result == S_OK);
+
+	uint16_t *indexMap = nullptr;
+	result = indexBuff->Map(0, nullptr, (void **)&indexMap);
+	assert(result == S_OK);
+	std::copy(indices.begin(), indices.end(), indexMap);
+	indexBuff->Unmap(0, nullptr);
+
+	ibView = {};
+	ibView.BufferLocation = indexBuff->GetGPUVirtualAddress();
+	ibView.Format = DXGI_FORMAT_R16_UINT;
+	ibView.SizeInBytes = sizeIB;
+}
+
+void SpriteRenderer::CreateConstantBuffer()
+{
+	//Pixel space projection (never changes)
+	CD3DX12_HEAP_PROPERTIES heapprop(D3D12_HEAP_TYPE_UPLOAD);
+	CD3DX12_RESOURCE_DESC resdesc = CD3DX12_RESOURCE_DESC::Buffer((sizeof(DirectX::XMMATRIX) + 0xff) & ~0xff);
+
+	constBuff = nullptr;
+	result = dev->CreateCommittedResource(
+		&heapprop,
+		D3D12_HEAP_FLAG_NONE,
+		&resdesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&constBuff)
+	);
+	assert(result == S_OK);
+
+	DirectX::XMMATRIX *constMap = nullptr;
+	result = constBuff->Map(0, nullptr, (void **)&constMap);
+	assert(result == S_OK);
+	*constMap = DirectX::XMMatrixOrthographicOffCenterLH(0.0f, (float)window_width, (float)window_height, 0.0f, 0.0f, 1.0f);
+	constBuff->Unmap(0, nullptr);
+}
+
+void SpriteRenderer::SetShader()
+{
+	//Compiled once, shared through the cache
+	vsBlob = dx12->GetShaderCache()->Get(L"Shaders/SpriteVS.hlsl", "main", "vs_5_0");
+	psBlob = dx12->GetShaderCache()->Get(L"Shaders/SpritePS.hlsl", "main", "ps_5_0");
+}
+
+void SpriteRenderer::SetRootSignature()
+{
+	//[0] projection CBV, [1] texture SRV table
+	CD3DX12_DESCRIPTOR_RANGE descRangeSRV;
+	descRangeSRV.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+
+	CD3DX12_ROOT_PARAMETER rootparam[2];
+	rootparam[0].InitAsConstantBufferView(0);
+	rootparam[1].InitAsDescriptorTable(1, &descRangeSRV, D3D12_SHADER_VISIBILITY_PIXEL);
+
+	CD3DX12_STATIC_SAMPLER_DESC sampleDesc = CD3DX12_STATIC_SAMPLER_DESC(0, D3D12_FILTER_MIN_MAG_MIP_POINT);
+
+	CD3DX12_ROOT_SIGNATURE_DESC rootSignatureDesc;
+	rootSignatureDesc.Init(_countof(rootparam), rootparam, 1, &sampleDesc, D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
+
+	rootsignature = dx12->GetPipelineCache()->GetRootSignature(rootSignatureDesc);
+}
+
+void SpriteRenderer::SetGraphicsPipeLine(const SpriteBlend blend)
+{
+	//Top layout
+	D3D12_INPUT_ELEMENT_DESC inputLayout[] = {
+		{ "POSITION",	0, DXGI_FORMAT_R32G32B32_FLOAT,		0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD",	0, DXGI_FORMAT_R32G32_FLOAT,		0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "COLOR",		0, DXGI_FORMAT_R32G32B32A32_FLOAT,	0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+	};
+
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC gpipeline{};
+	gpipeline.pRootSignature = rootsignature;
+	gpipeline.VS = CD3DX12_SHADER_BYTECODE(vsBlob);
+	gpipeline.PS = CD3DX12_SHADER_BYTECODE(psBlob);
+	gpipeline.SampleMask = D3D12_DEFAULT_SAMPLE_MASK;
+	gpipeline.RasterizerState = CD3DX12_RASTERIZER_DESC(D3D12_DEFAULT);
+	gpipeline.RasterizerState.CullMode = D3D12_CULL_MODE_NONE;
+	gpipeline.BlendState = CD3DX12_BLEND_DESC(D3D12_DEFAULT);
+
+	//Layers are ordered by the batch, not by depth
+	gpipeline.DepthStencilState = CD3DX12_DEPTH_STENCIL_DESC(D3D12_DEFAULT);
+	gpipeline.DepthStencilState.DepthEnable = false;
+	gpipeline.DSVFormat = dx12->GetDepthFormat();
+
+	//Blend
+	D3D12_RENDER_TARGET_BLEND_DESC &blenddesc = gpipeline.BlendState.RenderTarget[0];
+	blenddesc.BlendEnable = true;
+	blenddesc.BlendOpAlpha = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.DestBlendAlpha = D3D12_BLEND_ONE;
+	blenddesc.BlendOp = D3D12_BLEND_OP_ADD;
+	blenddesc.SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	blenddesc.DestBlend = (blend == SpriteBlend::Add) ? D3D12_BLEND_ONE : D3D12_BLEND_INV_SRC_ALPHA;
+
+	gpipeline.InputLayout.pInputElementDescs = inputLayout;
+	gpipeline.InputLayout.NumElements = _countof(inputLayout);
+	gpipeline.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
+	gpipeline.NumRenderTargets = 1;
+	gpipeline.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
+	gpipeline.SampleDesc.Count = 1;
+
+	pipelinestate[static_cast<int>(blend)] = dx12->GetPipelineCache()->GetPipelineState(gpipeline);
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <DirectXTex.h>
+#include <d3dx12.h>
+#include "SpriteBatch.h"
+#include "TextureLoader.h"
+
+enum class SpriteBlend {
+	Alpha,
+	Add
+};
+
+class SpriteRenderer
+{
+public:
+	SpriteRenderer(DirectX12 *dx12, const int window_width, const int window_height, const uint32_t capacity = 1024);
+	~SpriteRenderer();
+
+	/// <summary>
+	/// Start streaming a texture (drawn with a placeholder until uploaded)
+	/// </summary>
+	/// <param name="fileName">Image file (WIC / tga / hdr / dds)</param>
+	/// <returns>Texture handle, used as Sprite::texture (released with the renderer)</returns>
+	uint32_t LoadTexture(const wchar_t *fileName);
+
+	void Begin();
+	void Draw(const Sprite &sprite);
+
+	/// <summary>
+	/// Write queued sprites to the vertex stream and record one draw per texture / blend
+	/// </summary>
+	void Flush();
+
+	uint32_t GetDrawCallCount() const;
+
+	//Sprites left out because the frame's vertex region was full (since creation)
+	uint64_t GetDroppedSpriteCount() const;
+
+private:
+	void CreateVertexBuffer();
+	void CreateIndexBuffer();
+	void CreateConstantBuffer();
+	void SetShader();
+	void SetRootSignature();
+	void SetGraphicsPipeLine(const SpriteBlend blend);
+
+private:
+	DirectX12 *dx12;
+	ID3D12Device *dev;
+	RenderCommandList *cmdList;
+	HRESULT result;
+
+	int window_width;
+	int window_height;
+
+	SpriteBatch batch;
+	uint32_t capacity;
+
+	//References taken by LoadTexture
+	std::vector<TextureHandle> textures;
+
+	//Per frame region cursor
+	uint64_t frameSerial;
+	uint32_t spriteCursor;
+	uint32_t drawCallCount;
+	uint64_t droppedSprites;
+
+	//Persistently mapped vertex stream (frame count * capacity quads)
+	ID3D12Resource *verBuff;
+	SpriteVertex *vertMap;
+	ID3D12Resource *indexBuff;
+	D3D12_INDEX_BUFFER_VIEW ibView;
+
+	ID3D12Resource *constBuff;
+
+	//Owned by ShaderCache / PipelineCache
+	ID3DBlob *vsBlob;
+	ID3DBlob *psBlob;
+	ID3D12RootSignature *rootsignature;
+	ID3D12PipelineState *pipelinestate[2];
+};
@@ -0,0 +1,17 @@
+//Utility
+#include "CacheKey.h"
+
+//this
+#include "StateHash.h"
+
+StateHash::StateHash() : hash(fnvOffsetBasis) {}
+
+void StateHash::Write(const void *data, const size_t size)
+{
+	hash = HashBytes(data, size, hash);
+}
+
+uint64_t StateHash::Get() const
+{
+	return hash;
+}
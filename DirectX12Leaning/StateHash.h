@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+/// <summary>
+/// FNV-1a over simulation values, written field by field so padding never counts
+/// </summary>
+class StateHash
+{
+public:
+	StateHash();
+
+	void Write(const void *data, const size_t size);
+
+	template<class T>
+	void WriteValue(const T &value)
+	{
+		Write(&value, sizeof(T));
+	}
+
+	uint64_t Get() const;
+
+private:
+	uint64_t hash;
+};
@@ -0,0 +1,211 @@
+//STL
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+//Utility
+#include "AssetArchive.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	typedef std::vector<uint8_t> Bytes;
+
+	//Working directory = build directory
+	const char *archivePath = "TestData/AssetArchiveTest.dla";
+	const char *corruptPath = "TestData/AssetArchiveCorrupt.dla";
+
+	//Index entry fields after the name
+	const size_t entryOffsetField = 0;
+	const size_t entrySizeField = 8;
+	const size_t entryMipCountField = 8 * 3 + 4 * 3;
+	const size_t mipRowCountField = entryMipCountField + 4 + 4 * 3;
+	const size_t mipOffsetField = mipRowCountField + 4;
+
+	DecodedImage MakeImage(const uint32_t width, const uint32_t height, const uint8_t seed)
+	{
+		DecodedImage image;
+		image.width = width;
+		image.height = height;
+		image.format = ImageFormat_RGBA8;
+		AppendImageMip(image, width, height);
+		for (size_t i = 0; i < image.pixels.size(); ++i) {
+			image.pixels[i] = (uint8_t)(seed + i);
+		}
+		return image;
+	}
+
+	//Two entries named "a.tga" and "b.tga"
+	Bytes WriteArchive()
+	{
+		AssetArchiveWriter writer;
+		writer.AddTexture("Textures\\A.tga", MakeImage(4, 2, 1));
+		writer.AddTexture("textures/b.tga", MakeImage(2, 2, 100));
+		writer.Save(archivePath);
+
+		std::ifstream file(archivePath, std::ios::binary);
+		return Bytes(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	uint64_t GetU64(const Bytes &data, const size_t at)
+	{
+		uint64_t value = 0;
+		for (int i = 7; i >= 0; --i) {
+			value = (value << 8) | data[at + i];
+		}
+		return value;
+	}
+
+	void PutU32(Bytes &data, const size_t at, const uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i) {
+			data[at + i] = (uint8_t)(value >> (i * 8));
+		}
+	}
+
+	void PutU64(Bytes &data, const size_t at, const uint64_t value)
+	{
+		PutU32(data, at, (uint32_t)value);
+		PutU32(data, at + 4, (uint32_t)(value >> 32));
+	}
+
+	//Start of the fields after the first entry's name
+	size_t FirstEntry(const Bytes &data)
+	{
+		const size_t indexOffset = (size_t)GetU64(data, 16);
+		return indexOffset + 4 + data[indexOffset];
+	}
+
+	bool OpenCorrupt(const Bytes &data)
+	{
+		{
+			std::ofstream file(corruptPath, std::ios::binary | std::ios::trunc);
+			file.write((const char *)data.data(), data.size());
+		}
+
+		AssetArchive archive;
+		const bool opened = archive.Open(corruptPath);
+		CHECK(opened == archive.IsOpen());
+		CHECK(opened || archive.GetCount() == 0);
+		return opened;
+	}
+}
+
+TEST_CASE(AssetArchive, RoundTrip)
+{
+	const DecodedImage a = MakeImage(4, 2, 1);
+	WriteArchive();
+
+	AssetArchive archive;
+	REQUIRE(archive.Open(archivePath));
+	REQUIRE(archive.GetCount() == 2);
+
+	//Names are canonical on both sides
+	const int index = archive.Find("TEXTURES/./a.tga");
+	REQUIRE(index >= 0);
+	CHECK(archive.GetName(index) == "textures/a.tga");
+	CHECK(archive.Find("textures/c.tga") == -1);
+	CHECK(archive.GetContentHash(index) == HashImage(a));
+	CHECK(archive.GetPayloadSize(index) == a.pixels.size());
+
+	const ImageView view = archive.GetImage(index);
+	CHECK(view.width == 4);
+	CHECK(view.height == 2);
+	CHECK(view.format == ImageFormat_RGBA8);
+	REQUIRE(view.mipCount == 1);
+	CHECK(view.mips[0].rowPitch == 16);
+	CHECK((view.pixels - archive.GetFile().GetData()) % assetArchiveAlignment == 0);
+	CHECK(std::equal(a.pixels.begin(), a.pixels.end(), view.pixels));
+
+	archive.Close();
+	CHECK(!archive.IsOpen());
+	CHECK(archive.GetCount() == 0);
+}
+
+TEST_CASE(AssetArchive, WriterRejectsDuplicates)
+{
+	AssetArchiveWriter writer;
+	CHECK(writer.AddTexture("a.tga", MakeImage(1, 1, 0)));
+	CHECK(!writer.AddTexture("./A.TGA", MakeImage(1, 1, 0)));
+	CHECK(writer.GetCount() == 1);
+}
+
+TEST_CASE(AssetArchive, RejectsHeader)
+{
+	const Bytes valid = WriteArchive();
+	REQUIRE(valid.size() > assetArchiveAlignment);
+	CHECK(OpenCorrupt(valid));
+
+	AssetArchive archive;
+	CHECK(!archive.Open("TestData/Missing.dla"));
+
+	Bytes magic = valid;
+	magic[0] ^= 0xff;
+	CHECK(!OpenCorrupt(magic));
+
+	Bytes version = valid;
+	PutU32(version, 4, assetArchiveVersion + 1);
+	CHECK(!OpenCorrupt(version));
+
+	//More entries than the index can hold
+	Bytes count = valid;
+	PutU32(count, 8, 1000);
+	CHECK(!OpenCorrupt(count));
+
+	Bytes indexOffset = valid;
+	PutU64(indexOffset, 16, valid.size() + 1);
+	CHECK(!OpenCorrupt(indexOffset));
+
+	//Index runs past the end of the file
+	Bytes indexSize = valid;
+	PutU64(indexSize, 24, GetU64(valid, 24) + 1);
+	CHECK(!OpenCorrupt(indexSize));
+
+	Bytes truncated = valid;
+	truncated.resize(truncated.size() - 1);
+	CHECK(!OpenCorrupt(truncated));
+	truncated.resize(20);
+	CHECK(!OpenCorrupt(truncated));
+}
+
+TEST_CASE(AssetArchive, RejectsEntry)
+{
+	const Bytes valid = WriteArchive();
+	const size_t entry = FirstEntry(valid);
+
+	//Payload outside the file
+	Bytes offset = valid;
+	PutU64(offset, entry + entryOffsetField, valid.size() + 1);
+	CHECK(!OpenCorrupt(offset));
+
+	Bytes size = valid;
+	PutU64(size, entry + entrySizeField, valid.size());
+	CHECK(!OpenCorrupt(size));
+
+	Bytes noMips = valid;
+	PutU32(noMips, entry + entryMipCountField, 0);
+	CHECK(!OpenCorrupt(noMips));
+
+	Bytes tooManyMips = valid;
+	PutU32(tooManyMips, entry + entryMipCountField, 17);
+	CHECK(!OpenCorrupt(tooManyMips));
+
+	//Mip rows outside the payload / not matching the level
+	Bytes rowCount = valid;
+	PutU32(rowCount, entry + mipRowCountField, 3);
+	CHECK(!OpenCorrupt(rowCount));
+
+	Bytes mipOffset = valid;
+	PutU64(mipOffset, entry + mipOffsetField, 1);
+	CHECK(!OpenCorrupt(mipOffset));
+
+	//"textures/b.tga" -> "textures/a.tga"
+	Bytes duplicate = valid;
+	const size_t second = entry + mipOffsetField + 8;
+	REQUIRE(duplicate[second + 4 + 9] == 'b');
+	duplicate[second + 4 + 9] = 'a';
+	CHECK(!OpenCorrupt(duplicate));
+}
@@ -0,0 +1,121 @@
+//STL
+#include <cmath>
+
+//Utility
+#include "BulletPool.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	bool Near(const float a, const float b)
+	{
+		return std::fabs(a - b) < 1e-4f;
+	}
+}
+
+TEST_CASE(BulletPool, CapacityExhaustion)
+{
+	BulletPool pool(4, 10.0f, 0.5f);
+	const Position3D muzzle;
+
+	//Volley larger than the pool: what fits is fired, the rest counted
+	CHECK(pool.FireVolley(muzzle, 6, 30.0f) == 4);
+	CHECK(pool.GetCount() == 4);
+	CHECK(pool.GetDroppedCount() == 2);
+
+	CHECK(pool.Fire(muzzle, 0) == invalidEntityHandle);
+	CHECK(pool.GetDroppedCount() == 3);
+	CHECK(pool.GetCapacity() == 4);
+}
+
+TEST_CASE(BulletPool, SlotReuse)
+{
+	BulletPool pool(2, 10.0f, 0.5f);
+	const Position3D muzzle;
+
+	const EntityHandle first = pool.Fire(muzzle, 0);
+	const EntityHandle second = pool.Fire(muzzle, 90.0f);
+	REQUIRE(first != invalidEntityHandle);
+	REQUIRE(second != invalidEntityHandle);
+
+	//Expired slot takes the next shot, the old handle goes stale
+	pool.ExpireAt(pool.GetBullets().Find(first));
+	const EntityHandle third = pool.Fire(muzzle, 0);
+	REQUIRE(third != invalidEntityHandle);
+	CHECK(third != first);
+	CHECK(!pool.GetBullets().IsAlive(first));
+	CHECK(pool.GetBullets().IsAlive(second));
+	CHECK(pool.GetDroppedCount() == 0);
+
+	//Clear frees every slot
+	pool.Clear();
+	CHECK(pool.GetCount() == 0);
+	CHECK(pool.FireVolley(muzzle, 2, 0) == 2);
+	CHECK(pool.GetDroppedCount() == 0);
+}
+
+TEST_CASE(BulletPool, ExpireOutsideField)
+{
+	BulletPool pool(8, 100.0f, 0.5f);
+	const Position3D muzzle;
+	pool.Fire(muzzle, 0);
+	pool.Fire(muzzle, 180.0f);
+
+	//+x passes the right edge (60) at 70, -x is still inside the left one (-80)
+	pool.Update(SimInput(), muzzle, 0.35f);
+	CHECK(pool.GetCount() == 2);
+	pool.Update(SimInput(), muzzle, 0.35f);
+	REQUIRE(pool.GetCount() == 1);
+	CHECK(Near(pool.GetBullets().GetX()[0], -70.0f));
+
+	//Freed slot is fired again
+	CHECK(pool.FireVolley(muzzle, 7, 10.0f) == 7);
+	CHECK(pool.GetDroppedCount() == 0);
+}
+
+TEST_CASE(BulletPool, VolleySpread)
+{
+	BulletPool pool(8, 10.0f, 0.5f);
+	REQUIRE(pool.FireVolley(Position3D(), 3, 90.0f) == 3);
+
+	//-45, 0, +45 degrees
+	const float diagonal = 10.0f * std::sqrt(0.5f);
+	const float *vx = pool.GetBullets().GetVelocityX();
+	const float *vy = pool.GetBullets().GetVelocityY();
+	CHECK(Near(vx[0], diagonal));
+	CHECK(Near(vy[0], -diagonal));
+	CHECK(Near(vx[1], 10.0f));
+	CHECK(Near(vy[1], 0));
+	CHECK(Near(vy[2], diagonal));
+}
+
+TEST_CASE(BulletPool, BurstPattern)
+{
+	BulletPool pool(16, 10.0f, 0.5f);
+	BulletPattern pattern;
+	pattern.shots = 2;
+	pattern.volleys = 3;
+	pattern.volleyInterval = 0.1f;
+	pool.SetPattern(pattern);
+
+	SimInput press;
+	press.held = SimButton_Fire;
+	press.pressed = SimButton_Fire;
+	SimInput hold;
+	hold.held = SimButton_Fire;
+
+	//One volley per interval until the burst is spent, holding does not restart it
+	pool.Update(press, Position3D(), 0.1f);
+	CHECK(pool.GetCount() == 2);
+	pool.Update(hold, Position3D(), 0.1f);
+	pool.Update(hold, Position3D(), 0.1f);
+	CHECK(pool.GetCount() == 6);
+	pool.Update(hold, Position3D(), 0.1f);
+	CHECK(pool.GetCount() == 6);
+
+	//New press, new burst
+	pool.Update(press, Position3D(), 0.1f);
+	CHECK(pool.GetCount() == 8);
+}
@@ -0,0 +1,32 @@
+# Cooks Tests/Data/Cooker with TextureCooker, twice:
+# the first run cooks every entry, the second finds them up to date.
+# The cooked DDS files then go through the runtime codec via AssetPack.
+# cmake -DCOOKER=... -DASSET_PACK=... -DFIXTURES=... -DWORK_DIR=... -P CookFixtures.cmake
+
+file(REMOVE_RECURSE ${WORK_DIR})
+file(COPY ${FIXTURES}/ DESTINATION ${WORK_DIR})
+
+function(run_cooker expected)
+	execute_process(
+		COMMAND ${COOKER} ${WORK_DIR}/fixtures.manifest --quick
+		RESULT_VARIABLE result
+		OUTPUT_VARIABLE output
+	)
+	message("${output}")
+	if(NOT result EQUAL 0 OR NOT output MATCHES "${expected}")
+		message(FATAL_ERROR "TextureCooker: expected \"${expected}\"")
+	endif()
+endfunction()
+
+run_cooker("cooked 2, up to date 0, failed 0")
+run_cooker("cooked 0, up to date 2, failed 0")
+
+execute_process(
+	COMMAND ${ASSET_PACK} pack ${WORK_DIR}/cooked.dla ${WORK_DIR}/Checker.cooked.dds ${WORK_DIR}/Ramp.cooked.dds
+	RESULT_VARIABLE result
+	OUTPUT_VARIABLE output
+)
+message("${output}")
+if(NOT result EQUAL 0)
+	message(FATAL_ERROR "AssetPack could not read the cooked textures")
+endif()
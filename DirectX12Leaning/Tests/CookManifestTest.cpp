@@ -0,0 +1,150 @@
+//STL
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//Utility
+#include "CookManifest.h"
+#include "ImageCodec.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Working directory = build directory
+	const std::string databasePath = "TestData/CookManifestTest.cooked";
+	const std::string outputPath = "TestData/CookManifestTest.dds";
+
+	void WriteText(const std::string &path, const std::string &text)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file << text;
+	}
+}
+
+TEST_CASE(CookManifest, Parse)
+{
+	std::vector<CookEntry> entries;
+	std::string error;
+	REQUIRE(ParseCookManifest(
+		"# input output kind\n"
+		"\n"
+		"AI.png      AI.dds      color   # trailing comment\n"
+		"sub/n.tga   sub/n.dds   normal\n"
+		"/abs/m.tga  C:/out/m.dds  mask\n", "Resources", entries, error));
+	REQUIRE(entries.size() == 3);
+
+	//Relative paths join the manifest directory, absolute ones stay
+	CHECK(entries[0].input == "Resources/AI.png");
+	CHECK(entries[0].output == "Resources/AI.dds");
+	CHECK(entries[0].kind == CookKind::Color);
+	CHECK(entries[1].input == "Resources/sub/n.tga");
+	CHECK(entries[1].kind == CookKind::Normal);
+	CHECK(entries[2].input == "/abs/m.tga");
+	CHECK(entries[2].output == "C:/out/m.dds");
+	CHECK(entries[2].kind == CookKind::Mask);
+
+	entries.clear();
+	REQUIRE(ParseCookManifest("a.tga a.dds color\n", "dir\\", entries, error));
+	CHECK(entries[0].input == "dir\\a.tga");
+	entries.clear();
+	REQUIRE(ParseCookManifest("a.tga a.dds color\n", "", entries, error));
+	CHECK(entries[0].input == "a.tga");
+}
+
+TEST_CASE(CookManifest, ParseErrors)
+{
+	std::vector<CookEntry> entries;
+	std::string error;
+
+	CHECK(!ParseCookManifest("a.tga a.dds color\nb.tga b.dds\n", "", entries, error));
+	CHECK(error.compare(0, 7, "line 2:") == 0);
+	CHECK(entries.size() == 1);
+
+	CHECK(!ParseCookManifest("# header\na.tga a.dds color extra\n", "", entries, error));
+	CHECK(error.compare(0, 7, "line 2:") == 0);
+
+	CHECK(!ParseCookManifest("a.tga a.dds albedo\n", "", entries, error));
+	CHECK(error.find("albedo") != std::string::npos);
+}
+
+TEST_CASE(CookManifest, Kinds)
+{
+	const CookKind kinds[] = { CookKind::Color, CookKind::Mask, CookKind::Normal };
+	for (auto kind : kinds) {
+		CookKind parsed;
+		REQUIRE(ParseCookKind(GetCookKindName(kind), parsed));
+		CHECK(parsed == kind);
+	}
+
+	CookKind kind;
+	CHECK(!ParseCookKind("Color", kind));
+	CHECK(GetCookFormat(CookKind::Color) == ImageFormat_BC7);
+	CHECK(GetCookFormat(CookKind::Mask) == ImageFormat_BC4);
+	CHECK(GetCookFormat(CookKind::Normal) == ImageFormat_BC5);
+}
+
+TEST_CASE(CookManifest, HashAndPaths)
+{
+	const std::vector<uint8_t> input = { 1, 2, 3 };
+	std::vector<uint8_t> changed = input;
+	changed[2] = 4;
+
+	CHECK(CookHash(input, CookKind::Color) == CookHash(input, CookKind::Color));
+	CHECK(CookHash(input, CookKind::Color) != CookHash(changed, CookKind::Color));
+	CHECK(CookHash(input, CookKind::Color) != CookHash(input, CookKind::Normal));
+
+	CHECK(CookedTexturePath("Resources/AI.png") == "Resources/AI.dds");
+	CHECK(CookedTexturePath("a.b/c") == "a.b/c.dds");
+	CHECK(CookedTexturePath("a.b\\c.tga") == "a.b\\c.dds");
+	CHECK(CookedTexturePath("noext") == "noext.dds");
+}
+
+TEST_CASE(CookManifest, Database)
+{
+	remove(databasePath.c_str());
+
+	//Missing file: empty, not an error
+	CookDatabase database;
+	CHECK(database.Load(databasePath));
+	CHECK(database.GetSize() == 0);
+
+	database.Set("out/a b.dds", 0x0123456789abcdefull);
+	database.Set("out/c.dds", 1);
+	database.Set("out/c.dds", 2);
+	REQUIRE(database.Save(databasePath));
+
+	CookDatabase loaded;
+	REQUIRE(loaded.Load(databasePath));
+	CHECK(loaded.GetSize() == 2);
+	CHECK(loaded.IsUpToDate("out/a b.dds", 0x0123456789abcdefull));
+	CHECK(loaded.IsUpToDate("out/c.dds", 2));
+	CHECK(!loaded.IsUpToDate("out/c.dds", 1));
+	CHECK(!loaded.IsUpToDate("out/d.dds", 2));
+
+	//Hash without an output
+	WriteText(databasePath, "0000000000000001 a.dds\n0000000000000002\n");
+	CHECK(!loaded.Load(databasePath));
+}
+
+TEST_CASE(CookManifest, SkipUnchangedInput)
+{
+	const std::vector<uint8_t> input = { 9, 8, 7 };
+	const uint64_t hash = CookHash(input, CookKind::Color);
+	remove(outputPath.c_str());
+
+	CookDatabase database;
+	CHECK(database.NeedsCook(outputPath, hash));
+
+	//Cooked and written: skipped until the input changes or the output goes away
+	database.Set(outputPath, hash);
+	CHECK(database.NeedsCook(outputPath, hash));
+	WriteText(outputPath, "DDS ");
+	CHECK(!database.NeedsCook(outputPath, hash));
+	CHECK(database.NeedsCook(outputPath, CookHash(input, CookKind::Mask)));
+
+	remove(outputPath.c_str());
+	CHECK(database.NeedsCook(outputPath, hash));
+}
@@ -0,0 +1,113 @@
+//Utility
+#include "DescriptorAllocator.h"
+
+//this
+#include "UnitTest.h"
+
+TEST_CASE(DescriptorAllocator, LowestSlotFirst)
+{
+	DescriptorAllocator allocator(4, 0);
+
+	CHECK(allocator.Allocate() == 0);
+	CHECK(allocator.Allocate() == 1);
+	CHECK(allocator.Allocate() == 2);
+	CHECK(allocator.Allocate() == 3);
+	CHECK(allocator.Allocate() == DescriptorAllocator::invalidIndex);
+	CHECK(allocator.GetAllocatedCount() == 4);
+}
+
+TEST_CASE(DescriptorAllocator, DeferredFree)
+{
+	DescriptorAllocator allocator(2, 0);
+	const uint32_t a = allocator.Allocate();
+	allocator.Allocate();
+
+	allocator.Free(a);
+	CHECK(!allocator.IsAllocated(a));
+	CHECK(allocator.GetAllocatedCount() == 1);
+
+	//Freed this frame: the GPU may still read it
+	CHECK(allocator.Allocate() == DescriptorAllocator::invalidIndex);
+
+	allocator.EndFrame(5);
+	allocator.Retire(4);
+	CHECK(allocator.Allocate() == DescriptorAllocator::invalidIndex);
+
+	allocator.Retire(5);
+	CHECK(allocator.Allocate() == a);
+	CHECK(allocator.IsAllocated(a));
+}
+
+TEST_CASE(DescriptorAllocator, FreeListReuseKeepsLowestFirst)
+{
+	DescriptorAllocator allocator(8, 0);
+	for (int i = 0; i < 8; ++i) {
+		allocator.Allocate();
+	}
+
+	//Freed over two frames, out of order
+	allocator.Free(6);
+	allocator.Free(2);
+	allocator.EndFrame(1);
+	allocator.Free(4);
+	allocator.EndFrame(2);
+
+	allocator.Retire(2);
+	CHECK(allocator.Allocate() == 2);
+	CHECK(allocator.Allocate() == 4);
+	CHECK(allocator.Allocate() == 6);
+	CHECK(allocator.Allocate() == DescriptorAllocator::invalidIndex);
+}
+
+TEST_CASE(DescriptorAllocator, FreeInvalidIgnored)
+{
+	DescriptorAllocator allocator(1, 0);
+	allocator.Free(DescriptorAllocator::invalidIndex);
+	CHECK(allocator.GetAllocatedCount() == 0);
+	CHECK(allocator.Allocate() == 0);
+}
+
+TEST_CASE(DescriptorAllocator, TransientAfterPersistent)
+{
+	DescriptorAllocator allocator(4, 8);
+	CHECK(allocator.GetCapacity() == 12);
+
+	//Ring slots follow the persistent range
+	CHECK(allocator.AllocateTransient(3) == 4);
+	CHECK(allocator.AllocateTransient(2) == 7);
+	CHECK(allocator.AllocateTransient(0) == DescriptorAllocator::invalidIndex);
+
+	//Never counted as persistent
+	CHECK(allocator.GetAllocatedCount() == 0);
+	CHECK(!allocator.IsAllocated(4));
+}
+
+TEST_CASE(DescriptorAllocator, TransientWrap)
+{
+	DescriptorAllocator allocator(4, 8);
+
+	REQUIRE(allocator.AllocateTransient(6) == 4);
+	allocator.EndFrame(1);
+
+	//Frame 1 in flight: 2 slots left before the end, 3 do not fit
+	CHECK(allocator.AllocateTransient(3) == DescriptorAllocator::invalidIndex);
+	CHECK(allocator.AllocateTransient(2) == 10);
+	allocator.EndFrame(2);
+
+	//Frame 1 retired: a table never splits over the end, it starts at the ring start again
+	allocator.Retire(1);
+	CHECK(allocator.AllocateTransient(4) == 4);
+	CHECK(allocator.AllocateTransient(4) == DescriptorAllocator::invalidIndex);
+	allocator.EndFrame(3);
+
+	//Everything retired: the ring continues where frame 3 stopped
+	allocator.Retire(3);
+	CHECK(allocator.AllocateTransient(4) == 8);
+	CHECK(allocator.AllocateTransient(4) == 4);
+}
+
+TEST_CASE(DescriptorAllocator, NoTransientRing)
+{
+	DescriptorAllocator allocator(4, 0);
+	CHECK(allocator.AllocateTransient(1) == DescriptorAllocator::invalidIndex);
+}
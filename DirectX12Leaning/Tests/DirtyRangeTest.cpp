@@ -0,0 +1,84 @@
+//Utility
+#include "DirtyRange.h"
+
+//this
+#include "UnitTest.h"
+
+TEST_CASE(DirtyRange, CleanAtStart)
+{
+	DirtyRange range;
+	CHECK(!range.IsDirty());
+	CHECK(range.GetSize() == 0);
+	CHECK(range.GetUploadCount() == 0);
+}
+
+TEST_CASE(DirtyRange, SingleMark)
+{
+	DirtyRange range;
+	range.Mark(64, 32);
+
+	CHECK(range.IsDirty());
+	CHECK(range.GetOffset() == 64);
+	CHECK(range.GetSize() == 32);
+}
+
+TEST_CASE(DirtyRange, EmptyMarkIgnored)
+{
+	DirtyRange range;
+	range.Mark(100, 0);
+	CHECK(!range.IsDirty());
+
+	range.Mark(16, 16);
+	range.Mark(1000, 0);
+	CHECK(range.GetOffset() == 16);
+	CHECK(range.GetSize() == 16);
+}
+
+TEST_CASE(DirtyRange, MergeOverlapping)
+{
+	DirtyRange range;
+	range.Mark(100, 50);
+	range.Mark(120, 60);
+
+	CHECK(range.GetOffset() == 100);
+	CHECK(range.GetSize() == 80);
+
+	//Contained: no change
+	range.Mark(110, 10);
+	CHECK(range.GetOffset() == 100);
+	CHECK(range.GetSize() == 80);
+}
+
+TEST_CASE(DirtyRange, MergeDisjointCoversGap)
+{
+	DirtyRange range;
+	range.Mark(200, 10);
+	range.Mark(0, 10);
+
+	//One range: the gap is uploaded too
+	CHECK(range.GetOffset() == 0);
+	CHECK(range.GetSize() == 210);
+}
+
+TEST_CASE(DirtyRange, ClearCountsUploads)
+{
+	DirtyRange range;
+
+	//Clean clear is not an upload
+	range.Clear();
+	CHECK(range.GetUploadCount() == 0);
+
+	range.Mark(8, 8);
+	range.Clear();
+	CHECK(!range.IsDirty());
+	CHECK(range.GetSize() == 0);
+	CHECK(range.GetUploadCount() == 1);
+
+	//Starts fresh, not merged with the cleared range
+	range.Mark(64, 4);
+	CHECK(range.GetOffset() == 64);
+	CHECK(range.GetSize() == 4);
+	range.Clear();
+	range.Clear();
+	CHECK(range.GetUploadCount() == 2);
+}
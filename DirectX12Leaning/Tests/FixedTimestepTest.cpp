@@ -0,0 +1,137 @@
+//Utility
+#include "FixedTimestep.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Stands in for the frame clock: hands out exact frame times in nanoseconds
+	class FakeClock
+	{
+	public:
+		FakeClock() : now(0), last(0)
+		{
+		}
+
+		void AdvanceMilliseconds(const int64_t milliseconds)
+		{
+			now += milliseconds * 1000000;
+		}
+
+		//Seconds since the previous call, as the game loop computes them
+		double Elapsed()
+		{
+			const double elapsed = (now - last) / 1e9;
+			last = now;
+			return elapsed;
+		}
+
+		int64_t Now() const
+		{
+			return now;
+		}
+
+	private:
+		int64_t now;
+		int64_t last;
+	};
+}
+
+TEST_CASE(FixedTimestep, TicksPerFrame)
+{
+	//10 ms ticks
+	FixedTimestep timestep(100.0, 8);
+	FakeClock clock;
+
+	clock.AdvanceMilliseconds(10);
+	CHECK(timestep.Advance(clock.Elapsed()) == 1);
+
+	clock.AdvanceMilliseconds(30);
+	CHECK(timestep.Advance(clock.Elapsed()) == 3);
+
+	//Shorter than a tick: nothing to run yet
+	clock.AdvanceMilliseconds(4);
+	CHECK(timestep.Advance(clock.Elapsed()) == 0);
+
+	CHECK(timestep.GetTickCount() == 4);
+	CHECK(timestep.GetDroppedTicks() == 0);
+}
+
+TEST_CASE(FixedTimestep, RemainderCarriesOver)
+{
+	FixedTimestep timestep(100.0, 8);
+	FakeClock clock;
+
+	//25 ms: 2 ticks, 5 ms left
+	clock.AdvanceMilliseconds(25);
+	CHECK(timestep.Advance(clock.Elapsed()) == 2);
+	CHECK(timestep.GetAlpha() == 0.5f);
+
+	//5 + 7 ms: one tick, 2 ms left
+	clock.AdvanceMilliseconds(7);
+	CHECK(timestep.Advance(clock.Elapsed()) == 1);
+	CHECK(timestep.GetAlpha() > 0.199f && timestep.GetAlpha() < 0.201f);
+
+	//Three 6 ms frames = 2 + 18 ms: one tick after the second frame, one after the third
+	int ticks = 0;
+	for (int i = 0; i < 3; ++i) {
+		clock.AdvanceMilliseconds(6);
+		ticks += timestep.Advance(clock.Elapsed());
+	}
+	CHECK(ticks == 2);
+	CHECK(timestep.GetTickCount() == 5);
+}
+
+TEST_CASE(FixedTimestep, ClampDropsExcessTime)
+{
+	FixedTimestep timestep(100.0, 4);
+	FakeClock clock;
+
+	//1 s hitch = 100 ticks, only 4 run
+	clock.AdvanceMilliseconds(1003);
+	CHECK(timestep.Advance(clock.Elapsed()) == 4);
+	CHECK(timestep.GetDroppedTicks() == 96);
+	CHECK(timestep.GetTickCount() == 4);
+
+	//Dropped time is gone, only the 3 ms remainder is kept
+	CHECK(timestep.GetAlpha() > 0.299f && timestep.GetAlpha() < 0.301f);
+	clock.AdvanceMilliseconds(7);
+	CHECK(timestep.Advance(clock.Elapsed()) == 1);
+	CHECK(timestep.GetDroppedTicks() == 96);
+}
+
+TEST_CASE(FixedTimestep, NegativeElapsedIgnored)
+{
+	FixedTimestep timestep(100.0, 8);
+
+	CHECK(timestep.Advance(0.015) == 1);
+	CHECK(timestep.Advance(-1.0) == 0);
+	CHECK(timestep.GetAlpha() == 0.5f);
+}
+
+TEST_CASE(FixedTimestep, TickEndTime)
+{
+	FixedTimestep timestep(100.0, 8);
+	FakeClock clock;
+
+	//3 ticks and 5 ms left: ticks end 25, 15 and 5 ms before now
+	clock.AdvanceMilliseconds(35);
+	const int count = timestep.Advance(clock.Elapsed());
+	REQUIRE(count == 3);
+	CHECK(timestep.GetTickEndTime(clock.Now(), 2, count) == clock.Now() - 5000000);
+	CHECK(timestep.GetTickEndTime(clock.Now(), 0, count) == clock.Now() - 25000000);
+}
+
+TEST_CASE(FixedTimestep, Reset)
+{
+	FixedTimestep timestep(100.0, 2);
+
+	timestep.Advance(0.055);
+	timestep.Reset();
+
+	CHECK(timestep.GetTickCount() == 0);
+	CHECK(timestep.GetDroppedTicks() == 0);
+	CHECK(timestep.GetAlpha() == 0.0f);
+	CHECK(timestep.Advance(0.005) == 0);
+}
@@ -0,0 +1,130 @@
+//STL
+#include <vector>
+
+//Utility
+#include "FramePacer.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	struct PacingResult
+	{
+		uint64_t waits;				//BeginFrame calls that blocked on the fence
+		uint64_t allocatorReuses;	//BeginFrame calls handing out a slot used before
+		bool reusedInFlight;		//A slot came back while the GPU still used it
+	};
+
+	//frames frames on a pacer of depth latency, the GPU gpuFrameDelay frames behind
+	PacingResult RunFrames(const int latency, const uint64_t gpuFrameDelay, const int frames)
+	{
+		NullFrameFence fence(gpuFrameDelay);
+		FramePacer pacer(&fence, latency);
+
+		//Fence value of the last frame recorded with each slot's allocator (0 = unused)
+		std::vector<uint64_t> slotValues(latency, 0);
+
+		PacingResult result = {};
+		int slot = pacer.GetFrameIndex();
+		for (int i = 0; i < frames; ++i) {
+			slotValues[slot] = pacer.EndFrame();
+
+			slot = pacer.BeginFrame();
+			if (slotValues[slot] != 0) {
+				result.allocatorReuses++;
+				if (fence.GetCompletedValue() < slotValues[slot]) {
+					result.reusedInFlight = true;
+				}
+			}
+		}
+
+		result.waits = pacer.GetWaitCount();
+		if (fence.GetWaitCount() != result.waits) {
+			result.reusedInFlight = true;
+		}
+		return result;
+	}
+
+	const int frameCount = 100;
+}
+
+TEST_CASE(FramePacer, NullFenceDelay)
+{
+	NullFrameFence fence(2);
+	fence.Signal(1);
+	fence.Signal(2);
+	CHECK(fence.GetCompletedValue() == 0);
+	fence.Signal(3);
+	CHECK(fence.GetCompletedValue() == 1);
+
+	fence.WaitForValue(3);
+	CHECK(fence.GetCompletedValue() == 3);
+	CHECK(fence.GetWaitCount() == 1);
+
+	//Never goes back
+	fence.Signal(4);
+	CHECK(fence.GetCompletedValue() == 3);
+}
+
+TEST_CASE(FramePacer, GpuKeepsUp)
+{
+	for (int latency = 1; latency <= 3; ++latency) {
+		const PacingResult result = RunFrames(latency, 0, frameCount);
+		CHECK(result.waits == 0);
+		CHECK(result.allocatorReuses == (uint64_t)(frameCount - latency + 1));
+		CHECK(!result.reusedInFlight);
+	}
+}
+
+//GPU two frames behind: latency 1 and 2 stall, 3 frames in flight hide the delay
+TEST_CASE(FramePacer, Latency1)
+{
+	const PacingResult result = RunFrames(1, 2, frameCount);
+	CHECK(result.waits == frameCount);
+	CHECK(result.allocatorReuses == frameCount);
+	CHECK(!result.reusedInFlight);
+}
+
+TEST_CASE(FramePacer, Latency2)
+{
+	const PacingResult result = RunFrames(2, 2, frameCount);
+	CHECK(result.waits == frameCount - 1);
+	CHECK(result.allocatorReuses == frameCount - 1);
+	CHECK(!result.reusedInFlight);
+}
+
+TEST_CASE(FramePacer, Latency3)
+{
+	const PacingResult result = RunFrames(3, 2, frameCount);
+	CHECK(result.waits == 0);
+	CHECK(result.allocatorReuses == frameCount - 2);
+	CHECK(!result.reusedInFlight);
+}
+
+TEST_CASE(FramePacer, SlotsCycle)
+{
+	NullFrameFence fence(0);
+	FramePacer pacer(&fence, 3);
+	CHECK(pacer.GetFrameCount() == 3);
+
+	const int expected[] = { 1, 2, 0, 1, 2, 0 };
+	for (int i = 0; i < 6; ++i) {
+		pacer.EndFrame();
+		CHECK(pacer.BeginFrame() == expected[i]);
+	}
+	CHECK(pacer.GetSubmittedValue() == 6);
+}
+
+TEST_CASE(FramePacer, WaitIdle)
+{
+	NullFrameFence fence(5);
+	FramePacer pacer(&fence, 3);
+	pacer.EndFrame();
+	pacer.BeginFrame();
+	pacer.EndFrame();
+
+	pacer.WaitIdle();
+	CHECK(pacer.GetCompletedValue() == 2);
+	CHECK(fence.GetCompletedValue() == 2);
+}
@@ -0,0 +1,301 @@
+//STL
+#include <cstring>
+#include <vector>
+
+//Utility
+#include "ImageCodec.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	typedef std::vector<uint8_t> Bytes;
+
+	void PutU16(Bytes &data, const size_t at, const uint32_t value)
+	{
+		data[at] = (uint8_t)value;
+		data[at + 1] = (uint8_t)(value >> 8);
+	}
+
+	void PutU32(Bytes &data, const size_t at, const uint32_t value)
+	{
+		for (int i = 0; i < 4; ++i) {
+			data[at + i] = (uint8_t)(value >> (i * 8));
+		}
+	}
+
+	void Append(Bytes &data, const char *text)
+	{
+		data.insert(data.end(), text, text + strlen(text));
+	}
+
+	Bytes TGAHeader(const uint8_t imageType, const uint32_t width, const uint32_t height, const uint8_t depth, const uint8_t descriptor)
+	{
+		Bytes data(18, 0);
+		data[2] = imageType;
+		PutU16(data, 12, width);
+		PutU16(data, 14, height);
+		data[16] = depth;
+		data[17] = descriptor;
+		return data;
+	}
+
+	//128 byte header, pixel format fields filled by the caller
+	Bytes DDSHeader(const uint32_t width, const uint32_t height, const uint32_t mipCount)
+	{
+		Bytes data(128, 0);
+		PutU32(data, 0, 0x20534444);	//"DDS "
+		PutU32(data, 4, 124);
+		PutU32(data, 12, height);
+		PutU32(data, 16, width);
+		PutU32(data, 28, mipCount);
+		PutU32(data, 76, 32);
+		return data;
+	}
+
+	const uint8_t *Texel(const DecodedImage &image, const uint32_t x, const uint32_t y)
+	{
+		const ImageMip &mip = image.mips[0];
+		return image.pixels.data() + mip.offset + (size_t)y * mip.rowPitch + (size_t)x * ImageElementSize(image.format);
+	}
+}
+
+TEST_CASE(ImageCodec, TGARawBottomUp)
+{
+	//2x2 BGR, default origin is bottom left
+	Bytes data = TGAHeader(2, 2, 2, 24, 0);
+	const uint8_t pixels[] = {
+		0, 0, 255,		0, 255, 0,		//Bottom row: red, green
+		255, 0, 0,		255, 255, 255,	//Top row: blue, white
+	};
+	data.insert(data.end(), pixels, pixels + sizeof(pixels));
+
+	DecodedImage image;
+	REQUIRE(DecodeTGA(data.data(), data.size(), image));
+	CHECK(image.width == 2);
+	CHECK(image.height == 2);
+	CHECK(image.format == ImageFormat_RGBA8);
+	REQUIRE(image.mips.size() == 1);
+
+	const uint8_t topLeft[] = { 0, 0, 255, 255 };
+	const uint8_t bottomLeft[] = { 255, 0, 0, 255 };
+	const uint8_t bottomRight[] = { 0, 255, 0, 255 };
+	CHECK(memcmp(Texel(image, 0, 0), topLeft, 4) == 0);
+	CHECK(memcmp(Texel(image, 0, 1), bottomLeft, 4) == 0);
+	CHECK(memcmp(Texel(image, 1, 1), bottomRight, 4) == 0);
+}
+
+TEST_CASE(ImageCodec, TGARleTopDownAlpha)
+{
+	//3x1 BGRA, top left origin: run of 2 + 1 literal
+	Bytes data = TGAHeader(10, 3, 1, 32, 0x20);
+	const uint8_t packets[] = {
+		0x81, 10, 20, 30, 40,
+		0x00, 50, 60, 70, 80,
+	};
+	data.insert(data.end(), packets, packets + sizeof(packets));
+
+	DecodedImage image;
+	REQUIRE(DecodeTGA(data.data(), data.size(), image));
+
+	const uint8_t run[] = { 30, 20, 10, 40 };
+	const uint8_t literal[] = { 70, 60, 50, 80 };
+	CHECK(memcmp(Texel(image, 0, 0), run, 4) == 0);
+	CHECK(memcmp(Texel(image, 1, 0), run, 4) == 0);
+	CHECK(memcmp(Texel(image, 2, 0), literal, 4) == 0);
+}
+
+TEST_CASE(ImageCodec, TGAGray)
+{
+	Bytes data = TGAHeader(3, 1, 1, 8, 0);
+	data.push_back(77);
+
+	DecodedImage image;
+	REQUIRE(DecodeTGA(data.data(), data.size(), image));
+	const uint8_t expected[] = { 77, 77, 77, 255 };
+	CHECK(memcmp(Texel(image, 0, 0), expected, 4) == 0);
+}
+
+TEST_CASE(ImageCodec, TGARejectsMalformed)
+{
+	DecodedImage image;
+
+	//Truncated pixels
+	Bytes truncated = TGAHeader(2, 2, 2, 24, 0);
+	truncated.resize(truncated.size() + 11);
+	CHECK(!DecodeTGA(truncated.data(), truncated.size(), image));
+
+	//RLE run longer than the image
+	Bytes overrun = TGAHeader(10, 2, 1, 24, 0);
+	const uint8_t packet[] = { 0x83, 1, 2, 3 };
+	overrun.insert(overrun.end(), packet, packet + sizeof(packet));
+	CHECK(!DecodeTGA(overrun.data(), overrun.size(), image));
+
+	//Color mapped, 16 bit, empty
+	Bytes mapped = TGAHeader(1, 1, 1, 8, 0);
+	mapped.push_back(0);
+	CHECK(!DecodeTGA(mapped.data(), mapped.size(), image));
+	Bytes depth16 = TGAHeader(2, 1, 1, 16, 0);
+	depth16.resize(depth16.size() + 2);
+	CHECK(!DecodeTGA(depth16.data(), depth16.size(), image));
+	Bytes empty = TGAHeader(2, 0, 1, 24, 0);
+	CHECK(!DecodeTGA(empty.data(), empty.size(), image));
+
+	CHECK(!DecodeTGA(truncated.data(), 10, image));
+}
+
+TEST_CASE(ImageCodec, HDRFlat)
+{
+	Bytes data;
+	Append(data, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y 1 +X 2\n");
+
+	//mantissa * 2^(exponent - 136): 128 * 2^-7 = 1.0, 128 * 2^-6 = 2.0
+	const uint8_t texels[] = { 128, 64, 0, 129,		128, 128, 128, 130 };
+	data.insert(data.end(), texels, texels + sizeof(texels));
+
+	DecodedImage image;
+	REQUIRE(DecodeHDR(data.data(), data.size(), image));
+	CHECK(image.format == ImageFormat_RGBA32F);
+
+	const float *p = reinterpret_cast<const float *>(Texel(image, 0, 0));
+	CHECK(p[0] == 1.0f);
+	CHECK(p[1] == 0.5f);
+	CHECK(p[2] == 0.0f);
+	CHECK(p[3] == 1.0f);
+	CHECK(p[4] == 2.0f);
+	CHECK(p[6] == 2.0f);
+}
+
+TEST_CASE(ImageCodec, HDRRunLength)
+{
+	const uint32_t width = 8;
+	Bytes data;
+	Append(data, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y 1 +X 8\n");
+
+	//New style scanline: R, G, B as runs of 8, E as 8 literals of 128 + 1
+	const uint8_t scanline[] = {
+		2, 2, 0, (uint8_t)width,
+		128 + 8, 64,
+		128 + 8, 128,
+		128 + 8, 0,
+		8, 129, 129, 129, 129, 129, 129, 129, 129,
+	};
+	data.insert(data.end(), scanline, scanline + sizeof(scanline));
+
+	DecodedImage image;
+	REQUIRE(DecodeHDR(data.data(), data.size(), image));
+	REQUIRE(image.width == width);
+	const float *p = reinterpret_cast<const float *>(Texel(image, 7, 0));
+	CHECK(p[0] == 0.5f);
+	CHECK(p[1] == 1.0f);
+	CHECK(p[2] == 0.0f);
+}
+
+TEST_CASE(ImageCodec, HDRRejectsMalformed)
+{
+	DecodedImage image;
+
+	Bytes badMagic;
+	Append(badMagic, "#?PNG\n\n-Y 1 +X 1\n");
+	badMagic.resize(badMagic.size() + 4);
+	CHECK(!DecodeHDR(badMagic.data(), badMagic.size(), image));
+
+	Bytes flipped;
+	Append(flipped, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n+Y 1 +X 1\n");
+	flipped.resize(flipped.size() + 4);
+	CHECK(!DecodeHDR(flipped.data(), flipped.size(), image));
+
+	Bytes truncated;
+	Append(truncated, "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y 2 +X 2\n");
+	truncated.resize(truncated.size() + 12);
+	CHECK(!DecodeHDR(truncated.data(), truncated.size(), image));
+}
+
+TEST_CASE(ImageCodec, DDSRGBAWithMips)
+{
+	//4x2 RGBA8, 3 levels: 4x2, 2x1, 1x1
+	Bytes data = DDSHeader(4, 2, 3);
+	PutU32(data, 80, 0x41);
+	PutU32(data, 88, 32);
+	PutU32(data, 92, 0x000000ff);
+	PutU32(data, 96, 0x0000ff00);
+	PutU32(data, 100, 0x00ff0000);
+	PutU32(data, 104, 0xff000000);
+	for (uint32_t i = 0; i < (8 + 2 + 1) * 4; ++i) {
+		data.push_back((uint8_t)i);
+	}
+
+	DecodedImage image;
+	REQUIRE(DecodeDDS(data.data(), data.size(), image));
+	CHECK(image.format == ImageFormat_RGBA8);
+	REQUIRE(image.mips.size() == 3);
+	CHECK(image.mips[1].width == 2);
+	CHECK(image.mips[1].height == 1);
+	CHECK(image.mips[2].width == 1);
+	CHECK(image.pixels[image.mips[1].offset] == 32);
+	CHECK(image.pixels[image.mips[2].offset] == 40);
+
+	//Missing the last level
+	data.resize(data.size() - 1);
+	CHECK(!DecodeDDS(data.data(), data.size(), image));
+}
+
+TEST_CASE(ImageCodec, DDSBlockCompressed)
+{
+	//DXT1 8x8: 2x2 blocks of 8 bytes
+	Bytes dxt1 = DDSHeader(8, 8, 1);
+	PutU32(dxt1, 80, 0x4);
+	PutU32(dxt1, 84, 0x31545844);	//"DXT1"
+	dxt1.resize(dxt1.size() + 32, 0xab);
+
+	DecodedImage image;
+	REQUIRE(DecodeDDS(dxt1.data(), dxt1.size(), image));
+	CHECK(image.format == ImageFormat_BC1);
+	CHECK(image.mips[0].rowPitch == 16);
+	CHECK(image.mips[0].rowCount == 2);
+
+	//DX10 header with BC7
+	Bytes dx10 = DDSHeader(4, 4, 1);
+	PutU32(dx10, 80, 0x4);
+	PutU32(dx10, 84, 0x30315844);	//"DX10"
+	dx10.resize(148, 0);
+	PutU32(dx10, 128, ImageFormat_BC7);
+	PutU32(dx10, 132, 3);
+	PutU32(dx10, 140, 1);
+	dx10.resize(dx10.size() + 16, 0);
+	REQUIRE(DecodeDDS(dx10.data(), dx10.size(), image));
+	CHECK(image.format == ImageFormat_BC7);
+
+	//Texture array is not a 2D texture
+	PutU32(dx10, 140, 6);
+	CHECK(!DecodeDDS(dx10.data(), dx10.size(), image));
+}
+
+TEST_CASE(ImageCodec, DispatchByExtension)
+{
+	Bytes tga = TGAHeader(3, 1, 1, 8, 0);
+	tga.push_back(1);
+
+	DecodedImage image;
+	CHECK(IsPortableImageFile("a/b/Test.TGA"));
+	CHECK(!IsPortableImageFile("Test.png"));
+	CHECK(DecodeImageData("Test.Tga", tga.data(), tga.size(), image));
+	CHECK(!DecodeImageData("Test.dds", tga.data(), tga.size(), image));
+	CHECK(!DecodeImageData("Test", tga.data(), tga.size(), image));
+}
+
+TEST_CASE(ImageCodec, HashImage)
+{
+	Bytes tga = TGAHeader(3, 2, 1, 8, 0);
+	tga.push_back(1);
+	tga.push_back(2);
+
+	DecodedImage a, b;
+	REQUIRE(DecodeTGA(tga.data(), tga.size(), a));
+	REQUIRE(DecodeTGA(tga.data(), tga.size(), b));
+	CHECK(HashImage(a) == HashImage(b));
+
+	b.pixels[0] ^= 1;
+	CHECK(HashImage(a) != HashImage(b));
+}
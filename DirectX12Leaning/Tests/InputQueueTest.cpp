@@ -0,0 +1,142 @@
+//STL
+#include <string>
+
+//Utility
+#include "InputQueue.h"
+#include "ScriptedInput.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	const int64_t millisecond = 1000000;
+
+	void Push(InputQueue &queue, const int64_t ms, const keycode key, const bool down)
+	{
+		queue.Push({ ms * millisecond, (uint8_t)key, down });
+	}
+}
+
+TEST_CASE(InputQueue, TapInsideOneTick)
+{
+	InputQueue queue;
+	Push(queue, 2, keycode::Space, true);
+	Push(queue, 6, keycode::Space, false);
+
+	//Pressed and released between two ticks: still one press
+	queue.AdvanceTo(10 * millisecond);
+	CHECK(queue.GetKeyDown(keycode::Space));
+	CHECK(queue.GetKeyUp(keycode::Space));
+	CHECK(!queue.GetKey(keycode::Space));
+
+	queue.AdvanceTo(20 * millisecond);
+	CHECK(!queue.GetKeyDown(keycode::Space));
+	CHECK(!queue.GetKeyUp(keycode::Space));
+}
+
+TEST_CASE(InputQueue, EventsWaitForTheirTick)
+{
+	InputQueue queue;
+	Push(queue, 10, keycode::W, true);
+	Push(queue, 25, keycode::W, false);
+	Push(queue, 31, keycode::D, true);
+
+	//Several ticks in one frame, each takes only its own events (end inclusive)
+	queue.AdvanceTo(5 * millisecond);
+	CHECK(!queue.GetKey(keycode::W));
+	CHECK(queue.GetPendingCount() == 3);
+	CHECK(queue.GetLatestKey(keycode::D));
+
+	queue.AdvanceTo(10 * millisecond);
+	CHECK(queue.GetKeyDown(keycode::W));
+	CHECK(queue.GetPendingCount() == 2);
+
+	queue.AdvanceTo(20 * millisecond);
+	CHECK(queue.GetKey(keycode::W));
+	CHECK(!queue.GetKeyDown(keycode::W));
+
+	queue.AdvanceTo(30 * millisecond);
+	CHECK(queue.GetKeyUp(keycode::W));
+	CHECK(!queue.GetKey(keycode::D));
+
+	queue.AdvanceTo(40 * millisecond);
+	CHECK(queue.GetKeyDown(keycode::D));
+	CHECK(queue.GetPendingCount() == 0);
+}
+
+TEST_CASE(InputQueue, KeyRepeatIsNotAPress)
+{
+	InputQueue queue;
+	Push(queue, 1, keycode::A, true);
+	queue.AdvanceTo(10 * millisecond);
+	CHECK(queue.GetKeyDown(keycode::A));
+
+	Push(queue, 11, keycode::A, true);
+	Push(queue, 12, keycode::A, true);
+	queue.AdvanceTo(20 * millisecond);
+	CHECK(queue.GetKey(keycode::A));
+	CHECK(!queue.GetKeyDown(keycode::A));
+
+	//Release of a key that was never down is not an edge
+	Push(queue, 21, keycode::S, false);
+	queue.AdvanceTo(30 * millisecond);
+	CHECK(!queue.GetKeyUp(keycode::S));
+}
+
+TEST_CASE(InputQueue, ReleaseAll)
+{
+	InputQueue queue;
+	Push(queue, 1, keycode::A, true);
+	Push(queue, 2, keycode::Space, true);
+	queue.AdvanceTo(10 * millisecond);
+
+	queue.ReleaseAll(15 * millisecond);
+	CHECK(!queue.GetLatestKey(keycode::A));
+	CHECK(queue.GetKey(keycode::A));
+
+	queue.AdvanceTo(20 * millisecond);
+	CHECK(queue.GetKeyUp(keycode::A));
+	CHECK(queue.GetKeyUp(keycode::Space));
+	CHECK(!queue.GetKey(keycode::Space));
+}
+
+TEST_CASE(InputQueue, ScriptedStream)
+{
+	ScriptedInput script;
+	std::string error;
+	REQUIRE(script.Load(
+		"# fire held across two ticks, move tapped inside the last one\n"
+		"5 space down\n"
+		"25 space up\n"
+		"22 d down\n"
+		"28 d up\n"
+		"35 w down\n", error));
+
+	//One 30ms frame of three 10ms ticks, events past the frame stay in the script
+	InputQueue queue;
+	CHECK(script.Poll(queue, 30 * millisecond));
+	CHECK(queue.GetPendingCount() == 4);
+
+	queue.AdvanceTo(10 * millisecond);
+	SimInput input = ReadSimInput(queue);
+	CHECK(input.pressed == SimButton_Fire);
+	CHECK(input.held == SimButton_Fire);
+
+	queue.AdvanceTo(20 * millisecond);
+	input = ReadSimInput(queue);
+	CHECK(input.pressed == 0);
+	CHECK(input.held == SimButton_Fire);
+
+	queue.AdvanceTo(30 * millisecond);
+	input = ReadSimInput(queue);
+	CHECK(input.pressed == SimButton_Right);
+	CHECK(input.held == 0);
+	CHECK(queue.GetKeyUp(keycode::Space));
+
+	CHECK(!script.IsFinished());
+	script.Poll(queue, 40 * millisecond);
+	queue.AdvanceTo(40 * millisecond);
+	CHECK(ReadSimInput(queue).pressed == SimButton_Up);
+	CHECK(script.IsFinished());
+}
@@ -0,0 +1,154 @@
+//Utility
+#include "InstancePacker.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	const float white[4] = { 1, 1, 1, 1 };
+	const float red[4] = { 1, 0, 0, 1 };
+
+	bool Equal(const float *a, const float *b, const int count)
+	{
+		for (int i = 0; i < count; ++i) {
+			if (a[i] != b[i]) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+TEST_CASE(InstancePacker, EmptyPack)
+{
+	InstancePacker packer(4);
+	packer.Begin();
+
+	CHECK(packer.GetCount() == 0);
+	CHECK(packer.GetSizeInBytes() == 0);
+	CHECK(packer.GetCapacity() == 4);
+}
+
+TEST_CASE(InstancePacker, BeginClearsPreviousFrame)
+{
+	InstancePacker packer(4);
+	packer.Begin();
+	CHECK(packer.Add(Position3D{ 1, 2, 3 }, white));
+	CHECK(packer.Add(Position3D{ 4, 5, 6 }, white));
+
+	packer.Begin();
+	CHECK(packer.GetCount() == 0);
+	CHECK(packer.GetSizeInBytes() == 0);
+}
+
+TEST_CASE(InstancePacker, Capacity)
+{
+	InstancePacker packer(3);
+	packer.Begin();
+	for (int i = 0; i < 3; ++i) {
+		CHECK(packer.Add(Position3D{ (float)i, 0, 0 }, white));
+	}
+
+	//Full: refused without touching the packed data
+	CHECK(!packer.Add(Position3D{ 9, 9, 9 }, red));
+	const float identity[16] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1 };
+	CHECK(!packer.Add(identity, red));
+
+	CHECK(packer.GetCount() == 3);
+	CHECK(packer.GetSizeInBytes() == 3 * sizeof(InstanceData));
+	CHECK(packer.GetData()[2].world[12] == 2.0f);
+	CHECK(Equal(packer.GetData()[2].color, white, 4));
+}
+
+TEST_CASE(InstancePacker, TranslationWithIdentityBase)
+{
+	InstancePacker packer(1);
+	packer.Begin();
+	REQUIRE(packer.Add(Position3D{ 1, 2, 3 }, red));
+
+	//Row major, translation in the last row
+	const float expected[16] = {
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		1, 2, 3, 1,
+	};
+	CHECK(Equal(packer.GetData()[0].world, expected, 16));
+	CHECK(Equal(packer.GetData()[0].color, red, 4));
+}
+
+TEST_CASE(InstancePacker, TranslationWithBase)
+{
+	//Uniform scale 2 then move by (10, 0, 0): world = base * translation
+	const float base[16] = {
+		2, 0, 0, 0,
+		0, 2, 0, 0,
+		0, 0, 2, 0,
+		10, 0, 0, 1,
+	};
+
+	InstancePacker packer(1);
+	packer.Begin(base);
+	REQUIRE(packer.Add(Position3D{ 1, 2, 3 }, white));
+
+	const float expected[16] = {
+		2, 0, 0, 0,
+		0, 2, 0, 0,
+		0, 0, 2, 0,
+		11, 2, 3, 1,
+	};
+	CHECK(Equal(packer.GetData()[0].world, expected, 16));
+}
+
+TEST_CASE(InstancePacker, MatrixMatchesTranslation)
+{
+	const float base[16] = {
+		0, 1, 0, 0,
+		-1, 0, 0, 0,
+		0, 0, 1, 0,
+		5, 6, 7, 1,
+	};
+	const float translation[16] = {
+		1, 0, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		1, 2, 3, 1,
+	};
+
+	//Both Add overloads build the same world for a pure translation
+	InstancePacker packer(2);
+	packer.Begin(base);
+	REQUIRE(packer.Add(Position3D{ 1, 2, 3 }, white));
+	REQUIRE(packer.Add(translation, white));
+
+	CHECK(Equal(packer.GetData()[0].world, packer.GetData()[1].world, 16));
+}
+
+TEST_CASE(InstancePacker, MatrixProduct)
+{
+	const float base[16] = {
+		1, 2, 0, 0,
+		0, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 0, 1,
+	};
+	const float matrix[16] = {
+		1, 0, 0, 0,
+		3, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 4, 1,
+	};
+
+	InstancePacker packer(1);
+	packer.Begin(base);
+	REQUIRE(packer.Add(matrix, white));
+
+	const float expected[16] = {
+		7, 2, 0, 0,
+		3, 1, 0, 0,
+		0, 0, 1, 0,
+		0, 0, 4, 1,
+	};
+	CHECK(Equal(packer.GetData()[0].world, expected, 16));
+}
@@ -0,0 +1,195 @@
+//STL
+#include <atomic>
+#include <thread>
+#include <vector>
+
+//Utility
+#include "JobSystem.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	void Increment(void *data)
+	{
+		static_cast<std::atomic<uint32_t> *>(data)->fetch_add(1);
+	}
+
+	//fib(n) = fib(n - 1) + fib(n - 2), both halves as nested jobs
+	struct Fibonacci
+	{
+		JobSystem *jobs;
+		uint32_t n;
+		uint64_t result;
+
+		static void Execute(void *data)
+		{
+			Fibonacci &task = *static_cast<Fibonacci *>(data);
+			if (task.n < 2) {
+				task.result = task.n;
+				return;
+			}
+
+			Fibonacci a = { task.jobs, task.n - 1, 0 };
+			Fibonacci b = { task.jobs, task.n - 2, 0 };
+			JobCounter counter;
+			task.jobs->Run(counter, &Fibonacci::Execute, &a);
+			task.jobs->Run(counter, &Fibonacci::Execute, &b);
+			task.jobs->Wait(counter);
+			task.result = a.result + b.result;
+		}
+	};
+
+	//Blocks until released, records the worker it ran on
+	struct Blocker
+	{
+		std::atomic<uint32_t> started{ 0 };
+		std::atomic<bool> released{ false };
+		std::atomic<uint32_t> offMainWorker{ 0 };
+		JobSystem *jobs = nullptr;
+
+		static void Execute(void *data)
+		{
+			Blocker &blocker = *static_cast<Blocker *>(data);
+			if (blocker.jobs->GetWorkerIndex() != 0) {
+				blocker.offMainWorker.fetch_add(1);
+			}
+			blocker.started.fetch_add(1);
+			while (!blocker.released.load()) {
+				std::this_thread::yield();
+			}
+		}
+	};
+}
+
+TEST_CASE(JobSystem, Workers)
+{
+	JobSystem jobs(3);
+	CHECK(jobs.GetWorkerCount() == 3);
+	CHECK(jobs.GetWorkerIndex() == 0);
+
+	uint32_t outside = 0;
+	std::thread([&]() { outside = jobs.GetWorkerIndex(); }).join();
+	CHECK(outside == JobSystem::invalidWorker);
+}
+
+TEST_CASE(JobSystem, RunWait)
+{
+	JobSystem jobs(4);
+	std::atomic<uint32_t> count{ 0 };
+
+	JobCounter counter;
+	CHECK(counter.IsDone());
+	for (int i = 0; i < 100; ++i) {
+		jobs.Run(counter, Increment, &count);
+	}
+	jobs.Wait(counter);
+	CHECK(counter.IsDone());
+	CHECK(count.load() == 100);
+	CHECK(jobs.GetStats().executed == 100);
+
+	//Counters are reusable
+	jobs.Run(counter, Increment, &count);
+	jobs.Wait(counter);
+	CHECK(count.load() == 101);
+}
+
+TEST_CASE(JobSystem, RunFromOutside)
+{
+	JobSystem jobs(2);
+	std::atomic<uint32_t> count{ 0 };
+
+	//A thread that is no worker queues to worker 0 and helps by stealing
+	std::thread([&]() {
+		JobCounter counter;
+		for (int i = 0; i < 50; ++i) {
+			jobs.Run(counter, Increment, &count);
+		}
+		jobs.Wait(counter);
+	}).join();
+	CHECK(count.load() == 50);
+}
+
+TEST_CASE(JobSystem, NestedJobs)
+{
+	JobSystem jobs(4);
+
+	//Every level waits inside a job, deadlock free only if waiting workers keep running jobs
+	Fibonacci root = { &jobs, 16, 0 };
+	JobCounter counter;
+	jobs.Run(counter, &Fibonacci::Execute, &root);
+	jobs.Wait(counter);
+	CHECK(root.result == 987);
+
+	//fib(16) spawns 2 * fib(17) - 1 jobs including the root
+	CHECK(jobs.GetStats().executed == 2 * 1597 - 1);
+}
+
+TEST_CASE(JobSystem, Stealing)
+{
+	JobSystem jobs(2);
+	Blocker blocker;
+	blocker.jobs = &jobs;
+
+	//Every job sits in worker 0's queue and worker 0 is not waiting yet:
+	//the one that starts was stolen by worker 1
+	JobCounter counter;
+	for (int i = 0; i < 4; ++i) {
+		jobs.Run(counter, &Blocker::Execute, &blocker);
+	}
+	while (blocker.started.load() == 0) {
+		std::this_thread::yield();
+	}
+	CHECK(blocker.offMainWorker.load() == 1);
+	CHECK(jobs.GetStats().stolen >= 1);
+
+	blocker.released.store(true);
+	jobs.Wait(counter);
+	CHECK(blocker.started.load() == 4);
+	CHECK(jobs.GetStats().executed == 4);
+}
+
+TEST_CASE(JobSystem, QueueOverflowRunsInline)
+{
+	//One worker: nothing runs the queue until Wait
+	JobSystem jobs(1);
+	std::atomic<uint32_t> count{ 0 };
+
+	const uint32_t total = jobQueueSize + 100;
+	JobCounter counter;
+	for (uint32_t i = 0; i < total; ++i) {
+		jobs.Run(counter, Increment, &count);
+	}
+	CHECK(count.load() == 100);
+	CHECK(!counter.IsDone());
+
+	jobs.Wait(counter);
+	CHECK(count.load() == total);
+	CHECK(jobs.GetStats().executed == total);
+	CHECK(jobs.GetStats().stolen == 0);
+}
+
+TEST_CASE(JobSystem, ParallelFor)
+{
+	JobSystem jobs(4);
+	std::vector<std::atomic<uint32_t>> visits(1000);
+	for (auto &visit : visits) {
+		visit.store(0);
+	}
+
+	jobs.ParallelFor(1000, 7, [&](uint32_t index) { visits[index].fetch_add(1); });
+	bool once = true;
+	for (auto &visit : visits) {
+		once = once && visit.load() == 1;
+	}
+	CHECK(once);
+
+	//Empty range, batch size 0 is 1
+	uint32_t calls = 0;
+	jobs.ParallelFor(0, 4, [&](uint32_t) { ++calls; });
+	CHECK(calls == 0);
+	std::atomic<uint32_t> single{ 0 };
+	jobs.ParallelFor(3, 0, [&](uint32_t) { single.fetch_add(1); });
+	CHECK(single.load() == 3);
+}
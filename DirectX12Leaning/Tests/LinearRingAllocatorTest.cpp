@@ -0,0 +1,134 @@
+//Utility
+#include "FramePacer.h"
+#include "LinearRingAllocator.h"
+
+//this
+#include "UnitTest.h"
+
+TEST_CASE(LinearRingAllocator, Alignment)
+{
+	LinearRingAllocator ring(4096);
+
+	CHECK(ring.Allocate(10, 256) == 0);
+	CHECK(ring.Allocate(10, 256) == 256);
+	CHECK(ring.Allocate(4, 4) == 268);
+	CHECK(ring.Allocate(1, 1) == 272);
+	CHECK(ring.Allocate(16, 16) == 288);
+
+	//Padding counts as used until the frame retires
+	CHECK(ring.GetUsedSize() == 304);
+}
+
+TEST_CASE(LinearRingAllocator, FullRingFails)
+{
+	LinearRingAllocator ring(1024);
+
+	CHECK(ring.Allocate(2048, 1) == LinearRingAllocator::invalidOffset);
+	CHECK(ring.Allocate(1024, 256) == 0);
+	CHECK(ring.Allocate(1, 1) == LinearRingAllocator::invalidOffset);
+	CHECK(ring.GetFailedCount() == 2);
+	CHECK(ring.GetUsedSize() == 1024);
+}
+
+TEST_CASE(LinearRingAllocator, FenceRetirement)
+{
+	LinearRingAllocator ring(1024);
+
+	REQUIRE(ring.Allocate(512, 256) == 0);
+	ring.EndFrame(1);
+	REQUIRE(ring.Allocate(256, 256) == 512);
+	ring.EndFrame(2);
+
+	//Nothing completed: space stays taken
+	ring.Retire(0);
+	CHECK(ring.GetUsedSize() == 768);
+
+	//Frame 1 done, frame 2 still in flight
+	ring.Retire(1);
+	CHECK(ring.GetUsedSize() == 256);
+
+	ring.Retire(2);
+	CHECK(ring.GetUsedSize() == 0);
+}
+
+TEST_CASE(LinearRingAllocator, Wraparound)
+{
+	LinearRingAllocator ring(1024);
+
+	REQUIRE(ring.Allocate(768, 256) == 0);
+	ring.EndFrame(1);
+	ring.Retire(1);
+
+	//512 does not fit in the 256 bytes before the end: starts over at 0, never split
+	CHECK(ring.Allocate(512, 256) == 0);
+	CHECK(ring.GetUsedSize() == 256 + 512);
+	ring.EndFrame(2);
+
+	//Tail at 768, head at 1536: 256 bytes left
+	CHECK(ring.Allocate(256, 256) == 512);
+	CHECK(ring.Allocate(256, 256) == LinearRingAllocator::invalidOffset);
+
+	//Wraps again: [768, 1024) is padding, the block starts at 0
+	ring.Retire(2);
+	CHECK(ring.GetUsedSize() == 256);
+	CHECK(ring.Allocate(512, 256) == 0);
+	CHECK(ring.GetUsedSize() == 1024);
+}
+
+TEST_CASE(LinearRingAllocator, WrapDoesNotOverwriteInFlight)
+{
+	LinearRingAllocator ring(1024);
+
+	//Frame 1 keeps [0, 256) alive
+	REQUIRE(ring.Allocate(256, 256) == 0);
+	ring.EndFrame(1);
+	REQUIRE(ring.Allocate(512, 256) == 256);
+
+	//Only 256 bytes at the end and the start is still in use
+	CHECK(ring.Allocate(512, 256) == LinearRingAllocator::invalidOffset);
+	CHECK(ring.Allocate(256, 256) == 768);
+}
+
+TEST_CASE(LinearRingAllocator, AllocateWaitsForOldestFrame)
+{
+	//GPU two frames behind: nothing retires on its own
+	NullFrameFence fence(2);
+	LinearRingAllocator ring(1024);
+
+	for (uint64_t frame = 1; frame <= 3; ++frame) {
+		REQUIRE(ring.AllocateWaiting(256, 256, &fence) != LinearRingAllocator::invalidOffset);
+		fence.Signal(frame);
+		ring.EndFrame(frame);
+	}
+	CHECK(ring.GetWaitCount() == 0);
+
+	//Last free block, then frame 1 (completed by the third signal) is retired without waiting
+	CHECK(ring.AllocateWaiting(256, 256, &fence) == 768);
+	CHECK(ring.AllocateWaiting(256, 256, &fence) == 0);
+	CHECK(ring.GetWaitCount() == 0);
+
+	//Frame 2 is still on the GPU: wait for it
+	CHECK(ring.AllocateWaiting(256, 256, &fence) == 256);
+	CHECK(ring.GetWaitCount() == 1);
+	CHECK(fence.GetWaitCount() == 1);
+	CHECK(fence.GetCompletedValue() == 2);
+}
+
+TEST_CASE(LinearRingAllocator, AllocateWaitingGivesUp)
+{
+	NullFrameFence fence(1);
+	LinearRingAllocator ring(1024);
+
+	REQUIRE(ring.AllocateWaiting(512, 256, &fence) == 0);
+	fence.Signal(1);
+	ring.EndFrame(1);
+	REQUIRE(ring.AllocateWaiting(512, 256, &fence) == 512);
+
+	//The current frame alone fills the ring: waits for frame 1, then fails instead of overlapping
+	CHECK(ring.AllocateWaiting(768, 256, &fence) == LinearRingAllocator::invalidOffset);
+	CHECK(ring.GetWaitCount() == 1);
+	CHECK(ring.GetUsedSize() == 512);
+
+	//Larger than the ring
+	CHECK(ring.AllocateWaiting(4096, 256, &fence) == LinearRingAllocator::invalidOffset);
+}
@@ -0,0 +1,171 @@
+//STL
+#include <vector>
+
+//Utility
+#include "NullRenderBackend.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Stand-ins for D3D12 objects (only compared, never dereferenced)
+	int pipelineA, pipelineB, rootSignature, heap;
+
+	template<class T>
+	uint16_t CommandSize()
+	{
+		return (uint16_t)((sizeof(T) + 7) / 8 * 8);
+	}
+
+	std::vector<const RenderCommandHeader *> Commands(const RenderCommandList &list)
+	{
+		std::vector<const RenderCommandHeader *> commands;
+		const RenderCommandHeader *end = (const RenderCommandHeader *)(list.GetData() + list.GetSize());
+		for (const RenderCommandHeader *header = (const RenderCommandHeader *)list.GetData(); header != end; header = RenderCommandList::Next(header)) {
+			commands.push_back(header);
+		}
+		return commands;
+	}
+
+	//Two draws of a typical draw class
+	void RecordScene(RenderCommandList &list)
+	{
+		void *heaps[] = { &heap };
+		const float clear[4] = { 0, 0, 0, 1 };
+
+		list.ClearRenderTargetView(1, clear);
+		list.OMSetRenderTargets(1, 2);
+		list.SetPipelineState(&pipelineA);
+		list.SetGraphicsRootSignature(&rootSignature);
+		list.SetDescriptorHeaps(1, heaps);
+		list.SetGraphicsRootConstantBufferView(0, 0x1000);
+		list.SetGraphicsRootDescriptorTable(1, 0x2000);
+		list.IASetPrimitiveTopology(4);
+		list.IASetVertexBuffer(0, { 0x3000, 96, 32 });
+		list.IASetIndexBuffer(RenderIndexBufferView{ 0x4000, 12, 57 });
+		list.Upload(256);
+		list.DrawIndexedInstanced(6, 1, 0, 0, 0);
+
+		list.SetPipelineState(&pipelineB);
+		list.SetGraphicsRootConstantBufferView(0, 0x1100);
+		list.DrawInstanced(3, 10, 0, 0);
+	}
+}
+
+TEST_CASE(NullRenderBackend, StreamLayout)
+{
+	RenderCommandList list;
+	RecordScene(list);
+
+	//Commands come back in call order, each padded to 8 bytes
+	const std::vector<const RenderCommandHeader *> commands = Commands(list);
+	const RenderCommandType expected[] = {
+		RenderCommandType::ClearRenderTargetView,
+		RenderCommandType::OMSetRenderTargets,
+		RenderCommandType::SetPipelineState,
+		RenderCommandType::SetGraphicsRootSignature,
+		RenderCommandType::SetDescriptorHeaps,
+		RenderCommandType::SetGraphicsRootConstantBufferView,
+		RenderCommandType::SetGraphicsRootDescriptorTable,
+		RenderCommandType::IASetPrimitiveTopology,
+		RenderCommandType::IASetVertexBuffer,
+		RenderCommandType::IASetIndexBuffer,
+		RenderCommandType::Upload,
+		RenderCommandType::DrawIndexedInstanced,
+		RenderCommandType::SetPipelineState,
+		RenderCommandType::SetGraphicsRootConstantBufferView,
+		RenderCommandType::DrawInstanced,
+	};
+	REQUIRE(commands.size() == sizeof(expected) / sizeof(expected[0]));
+	CHECK(list.GetCommandCount() == commands.size());
+
+	size_t bytes = 0;
+	for (size_t i = 0; i < commands.size(); ++i) {
+		CHECK(commands[i]->type == expected[i]);
+		CHECK(commands[i]->size % 8 == 0);
+		bytes += commands[i]->size;
+	}
+	CHECK(bytes == list.GetSize());
+
+	CHECK(commands[2]->size == CommandSize<CmdSetPipelineState>());
+	CHECK(commands[4]->size == CommandSize<CmdSetDescriptorHeaps>());
+	CHECK(commands[11]->size == CommandSize<CmdDrawIndexedInstanced>());
+
+	//Arguments as recorded
+	auto &pipeline = *(const CmdSetPipelineState *)commands[12];
+	CHECK(pipeline.pipeline == &pipelineB);
+	auto &vertex = *(const CmdIASetVertexBuffer *)commands[8];
+	CHECK(vertex.view.address == 0x3000 && vertex.view.size == 96 && vertex.view.stride == 32);
+	auto &draw = *(const CmdDrawIndexedInstanced *)commands[11];
+	CHECK(draw.indexCount == 6 && draw.instanceCount == 1);
+
+	//Reset keeps nothing
+	list.Reset();
+	CHECK(list.GetSize() == 0);
+	CHECK(list.GetCommandCount() == 0);
+}
+
+TEST_CASE(NullRenderBackend, Counters)
+{
+	RenderCommandList list;
+	RecordScene(list);
+
+	NullRenderBackend backend;
+	backend.Execute(list);
+	const RenderStats &stats = backend.GetStats();
+
+	CHECK(stats.commands == 15);
+	CHECK(stats.streamBytes == list.GetSize());
+	CHECK(stats.draws == 2);
+	CHECK(stats.instances == 11);
+	CHECK(stats.indices == 6 + 3 * 10);
+	CHECK(stats.uploadBytes == 256);
+	CHECK(stats.calls[(uint32_t)RenderCommandType::SetPipelineState] == 2);
+	CHECK(stats.calls[(uint32_t)RenderCommandType::ClearRenderTargetView] == 1);
+
+	//Pipeline x2, root signature, heaps, root arguments x3, IA x3, OM
+	CHECK(stats.stateCalls == 11);
+	CHECK(stats.redundantCalls == 0);
+
+	//Each Execute is a new command list: nothing carries over, stats add up
+	backend.Execute(list);
+	CHECK(backend.GetStats().draws == 4);
+	CHECK(backend.GetStats().redundantCalls == 0);
+
+	backend.ResetStats();
+	CHECK(backend.GetStats().commands == 0);
+}
+
+TEST_CASE(NullRenderBackend, RedundantCalls)
+{
+	//Unfiltered recording: every call reaches the backend
+	RenderCommandList list;
+	list.SetStateFiltering(false);
+	list.SetGraphicsRootSignature(&rootSignature);
+	list.SetGraphicsRootConstantBufferView(0, 0x1000);
+	list.SetGraphicsRootConstantBufferView(0, 0x1000);
+	list.RSSetViewport(0, 0, 1280, 720, 0, 1);
+	list.RSSetViewport(0, 0, 1280, 720, 0, 1);
+	list.IASetPrimitiveTopology(4);
+	list.IASetPrimitiveTopology(4);
+
+	//A new root signature drops the root arguments, the same CBV is not redundant after it
+	list.SetGraphicsRootSignature(&pipelineA);
+	list.SetGraphicsRootConstantBufferView(0, 0x1000);
+
+	NullRenderBackend backend;
+	backend.Execute(list);
+	const RenderStats &stats = backend.GetStats();
+	CHECK(stats.stateCalls == 9);
+	CHECK(stats.redundantCalls == 3);
+	CHECK(stats.redundant[(uint32_t)RenderCommandType::SetGraphicsRootConstantBufferView] == 1);
+	CHECK(stats.redundant[(uint32_t)RenderCommandType::RSSetViewport] == 1);
+	CHECK(stats.redundant[(uint32_t)RenderCommandType::IASetPrimitiveTopology] == 1);
+
+	RenderStats total;
+	total.Add(stats);
+	total.Add(stats);
+	CHECK(total.redundantCalls == 6);
+	CHECK(total.redundant[(uint32_t)RenderCommandType::RSSetViewport] == 2);
+}
@@ -0,0 +1,189 @@
+//STL
+#include <functional>
+#include <vector>
+
+//Utility
+#include "ObjectCache.h"
+#include "PipelineKey.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	const uint8_t vsCode[] = { 0x44, 0x58, 0x42, 0x43, 1, 2, 3, 4 };
+	const uint8_t psCode[] = { 0x44, 0x58, 0x42, 0x43, 5, 6, 7, 8 };
+	int rootSignature = 0;
+
+	//A typical opaque 3D pipeline (values are the D3D12 enum values)
+	PipelineKeyDesc MakeDesc()
+	{
+		PipelineKeyDesc desc;
+		desc.rootSignature = &rootSignature;
+		desc.vs.bytecode = vsCode;
+		desc.vs.size = sizeof(vsCode);
+		desc.ps.bytecode = psCode;
+		desc.ps.size = sizeof(psCode);
+
+		desc.blend[0].srcBlend = 2;
+		desc.blend[0].destBlend = 1;
+		desc.blend[0].blendOp = 1;
+		desc.blend[0].writeMask = 0xf;
+		desc.sampleMask = 0xffffffff;
+
+		desc.rasterizer.fillMode = 3;
+		desc.rasterizer.cullMode = 3;
+		desc.rasterizer.depthClipEnable = 1;
+
+		desc.depthStencil.depthEnable = 1;
+		desc.depthStencil.depthWriteMask = 1;
+		desc.depthStencil.depthFunc = 2;
+
+		PipelineInputElement position;
+		position.semanticName = "POSITION";
+		position.format = 6;
+		PipelineInputElement texcoord;
+		texcoord.semanticName = "TEXCOORD";
+		texcoord.format = 16;
+		texcoord.alignedByteOffset = 12;
+		desc.inputLayout.push_back(position);
+		desc.inputLayout.push_back(texcoord);
+
+		desc.primitiveTopologyType = 3;
+		desc.numRenderTargets = 1;
+		desc.rtvFormats[0] = 28;
+		desc.dsvFormat = 40;
+		desc.sampleCount = 1;
+		return desc;
+	}
+
+	CacheKey MakeKey(const PipelineKeyDesc &desc)
+	{
+		CacheKey key;
+		WritePipelineKey(key, desc);
+		return key;
+	}
+}
+
+TEST_CASE(PipelineKey, EqualDescsDedupe)
+{
+	//Same content in other memory: bytecode and names are keyed by content
+	std::vector<uint8_t> vsCopy(vsCode, vsCode + sizeof(vsCode));
+	PipelineKeyDesc other = MakeDesc();
+	other.vs.bytecode = vsCopy.data();
+	const char position[] = "POSITION";
+	other.inputLayout[0].semanticName = position;
+
+	CHECK(MakeKey(MakeDesc()) == MakeKey(other));
+
+	ObjectCache<int> cache;
+	int created = 0;
+	const int first = cache.GetOrCreate(MakeKey(MakeDesc()), [&]() { return ++created; });
+	const int second = cache.GetOrCreate(MakeKey(other), [&]() { return ++created; });
+
+	CHECK(first == second);
+	CHECK(created == 1);
+	CHECK(cache.GetSize() == 1);
+	CHECK(cache.GetHitCount() == 1);
+	CHECK(cache.GetMissCount() == 1);
+}
+
+TEST_CASE(PipelineKey, EveryFieldChangesKey)
+{
+	const uint8_t otherCode[] = { 0x44, 0x58, 0x42, 0x43, 1, 2, 3, 5 };
+	const uint32_t strides[] = { 16 };
+
+	typedef std::function<void(PipelineKeyDesc &)> Change;
+	const Change changes[] = {
+		[](PipelineKeyDesc &d) { d.rootSignature = nullptr; },
+		[&](PipelineKeyDesc &d) { d.vs.bytecode = otherCode; },
+		[](PipelineKeyDesc &d) { d.vs.size -= 1; },
+		[](PipelineKeyDesc &d) { d.ps.bytecode = vsCode; },
+		[](PipelineKeyDesc &d) { d.ds = d.vs; },
+		[](PipelineKeyDesc &d) { d.hs = d.vs; },
+		[](PipelineKeyDesc &d) { d.gs = d.vs; },
+		[](PipelineKeyDesc &d) { PipelineStreamOutputEntry e; e.semanticName = "SV_Position"; e.componentCount = 4; d.streamOutput.push_back(e); },
+		[&](PipelineKeyDesc &d) { d.streamOutputStrides.assign(strides, strides + 1); },
+		[](PipelineKeyDesc &d) { d.rasterizedStream = 1; },
+		[](PipelineKeyDesc &d) { d.alphaToCoverageEnable = 1; },
+		[](PipelineKeyDesc &d) { d.independentBlendEnable = 1; },
+		[](PipelineKeyDesc &d) { d.blend[0].blendEnable = 1; },
+		[](PipelineKeyDesc &d) { d.blend[0].logicOpEnable = 1; },
+		[](PipelineKeyDesc &d) { d.blend[0].srcBlend = 5; },
+		[](PipelineKeyDesc &d) { d.blend[0].destBlend = 6; },
+		[](PipelineKeyDesc &d) { d.blend[0].blendOp = 2; },
+		[](PipelineKeyDesc &d) { d.blend[0].srcBlendAlpha = 2; },
+		[](PipelineKeyDesc &d) { d.blend[0].destBlendAlpha = 2; },
+		[](PipelineKeyDesc &d) { d.blend[0].blendOpAlpha = 2; },
+		[](PipelineKeyDesc &d) { d.blend[0].logicOp = 4; },
+		[](PipelineKeyDesc &d) { d.blend[0].writeMask = 0x7; },
+		[](PipelineKeyDesc &d) { d.blend[7].blendEnable = 1; },
+		[](PipelineKeyDesc &d) { d.sampleMask = 1; },
+		[](PipelineKeyDesc &d) { d.rasterizer.fillMode = 2; },
+		[](PipelineKeyDesc &d) { d.rasterizer.cullMode = 1; },
+		[](PipelineKeyDesc &d) { d.rasterizer.frontCounterClockwise = 1; },
+		[](PipelineKeyDesc &d) { d.rasterizer.depthBias = 1; },
+		[](PipelineKeyDesc &d) { d.rasterizer.depthBiasClamp = 0.5f; },
+		[](PipelineKeyDesc &d) { d.rasterizer.slopeScaledDepthBias = 0.5f; },
+		[](PipelineKeyDesc &d) { d.rasterizer.depthClipEnable = 0; },
+		[](PipelineKeyDesc &d) { d.rasterizer.multisampleEnable = 1; },
+		[](PipelineKeyDesc &d) { d.rasterizer.antialiasedLineEnable = 1; },
+		[](PipelineKeyDesc &d) { d.rasterizer.forcedSampleCount = 4; },
+		[](PipelineKeyDesc &d) { d.rasterizer.conservativeRaster = 1; },
+		[](PipelineKeyDesc &d) { d.depthStencil.depthEnable = 0; },
+		[](PipelineKeyDesc &d) { d.depthStencil.depthWriteMask = 0; },
+		[](PipelineKeyDesc &d) { d.depthStencil.depthFunc = 4; },
+		[](PipelineKeyDesc &d) { d.depthStencil.stencilEnable = 1; },
+		[](PipelineKeyDesc &d) { d.depthStencil.stencilReadMask = 0xff; },
+		[](PipelineKeyDesc &d) { d.depthStencil.stencilWriteMask = 0xff; },
+		[](PipelineKeyDesc &d) { d.depthStencil.frontFace.failOp = 2; },
+		[](PipelineKeyDesc &d) { d.depthStencil.frontFace.depthFailOp = 2; },
+		[](PipelineKeyDesc &d) { d.depthStencil.frontFace.passOp = 2; },
+		[](PipelineKeyDesc &d) { d.depthStencil.frontFace.func = 2; },
+		[](PipelineKeyDesc &d) { d.depthStencil.backFace.func = 2; },
+		[](PipelineKeyDesc &d) { d.inputLayout.pop_back(); },
+		[](PipelineKeyDesc &d) { d.inputLayout[0].semanticName = "NORMAL"; },
+		[](PipelineKeyDesc &d) { d.inputLayout[0].semanticIndex = 1; },
+		[](PipelineKeyDesc &d) { d.inputLayout[0].format = 2; },
+		[](PipelineKeyDesc &d) { d.inputLayout[0].inputSlot = 1; },
+		[](PipelineKeyDesc &d) { d.inputLayout[1].alignedByteOffset = 16; },
+		[](PipelineKeyDesc &d) { d.inputLayout[0].inputSlotClass = 1; },
+		[](PipelineKeyDesc &d) { d.inputLayout[0].instanceDataStepRate = 1; },
+		[](PipelineKeyDesc &d) { d.ibStripCutValue = 1; },
+		[](PipelineKeyDesc &d) { d.primitiveTopologyType = 2; },
+		[](PipelineKeyDesc &d) { d.numRenderTargets = 2; },
+		[](PipelineKeyDesc &d) { d.rtvFormats[0] = 87; },
+		[](PipelineKeyDesc &d) { d.dsvFormat = 45; },
+		[](PipelineKeyDesc &d) { d.sampleCount = 4; },
+		[](PipelineKeyDesc &d) { d.sampleQuality = 1; },
+		[](PipelineKeyDesc &d) { d.nodeMask = 1; },
+		[](PipelineKeyDesc &d) { d.flags = 1; },
+	};
+
+	const CacheKey base = MakeKey(MakeDesc());
+	std::vector<CacheKey> keys;
+	for (auto &change : changes) {
+		PipelineKeyDesc desc = MakeDesc();
+		change(desc);
+		const CacheKey key = MakeKey(desc);
+		CHECK(key != base);
+		CHECK(key.GetHash() != base.GetHash());
+		keys.push_back(key);
+	}
+
+	//No two changes collide either
+	for (size_t i = 0; i < keys.size(); ++i) {
+		for (size_t j = i + 1; j < keys.size(); ++j) {
+			CHECK(keys[i] != keys[j]);
+		}
+	}
+}
+
+TEST_CASE(PipelineKey, UnusedRenderTargetFormatsIgnored)
+{
+	//Only the first numRenderTargets formats are part of the key
+	PipelineKeyDesc desc = MakeDesc();
+	desc.rtvFormats[3] = 87;
+
+	CHECK(MakeKey(desc) == MakeKey(MakeDesc()));
+}
@@ -0,0 +1,151 @@
+//STL
+#include <sstream>
+#include <string>
+#include <vector>
+
+//Utility
+#include "Profiler.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Thread rings belong to Profiler::Get, every case starts a new capture on it
+	Profiler &StartCapture()
+	{
+		Profiler &profiler = Profiler::Get();
+		profiler.Start();
+		return profiler;
+	}
+
+	std::string WriteTrace(const Profiler &profiler)
+	{
+		std::ostringstream out;
+		profiler.WriteChromeTrace(out);
+		return out.str();
+	}
+
+	//Trace line of the event / metadata record whose name field starts with text
+	std::string FindLine(const std::string &trace, const std::string &text)
+	{
+		const size_t at = trace.find(text);
+		if (at == std::string::npos) {
+			return std::string();
+		}
+		const size_t begin = trace.rfind('\n', at) + 1;
+		return trace.substr(begin, trace.find('\n', at) - begin);
+	}
+}
+
+TEST_CASE(Profiler, RingOverflow)
+{
+	Profiler &profiler = StartCapture();
+	const int64_t now = Profiler::Now();
+
+	//A full ring drops the newest events until Collect frees the slots
+	for (uint32_t i = 0; i < profileRingSize + 10; ++i) {
+		profiler.Record("overflow", now, now + 1);
+	}
+	CHECK(profiler.GetDroppedCount() == 10);
+
+	profiler.Collect();
+	CHECK(profiler.GetEvents().size() == profileRingSize);
+
+	profiler.Record("overflow", now, now + 1);
+	profiler.Collect();
+	CHECK(profiler.GetEvents().size() == profileRingSize + 1);
+	CHECK(profiler.GetDroppedCount() == 10);
+	profiler.Stop();
+}
+
+TEST_CASE(Profiler, StartClearsLeftovers)
+{
+	Profiler &profiler = StartCapture();
+	const int64_t now = Profiler::Now();
+
+	profiler.Record("old", now, now + 1);
+	profiler.RecordGpu("old gpu", now, now + 1);
+	profiler.RecordCounter("old counter", 1);
+	profiler.Collect();
+	profiler.Stop();
+
+	//Stopped: nothing is recorded
+	profiler.Record("stopped", now, now + 1);
+	profiler.RecordCounter("stopped", 1);
+	profiler.Collect();
+	CHECK(profiler.GetEvents().size() == 2);
+	CHECK(profiler.GetCounters().size() == 1);
+
+	//Captured events and counters are gone
+	profiler.Start();
+	CHECK(profiler.GetEvents().empty());
+	CHECK(profiler.GetCounters().empty());
+
+	//So are drops and ring entries Collect never drained
+	for (uint32_t i = 0; i < profileRingSize + 1; ++i) {
+		profiler.Record("not collected", now, now + 1);
+	}
+	CHECK(profiler.GetDroppedCount() == 1);
+	profiler.Start();
+	CHECK(profiler.GetDroppedCount() == 0);
+
+	profiler.Record("new", now, now + 1);
+	profiler.RecordCounter("new counter", 7);
+	profiler.Collect();
+	const std::vector<CapturedEvent> events = profiler.GetEvents();
+	REQUIRE(events.size() == 1);
+	CHECK(std::string(events[0].event.name) == "new");
+	CHECK(events[0].track != profileGpuTrack);
+
+	const std::vector<ProfileCounter> counters = profiler.GetCounters();
+	REQUIRE(counters.size() == 1);
+	CHECK(counters[0].value == 7);
+	profiler.Stop();
+}
+
+TEST_CASE(Profiler, JsonEscaping)
+{
+	Profiler &profiler = StartCapture();
+	const int64_t now = Profiler::Now();
+
+	profiler.SetThreadName("tab\there");
+	profiler.Record("quote\"back\\slash\nline\x01", now, now + 1);
+	profiler.RecordCounter("counter\"", 3);
+	profiler.Collect();
+	profiler.Stop();
+
+	const std::string trace = WriteTrace(profiler);
+	CHECK(trace.find("\"name\":\"quote\\\"back\\\\slash\\u000aline\\u0001\"") != std::string::npos);
+	CHECK(trace.find("\"args\":{\"name\":\"tab\\u0009here\"}") != std::string::npos);
+	CHECK(trace.find("\"name\":\"counter\\\"\",\"ph\":\"C\"") != std::string::npos);
+
+	//No raw control characters inside a record
+	CHECK(trace.find('\t') == std::string::npos);
+	CHECK(trace.find('\x01') == std::string::npos);
+}
+
+TEST_CASE(Profiler, Microseconds)
+{
+	Profiler &profiler = StartCapture();
+	const int64_t now = Profiler::Now();
+
+	profiler.Record("fraction", now, now + 1500);
+	profiler.Record("small", now, now + 7);
+	profiler.Record("whole", now, now + 2000000);
+	profiler.Record("negative", now, now - 250);
+	profiler.Record("early", now - 1000000000, now);
+	profiler.Collect();
+	profiler.Stop();
+
+	const std::string trace = WriteTrace(profiler);
+	CHECK(FindLine(trace, "\"fraction\"").find("\"dur\":1.500}") != std::string::npos);
+	CHECK(FindLine(trace, "\"small\"").find("\"dur\":0.007}") != std::string::npos);
+	CHECK(FindLine(trace, "\"whole\"").find("\"dur\":2000.000}") != std::string::npos);
+	CHECK(FindLine(trace, "\"negative\"").find("\"dur\":-0.250}") != std::string::npos);
+
+	//Began a second before Start
+	const std::string early = FindLine(trace, "\"early\"");
+	CHECK(early.find("\"ts\":-99") != std::string::npos || early.find("\"ts\":-100") != std::string::npos);
+	CHECK(early.find("\"dur\":1000000.000}") != std::string::npos);
+}
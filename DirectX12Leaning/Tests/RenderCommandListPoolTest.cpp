@@ -0,0 +1,135 @@
+//STL
+#include <vector>
+
+//Utility
+#include "NullRenderBackend.h"
+#include "RenderCommandListPool.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//First command of each range, or Count when it is empty
+	RenderCommandType FirstType(const RenderSubmission &range)
+	{
+		return range.begin != range.end ? range.begin->type : RenderCommandType::Count;
+	}
+
+	uint32_t CountCommands(const RenderSubmission &range)
+	{
+		uint32_t count = 0;
+		for (const RenderCommandHeader *header = range.begin; header != range.end; header = RenderCommandList::Next(header)) {
+			++count;
+		}
+		return count;
+	}
+
+	//Draw whose instance count tags the list it came from
+	void Tag(RenderCommandList &list, const uint32_t tag)
+	{
+		list.DrawInstanced(3, tag, 0, 0);
+	}
+
+	uint32_t TagOf(const RenderSubmission &range)
+	{
+		const RenderCommandHeader *header = range.begin;
+		while (header != range.end && header->type != RenderCommandType::DrawInstanced) {
+			header = RenderCommandList::Next(header);
+		}
+		return header != range.end ? ((const CmdDrawInstanced *)header)->instanceCount : 0;
+	}
+}
+
+TEST_CASE(RenderCommandListPool, SubmissionOrder)
+{
+	RenderCommandList main;
+	RenderCommandListPool pool;
+
+	//main: 100, lists 1 2, main: 200, list 3, main: 300
+	Tag(main, 100);
+	const uint32_t first = pool.Begin(main, 2);
+	Tag(main, 200);
+	const uint32_t third = pool.Begin(main, 1);
+	Tag(main, 300);
+	CHECK(first == 0);
+	CHECK(third == 2);
+	CHECK(pool.GetListCount() == 3);
+
+	//Recorded out of order (other threads)
+	Tag(*pool.Get(2), 3);
+	Tag(*pool.Get(1), 2);
+	Tag(*pool.Get(0), 1);
+
+	std::vector<RenderSubmission> submission;
+	pool.BuildSubmission(main, submission);
+	const uint32_t expected[] = { 100, 1, 2, 200, 3, 300 };
+	REQUIRE(submission.size() == 6);
+	for (size_t i = 0; i < submission.size(); ++i) {
+		CHECK(TagOf(submission[i]) == expected[i]);
+		CHECK(CountCommands(submission[i]) == 1);
+	}
+
+	//The split markers are not replayed
+	for (auto &range : submission) {
+		CHECK(FirstType(range) != RenderCommandType::ParallelLists);
+	}
+}
+
+TEST_CASE(RenderCommandListPool, EdgesAndEmptyLists)
+{
+	RenderCommandList main;
+	RenderCommandListPool pool;
+
+	//Begin first and last: empty main ranges around it
+	pool.Begin(main, 2);
+	Tag(*pool.Get(0), 1);
+
+	std::vector<RenderSubmission> submission;
+	pool.BuildSubmission(main, submission);
+	REQUIRE(submission.size() == 4);
+	CHECK(CountCommands(submission[0]) == 0);
+	CHECK(TagOf(submission[1]) == 1);
+	CHECK(CountCommands(submission[2]) == 0);
+	CHECK(CountCommands(submission[3]) == 0);
+
+	//No Begin: one range, the whole main list
+	RenderCommandList single;
+	Tag(single, 7);
+	pool.BuildSubmission(single, submission);
+	REQUIRE(submission.size() == 1);
+	CHECK(TagOf(submission[0]) == 7);
+}
+
+TEST_CASE(RenderCommandListPool, ReplayAndReset)
+{
+	int pipeline;
+	RenderCommandList main;
+	RenderCommandListPool pool;
+
+	//Every range is its own D3D12 list: the pool list sets the pipeline again
+	main.SetPipelineState(&pipeline);
+	Tag(main, 1);
+	pool.Begin(main, 1);
+	pool.Get(0)->SetPipelineState(&pipeline);
+	Tag(*pool.Get(0), 2);
+	main.SetPipelineState(&pipeline);
+	Tag(main, 3);
+
+	std::vector<RenderSubmission> submission;
+	pool.BuildSubmission(main, submission);
+	NullRenderBackend backend;
+	for (auto &range : submission) {
+		backend.Execute(range.begin, range.end);
+	}
+	CHECK(backend.GetStats().draws == 3);
+	CHECK(backend.GetStats().calls[(uint32_t)RenderCommandType::SetPipelineState] == 3);
+	CHECK(backend.GetStats().redundantCalls == 0);
+
+	//Lists are handed out again from the first one, empty
+	pool.Reset();
+	CHECK(pool.GetListCount() == 0);
+	RenderCommandList next;
+	CHECK(pool.Begin(next, 1) == 0);
+	CHECK(pool.Get(0)->GetSize() == 0);
+}
@@ -0,0 +1,161 @@
+//STL
+#include <vector>
+
+//Utility
+#include "RenderCommandList.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Stand-ins for D3D12 objects (only compared, never dereferenced)
+	int pipelineA, pipelineB, rootSignature, heapA, heapB;
+
+	uint32_t CountType(const RenderCommandList &list, const RenderCommandType type)
+	{
+		uint32_t count = 0;
+		const RenderCommandHeader *end = (const RenderCommandHeader *)(list.GetData() + list.GetSize());
+		for (const RenderCommandHeader *header = (const RenderCommandHeader *)list.GetData(); header != end; header = RenderCommandList::Next(header)) {
+			count += header->type == type ? 1 : 0;
+		}
+		return count;
+	}
+}
+
+TEST_CASE(RenderCommandList, SkipsBoundState)
+{
+	RenderCommandList list;
+	list.SetPipelineState(&pipelineA);
+	list.SetPipelineState(&pipelineA);
+	list.SetGraphicsRootSignature(&rootSignature);
+	list.SetGraphicsRootSignature(&rootSignature);
+	list.IASetPrimitiveTopology(4);
+	list.IASetPrimitiveTopology(4);
+	list.IASetPrimitiveTopology(5);
+
+	//A change is recorded, going back is a change too
+	list.SetPipelineState(&pipelineB);
+	list.SetPipelineState(&pipelineA);
+
+	CHECK(CountType(list, RenderCommandType::SetPipelineState) == 3);
+	CHECK(CountType(list, RenderCommandType::SetGraphicsRootSignature) == 1);
+	CHECK(CountType(list, RenderCommandType::IASetPrimitiveTopology) == 2);
+
+	CHECK(list.GetSkippedCount() == 3);
+	CHECK(list.GetSkippedCount(RenderCommandType::SetPipelineState) == 1);
+	CHECK(list.GetSkippedCount(RenderCommandType::SetGraphicsRootSignature) == 1);
+	CHECK(list.GetSkippedCount(RenderCommandType::IASetPrimitiveTopology) == 1);
+	CHECK(list.GetSkippedCount(RenderCommandType::DrawInstanced) == 0);
+	CHECK(list.GetSkippedCount(RenderCommandType::Count) == 0);
+}
+
+TEST_CASE(RenderCommandList, DescriptorHeaps)
+{
+	RenderCommandList list;
+	void *one[] = { &heapA };
+	void *two[] = { &heapA, &heapB };
+	void *swapped[] = { &heapB, &heapA };
+
+	list.SetDescriptorHeaps(1, one);
+	list.SetDescriptorHeaps(1, one);
+	CHECK(list.GetSkippedCount(RenderCommandType::SetDescriptorHeaps) == 1);
+
+	//Same first heap, different count / order: recorded
+	list.SetDescriptorHeaps(2, two);
+	list.SetDescriptorHeaps(2, two);
+	list.SetDescriptorHeaps(2, swapped);
+	list.SetDescriptorHeaps(1, one);
+	CHECK(list.GetSkippedCount(RenderCommandType::SetDescriptorHeaps) == 2);
+	CHECK(CountType(list, RenderCommandType::SetDescriptorHeaps) == 4);
+
+	//D3D12 signature (ID3D12DescriptorHeap *const *)
+	int *typed[] = { &heapA };
+	list.SetDescriptorHeaps(1, typed);
+	CHECK(list.GetSkippedCount(RenderCommandType::SetDescriptorHeaps) == 3);
+}
+
+TEST_CASE(RenderCommandList, VertexSlots)
+{
+	RenderCommandList list;
+	const RenderVertexBufferView a = { 0x1000, 96, 32 };
+	const RenderVertexBufferView b = { 0x1000, 96, 16 };
+
+	//Per slot, whole view compared
+	list.IASetVertexBuffer(0, a);
+	list.IASetVertexBuffer(0, a);
+	list.IASetVertexBuffer(1, a);
+	list.IASetVertexBuffer(0, b);
+	CHECK(list.GetSkippedCount(RenderCommandType::IASetVertexBuffer) == 1);
+	CHECK(CountType(list, RenderCommandType::IASetVertexBuffer) == 3);
+
+	//Slots past the tracked ones are always recorded
+	list.IASetVertexBuffer(7, a);
+	list.IASetVertexBuffer(7, a);
+	list.IASetVertexBuffer(8, a);
+	list.IASetVertexBuffer(8, a);
+	list.IASetVertexBuffer(31, a);
+	list.IASetVertexBuffer(31, a);
+	CHECK(list.GetSkippedCount(RenderCommandType::IASetVertexBuffer) == 2);
+	CHECK(CountType(list, RenderCommandType::IASetVertexBuffer) == 8);
+}
+
+TEST_CASE(RenderCommandList, ResetForgetsState)
+{
+	RenderCommandList list;
+	void *heaps[] = { &heapA };
+	list.SetPipelineState(&pipelineA);
+	list.SetPipelineState(&pipelineA);
+	list.SetDescriptorHeaps(1, heaps);
+	CHECK(list.GetSkippedCount() == 1);
+
+	//New frame, new D3D12 list: the first sets are recorded again, counts restart
+	list.Reset();
+	CHECK(list.GetSkippedCount() == 0);
+	CHECK(list.GetSkippedCount(RenderCommandType::SetPipelineState) == 0);
+	list.SetPipelineState(&pipelineA);
+	list.SetDescriptorHeaps(1, heaps);
+	CHECK(list.GetCommandCount() == 2);
+	CHECK(list.GetSkippedCount() == 0);
+}
+
+TEST_CASE(RenderCommandList, ParallelListsForgetsState)
+{
+	RenderCommandList list;
+	list.SetPipelineState(&pipelineA);
+	list.IASetVertexBuffer(0, { 0x1000, 96, 32 });
+
+	//Commands after the split replay into a new D3D12 list
+	list.ParallelLists(0, 1);
+	list.SetPipelineState(&pipelineA);
+	list.IASetVertexBuffer(0, { 0x1000, 96, 32 });
+	CHECK(list.GetSkippedCount() == 0);
+	CHECK(CountType(list, RenderCommandType::SetPipelineState) == 2);
+
+	//Counts of the list are kept (only Reset clears them)
+	list.SetPipelineState(&pipelineA);
+	CHECK(list.GetSkippedCount() == 1);
+}
+
+TEST_CASE(RenderCommandList, FilteringOff)
+{
+	RenderCommandList list;
+	list.SetStateFiltering(false);
+	void *heaps[] = { &heapA };
+	for (int i = 0; i < 2; ++i) {
+		list.SetPipelineState(&pipelineA);
+		list.SetGraphicsRootSignature(&rootSignature);
+		list.SetDescriptorHeaps(1, heaps);
+		list.IASetPrimitiveTopology(4);
+		list.IASetVertexBuffer(0, { 0x1000, 96, 32 });
+	}
+	CHECK(list.GetCommandCount() == 10);
+	CHECK(list.GetSkippedCount() == 0);
+
+	//Turning it back on compares against what was recorded meanwhile
+	list.SetStateFiltering(true);
+	list.SetPipelineState(&pipelineA);
+	list.IASetPrimitiveTopology(4);
+	CHECK(list.GetSkippedCount() == 2);
+	CHECK(list.GetCommandCount() == 10);
+}
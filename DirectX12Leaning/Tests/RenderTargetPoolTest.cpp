@@ -0,0 +1,133 @@
+//STL
+#include <vector>
+
+//Utility
+#include "RenderTargetPool.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	struct FakeTarget
+	{
+		RenderTargetDesc desc;
+	};
+
+	//Pool of FakeTarget, 4 bytes per pixel, counts live targets
+	struct FakePool
+	{
+		RenderTargetPool<FakeTarget> pool;
+		int liveTargets = 0;
+
+		FakePool()
+		{
+			pool.Initialize(
+				[this](const RenderTargetDesc &desc, uint64_t &sizeInBytes) {
+					sizeInBytes = uint64_t(desc.width) * desc.height * 4;
+					++liveTargets;
+					return new FakeTarget{ desc };
+				},
+				[this](FakeTarget *target) {
+					--liveTargets;
+					delete target;
+				});
+		}
+	};
+
+	const RenderTargetDesc sceneColor = { 1280, 720, 28, 0 };
+	const RenderTargetDesc sceneDepth = { 1280, 720, 40, 1 };
+	const RenderTargetDesc bloom = { 640, 360, 28, 0 };
+}
+
+TEST_CASE(RenderTargetPool, ReleasedTargetWaitsForFence)
+{
+	FakePool fake;
+	FakeTarget *first = fake.pool.Acquire(sceneColor);
+	fake.pool.Release(first);
+
+	//Same frame: the GPU may still render into it
+	FakeTarget *second = fake.pool.Acquire(sceneColor);
+	CHECK(second != first);
+	CHECK(fake.pool.GetCreateCount() == 2);
+
+	fake.pool.EndFrame(1);
+	fake.pool.Retire(0);
+	CHECK(fake.pool.Acquire(sceneColor) != first);
+
+	fake.pool.Retire(1);
+	CHECK(fake.pool.Acquire(sceneColor) == first);
+	CHECK(fake.pool.GetReuseCount() == 1);
+}
+
+TEST_CASE(RenderTargetPool, MatchesWholeDesc)
+{
+	FakePool fake;
+	FakeTarget *color = fake.pool.Acquire(sceneColor);
+	fake.pool.Release(color);
+	fake.pool.EndFrame(1);
+	fake.pool.Retire(1);
+
+	//Same size, other format / flags: not interchangeable
+	RenderTargetDesc otherFormat = sceneColor;
+	otherFormat.format = 87;
+	RenderTargetDesc otherFlags = sceneColor;
+	otherFlags.flags = 2;
+	CHECK(fake.pool.Acquire(otherFormat) != color);
+	CHECK(fake.pool.Acquire(otherFlags) != color);
+	CHECK(fake.pool.Acquire(sceneColor) == color);
+}
+
+TEST_CASE(RenderTargetPool, MemoryConstantOverFrames)
+{
+	FakePool fake;
+	const uint64_t frameBytes = (1280 * 720 + 1280 * 720 + 640 * 360) * 4;
+
+	//Two frames in flight: frame f retires when f + 2 starts
+	uint64_t bytesAfterWarmup = 0;
+	for (uint64_t frame = 1; frame <= 200; ++frame) {
+		if (frame > 2) {
+			fake.pool.Retire(frame - 2);
+		}
+
+		FakeTarget *color = fake.pool.Acquire(sceneColor);
+		FakeTarget *depth = fake.pool.Acquire(sceneDepth);
+		FakeTarget *blur = fake.pool.Acquire(bloom);
+		fake.pool.Release(blur);
+		fake.pool.Release(depth);
+		fake.pool.Release(color);
+		fake.pool.EndFrame(frame);
+
+		if (frame == 2) {
+			bytesAfterWarmup = fake.pool.GetAllocatedBytes();
+		}
+		if (frame > 2) {
+			CHECK(fake.pool.GetAllocatedBytes() == bytesAfterWarmup);
+		}
+	}
+
+	//One set for the frame being recorded, one for the frame on the GPU, never more
+	CHECK(bytesAfterWarmup == frameBytes * 2);
+	CHECK(fake.pool.GetTargetCount() == 6);
+	CHECK(fake.pool.GetCreateCount() == 6);
+	CHECK(fake.pool.GetReuseCount() == 200 * 3 - 6);
+	CHECK(fake.liveTargets == 6);
+}
+
+TEST_CASE(RenderTargetPool, ClearDestroysEverything)
+{
+	FakePool fake;
+	fake.pool.Acquire(sceneColor);
+	fake.pool.Release(fake.pool.Acquire(bloom));
+
+	fake.pool.Clear();
+	CHECK(fake.liveTargets == 0);
+	CHECK(fake.pool.GetTargetCount() == 0);
+	CHECK(fake.pool.GetAllocatedBytes() == 0);
+
+	//Pending releases went with it
+	fake.pool.EndFrame(1);
+	fake.pool.Retire(1);
+	fake.pool.Acquire(bloom);
+	CHECK(fake.pool.GetCreateCount() == 3);
+}
@@ -0,0 +1,140 @@
+//STL
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//Utility
+#include "ShaderSource.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Scratch directories created by CMakeLists.txt (working directory = build directory)
+	const std::string sourceDirectory = "TestData/Shaders";
+	const std::string copyDirectory = "TestData/Shaders/source";
+
+	void WriteText(const std::string &path, const std::string &text)
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << text;
+	}
+
+	const std::string vsPath = sourceDirectory + "/TestVS.hlsl";
+	const std::string includePath = sourceDirectory + "/Test.hlsli";
+
+	//Source + include and their build copies
+	void WriteShaders()
+	{
+		WriteText(vsPath, "#include \"Test.hlsli\"\nfloat4 main(float4 pos : POSITION) : SV_POSITION { return pos * scale; }\n");
+		WriteText(includePath, "static const float scale = 2;\n");
+		WriteText(copyDirectory + "/TestVS.hlsl", "#include \"Test.hlsli\"\nfloat4 main(float4 pos : POSITION) : SV_POSITION { return pos * scale; }\n");
+		WriteText(copyDirectory + "/Test.hlsli", "static const float scale = 2;\n");
+	}
+
+	uint64_t SourceHash(std::vector<std::string> &files)
+	{
+		CacheKey key;
+		files.clear();
+		WriteShaderSource(key, vsPath, files);
+		return key.GetHash();
+	}
+}
+
+TEST_CASE(ShaderSource, IncludesAreRead)
+{
+	WriteShaders();
+
+	CacheKey key;
+	std::vector<std::string> files;
+	REQUIRE(WriteShaderSource(key, vsPath, files));
+	REQUIRE(files.size() == 2);
+	CHECK(files[0] == vsPath);
+	CHECK(files[1] == includePath);
+}
+
+TEST_CASE(ShaderSource, MissingFile)
+{
+	CacheKey key;
+	std::vector<std::string> files;
+	CHECK(!WriteShaderSource(key, sourceDirectory + "/Missing.hlsl", files));
+}
+
+TEST_CASE(ShaderSource, IncludeContentChangesKey)
+{
+	WriteShaders();
+	std::vector<std::string> files;
+	const uint64_t before = SourceHash(files);
+	CHECK(SourceHash(files) == before);
+
+	WriteText(includePath, "static const float scale = 3;\n");
+	CHECK(SourceHash(files) != before);
+}
+
+TEST_CASE(ShaderSource, OptionsChangeKey)
+{
+	CacheKey base;
+	WriteShaderOptions(base, "main", "vs_5_0", {}, 0);
+
+	CacheKey flags;
+	WriteShaderOptions(flags, "main", "vs_5_0", {}, 1);
+	CacheKey target;
+	WriteShaderOptions(target, "main", "vs_5_1", {}, 0);
+	CacheKey define;
+	WriteShaderOptions(define, "main", "vs_5_0", { { "INSTANCED", "1" } }, 0);
+
+	CHECK(flags != base);
+	CHECK(target != base);
+	CHECK(define != base);
+}
+
+TEST_CASE(ShaderSource, SourcesMatchBuildCopy)
+{
+	WriteShaders();
+	std::vector<std::string> files;
+	SourceHash(files);
+	CHECK(ShaderSourcesMatch(files, copyDirectory));
+
+	//Include edited after the build: the .cso is stale whatever the file times say
+	WriteText(includePath, "static const float scale = 4;\n");
+	CHECK(!ShaderSourcesMatch(files, copyDirectory));
+
+	//Copy missing
+	WriteShaders();
+	std::remove((copyDirectory + "/Test.hlsli").c_str());
+	CHECK(!ShaderSourcesMatch(files, copyDirectory));
+}
+
+TEST_CASE(ShaderSource, FileNames)
+{
+	CHECK(ShaderFileStem("Shaders/BasicVS3D.hlsl") == "BasicVS3D");
+	CHECK(ShaderFileStem("BasicVS3D") == "BasicVS3D");
+	CHECK(ShaderCacheFileName("Shaders\\SpriteVS.hlsl", 0x0123456789abcdefull) == "SpriteVS_0123456789abcdef.cso");
+}
+
+TEST_CASE(ShaderSource, PrecompiledOptions)
+{
+	//Debug and Release lines as CopyShaderSources writes them
+	std::unordered_map<std::string, PrecompiledShaderOptions> options;
+	REQUIRE(ParsePrecompiledOptions("BasicVS|true|true|\r\nSpritePS|||/O3 \n\n", options));
+	REQUIRE(options.size() == 2);
+
+	CHECK(options["BasicVS"].debugInfo);
+	CHECK(options["BasicVS"].skipOptimization);
+	CHECK(options["BasicVS"].optimizationLevel == 1);
+
+	CHECK(!options["SpritePS"].debugInfo);
+	CHECK(!options["SpritePS"].skipOptimization);
+	CHECK(options["SpritePS"].optimizationLevel == 3);
+
+	//Switches in the additional options count too
+	REQUIRE(ParsePrecompiledOptions("Graph2DVS|false||/Zi /Od /O0", options));
+	CHECK(options["Graph2DVS"].debugInfo);
+	CHECK(options["Graph2DVS"].skipOptimization);
+	CHECK(options["Graph2DVS"].optimizationLevel == 0);
+
+	CHECK(!ParsePrecompiledOptions("BasicPS|true", options));
+	CHECK(!ParsePrecompiledOptions("|true|true|", options));
+}
@@ -0,0 +1,162 @@
+//STL
+#include <vector>
+
+//Utility
+#include "SpriteBatch.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	Sprite MakeSprite(const uint32_t layer, const uint32_t pipeline, const uint32_t texture, const float x)
+	{
+		Sprite sprite;
+		sprite.layer = layer;
+		sprite.pipeline = pipeline;
+		sprite.texture = texture;
+		sprite.x = x;
+		sprite.y = 0;
+		sprite.width = 1;
+		sprite.height = 1;
+		return sprite;
+	}
+}
+
+TEST_CASE(SpriteBatch, EmptyBatch)
+{
+	SpriteBatch batch(4);
+	batch.Begin();
+
+	CHECK(batch.End(nullptr) == 0);
+	CHECK(batch.GetDrawCalls().empty());
+	CHECK(batch.GetSpriteCount() == 0);
+}
+
+TEST_CASE(SpriteBatch, QuadVertices)
+{
+	SpriteBatch batch(1);
+	batch.Begin();
+
+	Sprite sprite;
+	sprite.x = 10;
+	sprite.y = 20;
+	sprite.width = 4;
+	sprite.height = 8;
+	sprite.uv[0] = 0.25f;
+	sprite.uv[1] = 0.5f;
+	sprite.uv[2] = 0.75f;
+	sprite.uv[3] = 1.0f;
+	sprite.color[0] = 0.5f;
+	REQUIRE(batch.Draw(sprite));
+
+	SpriteVertex vertices[4];
+	REQUIRE(batch.End(vertices) == 1);
+
+	//Top left, top right, bottom left, bottom right
+	const float expected[4][4] = {
+		{ 10, 20, 0.25f, 0.5f },
+		{ 14, 20, 0.75f, 0.5f },
+		{ 10, 28, 0.25f, 1.0f },
+		{ 14, 28, 0.75f, 1.0f },
+	};
+	for (int i = 0; i < 4; ++i) {
+		CHECK(vertices[i].pos[0] == expected[i][0]);
+		CHECK(vertices[i].pos[1] == expected[i][1]);
+		CHECK(vertices[i].pos[2] == 0.0f);
+		CHECK(vertices[i].uv[0] == expected[i][2]);
+		CHECK(vertices[i].uv[1] == expected[i][3]);
+		CHECK(vertices[i].color[0] == 0.5f);
+		CHECK(vertices[i].color[3] == 1.0f);
+	}
+}
+
+TEST_CASE(SpriteBatch, SortAndMerge)
+{
+	SpriteBatch batch(8);
+	batch.Begin();
+
+	//Submission order mixes layers and textures
+	batch.Draw(MakeSprite(1, 0, 7, 0));
+	batch.Draw(MakeSprite(0, 0, 3, 1));
+	batch.Draw(MakeSprite(0, 1, 3, 2));
+	batch.Draw(MakeSprite(0, 0, 3, 3));
+	batch.Draw(MakeSprite(1, 0, 7, 4));
+	batch.Draw(MakeSprite(0, 0, 5, 5));
+
+	std::vector<SpriteVertex> vertices(batch.GetSpriteCount() * 4);
+	REQUIRE(batch.End(vertices.data()) == 6);
+
+	//Layer, then pipeline, then texture, then submission order
+	const float order[] = { 1, 3, 5, 2, 0, 4 };
+	for (int i = 0; i < 6; ++i) {
+		CHECK(vertices[i * 4].pos[0] == order[i]);
+	}
+
+	const auto &draws = batch.GetDrawCalls();
+	REQUIRE(draws.size() == 4);
+	const SpriteDrawCall expected[] = {
+		{ 0, 3, 0, 2 },
+		{ 0, 5, 2, 1 },
+		{ 1, 3, 3, 1 },
+		{ 0, 7, 4, 2 },
+	};
+	for (int i = 0; i < 4; ++i) {
+		CHECK(draws[i].pipeline == expected[i].pipeline);
+		CHECK(draws[i].texture == expected[i].texture);
+		CHECK(draws[i].firstSprite == expected[i].firstSprite);
+		CHECK(draws[i].spriteCount == expected[i].spriteCount);
+	}
+}
+
+TEST_CASE(SpriteBatch, Capacity)
+{
+	SpriteBatch batch(2);
+	batch.Begin();
+
+	CHECK(batch.Draw(MakeSprite(0, 0, 0, 0)));
+	CHECK(batch.Draw(MakeSprite(0, 0, 0, 1)));
+	CHECK(!batch.Draw(MakeSprite(0, 0, 0, 2)));
+	CHECK(batch.GetSpriteCount() == 2);
+
+	//Begin empties it again
+	batch.Begin();
+	CHECK(batch.Draw(MakeSprite(0, 0, 0, 3)));
+	CHECK(batch.GetSpriteCount() == 1);
+}
+
+TEST_CASE(SpriteBatch, PartialEnd)
+{
+	SpriteBatch batch(4);
+	batch.Begin();
+	batch.Draw(MakeSprite(2, 0, 1, 0));
+	batch.Draw(MakeSprite(0, 0, 1, 1));
+	batch.Draw(MakeSprite(1, 0, 2, 2));
+	batch.Draw(MakeSprite(0, 0, 1, 3));
+
+	//Room for 3: the last sprite in sort order is left out, nothing is written past the room
+	std::vector<SpriteVertex> vertices(4 * 4);
+	vertices[12].pos[0] = -1;
+	REQUIRE(batch.End(vertices.data(), 3) == 3);
+	CHECK(vertices[0].pos[0] == 1);
+	CHECK(vertices[4].pos[0] == 3);
+	CHECK(vertices[8].pos[0] == 2);
+	CHECK(vertices[12].pos[0] == -1);
+
+	const auto &draws = batch.GetDrawCalls();
+	REQUIRE(draws.size() == 2);
+	CHECK(draws[0].spriteCount == 2);
+	CHECK(draws[1].texture == 2);
+	CHECK(draws[1].firstSprite + draws[1].spriteCount == 3);
+}
+
+TEST_CASE(SpriteBatch, QuadIndices)
+{
+	const std::vector<uint16_t> indices = SpriteBatch::CreateQuadIndices(2);
+	const uint16_t expected[] = { 0, 1, 2, 2, 1, 3, 4, 5, 6, 6, 5, 7 };
+
+	REQUIRE(indices.size() == 12);
+	for (int i = 0; i < 12; ++i) {
+		CHECK(indices[i] == expected[i]);
+	}
+}
@@ -0,0 +1,54 @@
+//STL
+#include <cstring>
+
+//Utility
+#include "CacheKey.h"
+#include "StateHash.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	struct Padded
+	{
+		uint8_t a;
+		uint32_t b;
+	};
+}
+
+TEST_CASE(StateHash, MatchesCacheKey)
+{
+	//Same FNV-1a as every content key
+	StateHash empty;
+	CHECK(empty.Get() == fnvOffsetBasis);
+
+	const char text[] = "replay";
+	StateHash hash;
+	hash.Write(text, 3);
+	hash.Write(text + 3, 3);
+	CHECK(hash.Get() == HashBytes(text, 6));
+
+	CacheKey key;
+	key.Write(text, 6);
+	CHECK(hash.Get() == key.GetHash());
+}
+
+TEST_CASE(StateHash, FieldsIgnorePadding)
+{
+	Padded a, b;
+	memset(&a, 0x00, sizeof(a));
+	memset(&b, 0xff, sizeof(b));
+	a.a = b.a = 1;
+	a.b = b.b = 2;
+
+	StateHash ha, hb;
+	ha.WriteValue(a.a);
+	ha.WriteValue(a.b);
+	hb.WriteValue(b.a);
+	hb.WriteValue(b.b);
+	CHECK(ha.Get() == hb.Get());
+
+	hb.WriteValue(b.b);
+	CHECK(ha.Get() != hb.Get());
+}
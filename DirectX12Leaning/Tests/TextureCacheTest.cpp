@@ -0,0 +1,244 @@
+//STL
+#include <string>
+#include <vector>
+
+//Utility
+#include "TextureCache.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//Single level RGBA8 image of size bytes
+	TextureDesc Desc(const uint64_t size)
+	{
+		return { 16, (uint32_t)(size / 64), ImageFormat_RGBA8, 1, size };
+	}
+
+	//Acquire + bind + upload of a file whose content is hash
+	TextureHandle Load(TextureCache &cache, const std::string &path, const uint64_t hash, const uint64_t size)
+	{
+		bool loadRequired = false;
+		const TextureHandle handle = cache.Acquire(path, loadRequired);
+		if (loadRequired) {
+			uint32_t content;
+			if (!cache.BindContent(handle, hash, Desc(size), size, content)) {
+				cache.MarkResident(content);
+			}
+		}
+		return handle;
+	}
+}
+
+TEST_CASE(TextureCache, CanonicalPath)
+{
+	CHECK(CanonicalTexturePath("Resources\\Tex\\A.PNG") == "resources/tex/a.png");
+	CHECK(CanonicalTexturePath("./a//b/../c.tga") == "a/c.tga");
+	CHECK(CanonicalTexturePath("../shared/x.dds") == "../shared/x.dds");
+	CHECK(CanonicalTexturePath("/a/../../b.dds") == "/b.dds");
+}
+
+TEST_CASE(TextureCache, RefCountAndCounters)
+{
+	TextureCache cache(1024);
+
+	bool loadRequired = false;
+	const TextureHandle handle = cache.Acquire("a.tga", loadRequired);
+	CHECK(loadRequired);
+	CHECK(cache.GetContent(handle) == TextureCache::invalidContent);
+
+	uint32_t content;
+	CHECK(!cache.BindContent(handle, 1, Desc(100), 100, content));
+	cache.MarkResident(content);
+	CHECK(cache.GetContent(handle) == content);
+
+	CHECK(cache.Acquire("a.tga", loadRequired) == handle);
+	CHECK(!loadRequired);
+	cache.AddRef(handle);
+	CHECK(cache.GetRefCount(handle) == 3);
+	CHECK(cache.GetHitCount() == 1);
+	CHECK(cache.GetMissCount() == 1);
+
+	//Unreferenced stays resident and is found again without loading
+	cache.Release(handle);
+	cache.Release(handle);
+	cache.Release(handle);
+	cache.Release(invalidTextureHandle);
+	CHECK(cache.GetRefCount(handle) == 0);
+	CHECK(cache.GetResidentBytes() == 100);
+
+	CHECK(cache.Acquire("a.tga", loadRequired) == handle);
+	CHECK(!loadRequired);
+	CHECK(cache.GetHitCount() == 2);
+	CHECK(cache.GetMissCount() == 1);
+}
+
+TEST_CASE(TextureCache, SharedContent)
+{
+	TextureCache cache(1024);
+	const TextureHandle a = Load(cache, "a.tga", 7, 100);
+
+	//Different path, same texels: nothing new to upload
+	bool loadRequired = false;
+	const TextureHandle b = cache.Acquire("copy/a.tga", loadRequired);
+	REQUIRE(loadRequired);
+	uint32_t content;
+	CHECK(cache.BindContent(b, 7, Desc(100), 100, content));
+	CHECK(content == cache.GetContent(a));
+	CHECK(cache.GetSharedCount() == 1);
+	CHECK(cache.GetTextureCount() == 1);
+	CHECK(cache.GetResidentBytes() == 100);
+
+	//Still referenced through b
+	cache.Release(a);
+	std::vector<uint32_t> evicted;
+	cache.SetBudget(0);
+	CHECK(cache.Evict(evicted) == 0);
+
+	//Both paths leave with the content
+	cache.Release(b);
+	CHECK(cache.Evict(evicted) == 1);
+	CHECK(cache.GetTextureCount() == 0);
+	CHECK(cache.Acquire("a.tga", loadRequired) != invalidTextureHandle);
+	CHECK(loadRequired);
+}
+
+TEST_CASE(TextureCache, HashCollision)
+{
+	TextureCache cache(1024);
+	const TextureHandle a = Load(cache, "a.tga", 7, 128);
+
+	//Same hash, other size / format / mips: a separate texture
+	TextureDesc other[4] = { Desc(128), Desc(128), Desc(128), Desc(128) };
+	other[0].width = 32;
+	other[1].format = ImageFormat_BGRA8;
+	other[2].mipCount = 2;
+	other[3].pixelBytes = 256;
+
+	std::vector<TextureHandle> handles;
+	for (int i = 0; i < 4; ++i) {
+		bool loadRequired = false;
+		const TextureHandle handle = cache.Acquire("other" + std::to_string(i) + ".tga", loadRequired);
+		REQUIRE(loadRequired);
+		uint32_t content;
+		CHECK(!cache.BindContent(handle, 7, other[i], 128, content));
+		CHECK(content != cache.GetContent(a));
+		cache.MarkResident(content);
+		handles.push_back(handle);
+	}
+
+	//Same description, other video memory size
+	bool loadRequired = false;
+	const TextureHandle padded = cache.Acquire("padded.tga", loadRequired);
+	uint32_t content;
+	CHECK(!cache.BindContent(padded, 7, Desc(128), 192, content));
+	cache.MarkResident(content);
+
+	CHECK(cache.GetCollisionCount() == 5);
+	CHECK(cache.GetSharedCount() == 0);
+	CHECK(cache.GetTextureCount() == 6);
+
+	//Evicting a colliding texture keeps the hash pointing at the first one
+	cache.Release(handles[0]);
+	std::vector<uint32_t> evicted;
+	cache.SetBudget(cache.GetResidentBytes() - 1);
+	CHECK(cache.Evict(evicted) == 1);
+
+	const TextureHandle copy = cache.Acquire("copy/a.tga", loadRequired);
+	CHECK(cache.BindContent(copy, 7, Desc(128), 128, content));
+	CHECK(content == cache.GetContent(a));
+}
+
+TEST_CASE(TextureCache, DescribeTexture)
+{
+	DecodedImage image;
+	image.width = 8;
+	image.height = 4;
+	image.format = ImageFormat_RGBA8;
+	AppendImageMip(image, 8, 4);
+	AppendImageMip(image, 4, 2);
+
+	const TextureDesc desc = DescribeTexture(ViewImage(image));
+	CHECK(desc.width == 8);
+	CHECK(desc.height == 4);
+	CHECK(desc.format == ImageFormat_RGBA8);
+	CHECK(desc.mipCount == 2);
+	CHECK(desc.pixelBytes == image.pixels.size());
+	CHECK(desc.pixelBytes == 8 * 4 * 4 + 4 * 2 * 4);
+}
+
+TEST_CASE(TextureCache, EvictLeastRecentlyUsed)
+{
+	TextureCache cache(300);
+	const TextureHandle a = Load(cache, "a.tga", 1, 100);
+	const TextureHandle b = Load(cache, "b.tga", 2, 100);
+	const TextureHandle c = Load(cache, "c.tga", 3, 100);
+	const uint32_t contentB = cache.GetContent(b);
+	const uint32_t contentC = cache.GetContent(c);
+
+	//Released order: b, c, a
+	cache.Release(b);
+	cache.Release(c);
+	cache.Release(a);
+
+	//Within budget: nothing leaves
+	std::vector<uint32_t> evicted;
+	CHECK(cache.Evict(evicted) == 0);
+
+	//a is used again, d pushes the cache over budget by two textures
+	bool loadRequired = false;
+	cache.Acquire("a.tga", loadRequired);
+	Load(cache, "d.tga", 4, 200);
+	CHECK(cache.GetResidentBytes() == 500);
+
+	CHECK(cache.Evict(evicted) == 2);
+	REQUIRE(evicted.size() == 2);
+	CHECK(evicted[0] == contentB);
+	CHECK(evicted[1] == contentC);
+	CHECK(cache.GetResidentBytes() == 300);
+	CHECK(cache.GetEvictionCount() == 2);
+	CHECK(cache.GetContent(a) != TextureCache::invalidContent);
+
+	//Evicted path loads again
+	cache.Acquire("b.tga", loadRequired);
+	CHECK(loadRequired);
+}
+
+TEST_CASE(TextureCache, EvictSkipsUploading)
+{
+	TextureCache cache(0);
+
+	//Bound but still on the copy queue
+	bool loadRequired = false;
+	const TextureHandle handle = cache.Acquire("a.tga", loadRequired);
+	uint32_t content;
+	cache.BindContent(handle, 1, Desc(100), 100, content);
+	cache.Release(handle);
+
+	std::vector<uint32_t> evicted;
+	CHECK(cache.Evict(evicted) == 0);
+
+	cache.MarkResident(content);
+	CHECK(cache.Evict(evicted) == 1);
+	CHECK(cache.GetResidentBytes() == 0);
+}
+
+TEST_CASE(TextureCache, FailedRetries)
+{
+	TextureCache cache(1024);
+
+	bool loadRequired = false;
+	const TextureHandle handle = cache.Acquire("missing.tga", loadRequired);
+	cache.MarkFailed(handle);
+	CHECK(cache.IsFailed(handle));
+	CHECK(cache.GetContent(handle) == TextureCache::invalidContent);
+
+	//Failed entries are not cached once released
+	cache.Release(handle);
+	CHECK(!cache.IsFailed(handle));
+	cache.Acquire("missing.tga", loadRequired);
+	CHECK(loadRequired);
+	CHECK(cache.GetMissCount() == 2);
+	CHECK(cache.GetResidentBytes() == 0);
+}
@@ -0,0 +1,109 @@
+//STL
+#include <vector>
+
+//Utility
+#include "TextureLayout.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	DecodedImage MakeImage(const uint32_t format, const std::vector<uint32_t> &sizes)
+	{
+		DecodedImage image;
+		image.width = sizes[0];
+		image.height = sizes[1];
+		image.format = format;
+		for (size_t i = 0; i + 1 < sizes.size(); i += 2) {
+			AppendImageMip(image, sizes[i], sizes[i + 1]);
+		}
+
+		//Texel byte = its own index, to follow rows through the copy
+		for (size_t i = 0; i < image.pixels.size(); ++i) {
+			image.pixels[i] = (uint8_t)i;
+		}
+		return image;
+	}
+}
+
+TEST_CASE(TextureLayout, UncompressedPitch)
+{
+	//400 byte rows pad to 512, the next level starts placement aligned
+	const DecodedImage image = MakeImage(ImageFormat_RGBA8, { 100, 3, 50, 1, 1, 1 });
+
+	std::vector<UploadSubresource> layout;
+	const uint64_t size = ComputeUploadLayout(ViewImage(image), layout);
+	REQUIRE(layout.size() == 3);
+
+	CHECK(layout[0].offset == 0);
+	CHECK(layout[0].rowSize == 400);
+	CHECK(layout[0].rowPitch == 512);
+	CHECK(layout[0].rowCount == 3);
+	CHECK(layout[0].width == 100);
+	CHECK(layout[0].height == 3);
+
+	//Last row unpadded: 512 * 2 + 400 = 1424
+	CHECK(layout[1].offset == 1536);
+	CHECK(layout[1].rowSize == 200);
+	CHECK(layout[1].rowPitch == 256);
+
+	CHECK(layout[2].offset == 2048);
+	CHECK(layout[2].rowSize == 4);
+	CHECK(layout[2].rowPitch == 256);
+	CHECK(size == 2048 + 4);
+
+	for (auto &subresource : layout) {
+		CHECK(subresource.offset % uploadPlacementAlignment == 0);
+		CHECK(subresource.rowPitch % uploadPitchAlignment == 0);
+	}
+}
+
+TEST_CASE(TextureLayout, BlockCompressed)
+{
+	//10x6 BC1: 3x2 blocks of 8 bytes, dimensions padded to whole blocks
+	const DecodedImage image = MakeImage(ImageFormat_BC1, { 10, 6, 5, 3, 2, 1, 1, 1 });
+
+	std::vector<UploadSubresource> layout;
+	const uint64_t size = ComputeUploadLayout(ViewImage(image), layout);
+	REQUIRE(layout.size() == 4);
+
+	CHECK(layout[0].width == 12);
+	CHECK(layout[0].height == 8);
+	CHECK(layout[0].rowSize == 24);
+	CHECK(layout[0].rowCount == 2);
+	CHECK(layout[0].rowPitch == 256);
+
+	CHECK(layout[1].offset == 512);
+	CHECK(layout[1].width == 8);
+	CHECK(layout[1].height == 4);
+	CHECK(layout[1].rowSize == 16);
+	CHECK(layout[1].rowCount == 1);
+
+	//Mips below one block still take a whole block
+	CHECK(layout[3].offset == 1536);
+	CHECK(layout[3].width == 4);
+	CHECK(layout[3].rowSize == 8);
+	CHECK(size == 1536 + 8);
+}
+
+TEST_CASE(TextureLayout, WriteUploadData)
+{
+	const DecodedImage image = MakeImage(ImageFormat_RGBA8, { 3, 2, 1, 1 });
+
+	std::vector<UploadSubresource> layout;
+	std::vector<uint8_t> upload((size_t)ComputeUploadLayout(ViewImage(image), layout), 0xcd);
+	WriteUploadData(ViewImage(image), layout, upload.data());
+
+	//Rows land at rowPitch, padding is untouched
+	for (uint32_t row = 0; row < 2; ++row) {
+		for (uint32_t i = 0; i < 12; ++i) {
+			CHECK(upload[row * 256 + i] == (uint8_t)(row * 12 + i));
+		}
+	}
+	CHECK(upload[12] == 0xcd);
+	CHECK(upload[255] == 0xcd);
+
+	REQUIRE(upload.size() == layout[1].offset + 4);
+	CHECK(upload[layout[1].offset] == (uint8_t)image.mips[1].offset);
+}
@@ -0,0 +1,175 @@
+//STL
+#include <atomic>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+//Utility
+#include "TextureLoader.h"
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	//1x1 image whose texel is the path length, "bad" paths fail
+	bool FakeDecode(const std::string &path, DecodedImage &image)
+	{
+		if (path.compare(0, 3, "bad") == 0) {
+			return false;
+		}
+		image = DecodedImage();
+		image.width = 1;
+		image.height = 1;
+		image.format = ImageFormat_RGBA8;
+		AppendImageMip(image, 1, 1);
+		image.pixels[0] = (uint8_t)path.size();
+		return true;
+	}
+
+	//Holds every decode until Open, to look at the queue
+	struct Gate
+	{
+		std::mutex mutex;
+		std::condition_variable opened;
+		bool open = false;
+		std::atomic<int> entered{ 0 };
+
+		void Open()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				open = true;
+			}
+			opened.notify_all();
+		}
+
+		void Wait()
+		{
+			++entered;
+			std::unique_lock<std::mutex> lock(mutex);
+			opened.wait(lock, [this] { return open; });
+		}
+	};
+}
+
+TEST_CASE(TextureLoader, WorkerCount)
+{
+	TextureLoader fixed(FakeDecode, 3);
+	CHECK(fixed.GetWorkerCount() == 3);
+
+	//0 = hardware threads - 1, at least one whatever the platform reports
+	TextureLoader automatic(FakeDecode);
+	CHECK(automatic.GetWorkerCount() >= 1);
+	CHECK(automatic.GetWorkerCount() < 1024);
+}
+
+TEST_CASE(TextureLoader, DecodeAndHandoff)
+{
+	TextureLoader loader(FakeDecode, 2);
+
+	const TextureHandle a = loader.Request("a.tga");
+	const TextureHandle b = loader.Request("bb.tga");
+	const TextureHandle bad = loader.Request("bad.tga");
+	CHECK(a != b);
+	CHECK(loader.GetState(a) != TextureState::Ready);
+
+	loader.WaitDecoded();
+	CHECK(loader.GetQueuedCount() == 0);
+	CHECK(loader.GetState(a) == TextureState::Decoded);
+	CHECK(loader.GetState(bad) == TextureState::Failed);
+
+	//Failures are handed over too, so the caller can drop its placeholder
+	std::vector<DecodedTexture> out;
+	CHECK(loader.TakeDecoded(out) == 3);
+	CHECK(loader.TakeDecoded(out) == 0);
+	REQUIRE(out.size() == 3);
+
+	for (auto &texture : out) {
+		if (texture.handle == bad) {
+			CHECK(!texture.succeeded);
+			CHECK(texture.contentHash == 0);
+			continue;
+		}
+		CHECK(texture.succeeded);
+		CHECK(texture.image.pixels[0] == texture.path.size());
+		CHECK(texture.contentHash == HashImage(texture.image));
+	}
+
+	loader.MarkReady(a);
+	loader.MarkReady(bad);
+	CHECK(loader.GetState(a) == TextureState::Ready);
+	CHECK(loader.GetState(bad) == TextureState::Failed);
+	CHECK(loader.GetState(invalidTextureHandle) == TextureState::Failed);
+}
+
+TEST_CASE(TextureLoader, TakeDecodedBudget)
+{
+	TextureLoader loader(FakeDecode, 1);
+	for (int i = 0; i < 5; ++i) {
+		loader.Request("texture.tga");
+	}
+	loader.WaitDecoded();
+
+	std::vector<DecodedTexture> out;
+	CHECK(loader.TakeDecoded(out, 2) == 2);
+	CHECK(loader.TakeDecoded(out, 2) == 2);
+	CHECK(loader.TakeDecoded(out, 2) == 1);
+	CHECK(out.size() == 5);
+}
+
+TEST_CASE(TextureLoader, RequestNeverBlocks)
+{
+	Gate gate;
+	TextureLoader loader([&](const std::string &path, DecodedImage &image) {
+		gate.Wait();
+		return FakeDecode(path, image);
+	}, 1);
+
+	//The only worker is stuck: requests still return at once and queue up
+	const TextureHandle first = loader.Request("a.tga");
+	for (int i = 0; i < 3; ++i) {
+		loader.Request("b.tga");
+	}
+	CHECK(loader.GetQueuedCount() == 4);
+	CHECK(loader.GetState(first) == TextureState::Pending);
+
+	std::vector<DecodedTexture> out;
+	CHECK(loader.TakeDecoded(out) == 0);
+
+	gate.Open();
+	loader.WaitDecoded();
+	CHECK(loader.TakeDecoded(out) == 4);
+	CHECK(out[0].handle == first);
+}
+
+TEST_CASE(TextureLoader, DecodeImageFile)
+{
+	//Real codec through the loader (working directory = build directory)
+	const uint8_t tga[] = {
+		0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 1, 0, 8, 0,
+		200,
+	};
+	{
+		std::ofstream file("TestData/LoaderTest.tga", std::ios::binary);
+		file.write(reinterpret_cast<const char *>(tga), sizeof(tga));
+	}
+
+	TextureLoader loader(DecodeImageFile, 1);
+	const TextureHandle handle = loader.Request("TestData/LoaderTest.tga");
+	const TextureHandle missing = loader.Request("TestData/Missing.tga");
+	loader.WaitDecoded();
+
+	CHECK(loader.GetState(handle) == TextureState::Decoded);
+	CHECK(loader.GetState(missing) == TextureState::Failed);
+
+	std::vector<DecodedTexture> out;
+	REQUIRE(loader.TakeDecoded(out) == 2);
+	for (auto &texture : out) {
+		if (texture.handle == handle) {
+			CHECK(texture.image.pixels[0] == 200);
+			CHECK(texture.image.pixels[3] == 255);
+		}
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstdint>
+
+//Minimal test registry for the headless build (ctest runs one suite per UnitTests call)
+
+typedef void (*UnitTestFunction)();
+
+/// <summary>
+/// Registers a test case before main, TEST_CASE creates one per case
+/// </summary>
+struct UnitTestRegistrar
+{
+	UnitTestRegistrar(const char *suite, const char *name, const UnitTestFunction function);
+};
+
+//Records a failed check of the running case
+void UnitTestFail(const char *file, const int line, const char *expression);
+
+#define TEST_CASE(suite, name) \
+	static void suite##_##name(); \
+	static UnitTestRegistrar suite##_##name##Registrar(#suite, #name, &suite##_##name); \
+	static void suite##_##name()
+
+//Failure is recorded, the case goes on
+#define CHECK(expression) \
+	do { if (!(expression)) { UnitTestFail(__FILE__, __LINE__, #expression); } } while (0)
+
+//Failure ends the case (later checks depend on it)
+#define REQUIRE(expression) \
+	do { if (!(expression)) { UnitTestFail(__FILE__, __LINE__, #expression); return; } } while (0)
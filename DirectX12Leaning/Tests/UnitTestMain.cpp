@@ -0,0 +1,69 @@
+//usage: UnitTests [suite]   (default every suite)
+
+//STL
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+//this
+#include "UnitTest.h"
+
+namespace
+{
+	struct TestCase
+	{
+		const char *suite;
+		const char *name;
+		UnitTestFunction function;
+	};
+
+	//Function local: registrars of other files run before main in any order
+	std::vector<TestCase> &GetCases()
+	{
+		static std::vector<TestCase> cases;
+		return cases;
+	}
+
+	int currentFailures = 0;
+}
+
+UnitTestRegistrar::UnitTestRegistrar(const char *suite, const char *name, const UnitTestFunction function)
+{
+	GetCases().push_back({ suite, name, function });
+}
+
+void UnitTestFail(const char *file, const int line, const char *expression)
+{
+	printf("  %s(%d): CHECK(%s) failed\n", file, line, expression);
+	++currentFailures;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *suite = argc > 1 ? argv[1] : nullptr;
+
+	int run = 0, failed = 0;
+	for (auto &testCase : GetCases()) {
+		if (suite != nullptr && std::strcmp(suite, testCase.suite) != 0) {
+			continue;
+		}
+
+		currentFailures = 0;
+		testCase.function();
+		++run;
+
+		printf("%s %s.%s\n", currentFailures == 0 ? "[ OK ]" : "[FAIL]", testCase.suite, testCase.name);
+		if (currentFailures != 0) {
+			++failed;
+		}
+	}
+
+	//A misspelled suite must not pass as "nothing failed"
+	if (run == 0) {
+		printf("no test cases%s%s\n", suite != nullptr ? " in suite " : "", suite != nullptr ? suite : "");
+		return 1;
+	}
+
+	printf("%d / %d passed\n", run - failed, run);
+	return failed == 0 ? 0 : 1;
+}
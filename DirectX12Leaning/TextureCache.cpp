@@ -0,0 +1,340 @@
+//STL
+#include <algorithm>
+#include <cctype>
+#include <assert.h>
+
+//this
+#include "TextureCache.h"
+
+std::string CanonicalTexturePath(const std::string &path)
+{
+	std::string lowered = path;
+	for (auto &c : lowered) {
+		c = c == '\\' ? '/' : (char)std::tolower((unsigned char)c);
+	}
+
+	//Split on '/', fold "." and ".." (leading ".." of a relative path is kept)
+	const bool absolute = !lowered.empty() && lowered[0] == '/';
+	std::vector<std::string> segments;
+	size_t begin = 0;
+	while (begin <= lowered.size()) {
+		size_t end = lowered.find('/', begin);
+		if (end == std::string::npos) {
+			end = lowered.size();
+		}
+
+		const std::string segment = lowered.substr(begin, end - begin);
+		if (segment == "..") {
+			if (!segments.empty() && segments.back() != ".." && segments.back().back() != ':') {
+				segments.pop_back();
+			}
+			else if (!absolute) {
+				segments.push_back(segment);
+			}
+		}
+		else if (!segment.empty() && segment != ".") {
+			segments.push_back(segment);
+		}
+		begin = end + 1;
+	}
+
+	std::string result = absolute ? "/" : "";
+	for (size_t i = 0; i < segments.size(); ++i) {
+		if (i > 0) {
+			result += '/';
+		}
+		result += segments[i];
+	}
+	return result;
+}
+
+TextureDesc DescribeTexture(const ImageView &image)
+{
+	TextureDesc desc = { image.width, image.height, image.format, image.mipCount, 0 };
+	if (image.mipCount > 0) {
+		const ImageMip &last = image.mips[image.mipCount - 1];
+		desc.pixelBytes = last.offset + (uint64_t)last.rowPitch * last.rowCount;
+	}
+	return desc;
+}
+
+TextureCache::TextureCache(const uint64_t budgetBytes) :
+	budgetBytes(budgetBytes),
+	residentBytes(0),
+	hitCount(0),
+	missCount(0),
+	sharedCount(0),
+	collisionCount(0),
+	evictionCount(0)
+{
+}
+
+TextureHandle TextureCache::Acquire(const std::string &canonicalPath, bool &loadRequired)
+{
+	auto found = paths.find(canonicalPath);
+	if (found != paths.end()) {
+		++hitCount;
+		AddRef(found->second);
+		loadRequired = false;
+		return found->second;
+	}
+
+	++missCount;
+	TextureHandle handle;
+	if (!freeEntries.empty()) {
+		handle = freeEntries.back();
+		freeEntries.pop_back();
+	}
+	else {
+		handle = (TextureHandle)entries.size();
+		entries.emplace_back();
+	}
+
+	Entry &entry = entries[handle];
+	entry.path = canonicalPath;
+	entry.state = EntryState::Loading;
+	entry.refCount = 1;
+	entry.content = invalidContent;
+	entry.used = true;
+	paths[canonicalPath] = handle;
+
+	loadRequired = true;
+	return handle;
+}
+
+void TextureCache::AddRef(const TextureHandle handle)
+{
+	assert(handle < entries.size() && entries[handle].used);
+
+	Entry &entry = entries[handle];
+	if (entry.refCount++ == 0 && entry.state == EntryState::Bound) {
+		AddContentRef(entry.content);
+	}
+}
+
+void TextureCache::Release(const TextureHandle handle)
+{
+	if (handle == invalidTextureHandle) {
+		return;
+	}
+	assert(handle < entries.size() && entries[handle].used && entries[handle].refCount > 0);
+
+	Entry &entry = entries[handle];
+	if (--entry.refCount > 0) {
+		return;
+	}
+
+	switch (entry.state)
+	{
+		case EntryState::Bound: {
+			//Stays resident (and findable by path) until evicted
+			ReleaseContentRef(entry.content);
+			break;
+		}
+		case EntryState::Failed: {
+			//Next Acquire tries the file again
+			FreeEntry(handle);
+			break;
+		}
+
+		//Loading: BindContent / MarkFailed finish it
+		default: break;
+	}
+}
+
+bool TextureCache::BindContent(const TextureHandle handle, const uint64_t contentHash, const TextureDesc &desc, const uint64_t sizeInBytes, uint32_t &content)
+{
+	assert(handle < entries.size() && entries[handle].state == EntryState::Loading);
+
+	Entry &entry = entries[handle];
+	entry.state = EntryState::Bound;
+
+	//Same texels under another path
+	auto found = hashes.find(contentHash);
+	const bool collision = found != hashes.end() &&
+		(!(contents[found->second].desc == desc) || contents[found->second].sizeInBytes != sizeInBytes);
+	if (collision) {
+		++collisionCount;
+	}
+	else if (found != hashes.end()) {
+		++sharedCount;
+		content = found->second;
+		entry.content = content;
+		contents[content].entries.push_back(handle);
+		if (entry.refCount > 0) {
+			AddContentRef(content);
+		}
+		return true;
+	}
+
+	if (!freeContents.empty()) {
+		content = freeContents.back();
+		freeContents.pop_back();
+	}
+	else {
+		content = (uint32_t)contents.size();
+		contents.emplace_back();
+	}
+
+	Content &slot = contents[content];
+	slot.hash = contentHash;
+	slot.desc = desc;
+	slot.sizeInBytes = sizeInBytes;
+	slot.refCount = 0;
+	slot.resident = false;
+	slot.used = true;
+	slot.entries.assign(1, handle);
+	hashes.emplace(contentHash, content);
+	residentBytes += sizeInBytes;
+
+	entry.content = content;
+	if (entry.refCount > 0) {
+		++slot.refCount;
+	}
+	else {
+		slot.lru = lru.insert(lru.end(), content);
+	}
+	return false;
+}
+
+void TextureCache::MarkFailed(const TextureHandle handle)
+{
+	assert(handle < entries.size() && entries[handle].state == EntryState::Loading);
+
+	entries[handle].state = EntryState::Failed;
+	if (entries[handle].refCount == 0) {
+		FreeEntry(handle);
+	}
+}
+
+void TextureCache::MarkResident(const uint32_t content)
+{
+	assert(content < contents.size() && contents[content].used);
+	contents[content].resident = true;
+}
+
+size_t TextureCache::Evict(std::vector<uint32_t> &evicted)
+{
+	size_t count = 0;
+	auto it = lru.begin();
+	while (residentBytes > budgetBytes && it != lru.end()) {
+		const uint32_t content = *it;
+		Content &slot = contents[content];
+
+		//Still on the copy queue
+		if (!slot.resident) {
+			++it;
+			continue;
+		}
+
+		//Every path of this content is unreferenced
+		for (auto handle : slot.entries) {
+			FreeEntry(handle);
+		}
+		slot.entries.clear();
+
+		it = lru.erase(it);
+		auto hashed = hashes.find(slot.hash);
+		if (hashed != hashes.end() && hashed->second == content) {
+			hashes.erase(hashed);
+		}
+		residentBytes -= slot.sizeInBytes;
+		slot.used = false;
+		freeContents.push_back(content);
+
+		evicted.push_back(content);
+		++evictionCount;
+		++count;
+	}
+	return count;
+}
+
+uint32_t TextureCache::GetContent(const TextureHandle handle) const
+{
+	if (handle >= entries.size() || entries[handle].state != EntryState::Bound) {
+		return invalidContent;
+	}
+	return entries[handle].content;
+}
+
+bool TextureCache::IsFailed(const TextureHandle handle) const
+{
+	return handle < entries.size() && entries[handle].used && entries[handle].state == EntryState::Failed;
+}
+
+uint32_t TextureCache::GetRefCount(const TextureHandle handle) const
+{
+	return handle < entries.size() ? entries[handle].refCount : 0;
+}
+
+void TextureCache::SetBudget(const uint64_t budgetBytes)
+{
+	this->budgetBytes = budgetBytes;
+}
+
+uint64_t TextureCache::GetBudget() const
+{
+	return budgetBytes;
+}
+
+uint64_t TextureCache::GetResidentBytes() const
+{
+	return residentBytes;
+}
+
+size_t TextureCache::GetTextureCount() const
+{
+	return contents.size() - freeContents.size();
+}
+
+uint64_t TextureCache::GetHitCount() const
+{
+	return hitCount;
+}
+
+uint64_t TextureCache::GetMissCount() const
+{
+	return missCount;
+}
+
+uint64_t TextureCache::GetSharedCount() const
+{
+	return sharedCount;
+}
+
+uint64_t TextureCache::GetCollisionCount() const
+{
+	return collisionCount;
+}
+
+uint64_t TextureCache::GetEvictionCount() const
+{
+	return evictionCount;
+}
+
+void TextureCache::FreeEntry(const TextureHandle handle)
+{
+	Entry &entry = entries[handle];
+	paths.erase(entry.path);
+	entry.path.clear();
+	entry.state = EntryState::Failed;
+	entry.content = invalidContent;
+	entry.used = false;
+	freeEntries.push_back(handle);
+}
+
+void TextureCache::AddContentRef(const uint32_t content)
+{
+	Content &slot = contents[content];
+	if (slot.refCount++ == 0) {
+		lru.erase(slot.lru);
+	}
+}
+
+void TextureCache::ReleaseContentRef(const uint32_t content)
+{
+	Content &slot = contents[content];
+	if (--slot.refCount == 0) {
+		slot.lru = lru.insert(lru.end(), content);
+	}
+}
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "TextureLoader.h"
+
+/// <summary>
+/// Lexical path normalization: '\' -> '/', lower case, "." / ".." / "//" folded
+/// </summary>
+std::string CanonicalTexturePath(const std::string &path);
+
+//Compared on a content hash match, so a 64 bit collision is not shared as the same texture
+struct TextureDesc
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t format;
+	uint32_t mipCount;
+	uint64_t pixelBytes;	//Every mip level
+
+	bool operator==(const TextureDesc &other) const
+	{
+		return width == other.width && height == other.height && format == other.format &&
+			mipCount == other.mipCount && pixelBytes == other.pixelBytes;
+	}
+};
+
+TextureDesc DescribeTexture(const ImageView &image);
+
+/// <summary>
+/// Ref counted texture handles keyed by canonical path, sharing one resource per distinct content
+/// </summary>
+/// <remarks>
+/// Bookkeeping only: the owner decodes, uploads and destroys the resource of each content index.
+/// Unreferenced textures stay resident until the budget is exceeded, then leave in LRU order.
+/// </remarks>
+class TextureCache
+{
+public:
+	static const uint32_t invalidContent = UINT32_MAX;
+
+	TextureCache(const uint64_t budgetBytes);
+
+	/// <summary>
+	/// Reference the texture of a file
+	/// </summary>
+	/// <param name="canonicalPath">CanonicalTexturePath (or an absolute path passed through it)</param>
+	/// <param name="loadRequired">true on a miss: decode the file and call BindContent / MarkFailed</param>
+	TextureHandle Acquire(const std::string &canonicalPath, bool &loadRequired);
+
+	void AddRef(const TextureHandle handle);
+
+	//invalidTextureHandle is ignored
+	void Release(const TextureHandle handle);
+
+	/// <summary>
+	/// Decode of handle finished
+	/// </summary>
+	/// <param name="contentHash">HashImage of the decoded texels</param>
+	/// <param name="desc">DescribeTexture of the decoded texels, must match as well to share</param>
+	/// <param name="sizeInBytes">Video memory the texture takes</param>
+	/// <param name="content">Resource slot of the texture</param>
+	/// <returns>true when the same content is already cached (nothing to upload)</returns>
+	bool BindContent(const TextureHandle handle, const uint64_t contentHash, const TextureDesc &desc, const uint64_t sizeInBytes, uint32_t &content);
+	void MarkFailed(const TextureHandle handle);
+
+	//Upload of content finished, it may be evicted from now on
+	void MarkResident(const uint32_t content);
+
+	/// <summary>
+	/// Drop unreferenced resident textures, least recently used first, until the budget is met
+	/// </summary>
+	/// <param name="evicted">Content slots whose resource has to be destroyed</param>
+	/// <returns>Number of contents evicted</returns>
+	size_t Evict(std::vector<uint32_t> &evicted);
+
+	//invalidContent while loading / failed
+	uint32_t GetContent(const TextureHandle handle) const;
+	bool IsFailed(const TextureHandle handle) const;
+	uint32_t GetRefCount(const TextureHandle handle) const;
+
+	void SetBudget(const uint64_t budgetBytes);
+	uint64_t GetBudget() const;
+	uint64_t GetResidentBytes() const;
+	size_t GetTextureCount() const;		//Distinct contents held
+
+	uint64_t GetHitCount() const;		//Acquire found the path
+	uint64_t GetMissCount() const;		//Acquire had to load
+	uint64_t GetSharedCount() const;	//Miss whose content was already cached
+	uint64_t GetCollisionCount() const;	//Hash matched, description did not (loaded separately)
+	uint64_t GetEvictionCount() const;
+
+private:
+	enum class EntryState {
+		Loading,
+		Bound,
+		Failed
+	};
+
+	//One per canonical path
+	struct Entry
+	{
+		std::string path;
+		EntryState state;
+		uint32_t refCount;
+		uint32_t content;
+		bool used;
+	};
+
+	//One per distinct texture
+	struct Content
+	{
+		uint64_t hash;
+		TextureDesc desc;
+		uint64_t sizeInBytes;
+		uint32_t refCount;		//References through every bound path
+		bool resident;
+		bool used;
+		std::vector<TextureHandle> entries;
+		std::list<uint32_t>::iterator lru;
+	};
+
+	void FreeEntry(const TextureHandle handle);
+	void AddContentRef(const uint32_t content);
+	void ReleaseContentRef(const uint32_t content);
+
+private:
+	uint64_t budgetBytes;
+	uint64_t residentBytes;
+
+	std::vector<Entry> entries;
+	std::vector<TextureHandle> freeEntries;
+	std::unordered_map<std::string, TextureHandle> paths;
+
+	std::vector<Content> contents;
+	std::vector<uint32_t> freeContents;
+	std::unordered_map<uint64_t, uint32_t> hashes;	//First content of each hash, collisions are not findable
+
+	//Unreferenced contents, least recently released first
+	std::list<uint32_t> lru;
+
+	uint64_t hitCount;
+	uint64_t missCount;
+	uint64_t sharedCount;
+	uint64_t collisionCount;
+	uint64_t evictionCount;
+};
@@ -0,0 +1,234 @@
+//Offline texture cooker: manifest entries -> BC7 / BC4 / BC5 DDS with a full mip chain
+//usage: TextureCooker manifest [--force] [--quick]
+//  --force  cook every entry even when its input hash is unchanged
+//  --quick  faster, lower quality BC7 (TEX_COMPRESS_BC7_QUICK)
+
+//API
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+#include <DirectXTex.h>
+
+//STL
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+//Utility
+#include "CookManifest.h"
+
+namespace
+{
+	//WIC stays out of the Linux build
+	const DirectX::TEX_FILTER_FLAGS mipFilter = DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_FORCE_NON_WIC;
+
+	bool ReadFile(const std::string &path, std::vector<uint8_t> &data)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	bool WriteFile(const std::string &path, const void *data, const size_t size)
+	{
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+		file.write(static_cast<const char *>(data), size);
+		return (bool)file;
+	}
+
+	std::string Extension(const std::string &path)
+	{
+		const size_t dot = path.find_last_of('.');
+		std::string ext = dot != std::string::npos ? path.substr(dot + 1) : std::string();
+		for (auto &c : ext) {
+			if (c >= 'A' && c <= 'Z') {
+				c = (char)(c - 'A' + 'a');
+			}
+		}
+		return ext;
+	}
+
+	std::string DirectoryOf(const std::string &path)
+	{
+		const size_t slash = path.find_last_of("/\\");
+		return slash != std::string::npos ? path.substr(0, slash + 1) : std::string();
+	}
+
+	HRESULT LoadSource(const std::string &path, const std::vector<uint8_t> &data, DirectX::ScratchImage &image)
+	{
+		const std::string ext = Extension(path);
+		if (ext == "dds") {
+			return DirectX::LoadFromDDSMemory(data.data(), data.size(), DirectX::DDS_FLAGS_NONE, nullptr, image);
+		}
+		if (ext == "tga") {
+			return DirectX::LoadFromTGAMemory(data.data(), data.size(), nullptr, image);
+		}
+		if (ext == "hdr") {
+			return DirectX::LoadFromHDRMemory(data.data(), data.size(), nullptr, image);
+		}
+
+#ifdef _WIN32
+		//png / jpg / bmp ...
+		return DirectX::LoadFromWICMemory(data.data(), data.size(), DirectX::WIC_FLAGS_NONE, nullptr, image);
+#else
+		//No WIC: convert to .tga first
+		return E_NOTIMPL;
+#endif
+	}
+
+	/// <summary>
+	/// Decode, pad to 4x4 blocks, build mips, compress and write the DDS
+	/// </summary>
+	bool Cook(const CookEntry &entry, const std::vector<uint8_t> &data, const DirectX::TEX_COMPRESS_FLAGS compressFlags, std::string &error)
+	{
+		DirectX::ScratchImage source;
+		HRESULT result = LoadSource(entry.input, data, source);
+		if (FAILED(result)) {
+			error = result == E_NOTIMPL ? "format needs WIC (use .tga / .hdr / .dds on this platform)" : "decode failed";
+			return false;
+		}
+
+		//Compressors read RGBA8 / float, first level of an already mipped source is enough
+		DirectX::ScratchImage converted;
+		const DirectX::Image *base = source.GetImage(0, 0, 0);
+		if (DirectX::IsCompressed(base->format)) {
+			result = DirectX::Decompress(*base, DXGI_FORMAT_R8G8B8A8_UNORM, converted);
+			base = converted.GetImage(0, 0, 0);
+		}
+		else if (base->format != DXGI_FORMAT_R8G8B8A8_UNORM && base->format != DXGI_FORMAT_R32G32B32A32_FLOAT) {
+			result = DirectX::Convert(*base, DXGI_FORMAT_R8G8B8A8_UNORM, DirectX::TEX_FILTER_FORCE_NON_WIC, DirectX::TEX_THRESHOLD_DEFAULT, converted);
+			base = converted.GetImage(0, 0, 0);
+		}
+		if (FAILED(result)) {
+			error = "format conversion failed";
+			return false;
+		}
+
+		//D3D12 needs block aligned level 0 sizes for BC
+		DirectX::ScratchImage padded;
+		const size_t width = (base->width + 3) & ~size_t(3);
+		const size_t height = (base->height + 3) & ~size_t(3);
+		if (width != base->width || height != base->height) {
+			result = DirectX::Resize(*base, width, height, mipFilter, padded);
+			if (FAILED(result)) {
+				error = "resize failed";
+				return false;
+			}
+			base = padded.GetImage(0, 0, 0);
+		}
+
+		DirectX::ScratchImage mipChain;
+		result = DirectX::GenerateMipMaps(*base, mipFilter, 0, mipChain);
+		if (FAILED(result)) {
+			error = "mip generation failed";
+			return false;
+		}
+
+		DirectX::ScratchImage compressed;
+		result = DirectX::Compress(
+			mipChain.GetImages(),
+			mipChain.GetImageCount(),
+			mipChain.GetMetadata(),
+			(DXGI_FORMAT)GetCookFormat(entry.kind),
+			compressFlags,
+			DirectX::TEX_THRESHOLD_DEFAULT,
+			compressed
+		);
+		if (FAILED(result)) {
+			error = "compression failed";
+			return false;
+		}
+
+		//DX10 header: the runtime DDS codec reads BC4 / BC5 / BC7 from it
+		DirectX::Blob blob;
+		result = DirectX::SaveToDDSMemory(compressed.GetImages(), compressed.GetImageCount(), compressed.GetMetadata(), DirectX::DDS_FLAGS_FORCE_DX10_EXT, blob);
+		if (FAILED(result) || !WriteFile(entry.output, blob.GetBufferPointer(), blob.GetBufferSize())) {
+			error = "could not write " + entry.output;
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2) {
+		printf("usage: TextureCooker manifest [--force] [--quick]\n");
+		return 1;
+	}
+
+	const std::string manifestPath = argv[1];
+	bool force = false;
+	DirectX::TEX_COMPRESS_FLAGS compressFlags = DirectX::TEX_COMPRESS_DEFAULT;
+	for (int i = 2; i < argc; ++i) {
+		if (strcmp(argv[i], "--force") == 0)		{ force = true; }
+		else if (strcmp(argv[i], "--quick") == 0)	{ compressFlags |= DirectX::TEX_COMPRESS_BC7_QUICK; }
+	}
+
+	std::vector<uint8_t> manifestData;
+	if (!ReadFile(manifestPath, manifestData)) {
+		printf("cannot read %s\n", manifestPath.c_str());
+		return 1;
+	}
+
+	std::vector<CookEntry> entries;
+	std::string error;
+	if (!ParseCookManifest(std::string(manifestData.begin(), manifestData.end()), DirectoryOf(manifestPath), entries, error)) {
+		printf("%s: %s\n", manifestPath.c_str(), error.c_str());
+		return 1;
+	}
+
+	//Hashes of the last cook sit next to the manifest
+	const std::string databasePath = manifestPath + ".cooked";
+	CookDatabase database;
+	if (!database.Load(databasePath)) {
+		printf("%s is damaged, cooking everything\n", databasePath.c_str());
+	}
+
+#ifdef _WIN32
+	CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+	int cooked = 0, skipped = 0, failed = 0;
+	for (auto &entry : entries) {
+		std::vector<uint8_t> data;
+		if (!ReadFile(entry.input, data)) {
+			printf("failed  %s: cannot read\n", entry.input.c_str());
+			++failed;
+			continue;
+		}
+
+		const uint64_t hash = CookHash(data, entry.kind);
+		if (!force && !database.NeedsCook(entry.output, hash)) {
+			++skipped;
+			continue;
+		}
+
+		if (!Cook(entry, data, compressFlags, error)) {
+			printf("failed  %s: %s\n", entry.input.c_str(), error.c_str());
+			++failed;
+			continue;
+		}
+
+		database.Set(entry.output, hash);
+		printf("cooked  %s -> %s (%s)\n", entry.input.c_str(), entry.output.c_str(), GetCookKindName(entry.kind));
+		++cooked;
+	}
+
+	if (!database.Save(databasePath)) {
+		printf("cannot write %s\n", databasePath.c_str());
+		++failed;
+	}
+
+	printf("cooked %d, up to date %d, failed %d\n", cooked, skipped, failed);
+	return failed > 0 ? 1 : 0;
+}
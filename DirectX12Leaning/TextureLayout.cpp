@@ -0,0 +1,51 @@
+//STL
+#include <cstring>
+
+//this
+#include "TextureLayout.h"
+
+namespace
+{
+	uint64_t AlignUp(const uint64_t value, const uint64_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+uint64_t ComputeUploadLayout(const ImageView &image, std::vector<UploadSubresource> &layout)
+{
+	const bool compressed = IsBlockCompressed(image.format);
+
+	layout.clear();
+	uint64_t totalSize = 0;
+	for (uint32_t level = 0; level < image.mipCount; ++level) {
+		const ImageMip &mip = image.mips[level];
+		UploadSubresource subresource{};
+		subresource.offset = AlignUp(totalSize, uploadPlacementAlignment);
+		subresource.width = compressed ? (uint32_t)AlignUp(mip.width, 4) : mip.width;
+		subresource.height = compressed ? (uint32_t)AlignUp(mip.height, 4) : mip.height;
+		subresource.rowSize = ImageRowPitch(image.format, mip.width);
+		subresource.rowCount = ImageRowCount(image.format, mip.height);
+		subresource.rowPitch = (uint32_t)AlignUp(subresource.rowSize, uploadPitchAlignment);
+		layout.push_back(subresource);
+
+		//Last row is not padded
+		totalSize = subresource.offset + (uint64_t)subresource.rowPitch * (subresource.rowCount - 1) + subresource.rowSize;
+	}
+	return totalSize;
+}
+
+void WriteUploadData(const ImageView &image, const std::vector<UploadSubresource> &layout, uint8_t *dst)
+{
+	for (size_t level = 0; level < layout.size(); ++level) {
+		const ImageMip &mip = image.mips[level];
+		const UploadSubresource &subresource = layout[level];
+		for (uint32_t row = 0; row < subresource.rowCount; ++row) {
+			memcpy(
+				dst + subresource.offset + (uint64_t)row * subresource.rowPitch,
+				image.pixels + mip.offset + (size_t)row * mip.rowPitch,
+				subresource.rowSize
+			);
+		}
+	}
+}
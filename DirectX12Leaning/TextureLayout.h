@@ -0,0 +1,31 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "ImageCodec.h"
+
+//D3D12_TEXTURE_DATA_PITCH_ALIGNMENT / D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT
+const uint32_t uploadPitchAlignment = 256;
+const uint32_t uploadPlacementAlignment = 512;
+
+//Where one mip level lives in the upload buffer (a placed footprint)
+struct UploadSubresource
+{
+	uint64_t offset;		//Placement aligned
+	uint32_t width;			//Texels, block aligned when compressed
+	uint32_t height;
+	uint32_t rowPitch;		//Pitch aligned
+	uint32_t rowCount;		//Rows (block rows when compressed)
+	uint32_t rowSize;		//Tight bytes per row
+};
+
+/// <summary>
+/// Upload buffer layout of every mip, same rules as ID3D12Device::GetCopyableFootprints
+/// </summary>
+/// <returns>Bytes the upload buffer needs</returns>
+uint64_t ComputeUploadLayout(const ImageView &image, std::vector<UploadSubresource> &layout);
+
+/// <summary>
+/// Copy the tight rows of image into the padded layout
+/// </summary>
+/// <param name="dst">Mapped upload buffer, ComputeUploadLayout bytes</param>
+void WriteUploadData(const ImageView &image, const std::vector<UploadSubresource> &layout, uint8_t *dst);
@@ -0,0 +1,135 @@
+//STL
+#include <algorithm>
+
+//Utility
+#include "Profiler.h"
+
+//this
+#include "TextureLoader.h"
+
+TextureLoader::TextureLoader(DecodeFunc decode, const uint32_t workerCount) :
+	decode(decode),
+	quit(false),
+	activeJobs(0)
+{
+	uint32_t count = workerCount;
+	if (count == 0) {
+		//Leave one core for the render thread (hardware_concurrency may be 0 = unknown)
+		count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	}
+
+	for (uint32_t i = 0; i < count; ++i) {
+		workers.emplace_back(&TextureLoader::WorkerMain, this);
+	}
+}
+
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	jobAvailable.notify_all();
+
+	for (auto &worker : workers) {
+		worker.join();
+	}
+}
+
+TextureHandle TextureLoader::Request(const std::string &path)
+{
+	TextureHandle handle;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		handle = (TextureHandle)states.size();
+		states.push_back(TextureState::Pending);
+		jobs.push_back({ handle, path });
+	}
+	jobAvailable.notify_one();
+	return handle;
+}
+
+size_t TextureLoader::TakeDecoded(std::vector<DecodedTexture> &out, const size_t maxCount)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	size_t count = 0;
+	while (!decoded.empty() && count < maxCount) {
+		out.push_back(std::move(decoded.front()));
+		decoded.pop_front();
+		++count;
+	}
+	return count;
+}
+
+void TextureLoader::MarkReady(const TextureHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (handle < states.size() && states[handle] == TextureState::Decoded) {
+		states[handle] = TextureState::Ready;
+	}
+}
+
+TextureState TextureLoader::GetState(const TextureHandle handle) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (handle >= states.size()) {
+		return TextureState::Failed;
+	}
+	return states[handle];
+}
+
+void TextureLoader::WaitDecoded()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	jobFinished.wait(lock, [this] { return jobs.empty() && activeJobs == 0; });
+}
+
+uint32_t TextureLoader::GetWorkerCount() const
+{
+	return (uint32_t)workers.size();
+}
+
+size_t TextureLoader::GetQueuedCount() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return jobs.size() + activeJobs;
+}
+
+void TextureLoader::WorkerMain()
+{
+	Profiler::Get().SetThreadName("TextureLoader");
+
+	while (true) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			jobAvailable.wait(lock, [this] { return quit || !jobs.empty(); });
+			if (quit) {
+				return;
+			}
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+			++activeJobs;
+		}
+
+		//Decode outside the lock
+		DecodedTexture result;
+		result.handle = job.handle;
+		result.path = job.path;
+		{
+			PROFILE_SCOPE("DecodeImage");
+			result.succeeded = decode(job.path, result.image);
+			result.contentHash = result.succeeded ? HashImage(result.image) : 0;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			states[job.handle] = result.succeeded ? TextureState::Decoded : TextureState::Failed;
+			decoded.push_back(std::move(result));
+			--activeJobs;
+		}
+		jobFinished.notify_all();
+	}
+}
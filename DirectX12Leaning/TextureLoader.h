@@ -0,0 +1,93 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ImageCodec.h"
+
+typedef uint32_t TextureHandle;
+const TextureHandle invalidTextureHandle = UINT32_MAX;
+
+enum class TextureState {
+	Pending,	//Queued / decoding
+	Decoded,	//Waiting for the render thread to upload
+	Ready,
+	Failed
+};
+
+//Decode result handed to the render thread
+struct DecodedTexture
+{
+	TextureHandle handle;
+	std::string path;
+	bool succeeded;
+	uint64_t contentHash;	//HashImage, hashed on the worker
+	DecodedImage image;
+};
+
+/// <summary>
+/// Decodes image files on worker threads; the render thread collects the results and uploads them
+/// </summary>
+class TextureLoader
+{
+public:
+	using DecodeFunc = std::function<bool(const std::string &path, DecodedImage &image)>;
+
+	/// <param name="decode">Called on worker threads (DecodeImageFile, WIC, ...)</param>
+	/// <param name="workerCount">0 = hardware threads - 1</param>
+	TextureLoader(DecodeFunc decode, const uint32_t workerCount = 0);
+	~TextureLoader();
+
+	/// <summary>
+	/// Queue a file, never blocks
+	/// </summary>
+	/// <returns>Handle, Pending until the render thread marks it Ready</returns>
+	TextureHandle Request(const std::string &path);
+
+	/// <summary>
+	/// Move finished decodes (success or failure) to out
+	/// </summary>
+	/// <param name="maxCount">Limit per call (upload budget)</param>
+	/// <returns>Number of textures taken</returns>
+	size_t TakeDecoded(std::vector<DecodedTexture> &out, const size_t maxCount = SIZE_MAX);
+
+	//Render thread: the upload of handle has completed
+	void MarkReady(const TextureHandle handle);
+
+	TextureState GetState(const TextureHandle handle) const;
+
+	/// <summary>
+	/// Block until every requested file has been decoded
+	/// </summary>
+	void WaitDecoded();
+
+	uint32_t GetWorkerCount() const;
+	size_t GetQueuedCount() const;
+
+private:
+	struct Job
+	{
+		TextureHandle handle;
+		std::string path;
+	};
+
+	void WorkerMain();
+
+private:
+	DecodeFunc decode;
+	std::vector<std::thread> workers;
+
+	mutable std::mutex mutex;
+	std::condition_variable jobAvailable;
+	std::condition_variable jobFinished;
+	bool quit;
+
+	std::deque<Job> jobs;
+	uint32_t activeJobs;
+	std::deque<DecodedTexture> decoded;
+	std::vector<TextureState> states;
+};
@@ -0,0 +1,520 @@
+//API
+#include <Windows.h>
+#include <d3d12.h>
+#include <d3dx12.h>
+#include <DirectXTex.h>
+
+//STL
+#include <fstream>
+#include <iterator>
+#include <algorithm>
+#include <assert.h>
+
+//Utility
+#include "DescriptorHeap.h"
+#include "TextureLayout.h"
+#include "CookManifest.h"
+
+//this
+#include "TextureStreamer.h"
+
+namespace
+{
+	std::string ToUtf8(const wchar_t *text)
+	{
+		const int length = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+		std::string result(length > 0 ? length - 1 : 0, '\0');
+		if (length > 1) {
+			WideCharToMultiByte(CP_UTF8, 0, text, -1, &result[0], length, nullptr, nullptr);
+		}
+		return result;
+	}
+
+	std::wstring ToWide(const std::string &text)
+	{
+		const int length = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+		std::wstring result(length > 0 ? length - 1 : 0, L'\0');
+		if (length > 1) {
+			MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, &result[0], length);
+		}
+		return result;
+	}
+
+	//Absolute, so "Resources/a.png" and "./Resources/A.png" hit the same entry
+	std::string CanonicalFileName(const wchar_t *fileName)
+	{
+		const DWORD length = GetFullPathNameW(fileName, 0, nullptr, nullptr);
+		if (length == 0) {
+			return CanonicalTexturePath(ToUtf8(fileName));
+		}
+
+		std::wstring fullPath(length, L'\0');
+		const DWORD written = GetFullPathNameW(fileName, length, &fullPath[0], nullptr);
+		fullPath.resize(written);
+		return CanonicalTexturePath(ToUtf8(fullPath.c_str()));
+	}
+}
+
+TextureStreamer::TextureStreamer(const uint64_t cacheBudget) :
+	dev(nullptr),
+	descriptorHeap(nullptr),
+	loader(&TextureStreamer::Decode),
+	cache(cacheBudget),
+	placeholder(nullptr),
+	placeholderDescriptor(DescriptorAllocator::invalidIndex),
+	copyQueue(nullptr),
+	copyAllocator(nullptr),
+	copyList(nullptr),
+	copyFence(nullptr),
+	copyFenceValue(0),
+	copyEvent(nullptr),
+	batchInFlight(false),
+	uploadedCount(0),
+	failedCount(0)
+{
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	if (dev == nullptr) {
+		return;
+	}
+
+	RetireUploads(true);
+
+	//Caller has waited for the direct queue (DirectX12::WaitIdle)
+	for (auto resource : evictedThisFrame) {
+		resource->Release();
+	}
+	for (auto &texture : retired) {
+		texture.resource->Release();
+	}
+
+	for (auto &texture : textures) {
+		if (texture.resource != nullptr) {
+			descriptorHeap->Free(texture.descriptor);
+			texture.resource->Release();
+		}
+	}
+	descriptorHeap->Free(placeholderDescriptor);
+	placeholder->Release();
+
+	copyList->Release();
+	copyAllocator->Release();
+	copyFence->Release();
+	copyQueue->Release();
+	CloseHandle(copyEvent);
+}
+
+void TextureStreamer::Initialize(ID3D12Device *dev, DescriptorHeap *descriptorHeap)
+{
+	this->dev = dev;
+	this->descriptorHeap = descriptorHeap;
+
+	CreatePlaceholder();
+	CreateCopyQueue();
+}
+
+TextureHandle TextureStreamer::Load(const wchar_t *fileName)
+{
+	bool loadRequired = false;
+	const TextureHandle handle = cache.Acquire(CanonicalFileName(fileName), loadRequired);
+	if (!loadRequired) {
+		return handle;
+	}
+
+	//Packed (as is, or its cooked .dds) -> read from the mapping, otherwise decode on a worker
+	const std::string path = ToUtf8(fileName);
+	int entry = -1;
+	if (archive.IsOpen()) {
+		entry = archive.Find(path);
+		if (entry < 0) {
+			entry = archive.Find(CookedTexturePath(path));
+		}
+	}
+
+	if (entry >= 0) {
+		archiveRequests.push_back({ handle, (uint32_t)entry });
+	}
+	else {
+		loading[loader.Request(path)] = handle;
+	}
+	return handle;
+}
+
+bool TextureStreamer::MountArchive(const wchar_t *fileName)
+{
+	return archive.Open(ToUtf8(fileName));
+}
+
+void TextureStreamer::Release(const TextureHandle handle)
+{
+	cache.Release(handle);
+}
+
+uint32_t TextureStreamer::GetDescriptor(const TextureHandle handle) const
+{
+	const uint32_t content = cache.GetContent(handle);
+	if (content >= textures.size() || !textures[content].ready) {
+		return placeholderDescriptor;
+	}
+	return textures[content].descriptor;
+}
+
+D3D12_GPU_DESCRIPTOR_HANDLE TextureStreamer::GetGpuHandle(const TextureHandle handle) const
+{
+	return descriptorHeap->GetGpuHandle(GetDescriptor(handle));
+}
+
+bool TextureStreamer::IsReady(const TextureHandle handle) const
+{
+	const uint32_t content = cache.GetContent(handle);
+	return content < textures.size() && textures[content].ready;
+}
+
+void TextureStreamer::Update()
+{
+	RetireUploads(false);
+	EvictTextures();
+	if (!batchInFlight) {
+		SubmitUploads();
+	}
+}
+
+void TextureStreamer::EndFrame(const uint64_t fenceValue)
+{
+	for (auto resource : evictedThisFrame) {
+		retired.push_back({ fenceValue, resource });
+	}
+	evictedThisFrame.clear();
+}
+
+void TextureStreamer::Retire(const uint64_t completedFenceValue)
+{
+	while (!retired.empty() && retired.front().fenceValue <= completedFenceValue) {
+		retired.front().resource->Release();
+		retired.pop_front();
+	}
+}
+
+void TextureStreamer::Flush()
+{
+	loader.WaitDecoded();
+
+	//Budgeted batches until everything decoded is on the GPU
+	do {
+		RetireUploads(true);
+		SubmitUploads();
+	} while (batchInFlight);
+}
+
+uint64_t TextureStreamer::GetUploadedCount() const
+{
+	return uploadedCount;
+}
+
+uint64_t TextureStreamer::GetFailedCount() const
+{
+	return failedCount;
+}
+
+const TextureCache &TextureStreamer::GetCache() const
+{
+	return cache;
+}
+
+TextureCache &TextureStreamer::GetCache()
+{
+	return cache;
+}
+
+void TextureStreamer::CreatePlaceholder()
+{
+	//1x1 white, CPU written like the old per object textures
+	const CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM, 1, 1, 1, 1);
+	result = dev->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_CPU_PAGE_PROPERTY_WRITE_BACK, D3D12_MEMORY_POOL_L0),
+		D3D12_HEAP_FLAG_NONE,
+		&texresDesc,
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&placeholder)
+	);
+	assert(result == S_OK);
+
+	const uint32_t white = 0xffffffff;
+	result = placeholder->WriteToSubresource(0, nullptr, &white, sizeof(white), sizeof(white));
+	assert(result == S_OK);
+
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+	srvDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MipLevels = 1;
+
+	placeholderDescriptor = descriptorHeap->Allocate();
+	dev->CreateShaderResourceView(placeholder, &srvDesc, descriptorHeap->GetCpuHandle(placeholderDescriptor));
+}
+
+void TextureStreamer::CreateCopyQueue()
+{
+	D3D12_COMMAND_QUEUE_DESC queueDesc{};
+	queueDesc.Type = D3D12_COMMAND_LIST_TYPE_COPY;
+	result = dev->CreateCommandQueue(&queueDesc, IID_PPV_ARGS(&copyQueue));
+	assert(result == S_OK);
+
+	result = dev->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_COPY, IID_PPV_ARGS(&copyAllocator));
+	assert(result == S_OK);
+
+	result = dev->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_COPY, copyAllocator, nullptr, IID_PPV_ARGS(&copyList));
+	assert(result == S_OK);
+	copyList->Close();
+
+	result = dev->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&copyFence));
+	assert(result == S_OK);
+
+	copyEvent = CreateEvent(nullptr, false, false, nullptr);
+	assert(copyEvent != nullptr);
+}
+
+void TextureStreamer::RetireUploads(const bool wait)
+{
+	if (!batchInFlight) {
+		return;
+	}
+
+	if (copyFence->GetCompletedValue() < batch.fenceValue) {
+		if (!wait) {
+			return;
+		}
+		copyFence->SetEventOnCompletion(batch.fenceValue, copyEvent);
+		WaitForSingleObject(copyEvent, INFINITE);
+	}
+
+	for (auto buffer : batch.staging) {
+		buffer->Release();
+	}
+
+	//Copy is done: the texture decays to COMMON and is promoted to SRV by the direct queue
+	for (auto content : batch.contents) {
+		Texture &texture = textures[content];
+
+		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+		srvDesc.Format = texture.format;
+		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+		srvDesc.Texture2D.MipLevels = texture.mipLevels;
+		dev->CreateShaderResourceView(texture.resource, &srvDesc, descriptorHeap->GetCpuHandle(texture.descriptor));
+
+		texture.ready = true;
+		cache.MarkResident(content);
+		++uploadedCount;
+	}
+
+	batch.staging.clear();
+	batch.contents.clear();
+	batchInFlight = false;
+}
+
+void TextureStreamer::EvictTextures()
+{
+	std::vector<uint32_t> evicted;
+	if (cache.Evict(evicted) == 0) {
+		return;
+	}
+
+	//The descriptor free is fence deferred by DescriptorHeap, the resource by EndFrame / Retire
+	for (auto content : evicted) {
+		Texture &texture = textures[content];
+		descriptorHeap->Free(texture.descriptor);
+		evictedThisFrame.push_back(texture.resource);
+		texture = Texture{ nullptr, DescriptorAllocator::invalidIndex, 0, DXGI_FORMAT_UNKNOWN, false };
+	}
+}
+
+void TextureStreamer::SubmitUploads()
+{
+	//Archive textures need no decode and go first
+	const size_t archiveCount = std::min<size_t>(archiveRequests.size(), maxTextureUploadsPerFrame);
+	std::vector<DecodedTexture> decoded;
+	loader.TakeDecoded(decoded, maxTextureUploadsPerFrame - archiveCount);
+	if (archiveCount == 0 && decoded.empty()) {
+		return;
+	}
+
+	copyAllocator->Reset();
+	copyList->Reset(copyAllocator, nullptr);
+
+	//Rows are copied straight out of the mapping into the upload buffer
+	for (size_t i = 0; i < archiveCount; ++i) {
+		const ArchiveRequest request = archiveRequests.front();
+		archiveRequests.pop_front();
+		RecordUpload(request.handle, archive.GetImage(request.entry), archive.GetContentHash(request.entry));
+	}
+
+	for (auto &entry : decoded) {
+		const auto request = loading.find(entry.handle);
+		const TextureHandle handle = request->second;
+		loading.erase(request);
+
+		if (!entry.succeeded) {
+			//Stays on the placeholder
+			OutputDebugStringA(("Texture load failed: " + entry.path + "\n").c_str());
+			cache.MarkFailed(handle);
+			++failedCount;
+			continue;
+		}
+		RecordUpload(handle, ViewImage(entry.image), entry.contentHash);
+	}
+
+	copyList->Close();
+	ID3D12CommandList *cmdLists[] = { copyList };
+	copyQueue->ExecuteCommandLists(1, cmdLists);
+
+	batch.fenceValue = ++copyFenceValue;
+	copyQueue->Signal(copyFence, batch.fenceValue);
+	batchInFlight = true;
+}
+
+void TextureStreamer::RecordUpload(const TextureHandle handle, const ImageView &image, const uint64_t contentHash)
+{
+	const UINT mipLevels = image.mipCount;
+	const CD3DX12_RESOURCE_DESC texresDesc = CD3DX12_RESOURCE_DESC::Tex2D(
+		(DXGI_FORMAT)image.format,
+		image.width,
+		image.height,
+		1,
+		(UINT16)mipLevels
+	);
+
+	//Identical texels already loaded from another file: share that texture
+	const D3D12_RESOURCE_ALLOCATION_INFO allocation = dev->GetResourceAllocationInfo(0, 1, &texresDesc);
+	uint32_t content = TextureCache::invalidContent;
+	if (cache.BindContent(handle, contentHash, DescribeTexture(image), allocation.SizeInBytes, content)) {
+		return;
+	}
+
+	//Copy queue resources start in COMMON
+	ID3D12Resource *texture = nullptr;
+	result = dev->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
+		D3D12_HEAP_FLAG_NONE,
+		&texresDesc,
+		D3D12_RESOURCE_STATE_COMMON,
+		nullptr,
+		IID_PPV_ARGS(&texture)
+	);
+	assert(result == S_OK);
+
+	std::vector<UploadSubresource> layout;
+	const uint64_t stagingSize = ComputeUploadLayout(image, layout);
+
+	ID3D12Resource *staging = nullptr;
+	result = dev->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(stagingSize),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&staging)
+	);
+	assert(result == S_OK);
+
+	//Tight rows -> 256 byte aligned footprint rows, every mip
+	uint8_t *mapped = nullptr;
+	result = staging->Map(0, &CD3DX12_RANGE(0, 0), (void **)&mapped);
+	assert(result == S_OK);
+	WriteUploadData(image, layout, mapped);
+	staging->Unmap(0, nullptr);
+
+	for (UINT level = 0; level < mipLevels; ++level) {
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT footprint{};
+		footprint.Offset = layout[level].offset;
+		footprint.Footprint.Format = texresDesc.Format;
+		footprint.Footprint.Width = layout[level].width;
+		footprint.Footprint.Height = layout[level].height;
+		footprint.Footprint.Depth = 1;
+		footprint.Footprint.RowPitch = layout[level].rowPitch;
+
+		const CD3DX12_TEXTURE_COPY_LOCATION dst(texture, level);
+		const CD3DX12_TEXTURE_COPY_LOCATION src(staging, footprint);
+		copyList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+	}
+
+	if (content >= textures.size()) {
+		textures.resize(content + 1, Texture{ nullptr, DescriptorAllocator::invalidIndex, 0, DXGI_FORMAT_UNKNOWN, false });
+	}
+	Texture &slot = textures[content];
+	slot.resource = texture;
+	slot.descriptor = descriptorHeap->Allocate();
+	slot.mipLevels = mipLevels;
+	slot.format = (DXGI_FORMAT)image.format;
+
+	//Published once the copy fence is reached
+	batch.staging.push_back(staging);
+	batch.contents.push_back(content);
+}
+
+bool TextureStreamer::Decode(const std::string &path, DecodedImage &image)
+{
+	const std::wstring fileName = ToWide(path);
+
+	//.tga / .hdr / .dds: portable CPU codecs
+	if (IsPortableImageFile(path)) {
+		std::ifstream file(fileName, std::ios::binary);
+		if (!file) {
+			return false;
+		}
+		const std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		if (!DecodeImageData(path, data.data(), data.size(), image)) {
+			return false;
+		}
+
+		//DDS keeps the mips it was saved with
+		GenerateImageMips(image);
+		return true;
+	}
+
+	//Cooked BC texture next to the source (TextureCooker), WIC otherwise
+	std::ifstream cooked(ToWide(CookedTexturePath(path)), std::ios::binary);
+	if (cooked) {
+		const std::vector<uint8_t> data((std::istreambuf_iterator<char>(cooked)), std::istreambuf_iterator<char>());
+		if (DecodeDDS(data.data(), data.size(), image)) {
+			return true;
+		}
+	}
+
+	//WIC needs COM on this worker thread
+	const HRESULT com = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+
+	DirectX::TexMetadata metadata{};
+	DirectX::ScratchImage scratchImg{};
+	const HRESULT loaded = LoadFromWICFile(fileName.c_str(), DirectX::WIC_FLAGS_NONE, &metadata, scratchImg);
+
+	bool succeeded = false;
+	if (loaded == S_OK) {
+		//Full chain, the single level image when the format can not be filtered
+		DirectX::ScratchImage mipChain{};
+		const DirectX::ScratchImage *source = &scratchImg;
+		if (DirectX::GenerateMipMaps(*scratchImg.GetImage(0, 0, 0), DirectX::TEX_FILTER_DEFAULT, 0, mipChain) == S_OK) {
+			source = &mipChain;
+		}
+
+		image = DecodedImage();
+		image.width = (uint32_t)metadata.width;
+		image.height = (uint32_t)metadata.height;
+		image.format = (uint32_t)metadata.format;
+		for (size_t level = 0; level < source->GetMetadata().mipLevels; ++level) {
+			const DirectX::Image *img = source->GetImage(level, 0, 0);
+			ImageMip mip{ (uint32_t)img->width, (uint32_t)img->height, (uint32_t)img->rowPitch, (uint32_t)(img->slicePitch / img->rowPitch), image.pixels.size() };
+			image.pixels.insert(image.pixels.end(), img->pixels, img->pixels + img->slicePitch);
+			image.mips.push_back(mip);
+		}
+		succeeded = true;
+	}
+
+	if (SUCCEEDED(com)) {
+		CoUninitialize();
+	}
+	return succeeded;
+}
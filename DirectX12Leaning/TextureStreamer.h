@@ -0,0 +1,145 @@
+#pragma once
+#include <deque>
+#include <unordered_map>
+#include "TextureLoader.h"
+#include "TextureCache.h"
+#include "AssetArchive.h"
+
+class DescriptorHeap;
+
+//Textures uploaded per frame at most (copy queue budget)
+const uint32_t maxTextureUploadsPerFrame = 8;
+
+/// <summary>
+/// Decodes textures on TextureLoader workers and uploads them on a copy queue
+/// </summary>
+/// <remarks>
+/// Handles come from TextureCache: one load per file path, one resource per distinct content.
+/// </remarks>
+class TextureStreamer
+{
+public:
+	/// <param name="cacheBudget">Bytes of unreferenced textures kept resident for reuse</param>
+	TextureStreamer(const uint64_t cacheBudget);
+	~TextureStreamer();
+	void Initialize(ID3D12Device *dev, DescriptorHeap *descriptorHeap);
+
+	/// <summary>
+	/// Reference a texture, the file is only loaded when it is not cached
+	/// </summary>
+	/// <param name="fileName">WIC image (a cooked .dds beside it is used instead), .tga / .hdr / .dds use the CPU codecs</param>
+	/// <returns>Handle holding one reference, give it back with Release</returns>
+	TextureHandle Load(const wchar_t *fileName);
+	void Release(const TextureHandle handle);
+
+	/// <summary>
+	/// Serve later Loads from an AssetArchive (names as passed to Load), missing names fall back to files
+	/// </summary>
+	/// <returns>false when the archive can not be opened</returns>
+	bool MountArchive(const wchar_t *fileName);
+
+	/// <summary>
+	/// SRV of the texture, a 1x1 white placeholder until the upload has finished
+	/// </summary>
+	uint32_t GetDescriptor(const TextureHandle handle) const;
+	D3D12_GPU_DESCRIPTOR_HANDLE GetGpuHandle(const TextureHandle handle) const;
+
+	bool IsReady(const TextureHandle handle) const;
+
+	/// <summary>
+	/// Publish finished uploads, evict over budget and submit newly decoded textures (DirectX12::ScreenFlip)
+	/// </summary>
+	void Update();
+
+	//Evicted resources are released once the frames that drew with them retire
+	void EndFrame(const uint64_t fenceValue);
+	void Retire(const uint64_t completedFenceValue);
+
+	/// <summary>
+	/// Block until every requested texture is decoded and uploaded
+	/// </summary>
+	void Flush();
+
+	uint64_t GetUploadedCount() const;
+	uint64_t GetFailedCount() const;
+
+	//Hit / miss / shared / eviction counters and resident bytes
+	const TextureCache &GetCache() const;
+	TextureCache &GetCache();
+
+private:
+	void CreatePlaceholder();
+	void CreateCopyQueue();
+	void RetireUploads(const bool wait);
+	void SubmitUploads();
+	void RecordUpload(const TextureHandle handle, const ImageView &image, const uint64_t contentHash);
+	void EvictTextures();
+
+	static bool Decode(const std::string &path, DecodedImage &image);
+
+private:
+	struct Texture
+	{
+		ID3D12Resource *resource;
+		uint32_t descriptor;
+		uint32_t mipLevels;
+		DXGI_FORMAT format;
+		bool ready;		//SRV written, copy finished
+	};
+
+	//Copies recorded in one ExecuteCommandLists
+	struct UploadBatch
+	{
+		uint64_t fenceValue;
+		std::vector<ID3D12Resource *> staging;
+		std::vector<uint32_t> contents;
+	};
+
+	struct ArchiveRequest
+	{
+		TextureHandle handle;
+		uint32_t entry;
+	};
+
+	//Evicted texture waiting for its last frame
+	struct RetiredTexture
+	{
+		uint64_t fenceValue;
+		ID3D12Resource *resource;
+	};
+
+	HRESULT result;
+	ID3D12Device *dev;
+	DescriptorHeap *descriptorHeap;
+
+	TextureLoader loader;
+	TextureCache cache;
+
+	//Loader request -> cache handle
+	std::unordered_map<TextureHandle, TextureHandle> loading;
+
+	AssetArchive archive;
+	std::deque<ArchiveRequest> archiveRequests;
+
+	//Indexed by TextureCache content
+	std::vector<Texture> textures;
+
+	std::vector<ID3D12Resource *> evictedThisFrame;
+	std::deque<RetiredTexture> retired;
+
+	ID3D12Resource *placeholder;
+	uint32_t placeholderDescriptor;
+
+	//Copy queue, one batch in flight
+	ID3D12CommandQueue *copyQueue;
+	ID3D12CommandAllocator *copyAllocator;
+	ID3D12GraphicsCommandList *copyList;
+	ID3D12Fence *copyFence;
+	uint64_t copyFenceValue;
+	HANDLE copyEvent;
+	bool batchInFlight;
+	UploadBatch batch;
+
+	uint64_t uploadedCount;
+	uint64_t failedCount;
+};
@@ -0,0 +1,102 @@
+//API
+#include <Windows.h>
+#include <d3d12.h>
+#include <d3dx12.h>
+
+//STL
+#include <assert.h>
+
+//Utility
+#include "FramePacer.h"
+
+//this
+#include "UploadRing.h"
+
+UploadRing::UploadRing(const uint64_t capacity) :
+	allocator(capacity),
+	fence(nullptr),
+	droppedCount(0),
+	buffer(nullptr),
+	mapped(nullptr),
+	gpuBase(0)
+{
+}
+
+UploadRing::~UploadRing()
+{
+	if (buffer != nullptr) {
+		buffer->Unmap(0, nullptr);
+		buffer->Release();
+	}
+}
+
+void UploadRing::Initialize(ID3D12Device *dev, FrameFence *fence)
+{
+	this->fence = fence;
+
+	result = dev->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(allocator.GetCapacity()),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(&buffer)
+	);
+	assert(result == S_OK);
+
+	//Upload heaps may stay mapped for their whole lifetime
+	result = buffer->Map(0, &CD3DX12_RANGE(0, 0), (void **)&mapped);
+	assert(result == S_OK);
+
+	gpuBase = buffer->GetGPUVirtualAddress();
+}
+
+UploadAllocation UploadRing::Allocate(const uint64_t size, const uint64_t alignment)
+{
+	uint64_t offset;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		offset = allocator.AllocateWaiting(size, alignment, fence);
+		if (offset == LinearRingAllocator::invalidOffset) {
+			++droppedCount;
+		}
+	}
+
+	//More than this frame left room for: never hand out memory outside the buffer
+	if (offset == LinearRingAllocator::invalidOffset) {
+		OutputDebugStringA("UploadRing: allocation does not fit in the ring, dropped\n");
+		return { nullptr, 0, buffer, 0 };
+	}
+
+	UploadAllocation allocation;
+	allocation.cpu = mapped + offset;
+	allocation.gpu = gpuBase + offset;
+	allocation.resource = buffer;
+	allocation.offset = offset;
+	return allocation;
+}
+
+void UploadRing::EndFrame(const uint64_t fenceValue)
+{
+	allocator.EndFrame(fenceValue);
+}
+
+void UploadRing::Retire(const uint64_t completedFenceValue)
+{
+	allocator.Retire(completedFenceValue);
+}
+
+uint64_t UploadRing::GetCapacity() const
+{
+	return allocator.GetCapacity();
+}
+
+uint64_t UploadRing::GetUsedSize() const
+{
+	return allocator.GetUsedSize();
+}
+
+uint64_t UploadRing::GetDroppedCount() const
+{
+	return droppedCount;
+}
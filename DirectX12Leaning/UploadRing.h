@@ -0,0 +1,73 @@
+#pragma once
+#include <cstring>
+#include <mutex>
+#include "LinearRingAllocator.h"
+
+class FrameFence;
+
+struct UploadAllocation
+{
+	void *cpu;
+	D3D12_GPU_VIRTUAL_ADDRESS gpu;
+
+	//For CopyBufferRegion / CopyTextureRegion sources
+	ID3D12Resource *resource;
+	uint64_t offset;
+};
+
+/// <summary>
+/// One persistently mapped UPLOAD buffer shared by every per-frame constant / instance write
+/// </summary>
+class UploadRing
+{
+public:
+	UploadRing(const uint64_t capacity);
+	~UploadRing();
+	/// <param name="fence">Fence of the frames passed to EndFrame (waited on when the ring is full)</param>
+	void Initialize(ID3D12Device *dev, FrameFence *fence);
+
+	/// <summary>
+	/// Memory valid until the GPU finishes the current frame (any thread, parallel recording)
+	/// </summary>
+	/// <remarks>
+	/// A full ring waits for the oldest frames in flight. cpu is nullptr when size does not fit
+	/// even then (larger than the space left by this frame): the caller drops the work.
+	/// </remarks>
+	UploadAllocation Allocate(const uint64_t size, const uint64_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	/// <summary>
+	/// Copy data and return its GPU address (root CBV / SRV)
+	/// </summary>
+	/// <returns>0 when the ring cannot hold it (drop the draw)</returns>
+	template<class T>
+	D3D12_GPU_VIRTUAL_ADDRESS Push(const T &data)
+	{
+		UploadAllocation allocation = Allocate(sizeof(T));
+		if (allocation.cpu == nullptr) {
+			return 0;
+		}
+		memcpy(allocation.cpu, &data, sizeof(T));
+		return allocation.gpu;
+	}
+
+	//Called by DirectX12::ScreenFlip
+	void EndFrame(const uint64_t fenceValue);
+	void Retire(const uint64_t completedFenceValue);
+
+	uint64_t GetCapacity() const;
+	uint64_t GetUsedSize() const;
+
+	//Allocations dropped because the ring could not hold them
+	uint64_t GetDroppedCount() const;
+
+private:
+	HRESULT result;
+	LinearRingAllocator allocator;
+	FrameFence *fence;
+	std::mutex mutex;
+	uint64_t droppedCount;
+
+	ID3D12Resource *buffer;
+	uint8_t *mapped;
+	D3D12_GPU_VIRTUAL_ADDRESS gpuBase;
+};
@@ -11,14 +11,25 @@
 //STL
 #include <vector>
 #include <ctime>
+#include <chrono>
+#include <fstream>
+#include <string>
 
 //Utility
+#include "KeyCodes.h"
+#include "InputQueue.h"
 #include "Input.h"
 #include "Win32.h"
 #include "tempUtility.h"
+#include "FixedTimestep.h"
+#include "Profiler.h"
 #include "DirectX12.h"
 #include "PlayerOP.h"
 #include "Draw2D.h"
 #include "Draw2DGraph.h"
 #include "Draw3D.h"
-#include "Bullet.h"
\ No newline at end of file
+#include "InstancePacker.h"
+#include "SpriteRenderer.h"
+#include "BulletPool.h"
+#include "GameSimulation.h"
+#include "InputRecording.h"
\ No newline at end of file
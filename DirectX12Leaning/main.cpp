@@ -1,20 +1,50 @@
 #include "includes.h"
 #include "GamePlay.h"
 
+//API(Win)
+#include <shellapi.h>
+#pragma comment(lib, "shell32.lib")
+
+namespace
+{
+	SessionOptions ParseCommandLine()
+	{
+		SessionOptions session;
+		session.seed = (uint64_t)time(nullptr);
+
+		int argc = 0;
+		LPWSTR *argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+		if (argv == nullptr) {
+			return session;
+		}
+
+		for (int i = 1; i + 1 < argc; ++i) {
+			const std::wstring option = argv[i];
+			if (option == L"-seed")			{ session.seed = wcstoull(argv[++i], nullptr, 10); }
+			else if (option == L"-record")	{ session.recordPath = argv[++i]; }
+			else if (option == L"-replay")	{ session.replayPath = argv[++i]; }
+			else if (option == L"-profile")	{ session.profilePath = argv[++i]; }
+		}
+
+		LocalFree(argv);
+		return session;
+	}
+}
+
 int WINAPI WinMain(_In_ HINSTANCE hinstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nShowCmd) 
 {
-	srand(time(nullptr));
+	const SessionOptions session = ParseCommandLine();
 	const int window_width = 1920;
 	const int window_height = 1080;
 
 	//Initialize
 	Win32		*win32 = new Win32(L"Test", window_width, window_height);
 	Input		*input = new Input(win32->GetWindowClass(), win32->GetHandleWindow());
-	DirectX12	*dx12 = new DirectX12(win32->GetHandleWindow(), window_width, window_height, SelectVSYNC::EnableVSYNC);
+	DirectX12	*dx12 = new DirectX12(win32->GetHandleWindow(), window_width, window_height, SelectVSYNC::EnableVSYNC, 2);
 
 	dx12->Initialize_components();
 
-	GamePlay play(win32, dx12, input, window_width, window_height);
+	GamePlay play(win32, dx12, input, window_width, window_height, session);
 	play.Update();
 
 	delete win32, dx12, input;
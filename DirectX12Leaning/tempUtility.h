@@ -1,5 +1,6 @@
 #pragma once
 #include <DirectXMath.h>
+#include "SimulationTypes.h"
 
 struct ConstBufferData
 {
@@ -30,13 +31,6 @@ struct Graph2DVertex
 	DirectX::XMFLOAT2 uv;
 };
 
-struct Position3D
-{
-	float x = 0;
-	float y = 0;
-	float z = 0;
-};
-
 class tempUtility
 {
 public: